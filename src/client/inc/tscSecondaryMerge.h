@@ -85,8 +85,11 @@ typedef struct SSubqueryState {
    */
   int32_t  numOfCompleted;
   int32_t  numOfTotal;          // number of total sub-queries
+  int32_t  numOfLaunched;       // number of sub-queries that are launched or skipped, at most numOfTotal
   int32_t  code;                // code from subqueries
   uint64_t numOfRetrievedRows;  // total number of points in this query
+  int32_t  numOfPagesInMem;     // pages of sorted runs kept in memory by all sub-queries
+  int32_t  maxPagesInMem;       // memory budget of sorted runs, runs above it are spilled to disk
 } SSubqueryState;
 
 typedef struct SRetrieveSupport {
@@ -102,15 +105,22 @@ typedef struct SRetrieveSupport {
 } SRetrieveSupport;
 
 int32_t tscLocalReducerEnvCreate(SSqlObj *pSql, tExtMemBuffer ***pMemBuffer, tOrderDescriptor **pDesc,
-                                 tColModel **pFinalModel, uint32_t nBufferSize);
+                                 tColModel **pFinalModel, uint32_t nBufferSize, int32_t maxPagesInMem);
 
 void tscLocalReducerEnvDestroy(tExtMemBuffer **pMemBuffer, tOrderDescriptor *pDesc, tColModel *pFinalModel,
                                int32_t numOfVnodes);
 
 int32_t saveToBuffer(tExtMemBuffer *pMemoryBuf, tOrderDescriptor *pDesc, tFilePage *pPage, void *data,
-                     int32_t numOfRows, int32_t orderType);
+                     int32_t numOfRows, int32_t orderType, SSubqueryState *pState);
 
-int32_t tscFlushTmpBuffer(tExtMemBuffer *pMemoryBuf, tOrderDescriptor *pDesc, tFilePage *pPage, int32_t orderType);
+int32_t tscFlushTmpBuffer(tExtMemBuffer *pMemoryBuf, tOrderDescriptor *pDesc, tFilePage *pPage, int32_t orderType,
+                          SSubqueryState *pState);
+
+/*
+ * merge the sorted runs of one vnode into a single run, once all data of the vnode are retrieved
+ */
+int32_t tscMergeTmpBufferRuns(tExtMemBuffer *pMemoryBuf, tOrderDescriptor *pDesc, int32_t orderType,
+                              SSubqueryState *pState);
 
 /*
  * create local reducer to launch the second-stage reduce process at client site
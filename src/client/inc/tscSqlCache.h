@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_TSCSQLCACHE_H
+#define TDENGINE_TSCSQLCACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "tsclient.h"
+
+struct SSqlStmtKey;
+
+void tscInitSqlCache(int32_t maxEntries);
+
+void tscClearSqlCache();
+
+/**
+ * normalize the sql string of pSql into a cache key, in which the time stamps, the limit/offset values and
+ * the literals compared with columns are replaced by placeholders
+ *
+ * @return  NULL if the statement can not be cached
+ */
+struct SSqlStmtKey *tscBuildSqlStmtKey(SSqlObj *pSql, const char *acct, const char *db);
+
+void tscFreeSqlStmtKey(struct SSqlStmtKey *pKey);
+
+/**
+ * build pSql->cmd from the cached plan of the same statement, only the values of the placeholders are bound again
+ *
+ * @return  true if the cache handles the statement, the result is kept in *code. Otherwise pSql->cmd is left
+ *          clean, and the statement should be parsed.
+ */
+bool tscGetSqlCmdFromCache(SSqlObj *pSql, struct SSqlStmtKey *pKey, int32_t *code);
+
+/**
+ * keep the plan in pSql->cmd that is just parsed from the statement
+ *
+ * @param parseTime  time spent in parsing the statement, in microsecond
+ */
+void tscAddSqlCmdIntoCache(SSqlObj *pSql, struct SSqlStmtKey *pKey, int64_t parseTime);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TDENGINE_TSCSQLCACHE_H
@@ -69,6 +69,19 @@ typedef struct SJoinSubquerySupporter {
   char  path[PATH_MAX];
 } SJoinSubquerySupporter;
 
+/*
+ * shared by the submit objects of a multi-vnode insertion, each of which sends the data block of one vnode
+ */
+typedef struct SInsertSupporter {
+  SSqlObj*  pObj;            // parent SqlObj
+  SSqlObj** pSubs;           // submit object of each vnode
+  int32_t   numOfTotal;      // number of submit objects
+  int32_t   numOfLaunched;   // number of submits that are sent, at most numOfTotal
+  int32_t   numOfCompleted;  // number of vnodes that respond
+  int32_t   numOfRows;       // inserted rows of all vnodes
+  int32_t   code;            // first error code from vnodes
+} SInsertSupporter;
+
 void tscDestroyDataBlock(STableDataBlocks* pDataBlock);
 STableDataBlocks* tscCreateDataBlock(int32_t size);
 void tscAppendDataBlock(SDataBlockList* pList, STableDataBlocks* pBlocks);
@@ -197,6 +210,9 @@ void tscGetMetricMetaCacheKey(SSqlCmd* pCmd, char* keyStr, uint64_t uid);
 int tscGetMetricMeta(SSqlObj* pSql);
 int tscGetMeterMeta(SSqlObj* pSql, char* meterId, int32_t tableIndex);
 int tscGetMeterMetaEx(SSqlObj* pSql, char* meterId, bool createIfNotExists);
+int tscGetMultiMeterMeta(SSqlObj* pSql, char* meterIdList, int32_t len, int32_t numOfMeters);
+bool tscIsMissingMeter(char* meterId);
+void tscRemoveMissingMeter(char* meterId);
 
 void tscResetForNextRetrieve(SSqlRes* pRes);
 
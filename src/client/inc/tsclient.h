@@ -355,6 +355,7 @@ typedef struct _tsc_obj {
   char             sversion[TSDB_VERSION_LEN];
   char             writeAuth : 1;
   char             superAuth : 1;
+  int16_t          queryParallelism;  // workers requested in each vnode for the super table queries
   struct _sql_obj *pSql;
   struct _sql_obj *pHb;
   struct _sql_obj *sqlList;
@@ -362,6 +363,22 @@ typedef struct _tsc_obj {
   pthread_mutex_t  mutex;
 } STscObj;
 
+/*
+ * typed rows of one table, written into the submit block directly instead of being formatted into sql text and
+ * parsed back. values are numOfRows * numOfColumns variants in the column order of the table, the first one of a row
+ * is the timestamp. If stable is not empty, the table is created from it with the tag values on demand.
+ */
+typedef struct SInsertRows {
+  char      table[TSDB_METER_ID_LEN];   // [db.]table
+  char      stable[TSDB_METER_ID_LEN];  // [db.]stable
+  bool      import;
+  int32_t   numOfTags;
+  tVariant *tags;
+  int32_t   numOfColumns;
+  int32_t   numOfRows;
+  tVariant *values;
+} SInsertRows;
+
 typedef struct _sql_obj {
   void *   signature;
   STscObj *pTscObj;
@@ -375,6 +392,7 @@ typedef struct _sql_obj {
   void *   thandle;
   void *   pStream;
   char *   sqlstr;
+  SInsertRows *pInsertRows;  // rows of taos_insert_rows_a, owned by the caller until the callback
   char     retry;
   char     maxRetry;
   char     index;
@@ -412,6 +430,15 @@ typedef struct _sstream {
   int16_t precision;
   void *  pTimer;
 
+  /*
+   * if it is larger than 0, each window is merged from results of numOfPanes panes of the sliding time, and only the
+   * newest pane is queried in each computing
+   */
+  int32_t numOfPanes;
+  int32_t paneSize;
+  int64_t paneEnd;  // results of panes before this timestamp are kept in pPanes
+  char *  pPanes;
+
   void (*fp)();
   void *param;
 
@@ -427,6 +454,13 @@ typedef struct {
 
 // tscSql API
 int tsParseSql(SSqlObj *pSql, char *acct, char *db, bool multiVnodeInsertion);
+int tsParseInsertRows(SSqlObj *pSql, SInsertRows *pRows);
+
+/**
+ * write typed rows without sql, used by the http handlers. pRows shall be kept until fp is called, fp gets the
+ * number of affected rows or the negative error code as taos_query_a does
+ */
+void taos_insert_rows_a(TAOS *taos, SInsertRows *pRows, void (*fp)(void *, TAOS_RES *, int), void *param);
 
 void  tscInitMsgs();
 void *tscProcessMsgFromServer(char *msg, void *ahandle, void *thandle);
@@ -489,11 +523,15 @@ bool tscIsUpdateQuery(STscObj *pObj);
 // transfer SSqlInfo to SqlCmd struct
 int32_t tscToSQLCmd(SSqlObj *pSql, struct SSqlInfo *pInfo);
 
+// time range, in microsecond, of the condition "primary timestamp optr pRight"
+int32_t getTimeRange(int64_t *stime, int64_t *etime, tSQLExpr *pRight, int32_t optr, int16_t timePrecision);
+
 void tscQueueAsyncFreeResult(SSqlObj *pSql);
 
 extern void *     pVnodeConn;
 extern void *     pTscMgmtConn;
 extern void *     tscCacheHandle;
+extern void *     tscMissCacheHandle;
 extern uint8_t    globalCode;
 extern int        slaveIndex;
 extern void *     tscTmr;
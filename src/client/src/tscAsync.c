@@ -109,6 +109,67 @@ void taos_query_a(TAOS *taos, const char *sqlstr, void (*fp)(void *, TAOS_RES *,
   tscDoQuery(pSql);
 }
 
+void taos_insert_rows_a(TAOS *taos, SInsertRows *pRows, void (*fp)(void *, TAOS_RES *, int), void *param) {
+  STscObj *pObj = (STscObj *)taos;
+  if (pObj == NULL || pObj->signature != pObj) {
+    tscError("bug!!! pObj:%p", pObj);
+    globalCode = TSDB_CODE_DISCONNECTED;
+    tscQueueAsyncError(fp, param);
+    return;
+  }
+
+  SSqlObj *pSql = (SSqlObj *)calloc(1, sizeof(SSqlObj));
+  if (pSql == NULL) {
+    tscError("failed to malloc sqlObj");
+    tscQueueAsyncError(fp, param);
+    return;
+  }
+
+  SSqlCmd *pCmd = &pSql->cmd;
+  SSqlRes *pRes = &pSql->res;
+
+  pSql->signature = pSql;
+  pSql->pTscObj = pObj;
+  pSql->fp = fp;
+  pSql->param = param;
+  pSql->pInsertRows = pRows;
+
+  if (TSDB_CODE_SUCCESS != tscAllocPayload(pCmd, TSDB_DEFAULT_PAYLOAD_SIZE)) {
+    tscError("failed to malloc payload");
+    tfree(pSql);
+    tscQueueAsyncError(fp, param);
+    return;
+  }
+
+  // sqlstr is duplicated by sub-queries and shown in query list, describe the insertion instead of the values
+  int32_t sqlLen = strlen(pRows->table) + 16;
+  if ((pSql->sqlstr = malloc(sqlLen)) == NULL) {
+    tscError("%p failed to malloc sql string buffer", pSql);
+    tfree(pCmd->payload);
+    tfree(pSql);
+    tscQueueAsyncError(fp, param);
+    return;
+  }
+  snprintf(pSql->sqlstr, sqlLen, "%s into %s", pRows->import ? "import" : "insert", pRows->table);
+
+  pRes->qhandle = 0;
+  pRes->numOfRows = 1;
+
+  tscTrace("%p Async insert rows, table:%s, stable:%s, rows:%d, pObj:%p", pSql, pRows->table, pRows->stable,
+           pRows->numOfRows, pObj);
+
+  int32_t code = tsParseSql(pSql, pObj->acctId, pObj->db, true);
+  if (code == TSDB_CODE_ACTION_IN_PROGRESS) return;
+
+  if (code != TSDB_CODE_SUCCESS) {
+    pSql->res.code = (uint8_t)code;
+    tscQueueAsyncRes(pSql);
+    return;
+  }
+
+  tscDoQuery(pSql);
+}
+
 static void tscProcessAsyncFetchRowsProxy(void *param, TAOS_RES *tres, int numOfRows) {
   if (tres == NULL) {
     return;
@@ -398,40 +459,25 @@ void tscQueueAsyncFreeResult(SSqlObj *pSql) {
   taosScheduleTask(tscQhandle, &schedMsg);
 }
 
+/*
+ * the insertion with only one data block is sent by pSql itself. Data blocks of multiple vnodes are sent
+ * concurrently by submit objects, and the user function is called in tscProcessAsyncRes once all vnodes respond.
+ */
 void tscAsyncInsertMultiVnodesProxy(void *param, TAOS_RES *tres, int numOfRows) {
   SSqlObj *pSql = (SSqlObj *)param;
   SSqlCmd *pCmd = &pSql->cmd;
-  int32_t  code = TSDB_CODE_SUCCESS;
 
   assert(!pCmd->isInsertFromFile && pSql->signature == pSql);
 
-  SDataBlockList *pDataBlocks = pCmd->pDataBlocks;
-  if (pDataBlocks == NULL || pCmd->vnodeIdx >= pDataBlocks->nSize) {
-    // restore user defined fp
-    pSql->fp = pSql->fetchFp;
-    tscTrace("%p Async insertion completed, destroy data block list", pSql);
+  // restore user defined fp
+  pSql->fp = pSql->fetchFp;
+  tscTrace("%p Async insertion completed, destroy data block list", pSql);
 
-    // release data block data
-    pCmd->pDataBlocks = tscDestroyBlockArrayList(pCmd->pDataBlocks);
+  // release data block data
+  pCmd->pDataBlocks = tscDestroyBlockArrayList(pCmd->pDataBlocks);
 
-    // all data has been sent to vnode, call user function
-    (*pSql->fp)(pSql->param, tres, numOfRows);
-  } else {
-    do {
-      code = tscCopyDataBlockToPayload(pSql, pDataBlocks->pData[pCmd->vnodeIdx++]);
-      if (code != TSDB_CODE_SUCCESS) {
-        tscTrace("%p prepare submit data block failed in async insertion, vnodeIdx:%d, total:%d, code:%d",
-                 pSql, pCmd->vnodeIdx - 1, pDataBlocks->nSize, code);
-      }
-
-    } while (code != TSDB_CODE_SUCCESS && pCmd->vnodeIdx < pDataBlocks->nSize);
-
-    // build submit msg may fail
-    if (code == TSDB_CODE_SUCCESS) {
-      tscTrace("%p async insertion, vnodeIdx:%d, total:%d", pSql, pCmd->vnodeIdx - 1, pDataBlocks->nSize);
-      tscProcessSql(pSql);
-    }
-  }
+  // all data has been sent to vnode, call user function
+  (*pSql->fp)(pSql->param, tres, numOfRows);
 }
 
 int tscSendMsgToServer(SSqlObj *pSql);
@@ -502,6 +548,24 @@ void tscMeterMetaCallBack(void *param, TAOS_RES *res, int code) {
       pRes->code = code;
 
       if (code == TSDB_CODE_ACTION_IN_PROGRESS) return;
+    } else if (pCmd->command == TSDB_SQL_INSERT && (pCmd->type & TSDB_QUERY_TYPE_SUBQUERY) != 0) {
+      // submit object of multi-vnode insertion, send the submit msg again with the renewed meter meta
+      tscTrace("%p renew meterMeta for submit successfully, retry:%d", pSql, pSql->retry);
+
+      code = tscGetMeterMeta(pSql, tscGetMeterMetaInfo(pCmd, 0)->name, 0);
+      pRes->code = code;
+
+      if (code == TSDB_CODE_ACTION_IN_PROGRESS) return;
+
+      if (code == TSDB_CODE_SUCCESS) {
+        code = tscSendMsgToServer(pSql);
+        if (code == TSDB_CODE_SUCCESS) return;
+
+        pRes->code = code;
+      }
+
+      tscQueueAsyncRes(pSql);
+      return;
     } else {  // normal async query continues
       code = tsParseSql(pSql, pObj->acctId, pObj->db, false);
       if (code == TSDB_CODE_ACTION_IN_PROGRESS) return;
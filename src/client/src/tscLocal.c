@@ -23,6 +23,7 @@
 
 #include "textbuffer.h"
 #include "tscSecondaryMerge.h"
+#include "tscSqlCache.h"
 #include "tschemautil.h"
 #include "tsocket.h"
 
@@ -469,6 +470,8 @@ int tscProcessLocalCmd(SSqlObj *pSql) {
     pSql->res.numOfRows = 0;
   } else if (pCmd->command == TSDB_SQL_RESET_CACHE) {
     taosClearDataCache(tscCacheHandle);
+    taosClearDataCache(tscMissCacheHandle);
+    tscClearSqlCache();
   } else if (pCmd->command == TSDB_SQL_SERV_VERSION) {
     tscProcessServerVer(pSql);
   } else if (pCmd->command == TSDB_SQL_CLI_VERSION) {
@@ -23,7 +23,11 @@
 
 #include "os.h"
 #include "ihash.h"
+#include "shash.h"
+#include "tcache.h"
+#include "tglobalcfg.h"
 #include "tscSecondaryMerge.h"
+#include "tscSqlCache.h"
 #include "tscUtil.h"
 #include "tschemautil.h"
 #include "tsclient.h"
@@ -48,7 +52,152 @@ enum {
 static void setErrMsg(char *msg, const char *sql);
 static int32_t tscAllocateMemIfNeed(STableDataBlocks *pDataBlock, int32_t rowSize);
 
+// check and convert 8 digits loaded from the string in one word, little endian is assumed
+static FORCE_INLINE bool tscIsEightDigits(uint64_t v) {
+  return ((v & 0xF0F0F0F0F0F0F0F0ULL) | (((v + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ==
+         0x3333333333333333ULL;
+}
+
+static FORCE_INLINE uint32_t tscEightDigitsToInt(uint64_t v) {
+  v -= 0x3030303030303030ULL;
+  v = (v * 10 + (v >> 8)) & 0x00FF00FF00FF00FFULL;
+  v = (v * 100 + (v >> 16)) & 0x0000FFFF0000FFFFULL;
+  return (uint32_t)((v * 10000 + (v >> 32)) & 0xFFFFFFFF);
+}
+
+/*
+ * accumulate the decimal digits at the beginning of z into *value
+ *
+ * @return number of digits
+ */
+static FORCE_INLINE int32_t tscScanDigits(const char *z, int32_t n, uint64_t *value) {
+  int32_t  i = 0;
+  uint64_t v = *value;
+
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  while (i + 8 <= n) {
+    uint64_t word;
+    memcpy(&word, z + i, sizeof(word));
+    if (!tscIsEightDigits(word)) {
+      break;
+    }
+
+    v = v * 100000000 + tscEightDigitsToInt(word);
+    i += 8;
+  }
+#endif
+
+  for (; i < n && z[i] >= '0' && z[i] <= '9'; ++i) {
+    v = v * 10 + (z[i] - '0');
+  }
+
+  *value = v;
+  return i;
+}
+
+/*
+ * [+|-]digits of a TK_INTEGER token, without the check of isValidNumber and strtoll. Integers with more than
+ * 18 digits are left to strtoll, which reports the overflow.
+ *
+ * @return false if the token can not be handled here
+ */
+static bool tscFastToInteger(const char *z, int32_t n, int64_t *value) {
+  int32_t i = (n > 0 && (z[0] == '-' || z[0] == '+')) ? 1 : 0;
+  if (n - i <= 0 || n - i > 18) {
+    return false;
+  }
+
+  uint64_t v = 0;
+  if (tscScanDigits(z + i, n - i, &v) != n - i) {
+    return false;
+  }
+
+  *value = (z[0] == '-') ? -(int64_t)v : (int64_t)v;
+  return true;
+}
+
+/*
+ * [+|-]digits[.digits][e[+|-]digits] with at most 19 significant digits and a small exponent. The mantissa and
+ * the power of 10 are both exactly represented in double, so the quotient or product is correctly rounded and
+ * identical to the result of strtod.
+ *
+ * @return false if the token can not be handled here
+ */
+static bool tscFastToDouble(const char *z, int32_t n, double *value) {
+  static const double powerOf10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                     1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+  int32_t i = (n > 0 && (z[0] == '-' || z[0] == '+')) ? 1 : 0;
+
+  // leading zeros are not significant digits
+  int32_t start = i;
+  while (i < n && z[i] == '0') {
+    ++i;
+  }
+
+  uint64_t mantissa = 0;
+  int32_t  numOfInt = tscScanDigits(z + i, n - i, &mantissa);
+  int32_t  numOfSig = numOfInt;
+  int32_t  exp = 0;
+  bool     hasDigits = (i + numOfInt > start);
+
+  i += numOfInt;
+  if (i < n && z[i] == '.') {
+    i += 1;
+
+    if (mantissa == 0) {
+      int32_t zeros = i;
+      while (i < n && z[i] == '0') {
+        ++i;
+      }
+
+      exp -= (i - zeros);
+      hasDigits |= (i > zeros);
+    }
+
+    int32_t numOfFrac = tscScanDigits(z + i, MIN(n - i, 19), &mantissa);
+    numOfSig += numOfFrac;
+    exp -= numOfFrac;
+    hasDigits |= (numOfFrac > 0);
+    i += numOfFrac;
+  }
+
+  if (!hasDigits || numOfSig > 19) {
+    return false;
+  }
+
+  if (i < n && (z[i] == 'e' || z[i] == 'E')) {
+    i += 1;
+
+    bool negExp = (i < n && z[i] == '-');
+    if (i < n && (z[i] == '-' || z[i] == '+')) {
+      i += 1;
+    }
+
+    uint64_t e = 0;
+    int32_t  numOfExp = tscScanDigits(z + i, MIN(n - i, 4), &e);
+    if (numOfExp == 0) {
+      return false;
+    }
+
+    exp += negExp ? -(int32_t)e : (int32_t)e;
+    i += numOfExp;
+  }
+
+  if (i != n || mantissa > (1ULL << 53) || exp > 22 || exp < -22) {
+    return false;
+  }
+
+  double dv = (exp >= 0) ? (double)mantissa * powerOf10[exp] : (double)mantissa / powerOf10[-exp];
+  *value = (z[0] == '-') ? -dv : dv;
+  return true;
+}
+
 static int32_t tscToInteger(SSQLToken *pToken, int64_t *value, char **endPtr) {
+  if (pToken->type == TK_INTEGER && tscFastToInteger(pToken->z, pToken->n, value)) {
+    return TK_INTEGER;
+  }
+
   int32_t numType = isValidNumber(pToken);
   if (TK_ILLEGAL == numType) {
     return numType;
@@ -69,6 +218,10 @@ static int32_t tscToInteger(SSQLToken *pToken, int64_t *value, char **endPtr) {
 }
 
 static int32_t tscToDouble(SSQLToken *pToken, double *value, char **endPtr) {
+  if ((pToken->type == TK_INTEGER || pToken->type == TK_FLOAT) && tscFastToDouble(pToken->z, pToken->n, value)) {
+    return pToken->type;
+  }
+
   int32_t numType = isValidNumber(pToken);
   if (TK_ILLEGAL == numType) {
     return numType;
@@ -93,7 +246,9 @@ int tsParseTime(SSQLToken *pToken, int64_t *time, char **next, char *error, int1
   } else if (strncmp(pToken->z, "0", 1) == 0 && pToken->n == 1) {
     // do nothing
   } else if (pToken->type == TK_INTEGER) {
-    useconds = str2int64(pToken->z);
+    if (!tscFastToInteger(pToken->z, pToken->n, &useconds)) {
+      useconds = str2int64(pToken->z);
+    }
   } else {
     // strptime("2001-11-12 18:31:01", "%Y-%m-%d %H:%M:%S", &tm);
     if (taosParseTime(pToken->z, time, pToken->n, timePrec) != TSDB_CODE_SUCCESS) {
@@ -835,6 +990,137 @@ int validateTableName(char *tblName, int len) {
   return tscValidateName(&token);
 }
 
+static bool tscIsUnknownMeter(char *meterId) {
+  SMeterMeta *pMeterMeta = taosGetDataFromCache(tscCacheHandle, meterId);
+  if (pMeterMeta != NULL) {
+    taosRemoveDataFromCache(tscCacheHandle, (void **)&pMeterMeta, false);
+    return false;
+  }
+
+  return !tscIsMissingMeter(meterId);
+}
+
+/*
+ * skip the content of parentheses without tokenizing it, str points to the character next to the left parenthesis.
+ * Parentheses in quoted strings are ignored, and a doubled quote inside a string simply closes and reopens it.
+ */
+static char *tscSkipParentheses(char *str) {
+  int32_t depth = 1;
+  char    delim = 0;
+
+  for (; *str != 0; ++str) {
+    if (delim != 0) {
+      if (*str == delim) delim = 0;
+    } else if (*str == '\'' || *str == '"') {
+      delim = *str;
+    } else if (*str == '(') {
+      depth++;
+    } else if (*str == ')' && --depth == 0) {
+      return str + 1;
+    }
+  }
+
+  return str;
+}
+
+/*
+ * Collect the meters from str on, as well as the super tables in using clause, that are not in meter meta cache and
+ * load their meter metas from mgmt in one batch, instead of one request for each meter during parsing the insert
+ * statement. Nothing is loaded if less than two meters are unknown, since it does not save any round trip. Any syntax
+ * error is left to the parser, the scan stops quietly. The name of the first meter meta info is overwritten.
+ */
+static int32_t tscPrefetchMeterMeta(SSqlObj *pSql, char *str) {
+  SMeterMetaInfo *pMeterMetaInfo = tscGetMeterMetaInfo(&pSql->cmd, 0);
+
+  void *  pNameList = NULL;
+  char *  pList = NULL;
+  int32_t len = 0;
+  int32_t allocSize = 0;
+  int32_t numOfMeters = 0;
+
+  bool expectMeter = true;
+  bool inValues = false;
+
+  while (numOfMeters < TSDB_MULTI_METERMETA_MAX_NUM) {
+    int32_t   index = 0;
+    SSQLToken sToken = tStrGetToken(str, &index, false, 0, NULL);
+    str += index;
+    if (sToken.n == 0) {
+      break;
+    }
+
+    if (inValues && sToken.type != TK_LP) {  // values of previous meter are over
+      inValues = false;
+      expectMeter = true;
+    }
+
+    if (!expectMeter) {
+      if (sToken.type == TK_USING) {
+        index = 0;
+        sToken = tStrGetToken(str, &index, false, 0, NULL);
+        str += index;
+      } else if (sToken.type == TK_FILE) {
+        index = 0;
+        tStrGetToken(str, &index, false, 0, NULL);
+        str += index;
+        expectMeter = true;
+        continue;
+      } else {
+        if (sToken.type == TK_VALUES) {
+          inValues = true;
+        } else if (sToken.type == TK_LP) {  // skip the column list, tag values or values of one row
+          str = tscSkipParentheses(str);
+        }
+
+        continue;
+      }
+    }
+
+    expectMeter = false;
+    if (validateTableName(sToken.z, sToken.n) != TSDB_CODE_SUCCESS ||
+        setMeterID(pSql, &sToken, 0) != TSDB_CODE_SUCCESS) {
+      break;
+    }
+
+    if (!tscIsUnknownMeter(pMeterMetaInfo->name)) {
+      continue;
+    }
+
+    if (pNameList == NULL) {
+      pNameList = taosInitStrHash(256, sizeof(int8_t), taosHashStringStep1);
+    } else if (taosGetStrHashData(pNameList, pMeterMetaInfo->name) != NULL) {
+      continue;
+    }
+
+    int8_t dummy = 1;
+    taosAddStrHash(pNameList, pMeterMetaInfo->name, (char *)&dummy);
+
+    int32_t nameLen = (int32_t)strlen(pMeterMetaInfo->name);
+    if (len + nameLen + 2 > allocSize) {
+      allocSize = (allocSize == 0) ? TSDB_DEFAULT_PAYLOAD_SIZE : allocSize << 1;
+      char *tmp = realloc(pList, allocSize);
+      if (tmp == NULL) {
+        break;
+      }
+
+      pList = tmp;
+    }
+
+    len += sprintf(pList + len, "%s,", pMeterMetaInfo->name);
+    numOfMeters++;
+  }
+
+  int32_t code = TSDB_CODE_SUCCESS;
+  if (numOfMeters > 1) {
+    code = tscGetMultiMeterMeta(pSql, pList, len, numOfMeters);
+  }
+
+  taosCleanUpStrHash(pNameList);
+  tfree(pList);
+
+  return code;
+}
+
 /**
  * usage: insert into table1 values() () table2 values()()
  *
@@ -863,6 +1149,7 @@ int tsParseInsertStatement(SSqlObj *pSql, char *str, char *acct, char *db) {
   }
 
   void *pTableHashList = taosInitIntHash(128, sizeof(void *), taosHashInt);
+  bool  prefetched = false;
 
   pSql->cmd.pDataBlocks = tscCreateBlockArrayList();
   tscTrace("%p create data block list for submit data, %p", pSql, pSql->cmd.pDataBlocks);
@@ -895,6 +1182,25 @@ int tsParseInsertStatement(SSqlObj *pSql, char *str, char *acct, char *db) {
     }
 
     void *fp = pSql->fp;
+
+    /*
+     * load the meter metas of the rest meters in one batch on the first cache miss, the statement is parsed again
+     * in tscMeterMetaCallBack after they are loaded for async insertion.
+     */
+    if (!prefetched && tscIsUnknownMeter(pMeterMetaInfo->name)) {
+      prefetched = true;
+
+      if ((code = tscPrefetchMeterMeta(pSql, sToken.z)) != TSDB_CODE_SUCCESS) {
+        if (fp != NULL) {
+          goto _clean;
+        } else {
+          goto _error_clean;
+        }
+      }
+
+      setMeterID(pSql, &sToken, 0);
+    }
+
     if ((code = tscParseSqlForCreateTableOnDemand(&str, pSql)) != TSDB_CODE_SUCCESS) {
       if (fp != NULL) {
         goto _clean;
@@ -1141,6 +1447,210 @@ int tsParseInsertSql(SSqlObj *pSql, char *sql, char *acct, char *db) {
   return tsParseInsertStatement(pSql, sql + index, acct, db);
 }
 
+static int32_t tscDumpInsertValue(tVariant *pVar, SSchema *pSchema, char *payload, char *msg) {
+  if (pVar->nType == TSDB_DATA_TYPE_NULL) {
+    setNull(payload, pSchema->type, pSchema->bytes);
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (pSchema->type != TSDB_DATA_TYPE_BINARY && pSchema->type != TSDB_DATA_TYPE_NCHAR) {
+    if (tVariantDump(pVar, payload, pSchema->type) != 0) {
+      INVALID_SQL_RET_MSG(msg, "invalid value of column:%s", pSchema->name);
+    }
+    return TSDB_CODE_SUCCESS;
+  }
+
+  // numbers are written into binary/nchar columns as the sql text would be
+  char    buf[64];
+  char   *pz = pVar->pz;
+  int32_t len = pVar->nLen;
+  if (pVar->nType == TSDB_DATA_TYPE_DOUBLE || pVar->nType == TSDB_DATA_TYPE_FLOAT) {
+    len = snprintf(buf, sizeof(buf), "%lf", pVar->dKey);
+    pz = buf;
+  } else if (pVar->nType != TSDB_DATA_TYPE_BINARY) {
+    len = snprintf(buf, sizeof(buf), "%ld", pVar->i64Key);
+    pz = buf;
+  }
+
+  if (pSchema->type == TSDB_DATA_TYPE_BINARY) {
+    if (len > pSchema->bytes) {
+      INVALID_SQL_RET_MSG(msg, "string data overflow, column:%s", pSchema->name);
+    }
+    memset(payload, 0, pSchema->bytes);
+    memcpy(payload, pz, len);
+  } else {
+    memset(payload, 0, pSchema->bytes);
+    if (!taosMbsToUcs4(pz, len, payload, pSchema->bytes)) {
+      INVALID_SQL_RET_MSG(msg, "string data overflow, column:%s", pSchema->name);
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t tscSetInsertRowsMeterId(SSqlObj *pSql, const char *name) {
+  char buf[TSDB_METER_ID_LEN] = {0};
+  strtolower(buf, name);
+
+  SSQLToken token = {.n = (uint32_t)strlen(buf), .type = TK_ID, .z = buf};
+  if (tscValidateName(&token) != TSDB_CODE_SUCCESS) {
+    strcpy(pSql->cmd.payload, "table name is invalid");
+    return TSDB_CODE_INVALID_SQL;
+  }
+
+  return setMeterID(pSql, &token, 0);
+}
+
+/**
+ * counterpart of tsParseInsertSql for the rows given as typed values, invoked again by the meter meta callback
+ * like the sql parser when the meta of the (super) table is not cached yet
+ */
+int tsParseInsertRows(SSqlObj *pSql, SInsertRows *pRows) {
+  SSqlCmd *pCmd = &pSql->cmd;
+  int32_t  code = TSDB_CODE_SUCCESS;
+
+  if (!pSql->pTscObj->writeAuth) {
+    return TSDB_CODE_NO_RIGHTS;
+  }
+
+  pCmd->command = TSDB_SQL_INSERT;
+  pCmd->isInsertFromFile = 0;
+  pCmd->count = 0;
+  if (pRows->import) {
+    pCmd->order.order = TSQL_SO_ASC;
+  }
+
+  pSql->res.numOfRows = 0;
+
+  SMeterMetaInfo *pMeterMetaInfo = tscAddEmptyMeterMetaInfo(pCmd);
+  if ((code = tscAllocPayload(pCmd, TSDB_PAYLOAD_SIZE)) != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  if (pRows->numOfRows <= 0 || pRows->numOfColumns <= 0 || pRows->values == NULL) {
+    INVALID_SQL_RET_MSG(pCmd->payload, "no any data points");
+  }
+
+  if (pRows->stable[0] != 0) {
+    STagData *pTag = (STagData *)pCmd->payload;
+    memset(pTag, 0, sizeof(STagData));
+
+    if ((code = tscSetInsertRowsMeterId(pSql, pRows->stable)) != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+
+    strncpy(pTag->name, pMeterMetaInfo->name, TSDB_METER_ID_LEN);
+    code = tscGetMeterMeta(pSql, pTag->name, 0);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+
+    if (!UTIL_METER_IS_METRIC(pMeterMetaInfo)) {
+      INVALID_SQL_RET_MSG(pCmd->payload, "create table only from super table is allowed");
+    }
+
+    SMeterMeta *pMetricMeta = pMeterMetaInfo->pMeterMeta;
+    if (pRows->numOfTags != pMetricMeta->numOfTags) {
+      INVALID_SQL_RET_MSG(pCmd->payload, "number of tags mismatch, expect:%d", pMetricMeta->numOfTags);
+    }
+
+    // the tag values are kept in the payload for the create table message, the error message overwrites them
+    char     tagVal[TSDB_MAX_TAGS_LEN] = {0};
+    char    *pVal = tagVal;
+    SSchema *pTagSchema = tsGetTagSchema(pMetricMeta);
+    for (int32_t i = 0; i < pRows->numOfTags; ++i) {
+      if ((code = tscDumpInsertValue(pRows->tags + i, pTagSchema + i, pVal, pCmd->payload)) != TSDB_CODE_SUCCESS) {
+        return code;
+      }
+      pVal += pTagSchema[i].bytes;
+    }
+    memcpy(pTag->data, tagVal, pVal - tagVal);
+
+    if ((code = tscSetInsertRowsMeterId(pSql, pRows->table)) != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+
+    code = tscGetMeterMetaEx(pSql, pMeterMetaInfo->name, true);
+  } else {
+    if ((code = tscSetInsertRowsMeterId(pSql, pRows->table)) != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+
+    code = tscGetMeterMeta(pSql, pMeterMetaInfo->name, 0);
+  }
+
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  SMeterMeta *pMeterMeta = pMeterMetaInfo->pMeterMeta;
+  if (UTIL_METER_IS_METRIC(pMeterMetaInfo)) {
+    INVALID_SQL_RET_MSG(pCmd->payload, "insert data into metric is not supported");
+  }
+
+  if (pRows->numOfColumns != pMeterMeta->numOfColumns) {
+    INVALID_SQL_RET_MSG(pCmd->payload, "number of columns mismatch, expect:%d", pMeterMeta->numOfColumns);
+  }
+
+  pCmd->pDataBlocks = tscCreateBlockArrayList();
+
+  STableDataBlocks *dataBuf = tscCreateDataBlockEx(TSDB_DEFAULT_PAYLOAD_SIZE, pMeterMeta->rowSize,
+                                                   sizeof(SShellSubmitBlock), pMeterMetaInfo->name);
+  tscAppendDataBlock(pCmd->pDataBlocks, dataBuf);
+
+  SSchema *pSchema = tsGetSchema(pMeterMeta);
+  int32_t  maxRows = 0;
+  for (int32_t i = 0; i < pRows->numOfRows; ++i) {
+    if (i >= maxRows || dataBuf->size + pMeterMeta->rowSize >= dataBuf->nAllocSize) {
+      int32_t tSize = tscAllocateMemIfNeed(dataBuf, pMeterMeta->rowSize);
+      if (0 == tSize) {
+        code = TSDB_CODE_CLI_OUT_OF_MEMORY;
+        goto _error_clean;
+      }
+      maxRows = i + tSize;
+    }
+
+    tVariant *pVal = pRows->values + i * pRows->numOfColumns;
+    char *    payload = dataBuf->pData + dataBuf->size;
+    for (int32_t j = 0; j < pMeterMeta->numOfColumns; ++j) {
+      if ((code = tscDumpInsertValue(pVal + j, pSchema + j, payload, pCmd->payload)) != TSDB_CODE_SUCCESS) {
+        goto _error_clean;
+      }
+
+      if (j == PRIMARYKEY_TIMESTAMP_COL_INDEX && tsCheckTimestamp(dataBuf, payload) != TSDB_CODE_SUCCESS) {
+        code = TSDB_CODE_INVALID_SQL;
+        strcpy(pCmd->payload, "client time/server time can not be mixed up");
+        goto _error_clean;
+      }
+
+      payload += pSchema[j].bytes;
+    }
+
+    dataBuf->size += pMeterMeta->rowSize;
+  }
+
+  SShellSubmitBlock *pBlocks = (SShellSubmitBlock *)(dataBuf->pData);
+  tsSetBlockInfo(pBlocks, pMeterMeta, pRows->numOfRows);
+
+  dataBuf->vgid = pMeterMeta->vgid;
+  dataBuf->numOfMeters = 1;
+
+  if ((code = tscMergeTableDataBlocks(pSql, pCmd->pDataBlocks)) != TSDB_CODE_SUCCESS) {
+    goto _error_clean;
+  }
+
+  if ((code = tscCopyDataBlockToPayload(pSql, pCmd->pDataBlocks->pData[0])) != TSDB_CODE_SUCCESS) {
+    goto _error_clean;
+  }
+
+  pCmd->vnodeIdx = 1;
+  return TSDB_CODE_SUCCESS;
+
+_error_clean:
+  pCmd->pDataBlocks = tscDestroyBlockArrayList(pCmd->pDataBlocks);
+  return code;
+}
+
 int tsParseSql(SSqlObj *pSql, char *acct, char *db, bool multiVnodeInsertion) {
   int32_t ret = TSDB_CODE_SUCCESS;
 
@@ -1148,7 +1658,7 @@ int tsParseSql(SSqlObj *pSql, char *acct, char *db, bool multiVnodeInsertion) {
   tscRemoveAllMeterMetaInfo(&pSql->cmd, false);
   tscCleanSqlCmd(&pSql->cmd);
 
-  if (tscIsInsertOrImportData(pSql->sqlstr)) {
+  if (pSql->pInsertRows != NULL || tscIsInsertOrImportData(pSql->sqlstr)) {
     /*
      * only for async multi-vnode insertion
      * Set the fp before parse the sql string, in case of getmetermeta failed, in which
@@ -1162,16 +1672,35 @@ int tsParseSql(SSqlObj *pSql, char *acct, char *db, bool multiVnodeInsertion) {
       pSql->fp = tscAsyncInsertMultiVnodesProxy;
     }
 
-    ret = tsParseInsertSql(pSql, pSql->sqlstr, acct, db);
+    if (pSql->pInsertRows != NULL) {
+      ret = tsParseInsertRows(pSql, pSql->pInsertRows);
+    } else {
+      ret = tsParseInsertSql(pSql, pSql->sqlstr, acct, db);
+    }
   } else {
     ret = tscAllocPayload(&pSql->cmd, TSDB_DEFAULT_PAYLOAD_SIZE);
     if (TSDB_CODE_SUCCESS != ret) return ret;
-    
+
+    // the plan of a repeated select statement is retrieved from cache, only the literals are bound again
+    struct SSqlStmtKey *pKey = tscBuildSqlStmtKey(pSql, acct, db);
+    if (tscGetSqlCmdFromCache(pSql, pKey, &ret)) {
+      tscFreeSqlStmtKey(pKey);
+      return ret;
+    }
+
+    int64_t st = taosGetTimestampUs();
+
     SSqlInfo SQLInfo = {0};
     tSQLParse(&SQLInfo, pSql->sqlstr);
 
     ret = tscToSQLCmd(pSql, &SQLInfo);
     SQLInfoDestroy(&SQLInfo);
+
+    if (ret == TSDB_CODE_SUCCESS) {
+      tscAddSqlCmdIntoCache(pSql, pKey, taosGetTimestampUs() - st);
+    }
+
+    tscFreeSqlStmtKey(pKey);
   }
 
   /*
@@ -1292,52 +1821,192 @@ static int tscInsertDataFromFile(SSqlObj *pSql, FILE *fp) {
   return numOfRows;
 }
 
-/* multi-vnodes insertion in sync query model
+static void tscInsertSubqueryCallback(void *param, TAOS_RES *tres, int numOfRows);
+
+static SSqlObj *tscCreateSqlObjForInsert(SSqlObj *pSql, SInsertSupporter *pSupporter, STableDataBlocks *pDataBlock,
+                                         int32_t vnodeIdx) {
+  SSqlObj *pNew = (SSqlObj *)calloc(1, sizeof(SSqlObj));
+  if (pNew == NULL) {
+    tscError("%p failed to allocate submit object, vnodeIdx:%d", pSql, vnodeIdx);
+    return NULL;
+  }
+
+  pNew->signature = pNew;
+  pNew->pTscObj = pSql->pTscObj;
+  if (pSql->sqlstr != NULL) {
+    pNew->sqlstr = strdup(pSql->sqlstr);
+  }
+
+  SSqlCmd *pCmd = &pNew->cmd;
+  pCmd->command = TSDB_SQL_INSERT;
+  pCmd->type = TSDB_QUERY_TYPE_SUBQUERY;
+  pCmd->order = pSql->cmd.order;
+  pCmd->vnodeIdx = vnodeIdx;
+
+  /*
+   * the meter meta is retrieved before the callback function is set, so it is loaded from mnode in the current
+   * thread in case of cache missing, instead of reparsing the sql string in tscMeterMetaCallBack.
+   */
+  int32_t code = tscAllocPayload(pCmd, TSDB_DEFAULT_PAYLOAD_SIZE);
+  if (code == TSDB_CODE_SUCCESS && tscAddEmptyMeterMetaInfo(pCmd) == NULL) {
+    code = TSDB_CODE_CLI_OUT_OF_MEMORY;
+  }
+
+  if (code == TSDB_CODE_SUCCESS) {
+    code = tscCopyDataBlockToPayload(pNew, pDataBlock);
+  }
+
+  if (code != TSDB_CODE_SUCCESS) {
+    tscError("%p build submit data block failed, vnodeIdx:%d, code:%d", pSql, vnodeIdx, code);
+    atomic_val_compare_exchange_32(&pSupporter->code, TSDB_CODE_SUCCESS, code);
+
+    tscFreeSqlObj(pNew);
+    return NULL;
+  }
+
+  // the submit object is freed automatically after the callback function returns, see tscShouldFreeAsyncSqlObj
+  pNew->fp = tscInsertSubqueryCallback;
+  pNew->fetchFp = tscInsertSubqueryCallback;
+  pNew->param = pSupporter;
+
+  tscTrace("%p new submit object:%p, vnodeIdx:%d, meterId:%s, numOfMeters:%d", pSql, pNew, vnodeIdx,
+           pDataBlock->meterId, pDataBlock->numOfMeters);
+  return pNew;
+}
+
+/*
+ * all submits are completed, set the affected rows and the first error code of vnodes to the parent object, and
+ * wake up the invoker in sync model or call the user defined function in async model.
+ */
+static void tscInsertSubqueryCompleted(SInsertSupporter *pSupporter) {
+  SSqlObj *pSql = pSupporter->pObj;
+  SSqlRes *pRes = &pSql->res;
+
+  pRes->numOfRows = pSupporter->numOfRows;
+  pRes->code = (uint8_t)pSupporter->code;
+
+  tscTrace("%p multi-vnode insertion completed, vnodes:%d, inserted rows:%d, code:%d", pSql, pSupporter->numOfTotal,
+           pRes->numOfRows, pRes->code);
+
+  tfree(pSupporter->pSubs);
+  tfree(pSupporter);
+
+  if (pSql->fp == NULL) {
+    tsem_post(&pSql->rspSem);
+  } else {
+    tscQueueAsyncRes(pSql);
+  }
+}
+
+/*
+ * a completed submit hands its slot over to the next pending one, so at most tsInsertVnodeConcurrency submits are
+ * in flight at the same time. It must be called before the caller is accounted as completed.
+ */
+static void tscLaunchPendingInsert(SInsertSupporter *pSupporter) {
+  int32_t idx = atomic_fetch_add_32(&pSupporter->numOfLaunched, 1);
+  if (idx >= pSupporter->numOfTotal) {
+    return;
+  }
+
+  tscTrace("%p launch submit:%p, vnodeIdx:%d", pSupporter->pObj, pSupporter->pSubs[idx], idx);
+  tscProcessSql(pSupporter->pSubs[idx]);
+}
+
+/*
+ * the retry of a failed submit, as well as the renew of meter meta, are handled by the submit object itself in
+ * tscProcessMsgFromServer, so a negative numOfRows is the final result of the vnode.
+ */
+static void tscInsertSubqueryCallback(void *param, TAOS_RES *tres, int numOfRows) {
+  SInsertSupporter *pSupporter = (SInsertSupporter *)param;
+
+  if (numOfRows < 0) {
+    tscError("%p submit to vnode failed, code:%d", pSupporter->pObj, -numOfRows);
+    atomic_val_compare_exchange_32(&pSupporter->code, TSDB_CODE_SUCCESS, -numOfRows);
+  } else {
+    atomic_add_fetch_32(&pSupporter->numOfRows, numOfRows);
+  }
+
+  // failure of one vnode does not affect the data blocks of other vnodes, which are still sent
+  tscLaunchPendingInsert(pSupporter);
+
+  if (atomic_add_fetch_32(&pSupporter->numOfCompleted, 1) < pSupporter->numOfTotal) {
+    return;
+  }
+
+  tscInsertSubqueryCompleted(pSupporter);
+}
+
+/*
+ * multi-vnodes insertion, in both sync and async model
  *
- * modify history
- * 2019.05.10 lihui
- * Remove the code for importing records from files
+ * The data block of each vnode is sent by its own submit object, so the data blocks of different vnodes are in
+ * flight concurrently, instead of one after another. In sync model, the invoker is blocked until all vnodes respond.
+ * In async model, pSql may have been released when this function returns.
  */
 void tscProcessMultiVnodesInsert(SSqlObj *pSql) {
   SSqlCmd *pCmd = &pSql->cmd;
+  SSqlRes *pRes = &pSql->res;
 
-  // not insert/import, return directly
-  if (pCmd->command != TSDB_SQL_INSERT) {
-    return;
-  }
+  assert(pCmd->command == TSDB_SQL_INSERT && pCmd->isInsertFromFile != 1 && pCmd->pDataBlocks != NULL);
+
+  SDataBlockList *pDataBlocks = pCmd->pDataBlocks;
+  pCmd->pDataBlocks = NULL;
 
-  // SSqlCmd may have been released
-  if (pCmd->pDataBlocks == NULL) {
+  SInsertSupporter *pSupporter = calloc(1, sizeof(SInsertSupporter));
+  SSqlObj **        pSubs = calloc(pDataBlocks->nSize, POINTER_BYTES);
+  if (pSupporter == NULL || pSubs == NULL) {
+    tfree(pSupporter);
+    tfree(pSubs);
+    tscDestroyBlockArrayList(pDataBlocks);
+
+    pRes->code = TSDB_CODE_CLI_OUT_OF_MEMORY;
+    if (pSql->fp != NULL) {
+      tscQueueAsyncRes(pSql);
+    }
     return;
   }
 
-  STableDataBlocks *pDataBlock = NULL;
-  SMeterMetaInfo *  pMeterMetaInfo = tscGetMeterMetaInfo(pCmd, 0);
-  int32_t           code = TSDB_CODE_SUCCESS;
+  pSupporter->pObj = pSql;
+  pSupporter->pSubs = pSubs;
 
-  /* the first block has been sent to server in processSQL function */
-  assert(pCmd->isInsertFromFile != -1 && pCmd->vnodeIdx >= 1 && pCmd->pDataBlocks != NULL);
+  // all submit messages are built before any of them is sent, the data blocks are not needed any more
+  for (int32_t i = 0; i < pDataBlocks->nSize; ++i) {
+    STableDataBlocks *pDataBlock = pDataBlocks->pData[i];
+    if (pDataBlock == NULL) {
+      continue;
+    }
 
-  if (pCmd->vnodeIdx < pCmd->pDataBlocks->nSize) {
-    SDataBlockList *pDataBlocks = pCmd->pDataBlocks;
+    SSqlObj *pNew = tscCreateSqlObjForInsert(pSql, pSupporter, pDataBlock, pSupporter->numOfTotal);
+    if (pNew != NULL) {
+      pSubs[pSupporter->numOfTotal++] = pNew;
+    }
+  }
 
-    for (int32_t i = pCmd->vnodeIdx; i < pDataBlocks->nSize; ++i) {
-      pDataBlock = pDataBlocks->pData[i];
-      if (pDataBlock == NULL) {
-        continue;
-      }
+  tscDestroyBlockArrayList(pDataBlocks);
 
-      if ((code = tscCopyDataBlockToPayload(pSql, pDataBlock)) != TSDB_CODE_SUCCESS) {
-        tscTrace("%p build submit data block failed, vnodeIdx:%d, total:%d", pSql, pCmd->vnodeIdx, pDataBlocks->nSize);
-        continue;
-      }
+  pRes->numOfRows = 0;
+  tscTrace("%p multi-vnode insertion, submit to %d vnode(s)", pSql, pSupporter->numOfTotal);
+
+  /*
+   * keep fp as local variable, since the pSupporter and pSql (in async model) may be released once the last
+   * submit is launched.
+   */
+  void *fp = pSql->fp;
 
-      tscProcessSql(pSql);
+  if (pSupporter->numOfTotal == 0) {
+    tscInsertSubqueryCompleted(pSupporter);
+  } else {
+    int32_t numOfConcurrent = MIN(pSupporter->numOfTotal, tsInsertVnodeConcurrency);
+    pSupporter->numOfLaunched = numOfConcurrent;
+
+    for (int32_t i = 0; i < numOfConcurrent; ++i) {
+      tscProcessSql(pSubs[i]);
     }
   }
 
-  // all data have been submit to vnode, release data blocks
-  pCmd->pDataBlocks = tscDestroyBlockArrayList(pCmd->pDataBlocks);
+  if (fp == NULL) {
+    tsem_wait(&pSql->rspSem);
+  }
 }
 
 // multi-vnodes insertion in sync query model
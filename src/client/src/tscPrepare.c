@@ -377,6 +377,166 @@ static int insertStmtBindParam(STscStmt* stmt, TAOS_BIND* bind) {
   return TSDB_CODE_SUCCESS;
 }
 
+static FORCE_INLINE bool isBatchParamNull(TAOS_MULTI_BIND* bind, int32_t row) {
+  return bind->is_null != NULL && (bind->is_null[row >> 3] & (1u << (row & 7))) != 0;
+}
+
+#define BIND_BATCH_COLUMN(_type)                                      \
+  do {                                                                \
+    _type* src = (_type*)bind->buffer;                                \
+    for (int32_t k = 0; k < rows; ++k, data += rowSize) {             \
+      if (isBatchParamNull(bind, k)) {                                \
+        setNull(data, param->type, param->bytes);                     \
+      } else {                                                        \
+        *(_type*)data = src[k];                                       \
+      }                                                               \
+    }                                                                 \
+  } while (0)
+
+/*
+ * transpose one column of rows into the rows of the data block, the type is checked once per column instead of once
+ * per value. data points to the first row to fill.
+ */
+static int doBindBatchParam(char* data, int32_t rowSize, SParamInfo* param, TAOS_MULTI_BIND* bind, int32_t rows) {
+  if (bind->buffer_type != param->type) {
+    return TSDB_CODE_INVALID_VALUE;
+  }
+
+  data += param->offset;
+
+  switch (param->type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+      BIND_BATCH_COLUMN(int8_t);
+      break;
+
+    case TSDB_DATA_TYPE_SMALLINT:
+      BIND_BATCH_COLUMN(int16_t);
+      break;
+
+    case TSDB_DATA_TYPE_INT:
+    case TSDB_DATA_TYPE_FLOAT:
+      BIND_BATCH_COLUMN(int32_t);
+      break;
+
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_DOUBLE:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      BIND_BATCH_COLUMN(int64_t);
+      break;
+
+    case TSDB_DATA_TYPE_BINARY:
+    case TSDB_DATA_TYPE_NCHAR:
+      if (bind->length == NULL) {
+        return TSDB_CODE_INVALID_VALUE;
+      }
+
+      for (int32_t k = 0; k < rows; ++k, data += rowSize) {
+        if (isBatchParamNull(bind, k)) {
+          setNull(data, param->type, param->bytes);
+          continue;
+        }
+
+        char*   src = (char*)bind->buffer + bind->buffer_length * k;
+        int32_t len = bind->length[k];
+        if (len < 0 || len > bind->buffer_length) {
+          return TSDB_CODE_INVALID_VALUE;
+        }
+
+        if (param->type == TSDB_DATA_TYPE_BINARY) {
+          if (len > param->bytes) {
+            return TSDB_CODE_INVALID_VALUE;
+          }
+          memcpy(data, src, len);
+          memset(data + len, 0, param->bytes - len);
+        } else if (!taosMbsToUcs4(src, len, data, param->bytes)) {
+          return TSDB_CODE_INVALID_VALUE;
+        }
+      }
+      break;
+
+    default:
+      return TSDB_CODE_INVALID_VALUE;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+/*
+ * A row bound by taos_stmt_bind_param but not added yet is kept, as taos_stmt_execute does. The rows are appended to
+ * every table of the statement, the size and number of rows of blocks are only updated when all of them succeed.
+ */
+static int insertStmtBindParamBatch(STscStmt* stmt, TAOS_MULTI_BIND* bind, int32_t rows) {
+  SSqlCmd* pCmd = &stmt->pSql->cmd;
+
+  int32_t binded = (pCmd->batchSize + 1) / 2;
+  if (rows <= 0 || binded + rows > INT16_MAX) {
+    tscTrace("%p invalid number of rows:%d to bind, %d rows are binded", stmt->pSql, rows, binded);
+    return TSDB_CODE_INVALID_VALUE;
+  }
+
+  for (int32_t i = 0; i < pCmd->pDataBlocks->nSize; ++i) {
+    STableDataBlocks* pBlock = pCmd->pDataBlocks->pData[i];
+    int32_t           rowSize = pBlock->rowSize;
+
+    uint32_t totalDataSize = sizeof(SShellSubmitBlock) + rowSize * (binded + rows);
+    if (totalDataSize > pBlock->nAllocSize) {
+      const double factor = 1.5;
+      void* tmp = realloc(pBlock->pData, (uint32_t)(totalDataSize * factor));
+      if (tmp == NULL) {
+        return TSDB_CODE_CLI_OUT_OF_MEMORY;
+      }
+      pBlock->pData = (char*)tmp;
+      pBlock->nAllocSize = (uint32_t)(totalDataSize * factor);
+    }
+
+    // values given in sql instead of '?' are only kept in the first row
+    char*   data = pBlock->pData + sizeof(SShellSubmitBlock);
+    int32_t paramSize = 0;
+    bool    tsBinded = false;
+    for (uint32_t j = 0; j < pBlock->numOfParams; ++j) {
+      paramSize += pBlock->params[j].bytes;
+      tsBinded = tsBinded || (pBlock->params[j].offset == 0);
+    }
+
+    if (paramSize < rowSize) {
+      for (int32_t k = MAX(binded, 1); k < binded + rows; ++k) {
+        memcpy(data + rowSize * k, data, rowSize);
+      }
+    }
+
+    for (uint32_t j = 0; j < pBlock->numOfParams; ++j) {
+      SParamInfo* param = pBlock->params + j;
+      int code = doBindBatchParam(data + rowSize * binded, rowSize, param, bind + param->idx, rows);
+      if (code != TSDB_CODE_SUCCESS) {
+        tscTrace("param %d: type mismatch or invalid", param->idx);
+        return code;
+      }
+    }
+
+    // the timestamp is the first column, the block is sorted before sent if keys are not increasing
+    if (tsBinded && pBlock->ordered) {
+      for (int32_t k = MAX(binded, 1); k < binded + rows; ++k) {
+        if (*(TSKEY*)(data + rowSize * k) <= *(TSKEY*)(data + rowSize * (k - 1))) {
+          pBlock->ordered = false;
+          break;
+        }
+      }
+    }
+  }
+
+  for (int32_t i = 0; i < pCmd->pDataBlocks->nSize; ++i) {
+    STableDataBlocks* pBlock = pCmd->pDataBlocks->pData[i];
+    pBlock->size = sizeof(SShellSubmitBlock) + pBlock->rowSize * (binded + rows);
+
+    SShellSubmitBlock* pSubmit = (SShellSubmitBlock*)pBlock->pData;
+    pSubmit->numOfRows = (short)(binded + rows);
+  }
+
+  pCmd->batchSize = (binded + rows) * 2;
+  return TSDB_CODE_SUCCESS;
+}
+
 static int insertStmtAddBatch(STscStmt* stmt) {
   SSqlCmd* pCmd = &stmt->pSql->cmd;
   if ((pCmd->batchSize % 2) == 1) {
@@ -544,6 +704,14 @@ int taos_stmt_bind_param(TAOS_STMT* stmt, TAOS_BIND* bind) {
   return normalStmtBindParam(pStmt, bind);
 }
 
+int taos_stmt_bind_param_batch(TAOS_STMT* stmt, TAOS_MULTI_BIND* bind, int rows) {
+  STscStmt* pStmt = (STscStmt*)stmt;
+  if (pStmt->isInsert) {
+    return insertStmtBindParamBatch(pStmt, bind, rows);
+  }
+  return TSDB_CODE_OPS_NOT_SUPPORT;
+}
+
 int taos_stmt_add_batch(TAOS_STMT* stmt) {
   STscStmt* pStmt = (STscStmt*)stmt;
   if (pStmt->isInsert) {
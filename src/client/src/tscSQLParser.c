@@ -3079,8 +3079,6 @@ typedef struct SCondExpr {
   bool      tsJoin;
 } SCondExpr;
 
-static int32_t getTimeRange(int64_t* stime, int64_t* etime, tSQLExpr* pRight, int32_t optr, int16_t timePrecision);
-
 static int32_t doParseWhereClause(SSqlObj* pSql, tSQLExpr** pExpr, SCondExpr* condExpr);
 
 static int32_t tSQLExprNodeToString(tSQLExpr* pExpr, char** str) {
@@ -357,12 +357,25 @@ static int32_t tscFlushTmpBufferImpl(tExtMemBuffer *pMemoryBuf, tOrderDescriptor
   return 0;
 }
 
-int32_t tscFlushTmpBuffer(tExtMemBuffer *pMemoryBuf, tOrderDescriptor *pDesc, tFilePage *pPage, int32_t orderType) {
+int32_t tscFlushTmpBuffer(tExtMemBuffer *pMemoryBuf, tOrderDescriptor *pDesc, tFilePage *pPage, int32_t orderType,
+                          SSubqueryState *pState) {
   int32_t ret = tscFlushTmpBufferImpl(pMemoryBuf, pDesc, pPage, orderType);
   if (ret != 0) {
     return -1;
   }
 
+  // the sorted run is kept in memory as long as the budget of the whole query is not used up
+  int32_t numOfPages = pMemoryBuf->numOfPagesInMem;
+  if (atomic_add_fetch_32(&pState->numOfPagesInMem, numOfPages) <= pState->maxPagesInMem) {
+    if (!tExtMemBufferSeal(pMemoryBuf)) {
+      atomic_sub_fetch_32(&pState->numOfPagesInMem, numOfPages);
+      return -1;
+    }
+
+    return 0;
+  }
+
+  atomic_sub_fetch_32(&pState->numOfPagesInMem, numOfPages);
   if (!tExtMemBufferFlush(pMemoryBuf)) {
     return -1;
   }
@@ -370,8 +383,119 @@ int32_t tscFlushTmpBuffer(tExtMemBuffer *pMemoryBuf, tOrderDescriptor *pDesc, tF
   return 0;
 }
 
+int32_t tscMergeTmpBufferRuns(tExtMemBuffer *pMemoryBuf, tOrderDescriptor *pDesc, int32_t orderType,
+                              SSubqueryState *pState) {
+  int32_t numOfRuns = pMemoryBuf->fileMeta.flushoutData.nLength;
+  if (numOfRuns <= 1 || !tExtMemBufferIsAllDataInMem(pMemoryBuf)) {
+    return 0;
+  }
+
+  /*
+   * the merged run is no larger than the input runs, which are released after merge completed.
+   * Reserve the memory for it in advance, and leave the runs to the final merge if it is not available.
+   */
+  int32_t numOfPages = pMemoryBuf->numOfPagesInMemRuns;
+  if (atomic_add_fetch_32(&pState->numOfPagesInMem, numOfPages) > pState->maxPagesInMem) {
+    atomic_sub_fetch_32(&pState->numOfPagesInMem, numOfPages);
+    return 0;
+  }
+
+  tColModel *        pModel = pMemoryBuf->pColModel;
+  SLocalDataSource **pDataSrc = (SLocalDataSource **)calloc(numOfRuns, POINTER_BYTES);
+  tFilePage *        pOutput = (tFilePage *)malloc(pMemoryBuf->nPageSize);
+  SLoserTreeInfo *   pTree = NULL;
+  int32_t            ret = -1;
+
+  if (pDataSrc == NULL || pOutput == NULL) {
+    goto _end;
+  }
+
+  for (int32_t i = 0; i < numOfRuns; ++i) {
+    pDataSrc[i] = (SLocalDataSource *)malloc(sizeof(SLocalDataSource) + pMemoryBuf->nPageSize);
+    if (pDataSrc[i] == NULL) {
+      goto _end;
+    }
+
+    pDataSrc[i]->pMemBuffer = pMemoryBuf;
+    pDataSrc[i]->flushoutIdx = i;
+    pDataSrc[i]->pageId = 0;
+    pDataSrc[i]->rowIdx = 0;
+
+    tExtMemBufferLoadData(pMemoryBuf, &pDataSrc[i]->filePage, i, 0);
+  }
+
+  SCompareParam param = {.pLocalData = pDataSrc,
+                         .pDesc = pDesc,
+                         .numOfElems = pMemoryBuf->numOfElemsPerPage,
+                         .groupOrderType = orderType};
+
+  if (tLoserTreeCreate(&pTree, numOfRuns, &param, treeComparator) != TSDB_CODE_SUCCESS) {
+    goto _end;
+  }
+
+  pOutput->numOfElems = 0;
+
+  int32_t numOfCompleted = 0;
+  while (numOfCompleted < numOfRuns) {
+    int32_t           idx = pTree->pNode[0].index;
+    SLocalDataSource *pOneDataSrc = pDataSrc[idx];
+
+    tColModelAppend(pModel, pOutput, pOneDataSrc->filePage.data, pOneDataSrc->rowIdx, 1, pModel->maxCapacity);
+    if (pOutput->numOfElems == pModel->maxCapacity) {
+      if (tExtMemBufferPut(pMemoryBuf, pOutput->data, pOutput->numOfElems) < 0) {
+        goto _end;
+      }
+
+      pOutput->numOfElems = 0;
+    }
+
+    // rows of a page are consumed, load the next page of this run or mark it exhausted
+    if (++pOneDataSrc->rowIdx >= pOneDataSrc->filePage.numOfElems) {
+      pOneDataSrc->rowIdx = 0;
+      pOneDataSrc->pageId += 1;
+
+      tFlushoutInfo *pInfo = &pMemoryBuf->fileMeta.flushoutData.pFlushoutInfo[idx];
+      if (pOneDataSrc->pageId >= pInfo->numOfPages ||
+          !tExtMemBufferLoadData(pMemoryBuf, &pOneDataSrc->filePage, idx, pOneDataSrc->pageId)) {
+        pOneDataSrc->rowIdx = -1;
+        numOfCompleted += 1;
+      }
+    }
+
+    tLoserTreeAdjust(pTree, idx + pTree->numOfEntries);
+  }
+
+  tColModelCompact(pModel, pOutput, pModel->maxCapacity);
+  if (tExtMemBufferPut(pMemoryBuf, pOutput->data, pOutput->numOfElems) < 0) {
+    goto _end;
+  }
+
+  // replace the input runs by the merged one
+  int32_t numOfNewPages = pMemoryBuf->numOfPagesInMem;
+  tExtMemBufferDropMemRuns(pMemoryBuf);
+  if (!tExtMemBufferSeal(pMemoryBuf)) {
+    goto _end;
+  }
+
+  atomic_sub_fetch_32(&pState->numOfPagesInMem, (numOfPages << 1) - numOfNewPages);
+  ret = 0;
+
+_end:
+  if (pDataSrc != NULL) {
+    for (int32_t i = 0; i < numOfRuns; ++i) {
+      tfree(pDataSrc[i]);
+    }
+  }
+
+  tfree(pDataSrc);
+  tfree(pOutput);
+  tfree(pTree);
+
+  return ret;
+}
+
 int32_t saveToBuffer(tExtMemBuffer *pMemoryBuf, tOrderDescriptor *pDesc, tFilePage *pPage, void *data,
-                     int32_t numOfRows, int32_t orderType) {
+                     int32_t numOfRows, int32_t orderType, SSubqueryState *pState) {
   if (pPage->numOfElems + numOfRows <= pDesc->pSchema->maxCapacity) {
     tColModelAppend(pDesc->pSchema, pPage, data, 0, numOfRows, numOfRows);
     return 0;
@@ -384,7 +508,7 @@ int32_t saveToBuffer(tExtMemBuffer *pMemoryBuf, tOrderDescriptor *pDesc, tFilePa
 
   /* current buffer is full, need to flushed to disk */
   assert(pPage->numOfElems == pDesc->pSchema->maxCapacity);
-  int32_t ret = tscFlushTmpBuffer(pMemoryBuf, pDesc, pPage, orderType);
+  int32_t ret = tscFlushTmpBuffer(pMemoryBuf, pDesc, pPage, orderType, pState);
   if (ret != 0) {
     return -1;
   }
@@ -402,7 +526,7 @@ int32_t saveToBuffer(tExtMemBuffer *pMemoryBuf, tOrderDescriptor *pDesc, tFilePa
     tColModelAppend(pModel, pPage, data, numOfRows - remain, numOfWriteElems, numOfRows);
 
     if (pPage->numOfElems == pModel->maxCapacity) {
-      int32_t ret = tscFlushTmpBuffer(pMemoryBuf, pDesc, pPage, orderType);
+      int32_t ret = tscFlushTmpBuffer(pMemoryBuf, pDesc, pPage, orderType, pState);
       if (ret != 0) {
         return -1;
       }
@@ -565,7 +689,7 @@ bool isSameGroup(SSqlCmd *pCmd, SLocalReducer *pReducer, char *pPrev, tFilePage
 }
 
 int32_t tscLocalReducerEnvCreate(SSqlObj *pSql, tExtMemBuffer ***pMemBuffer, tOrderDescriptor **pOrderDesc,
-                                 tColModel **pFinalModel, uint32_t nBufferSizes) {
+                                 tColModel **pFinalModel, uint32_t nBufferSizes, int32_t maxPagesInMem) {
   SSqlCmd *pCmd = &pSql->cmd;
   SSqlRes *pRes = &pSql->res;
 
@@ -602,12 +726,19 @@ int32_t tscLocalReducerEnvCreate(SSqlObj *pSql, tExtMemBuffer ***pMemBuffer, tOr
   int32_t capacity = nBufferSizes / rlen;
   pModel = tColModelCreate(pSchema, pCmd->fieldsInfo.numOfOutputCols, capacity);
 
+  /*
+   * data in buffer is sealed as a sorted run or flushed to disk explicitly, the buffer should never be flushed out
+   * by itself before the memory budget of the whole query is used up.
+   */
+  int32_t nMemBufferSize = MIN(maxPagesInMem, INT16_MAX) * DEFAULT_PAGE_SIZE;
+  nMemBufferSize = MAX(nMemBufferSize, (int32_t)nBufferSizes);
+
   for (int32_t i = 0; i < pMeterMetaInfo->pMetricMeta->numOfVnodes; ++i) {
     char tmpPath[512] = {0};
     getTmpfilePath("tv_bf_db", tmpPath);
     tscTrace("%p create [%d](%d) tmp file for subquery:%s", pSql, pMeterMetaInfo->pMetricMeta->numOfVnodes, i, tmpPath);
 
-    tExtMemBufferCreate(&(*pMemBuffer)[i], nBufferSizes, rlen, tmpPath, pModel);
+    tExtMemBufferCreate(&(*pMemBuffer)[i], nMemBufferSize, rlen, tmpPath, pModel);
     (*pMemBuffer)[i]->flushModel = MULTIPLE_APPEND_MODEL;
   }
 
@@ -30,6 +30,7 @@
 #include "tutil.h"
 
 #define TSC_MGMT_VNODE 999
+#define TSC_METRIC_SUBQUERY_BUFFER_SIZE (1 << 16)  // 64KB, buffer to sort data from a vnode before saved
 
 #ifdef CLUSTER
   SIpStrList tscMgmtIpList;
@@ -331,6 +332,11 @@ int tscSendMsgToServer(SSqlObj *pSql) {
 
     tscTrace("%p msg:%s is sent to server", pSql, taosMsg[pSql->cmd.msgType]);
 
+    // a subscription query is held by the vnode until there are new rows, its progress is checked less often
+    bool subscribe = (pSql->cmd.msgType == TSDB_MSG_TYPE_QUERY) &&
+                     (htons(((SQueryMeterMsg *)(buf + tsRpcHeadSize))->queryType) & TSDB_QUERY_TYPE_SUBSCRIBE) != 0;
+    taosSetRpcConnBackoff(pSql->thandle, subscribe);
+
     char *pStart = taosBuildReqHeader(pSql->thandle, pSql->cmd.msgType, buf);
     if (pStart) {
       /*
@@ -601,7 +607,8 @@ void *tscProcessMsgFromServer(char *msg, void *ahandle, void *thandle) {
        * the tscShouldFreeAsyncSqlObj will success and tscFreeSqlObj free it immediately.
        */
       bool shouldFree = tscShouldFreeAsyncSqlObj(pSql);
-      if (command == TSDB_SQL_INSERT) {  // handle multi-vnode insertion situation
+      // the async insertion proxy needs the SSqlObj, while the submit objects of multi-vnode insertion need param
+      if (command == TSDB_SQL_INSERT && (pCmd->type & TSDB_QUERY_TYPE_SUBQUERY) == 0) {
         (*pSql->fp)(pSql, taosres, code);
       } else {
         (*pSql->fp)(pSql->param, taosres, code);
@@ -849,27 +856,109 @@ int tscProcessSql(SSqlObj *pSql) {
   return doProcessSql(pSql);
 }
 
-static void doCleanupSubqueries(SSqlObj *pSql, int32_t vnodeIndex, int32_t numOfVnodes, SRetrieveSupport *pTrs,
-                                tOrderDescriptor *pDesc, tColModel *pModel, tExtMemBuffer **pMemoryBuf,
-                                SSubqueryState *pState) {
+static void doCleanupSubqueries(SSqlObj *pSql, bool allCompleted, int32_t numOfVnodes, tOrderDescriptor *pDesc,
+                                tColModel *pModel, tExtMemBuffer **pMemoryBuf, SSubqueryState *pState) {
   pSql->cmd.command = TSDB_SQL_RETRIEVE_METRIC;
   pSql->res.code = TSDB_CODE_CLI_OUT_OF_MEMORY;
 
   /*
-   * if i > 0, at least one sub query is issued, the allocated resource is
+   * if any issued sub query is not completed yet, the allocated resource is
    * freed by it when subquery completed.
    */
-  if (vnodeIndex == 0) {
+  if (allCompleted) {
     tscLocalReducerEnvDestroy(pMemoryBuf, pDesc, pModel, numOfVnodes);
     tfree(pState);
+  }
+}
 
-    if (pTrs != NULL) {
-      tfree(pTrs->localBuffer);
+static SSqlObj *tscCreateSqlObjForSubquery(SSqlObj *pSql, SRetrieveSupport *trsupport, SSqlObj *prevSqlObj);
 
-      pthread_mutex_unlock(&pTrs->queryMutex);
-      pthread_mutex_destroy(&pTrs->queryMutex);
-      tfree(pTrs);
-    }
+static int32_t tscLaunchSubquery(SSqlObj *pSql, int32_t vnodeIdx, tExtMemBuffer **pMemoryBuf, tOrderDescriptor *pDesc,
+                                 tColModel *pModel, SSubqueryState *pState) {
+  SRetrieveSupport *trs = (SRetrieveSupport *)calloc(1, sizeof(SRetrieveSupport));
+  if (trs == NULL) {
+    return TSDB_CODE_CLI_OUT_OF_MEMORY;
+  }
+
+  trs->pExtMemBuffer = pMemoryBuf;
+  trs->pOrderDescriptor = pDesc;
+  trs->pState = pState;
+  trs->localBuffer = (tFilePage *)calloc(1, TSC_METRIC_SUBQUERY_BUFFER_SIZE + sizeof(tFilePage));
+  trs->vnodeIdx = vnodeIdx;
+  trs->pParentSqlObj = pSql;
+  trs->pFinalColModel = pModel;
+
+  pthread_mutexattr_t mutexattr = {0};
+  pthread_mutexattr_settype(&mutexattr, PTHREAD_MUTEX_RECURSIVE_NP);
+  pthread_mutex_init(&trs->queryMutex, &mutexattr);
+  pthread_mutexattr_destroy(&mutexattr);
+
+  SSqlObj *pNew = (trs->localBuffer != NULL) ? tscCreateSqlObjForSubquery(pSql, trs, NULL) : NULL;
+  if (pNew == NULL) {
+    tfree(trs->localBuffer);
+    pthread_mutex_destroy(&trs->queryMutex);
+    tfree(trs);
+
+    return TSDB_CODE_CLI_OUT_OF_MEMORY;
+  }
+
+  // todo handle multi-vnode situation
+  if (pSql->cmd.tsBuf) {
+    pNew->cmd.tsBuf = tsBufClone(pSql->cmd.tsBuf);
+  }
+
+  tscTrace("%p sub:%p launch subquery.orderOfSub:%d", pSql, pNew, pNew->cmd.vnodeIdx);
+  tscProcessSql(pNew);
+
+  return TSDB_CODE_SUCCESS;
+}
+
+/*
+ * the sub-queries that are not launched yet are never launched, account them as completed together with the
+ * numOfSkipped ones whose launch failed. Return true if all sub-queries are completed after that.
+ */
+static bool tscSkipPendingSubqueries(SSubqueryState *pState, int32_t numOfSkipped) {
+  int32_t numOfLaunched = atomic_exchange_32(&pState->numOfLaunched, pState->numOfTotal);
+  if (numOfLaunched < pState->numOfTotal) {
+    numOfSkipped += (pState->numOfTotal - numOfLaunched);
+  }
+
+  if (numOfSkipped == 0) {
+    return false;
+  }
+
+  return atomic_add_fetch_32(&pState->numOfCompleted, numOfSkipped) == pState->numOfTotal;
+}
+
+/*
+ * a completed sub-query hands its slot over to the next pending one, so at most tsMetricSubqueryConcurrency
+ * sub-queries retrieve data from vnodes at the same time. If the super table query is failed or cancelled, the
+ * pending ones are skipped instead.
+ *
+ * It must be called before the caller is accounted as completed, so the last completion is always observed by
+ * a sub-query, which builds the local reducer or reports the error.
+ */
+static void tscLaunchPendingSubquery(SRetrieveSupport *trsupport) {
+  SSqlObj *       pPObj = trsupport->pParentSqlObj;
+  SSubqueryState *pState = trsupport->pState;
+
+  if (pState->code != TSDB_CODE_SUCCESS || pPObj->res.code != TSDB_CODE_SUCCESS) {
+    tscSkipPendingSubqueries(pState, 0);
+    return;
+  }
+
+  int32_t vnodeIdx = atomic_fetch_add_32(&pState->numOfLaunched, 1);
+  if (vnodeIdx >= pState->numOfTotal) {
+    return;
+  }
+
+  int32_t code = tscLaunchSubquery(pPObj, vnodeIdx, trsupport->pExtMemBuffer, trsupport->pOrderDescriptor,
+                                   trsupport->pFinalColModel, pState);
+  if (code != TSDB_CODE_SUCCESS) {
+    tscError("%p failed to launch subquery, orderOfSub:%d, code:%d, abort", pPObj, vnodeIdx, code);
+
+    atomic_val_compare_exchange_32(&pState->code, TSDB_CODE_SUCCESS, -code);
+    tscSkipPendingSubqueries(pState, 1);
   }
 }
 
@@ -888,12 +977,14 @@ int tscLaunchMetricSubQueries(SSqlObj *pSql) {
 
   pRes->qhandle = 1;  // hack the qhandle check
 
-  const uint32_t  nBufferSize = (1 << 16);  // 64KB
   SMeterMetaInfo *pMeterMetaInfo = tscGetMeterMetaInfo(&pSql->cmd, 0);
   int32_t         numOfVnodes = pMeterMetaInfo->pMetricMeta->numOfVnodes;
   assert(numOfVnodes > 0);
 
-  int32_t ret = tscLocalReducerEnvCreate(pSql, &pMemoryBuf, &pDesc, &pModel, nBufferSize);
+  int32_t maxPagesInMem = ((int64_t)tsMetricMergeBufferSize << 20) / DEFAULT_PAGE_SIZE;
+
+  int32_t ret =
+      tscLocalReducerEnvCreate(pSql, &pMemoryBuf, &pDesc, &pModel, TSC_METRIC_SUBQUERY_BUFFER_SIZE, maxPagesInMem);
   if (ret != 0) {
     pRes->code = TSDB_CODE_CLI_OUT_OF_MEMORY;
     if (pSql->fp) {
@@ -902,65 +993,43 @@ int tscLaunchMetricSubQueries(SSqlObj *pSql) {
     return pRes->code;
   }
 
-  pSql->pSubs = malloc(POINTER_BYTES * numOfVnodes);
+  pSql->pSubs = calloc(numOfVnodes, POINTER_BYTES);
   pSql->numOfSubs = numOfVnodes;
 
   tscTrace("%p retrieved query data from %d vnode(s)", pSql, numOfVnodes);
   SSubqueryState *pState = calloc(1, sizeof(SSubqueryState));
   pState->numOfTotal = numOfVnodes;
+  pState->maxPagesInMem = maxPagesInMem;
   pRes->code = TSDB_CODE_SUCCESS;
 
-  for (int32_t i = 0; i < numOfVnodes; ++i) {
-    if (pRes->code == TSDB_CODE_QUERY_CANCELLED || pRes->code == TSDB_CODE_CLI_OUT_OF_MEMORY) {
-      /*
-       * during launch sub queries, if the master query is cancelled. the remain is ignored and set the retrieveDoneRec
-       * to the value of remaining not built sub-queries. So, the already issued sub queries can successfully free
-       * allocated resources.
-       */
-      pState->numOfCompleted = (numOfVnodes - i);
-      doCleanupSubqueries(pSql, i, numOfVnodes, NULL, pDesc, pModel, pMemoryBuf, pState);
-
-      if (i == 0) {
-        return pSql->res.code;
-      }
+  /*
+   * only a limited number of sub-queries are launched here, the remains are launched one by one by the completed
+   * ones, see tscLaunchPendingSubquery.
+   *
+   * The slots of these sub-queries are taken before any of them is launched. Once the last one is launched, all
+   * sub-queries may complete and free pState, so it must not be touched by this loop any more.
+   */
+  int32_t numOfConcurrent = MIN(numOfVnodes, tsMetricSubqueryConcurrency);
+  pState->numOfLaunched = numOfConcurrent;
 
-      break;
+  for (int32_t i = 0; i < numOfConcurrent; ++i) {
+    if (pRes->code != TSDB_CODE_QUERY_CANCELLED && pRes->code != TSDB_CODE_CLI_OUT_OF_MEMORY &&
+        tscLaunchSubquery(pSql, i, pMemoryBuf, pDesc, pModel, pState) == TSDB_CODE_SUCCESS) {
+      continue;
     }
 
-    SRetrieveSupport *trs = (SRetrieveSupport *)calloc(1, sizeof(SRetrieveSupport));
-    trs->pExtMemBuffer = pMemoryBuf;
-    trs->pOrderDescriptor = pDesc;
-    trs->pState = pState;
-    trs->localBuffer = (tFilePage *)calloc(1, nBufferSize + sizeof(tFilePage));
-    trs->vnodeIdx = i;
-    trs->pParentSqlObj = pSql;
-    trs->pFinalColModel = pModel;
-
-    pthread_mutexattr_t mutexattr = {0};
-    pthread_mutexattr_settype(&mutexattr, PTHREAD_MUTEX_RECURSIVE_NP);
-    pthread_mutex_init(&trs->queryMutex, &mutexattr);
-    pthread_mutexattr_destroy(&mutexattr);
-
-    SSqlObj *pNew = tscCreateSqlObjForSubquery(pSql, trs, NULL);
-
-    if (pNew == NULL) {
-      pState->numOfCompleted = (numOfVnodes - i);
-      doCleanupSubqueries(pSql, i, numOfVnodes, trs, pDesc, pModel, pMemoryBuf, pState);
-
-      if (i == 0) {
-        return pSql->res.code;
-      }
-
-      break;
-    }
+    /*
+     * during launch sub queries, if the master query is cancelled or failed, the remain is ignored and accounted
+     * as completed, so the already issued sub queries can successfully free allocated resources.
+     */
+    bool allCompleted = tscSkipPendingSubqueries(pState, numOfConcurrent - i);
+    doCleanupSubqueries(pSql, allCompleted, numOfVnodes, pDesc, pModel, pMemoryBuf, pState);
 
-    // todo handle multi-vnode situation
-    if (pSql->cmd.tsBuf) {
-      pNew->cmd.tsBuf = tsBufClone(pSql->cmd.tsBuf);
+    if (allCompleted) {
+      return pSql->res.code;
     }
 
-    tscTrace("%p sub:%p launch subquery.orderOfSub:%d", pSql, pNew, pNew->cmd.vnodeIdx);
-    tscProcessSql(pNew);
+    break;
   }
 
   return TSDB_CODE_SUCCESS;
@@ -1036,6 +1105,7 @@ static void tscHandleSubRetrievalError(SRetrieveSupport *trsupport, SSqlObj *pSq
        * current query failed, and the retry count is less than the available
        * count, retry query clear previous retrieved data, then launch a new sub query
        */
+      atomic_sub_fetch_32(&trsupport->pState->numOfPagesInMem, trsupport->pExtMemBuffer[idx]->numOfPagesInMemRuns);
       tExtMemBufferClear(trsupport->pExtMemBuffer[idx]);
 
       // clear local saved number of results
@@ -1064,6 +1134,8 @@ static void tscHandleSubRetrievalError(SRetrieveSupport *trsupport, SSqlObj *pSq
     }
   }
 
+  tscLaunchPendingSubquery(trsupport);
+
   if (atomic_add_fetch_32(&trsupport->pState->numOfCompleted, 1) < trsupport->pState->numOfTotal) {
     return tscFreeSubSqlObj(trsupport, pSql);
   }
@@ -1148,7 +1220,7 @@ void tscRetrieveFromVnodeCallBack(void *param, TAOS_RES *tres, int numOfRows) {
       return;
     }
     int32_t ret = saveToBuffer(trsupport->pExtMemBuffer[idx], pDesc, trsupport->localBuffer, pRes->data,
-                               pRes->numOfRows, pCmd->groupbyExpr.orderType);
+                               pRes->numOfRows, pCmd->groupbyExpr.orderType, trsupport->pState);
     if (ret < 0) {
       // set no disk space error info, and abort retry
       tscAbortFurtherRetryRetrieval(trsupport, tres, TSDB_CODE_CLI_NO_DISKSPACE);
@@ -1182,13 +1254,29 @@ void tscRetrieveFromVnodeCallBack(void *param, TAOS_RES *tres, int numOfRows) {
 
     // each result for a vnode is ordered as an independant list,
     // then used as an input of loser tree for disk-based merge routine
-    int32_t ret =
-        tscFlushTmpBuffer(trsupport->pExtMemBuffer[idx], pDesc, trsupport->localBuffer, pCmd->groupbyExpr.orderType);
+    int32_t ret = tscFlushTmpBuffer(trsupport->pExtMemBuffer[idx], pDesc, trsupport->localBuffer,
+                                    pCmd->groupbyExpr.orderType, trsupport->pState);
     if (ret != 0) {
       /* set no disk space error info, and abort retry */
       return tscAbortFurtherRetryRetrieval(trsupport, tres, TSDB_CODE_CLI_NO_DISKSPACE);
     }
 
+    /*
+     * merge the sorted lists of current vnode into one while other vnodes are still being retrieved,
+     * so the final merge only picks rows from one list per vnode.
+     */
+    ret = tscMergeTmpBufferRuns(trsupport->pExtMemBuffer[idx], pDesc, pCmd->groupbyExpr.orderType, trsupport->pState);
+    if (ret != 0) {
+      return tscAbortFurtherRetryRetrieval(trsupport, tres, TSDB_CODE_CLI_OUT_OF_MEMORY);
+    }
+
+    tscLaunchPendingSubquery(trsupport);
+
+    // the pending sub-queries may fail to launch, the error is reported by the last completed one
+    if (trsupport->pState->code != TSDB_CODE_SUCCESS) {
+      return tscHandleSubRetrievalError(trsupport, pSql, 0);
+    }
+
     if (atomic_add_fetch_32(&trsupport->pState->numOfCompleted, 1) < trsupport->pState->numOfTotal) {
       return tscFreeSubSqlObj(trsupport, pSql);
     }
@@ -1367,7 +1455,8 @@ int tscBuildRetrieveMsg(SSqlObj *pSql) {
   *((uint64_t *)pMsg) = pSql->res.qhandle;
   pMsg += sizeof(pSql->res.qhandle);
 
-  *((uint16_t*)pMsg) = htons(pSql->cmd.type);
+  // the response may be compressed by column
+  *((uint16_t*)pMsg) = htons(pSql->cmd.type | TSDB_QUERY_TYPE_COLUMN_COMP);
   pMsg += sizeof(pSql->cmd.type);
 
   msgLen = pMsg - pStart;
@@ -1564,7 +1653,13 @@ int tscBuildQueryMsg(SSqlObj *pSql) {
     pQueryMsg->tagLength = htons(pMetricMeta->tagLen);
   }
 
-  pQueryMsg->queryType = htons(pCmd->type);
+  // the rows of a super table in several vnodes are not to be held back by a vnode without new rows
+  uint16_t queryType = pCmd->type;
+  if (!UTIL_METER_IS_NOMRAL_METER(pMeterMetaInfo) && pMetricMeta->numOfVnodes > 1) {
+    queryType &= (~TSDB_QUERY_TYPE_SUBSCRIBE);
+  }
+
+  pQueryMsg->queryType = htons(queryType);
   pQueryMsg->numOfOutputCols = htons(pCmd->exprsInfo.numOfExprs);
 
   if (pCmd->fieldsInfo.numOfOutputCols < 0) {
@@ -1780,6 +1875,10 @@ int tscBuildQueryMsg(SSqlObj *pSql) {
     pQueryMsg->tsOrder = htonl(pCmd->tsBuf->tsOrder);
   }
 
+  // appended after the variable part, so that a vnode of an older version still parses the message
+  *((int16_t *)pMsg) = htons(pSql->pTscObj->queryParallelism);
+  pMsg += sizeof(int16_t);
+
   msgLen = pMsg - pStart;
 
   tscTrace("%p msg built success,len:%d bytes", pSql, msgLen);
@@ -3047,6 +3146,62 @@ int tscProcessMeterMetaRsp(SSqlObj *pSql) {
   return TSDB_CODE_OTHERS;
 }
 
+/*
+ * Meters that do not exist in mgmt are remembered for tsMeterMetaMissKeepTimer seconds, so insertions into them fail
+ * without asking mgmt again and again.
+ */
+static void tscAddMissingMeter(char *meterId) {
+  int8_t missing = 1;
+
+  void *p = taosAddDataIntoCache(tscMissCacheHandle, meterId, (char *)&missing, sizeof(missing),
+                                 tsMeterMetaMissKeepTimer);
+  taosRemoveDataFromCache(tscMissCacheHandle, &p, false);
+}
+
+bool tscIsMissingMeter(char *meterId) {
+  void *p = taosGetDataFromCache(tscMissCacheHandle, meterId);
+  if (p == NULL) {
+    return false;
+  }
+
+  taosRemoveDataFromCache(tscMissCacheHandle, &p, false);
+  return true;
+}
+
+void tscRemoveMissingMeter(char *meterId) {
+  void *p = taosGetDataFromCache(tscMissCacheHandle, meterId);
+  taosRemoveDataFromCache(tscMissCacheHandle, &p, true);
+}
+
+/*
+ * meterIdList is the comma terminated meter ids in the multi meter meta request, those not in meter meta cache after
+ * the response is processed are the missing ones
+ */
+static void tscSetMissingMeters(SSqlObj *pSql, char *meterIdList) {
+  int32_t numOfMissing = 0;
+  char *  str = meterIdList;
+  char *  nextStr = NULL;
+
+  while ((nextStr = strchr(str, ',')) != NULL) {
+    *nextStr = 0;
+
+    SMeterMeta *pMeterMeta = taosGetDataFromCache(tscCacheHandle, str);
+    if (pMeterMeta == NULL) {
+      tscAddMissingMeter(str);
+      numOfMissing++;
+    } else {
+      taosRemoveDataFromCache(tscCacheHandle, (void **)&pMeterMeta, false);
+    }
+
+    *nextStr = ',';
+    str = nextStr + 1;
+  }
+
+  if (numOfMissing > 0) {
+    tscTrace("%p %d meters do not exist, kept in miss cache for %d sec", pSql, numOfMissing, tsMeterMetaMissKeepTimer);
+  }
+}
+
 /**
  *  multi meter meta rsp pkg format:
  *  | STaosRsp | ieType | SMultiMeterInfoMsg | SMeterMeta0 | SSchema0 | SMeterMeta1 | SSchema1 | SMeterMeta2 | SSchema2
@@ -3083,7 +3238,7 @@ int tscProcessMultiMeterMetaRsp(SSqlObj *pSql) {
     pMeta->vgid = htonl(pMeta->vgid);
     pMeta->uid = htobe64(pMeta->uid);
 
-    if (pMeta->sid <= 0 || pMeta->vgid < 0) {
+    if (pMeta->sid < 0 || pMeta->vgid < 0) {
       tscError("invalid meter vgid:%d, sid%d", pMeta->vgid, pMeta->sid);
       pSql->res.code = TSDB_CODE_INVALID_VALUE;
       pSql->res.numOfTotal = i;
@@ -3148,9 +3303,14 @@ int tscProcessMultiMeterMetaRsp(SSqlObj *pSql) {
     int32_t size = (int32_t)(rsp - ((char *)pMeta));  // Consistent with SMeterMeta in cache
 
     pMeta->index = 0;
-    (void)taosAddDataIntoCache(tscCacheHandle, pMultiMeta->meterId, (char *)pMeta, size, tsMeterMetaKeepTimer);
+    void *pCached = taosAddDataIntoCache(tscCacheHandle, pMultiMeta->meterId, (char *)pMeta, size, tsMeterMetaKeepTimer);
+    taosRemoveDataFromCache(tscCacheHandle, &pCached, false);
   }
 
+  // the request message is kept in payload, the meters that are not returned do not exist
+  SMultiMeterInfoMsg *pReq = (SMultiMeterInfoMsg *)(pSql->cmd.payload + tsRpcHeadSize + sizeof(SMgmtHead));
+  tscSetMissingMeters(pSql, pReq->meterId);
+
   pSql->res.code = TSDB_CODE_SUCCESS;
   pSql->res.numOfTotal = i;
   tscTrace("%p load multi-metermeta resp complete num:%d", pSql, pSql->res.numOfTotal);
@@ -3374,6 +3534,12 @@ int tscProcessDropDbRsp(SSqlObj *UNUSED_PARAM(pSql)) {
   return 0;
 }
 
+int tscProcessCreateTableRsp(SSqlObj *pSql) {
+  // the table may have been remembered as a missing one by previous insertions
+  tscRemoveMissingMeter(tscGetMeterMetaInfo(&pSql->cmd, 0)->name);
+  return 0;
+}
+
 int tscProcessDropTableRsp(SSqlObj *pSql) {
   SMeterMetaInfo *pMeterMetaInfo = tscGetMeterMetaInfo(&pSql->cmd, 0);
 
@@ -3441,29 +3607,141 @@ int tscProcessQueryRsp(SSqlObj *pSql) {
   return 0;
 }
 
-static void doDecompressPayload(SSqlCmd *pCmd, SSqlRes *pRes, int16_t compressed) {
-  if (compressed && pRes->numOfRows > 0) {
+static int (*tscDecompFunc[])(const char *const input, int compressedSize, const int elements, char *const output,
+                              int outputSize, char algorithm, char *const buffer, int bufferSize) = {
+    NULL,
+    tsDecompressBool,
+    tsDecompressTinyint,
+    tsDecompressSmallint,
+    tsDecompressInt,
+    tsDecompressBigint,
+    tsDecompressFloat,
+    tsDecompressDouble,
+    tsDecompressString,
+    tsDecompressTimestamp,
+    tsDecompressString};
+
+/*
+ * get the size of the columns after decoding. The width of each column is taken from its head, since the columns of
+ * a sub-query on super table are intermediate results that are wider than the fields.
+ * @return  -1 if the payload is broken
+ */
+static int32_t getDecompressedColumnsSize(SSqlCmd *pCmd, SSqlRes *pRes, char *payload, int32_t payloadSize) {
+  int32_t numOfTotalCols = pCmd->fieldsInfo.numOfOutputCols + pCmd->fieldsInfo.numOfHiddenCols;
+  char *  pEnd = payload + payloadSize;
+  int32_t size = 0;
+
+  for (int32_t i = 0; i < numOfTotalCols; ++i) {
+    SRetrieveColumnHead *pHead = (SRetrieveColumnHead *)payload;
+    if (payload + sizeof(SRetrieveColumnHead) > pEnd) return -1;
+
+    int32_t bytes = (int16_t)htons((uint16_t)pHead->bytes);
+    int32_t len = (int32_t)htonl((uint32_t)pHead->len);
+    if (bytes <= 0 || len <= 0) return -1;
+
+    size += bytes * pRes->numOfRows;
+    payload += sizeof(SRetrieveColumnHead) + len;
+  }
+
+  return size;
+}
+
+/*
+ * decode each column of payload directly into its place in the result buffer, see SRetrieveColumnHead
+ */
+static int32_t doDecompressColumns(SSqlCmd *pCmd, SSqlRes *pRes, char *payload, int32_t payloadSize, char *output) {
+  int32_t numOfTotalCols = pCmd->fieldsInfo.numOfOutputCols + pCmd->fieldsInfo.numOfHiddenCols;
+  char *  buffer = NULL;
+  int32_t bufferSize = 0;
+  int32_t code = TSDB_CODE_SUCCESS;
+  char *  pEnd = payload + payloadSize;
+
+  for (int32_t i = 0; i < numOfTotalCols; ++i) {
+    SRetrieveColumnHead *pHead = (SRetrieveColumnHead *)payload;
+
+    if (payload + sizeof(SRetrieveColumnHead) > pEnd || pHead->type < TSDB_DATA_TYPE_BOOL ||
+        pHead->type > TSDB_DATA_TYPE_NCHAR) {
+      code = TSDB_CODE_INVALID_VALUE;
+      break;
+    }
+
+    int32_t colSize = (int16_t)htons((uint16_t)pHead->bytes) * pRes->numOfRows;
+    int32_t len = (int32_t)htonl((uint32_t)pHead->len);
+    payload += sizeof(SRetrieveColumnHead);
+    if (len <= 0 || payload + len > pEnd) {
+      code = TSDB_CODE_INVALID_VALUE;
+      break;
+    }
+
+    if (pHead->algorithm == TWO_STAGE_COMP && bufferSize < colSize + EXTRA_BYTES) {
+      char *tmp = realloc(buffer, (size_t)(colSize + EXTRA_BYTES));
+      if (tmp == NULL) {
+        code = TSDB_CODE_CLI_OUT_OF_MEMORY;
+        break;
+      }
+
+      buffer = tmp;
+      bufferSize = colSize + EXTRA_BYTES;
+    }
+
+    int32_t ret = (*tscDecompFunc[pHead->type])(payload, len, pRes->numOfRows, output, colSize, pHead->algorithm,
+                                                buffer, bufferSize);
+    if (ret != colSize) {
+      code = TSDB_CODE_INVALID_VALUE;
+      break;
+    }
+
+    payload += len;
+    output += colSize;
+  }
+
+  tfree(buffer);
+  return code;
+}
+
+static int32_t doDecompressPayload(SSqlCmd *pCmd, SSqlRes *pRes, int16_t compressed) {
+  if (compressed != TSDB_RSP_COMP_NONE && pRes->numOfRows > 0) {
     SRetrieveMeterRsp *pRetrieve = (SRetrieveMeterRsp *)pRes->pRsp;
 
     int32_t numOfTotalCols = pCmd->fieldsInfo.numOfOutputCols + pCmd->fieldsInfo.numOfHiddenCols;
     int32_t rowSize = pCmd->fieldsInfo.pOffset[numOfTotalCols - 1] + pCmd->fieldsInfo.pFields[numOfTotalCols - 1].bytes;
-
-    // TODO handle the OOM problem
-    char *  buf = malloc(rowSize * pRes->numOfRows);
-
     int32_t payloadSize = pRes->rspLen - 1 - sizeof(SRetrieveMeterRsp);
+    int32_t decompressedSize = rowSize * pRes->numOfRows;
     assert(payloadSize > 0);
 
-    int32_t decompressedSize = tsDecompressString(pRetrieve->data, payloadSize, 1, buf, rowSize * pRes->numOfRows, 0, 0, 0);
-    assert(decompressedSize == rowSize * pRes->numOfRows);
+    if (compressed == TSDB_RSP_COMP_COLUMN) {
+      decompressedSize = getDecompressedColumnsSize(pCmd, pRes, pRetrieve->data, payloadSize);
+      if (decompressedSize < 0) return TSDB_CODE_INVALID_VALUE;
+    }
+
+    // the result is decoded into a new response buffer, the compressed one is dropped then
+    char *pRsp = malloc(sizeof(SRetrieveMeterRsp) + decompressedSize);
+    if (pRsp == NULL) {
+      return TSDB_CODE_CLI_OUT_OF_MEMORY;
+    }
+
+    memcpy(pRsp, pRetrieve, sizeof(SRetrieveMeterRsp));
 
-    pRes->pRsp = realloc(pRes->pRsp, pRes->rspLen - payloadSize + decompressedSize);
-    memcpy(pRes->pRsp + sizeof(SRetrieveMeterRsp), buf, decompressedSize);
+    int32_t code = TSDB_CODE_SUCCESS;
+    if (compressed == TSDB_RSP_COMP_COLUMN) {
+      code = doDecompressColumns(pCmd, pRes, pRetrieve->data, payloadSize, pRsp + sizeof(SRetrieveMeterRsp));
+    } else if (tsDecompressString(pRetrieve->data, payloadSize, 1, pRsp + sizeof(SRetrieveMeterRsp), decompressedSize,
+                                  0, 0, 0) != decompressedSize) {
+      code = TSDB_CODE_INVALID_VALUE;
+    }
 
-    free(buf);
+    if (code != TSDB_CODE_SUCCESS) {
+      free(pRsp);
+      return code;
+    }
+
+    free(pRes->pRsp);
+    pRes->pRsp = pRsp;
+    pRes->rspLen = sizeof(SRetrieveMeterRsp) + decompressedSize + 1;
   }
 
   pRes->data = ((SRetrieveMeterRsp *)pRes->pRsp)->data;
+  return TSDB_CODE_SUCCESS;
 }
 
 int tscProcessRetrieveRspFromVnode(SSqlObj *pSql) {
@@ -3480,7 +3758,12 @@ int tscProcessRetrieveRspFromVnode(SSqlObj *pSql) {
   pRes->useconds = htobe64(pRetrieve->useconds);
   pRetrieve->compress = htons(pRetrieve->compress);
 
-  doDecompressPayload(pCmd, pRes, pRetrieve->compress);
+  pRes->code = doDecompressPayload(pCmd, pRes, pRetrieve->compress);
+  if (pRes->code != TSDB_CODE_SUCCESS) {
+    tscError("%p failed to decompress retrieved data, compress:%d, code:%d", pSql, pRetrieve->compress, pRes->code);
+    pRes->numOfRows = 0;
+    return pRes->code;
+  }
 
   tscSetResultPointer(pCmd, pRes);
   pRes->row = 0;
@@ -3553,6 +3836,8 @@ static int32_t tscDoGetMeterMeta(SSqlObj *pSql, char *meterId, int32_t index) {
     // update cache only on success get metermeta
     if (code == TSDB_CODE_SUCCESS) {
       pInfo->pMeterMeta = (SMeterMeta *)taosGetDataFromCache(tscCacheHandle, meterId);
+    } else if (code == TSDB_CODE_INVALID_TABLE && pSql->cmd.command == TSDB_SQL_INSERT) {
+      tscAddMissingMeter(meterId);
     }
 
     tscTrace("%p get meter meta complete, code:%d, pMeterMeta:%p", pSql, code, pInfo->pMeterMeta);
@@ -3589,6 +3874,12 @@ int tscGetMeterMeta(SSqlObj *pSql, char *meterId, int32_t index) {
     return TSDB_CODE_SUCCESS;
   }
 
+  // the meter is known to be absent, no need to ask mgmt again unless it is going to be created
+  if (pCmd->command == TSDB_SQL_INSERT && pCmd->defaultVal[0] == 0 && tscIsMissingMeter(meterId)) {
+    tscTrace("%p meter:%s does not exist, retrieved from miss cache", pSql, meterId);
+    return TSDB_CODE_INVALID_TABLE;
+  }
+
   /*
    * for async insert operation, release data block buffer before issue new object to get metermeta
    * because in metermeta callback function, the tscParse function will generate the submit data blocks
@@ -3605,6 +3896,63 @@ int tscGetMeterMetaEx(SSqlObj *pSql, char *meterId, bool createIfNotExists) {
   return tscGetMeterMeta(pSql, meterId, 0);
 }
 
+/**
+ * load the meter metas of a batch of meters from mgmt in one request, the meters that are not returned are kept in
+ * the miss cache. Meters are not created automatically.
+ *
+ * @param pSql          sql object
+ * @param meterIdList   meter ids, each of which is terminated by comma
+ * @param len           length of meterIdList
+ * @param numOfMeters   number of meters in meterIdList
+ * @return              status code
+ */
+int tscGetMultiMeterMeta(SSqlObj *pSql, char *meterIdList, int32_t len, int32_t numOfMeters) {
+  int32_t code = TSDB_CODE_SUCCESS;
+
+  SSqlObj *pNew = calloc(1, sizeof(SSqlObj));
+  if (NULL == pNew) {
+    tscError("%p malloc failed for new sqlobj to get multi meter meta", pSql);
+    return TSDB_CODE_CLI_OUT_OF_MEMORY;
+  }
+  pNew->pTscObj = pSql->pTscObj;
+  pNew->signature = pNew;
+  pNew->cmd.command = TSDB_SQL_MULTI_META;
+  pNew->cmd.count = numOfMeters;
+
+  if (TSDB_CODE_SUCCESS != tscAllocPayload(&pNew->cmd, len + TSDB_DEFAULT_PAYLOAD_SIZE)) {
+    tscError("%p malloc failed for payload to get multi meter meta", pSql);
+    free(pNew);
+    return TSDB_CODE_CLI_OUT_OF_MEMORY;
+  }
+
+  tscAddEmptyMeterMetaInfo(&pNew->cmd);
+
+  memcpy(pNew->cmd.payload, meterIdList, len);
+  pNew->cmd.payload[len] = 0;
+  pNew->cmd.payloadLen = len + 1;
+  tscTrace("%p new pSqlObj:%p to get %d meter metas in batch", pSql, pNew, numOfMeters);
+
+  if (pSql->fp == NULL) {
+    tsem_init(&pNew->rspSem, 0, 0);
+    tsem_init(&pNew->emptyRspSem, 0, 1);
+
+    code = tscProcessSql(pNew);
+    tscTrace("%p get multi meter meta complete, code:%d, numOfMeters:%d", pSql, code, pNew->res.numOfTotal);
+    tscFreeSqlObj(pNew);
+  } else {
+    pNew->fp = tscMeterMetaCallBack;
+    pNew->param = pSql;
+    pNew->sqlstr = strdup(pSql->sqlstr);
+
+    code = tscProcessSql(pNew);
+    if (code == TSDB_CODE_SUCCESS) {
+      code = TSDB_CODE_ACTION_IN_PROGRESS;
+    }
+  }
+
+  return code;
+}
+
 /*
  * in handling the renew metermeta problem during insertion,
  *
@@ -3797,6 +4145,7 @@ void tscInitMsgs() {
   tscProcessMsgRsp[TSDB_SQL_FETCH] = tscProcessRetrieveRspFromVnode;
 
   tscProcessMsgRsp[TSDB_SQL_DROP_DB] = tscProcessDropDbRsp;
+  tscProcessMsgRsp[TSDB_SQL_CREATE_TABLE] = tscProcessCreateTableRsp;
   tscProcessMsgRsp[TSDB_SQL_DROP_TABLE] = tscProcessDropTableRsp;
   tscProcessMsgRsp[TSDB_SQL_CONNECT] = tscProcessConnectRsp;
   tscProcessMsgRsp[TSDB_SQL_USE_DB] = tscProcessUseDbRsp;
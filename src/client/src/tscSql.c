@@ -88,6 +88,7 @@ TAOS *taos_connect_imp(const char *ip, const char *user, const char *pass, const
   
   memset(pObj, 0, sizeof(STscObj));
   pObj->signature = pObj;
+  pObj->queryParallelism = (int16_t)tsQueryParallelism;
 
   strncpy(pObj->user, user, TSDB_USER_LEN);
   taosEncryptPass((uint8_t *)pass, strlen(pass), pObj->pass);
@@ -667,6 +668,49 @@ int taos_fetch_block(TAOS_RES *res, TAOS_ROW *rows) {
   return nRows;
 }
 
+static void doReverseColumn(char *data, int32_t bytes, int32_t numOfRows) {
+  char *p = data;
+  char *q = data + (numOfRows - 1) * bytes;
+
+  for (; p < q; p += bytes, q -= bytes) {
+    for (int32_t i = 0; i < bytes; ++i) {
+      char t = p[i];
+      p[i] = q[i];
+      q[i] = t;
+    }
+  }
+}
+
+/*
+ * the block is retrieved as taos_fetch_block does, but the values of each field are returned in the order of query,
+ * and the return value is always the number of rows
+ */
+int taos_fetch_columns(TAOS_RES *res, void **columns) {
+  TAOS_ROW rows = NULL;
+
+  int nRows = taos_fetch_block(res, &rows);
+  if (rows == NULL) return 0;
+
+  SSqlObj *pSql = (SSqlObj *)res;
+  SSqlCmd *pCmd = &pSql->cmd;
+  SSqlRes *pRes = &pSql->res;
+
+  // rows of a descending query are kept in reverse order in block, and rows[i] points to the last one of them
+  bool reversed = (nRows > 0);
+  nRows = abs(nRows);
+
+  for (int i = 0; i < pCmd->fieldsInfo.numOfOutputCols; ++i) {
+    char *data = rows[i];
+    if (reversed) {
+      data -= pRes->bytes[i] * (nRows - 1);
+      doReverseColumn(data, pRes->bytes[i], nRows);
+    }
+    columns[i] = data;
+  }
+
+  return nRows;
+}
+
 int taos_select_db(TAOS *taos, const char *db) {
   char sql[64];
 
@@ -681,6 +725,25 @@ int taos_select_db(TAOS *taos, const char *db) {
   return taos_query(taos, sql);
 }
 
+int taos_set_query_parallelism(TAOS *taos, int parallelism) {
+  STscObj *pObj = (STscObj *)taos;
+  if (pObj == NULL || pObj->signature != pObj) {
+    globalCode = TSDB_CODE_DISCONNECTED;
+    return TSDB_CODE_DISCONNECTED;
+  }
+
+  // the same range as the queryParallelism option, the dnode limits it further by its own value
+  if (parallelism < 1 || parallelism > 64) {
+    tscError("invalid query parallelism:%d, it shall be in [1, 64]", parallelism);
+    return TSDB_CODE_INVALID_VALUE;
+  }
+
+  pObj->queryParallelism = (int16_t)parallelism;
+  tscTrace("%p query parallelism is set to %d", pObj, parallelism);
+
+  return TSDB_CODE_SUCCESS;
+}
+
 void taos_free_result(TAOS_RES *res) {
   if (res == NULL) return;
 
@@ -0,0 +1,823 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "os.h"
+#include "shash.h"
+#include "tlog.h"
+#include "tscSqlCache.h"
+#include "tscUtil.h"
+#include "tschemautil.h"
+#include "tsqldef.h"
+#include "tstoken.h"
+#include "ttime.h"
+#include "ttypes.h"
+
+#define TSC_SQL_CACHE_MAX_SLOTS 64
+#define TSC_SQL_CACHE_STAT_INTERVAL 1000
+
+enum {
+  TSC_SLOT_CMP = 1,  // column optr literal
+  TSC_SLOT_LIMIT,
+  TSC_SLOT_OFFSET,
+  TSC_SLOT_SLIMIT,
+  TSC_SLOT_SOFFSET,
+};
+
+enum {
+  TSC_BIND_TIME = 1,  // literal of the primary timestamp column, bound again on each hit
+  TSC_BIND_EXACT,     // literal of other columns, a hit requires the same literal
+  TSC_BIND_VALUE,     // limit/offset value
+};
+
+typedef struct SSqlStmtSlot {
+  int8_t    type;
+  int16_t   optr;     // comparison operator of TSC_SLOT_CMP
+  int16_t   valType;  // TK_INTEGER, TK_FLOAT, TK_STRING, TK_BOOL or TK_NOW
+  int16_t   nowOptr;  // TK_PLUS/TK_MINUS if a duration is added to now, 0 otherwise
+  SSQLToken col;
+  SSQLToken val;       // the literal, including its sign
+  SSQLToken duration;  // duration added to now
+  SSQLToken text;      // the whole literal text
+} SSqlStmtSlot;
+
+typedef struct SSqlStmtKey {
+  int64_t      startTime;
+  char *       sql;  // private copy of the sql string, all tokens point to it
+  char *       key;
+  int32_t      numOfSlots;
+  int32_t      numOfOperands;
+  SSqlStmtSlot slots[TSC_SQL_CACHE_MAX_SLOTS];
+  SSQLToken    operands[TSC_SQL_CACHE_MAX_SLOTS];  // columns in expressions that are not a slot
+} SSqlStmtKey;
+
+typedef struct SSqlCacheSlot {
+  int8_t bind;
+  char * text;  // literal of TSC_BIND_EXACT
+} SSqlCacheSlot;
+
+typedef struct SSqlCacheEntry {
+  char *                 key;
+  struct SSqlCacheEntry *prev;
+  struct SSqlCacheEntry *next;
+
+  int32_t        numOfSlots;
+  SSqlCacheSlot *slots;
+
+  char     name[TSDB_METER_ID_LEN + 1];
+  uint64_t uid;
+  int16_t  sversion;
+  int16_t  numOfColumns;
+  int16_t  numOfTags;  // of the meter meta
+  int16_t  numOfQueriedTags;
+  int16_t  tagColumnIndex[TSDB_MAX_TAGS];
+  int64_t  parseTime;
+  SSqlCmd  cmd;
+} SSqlCacheEntry;
+
+typedef struct SSqlCache {
+  pthread_mutex_t mutex;
+  void *          pHash;
+  SSqlCacheEntry *pHead;  // most recently used
+  SSqlCacheEntry *pTail;
+  int32_t         numOfEntries;
+  int32_t         maxEntries;
+
+  int64_t hits;
+  int64_t misses;
+  int64_t savedTime;  // parse time saved by hits, in microsecond
+} SSqlCache;
+
+static SSqlCache *pSqlCache = NULL;
+
+static bool tscIsCompareOptr(uint32_t type) {
+  return type == TK_LT || type == TK_LE || type == TK_GT || type == TK_GE || type == TK_EQ || type == TK_NE;
+}
+
+static bool tscIsOperatorToken(uint32_t type) { return type >= TK_EQ && type <= TK_BITNOT; }
+
+static void tscCopyCachedSqlCmd(SSqlCmd *dst, SSqlCmd *src) {
+  *dst = *src;
+
+  tscColumnBaseInfoCopy(&dst->colList, &src->colList, -1);
+  tscFieldInfoCopyAll(&src->fieldsInfo, &dst->fieldsInfo);
+  tscTagCondCopy(&dst->tagCond, &src->tagCond);
+
+  if (src->exprsInfo.numOfAlloc > 0) {
+    dst->exprsInfo.pExprs = malloc(sizeof(SSqlExpr) * src->exprsInfo.numOfAlloc);
+    memcpy(dst->exprsInfo.pExprs, src->exprsInfo.pExprs, sizeof(SSqlExpr) * src->exprsInfo.numOfAlloc);
+
+    for (int32_t i = 0; i < src->exprsInfo.numOfExprs; ++i) {
+      for (int32_t j = 0; j < src->exprsInfo.pExprs[i].numOfParams; ++j) {
+        tVariantAssign(&dst->exprsInfo.pExprs[i].param[j], &src->exprsInfo.pExprs[i].param[j]);
+      }
+    }
+  }
+}
+
+static void tscFreeCachedSqlCmd(SSqlCmd *pCmd) {
+  for (int32_t i = 0; i < pCmd->exprsInfo.numOfExprs; ++i) {
+    for (int32_t j = 0; j < pCmd->exprsInfo.pExprs[i].numOfParams; ++j) {
+      tVariantDestroy(&pCmd->exprsInfo.pExprs[i].param[j]);
+    }
+  }
+
+  tscFreeSqlCmdData(pCmd);
+}
+
+static void tscFreeSqlCacheEntry(SSqlCacheEntry *pEntry) {
+  for (int32_t i = 0; i < pEntry->numOfSlots; ++i) {
+    tfree(pEntry->slots[i].text);
+  }
+
+  tscFreeCachedSqlCmd(&pEntry->cmd);
+  tfree(pEntry->slots);
+  tfree(pEntry->key);
+  free(pEntry);
+}
+
+static void tscUnlinkSqlCacheEntry(SSqlCacheEntry *pEntry) {
+  if (pEntry->prev != NULL) {
+    pEntry->prev->next = pEntry->next;
+  } else {
+    pSqlCache->pHead = pEntry->next;
+  }
+
+  if (pEntry->next != NULL) {
+    pEntry->next->prev = pEntry->prev;
+  } else {
+    pSqlCache->pTail = pEntry->prev;
+  }
+
+  pEntry->prev = NULL;
+  pEntry->next = NULL;
+}
+
+static void tscLinkSqlCacheEntry(SSqlCacheEntry *pEntry) {
+  pEntry->prev = NULL;
+  pEntry->next = pSqlCache->pHead;
+
+  if (pSqlCache->pHead != NULL) {
+    pSqlCache->pHead->prev = pEntry;
+  } else {
+    pSqlCache->pTail = pEntry;
+  }
+
+  pSqlCache->pHead = pEntry;
+}
+
+static void tscRemoveSqlCacheEntry(SSqlCacheEntry *pEntry) {
+  tscUnlinkSqlCacheEntry(pEntry);
+  taosDeleteStrHash(pSqlCache->pHash, pEntry->key);
+
+  pSqlCache->numOfEntries -= 1;
+  tscFreeSqlCacheEntry(pEntry);
+}
+
+static SSqlCacheEntry *tscGetSqlCacheEntry(char *key) {
+  SSqlCacheEntry **ppEntry = (SSqlCacheEntry **)taosGetStrHashData(pSqlCache->pHash, key);
+  return (ppEntry == NULL) ? NULL : *ppEntry;
+}
+
+static void tscUpdateSqlCacheStat(bool hit, int64_t savedTime) {
+  if (hit) {
+    pSqlCache->hits += 1;
+    pSqlCache->savedTime += savedTime;
+  } else {
+    pSqlCache->misses += 1;
+  }
+
+  int64_t total = pSqlCache->hits + pSqlCache->misses;
+  if (total % TSC_SQL_CACHE_STAT_INTERVAL == 0) {
+    tscPrint("sql cache, entries:%d hits:%lld misses:%lld hit rate:%.2f%% parse time saved:%lldus",
+             pSqlCache->numOfEntries, pSqlCache->hits, pSqlCache->misses, pSqlCache->hits * 100.0 / total,
+             pSqlCache->savedTime);
+  }
+}
+
+void tscInitSqlCache(int32_t maxEntries) {
+  if (pSqlCache != NULL || maxEntries <= 0) {
+    return;
+  }
+
+  SSqlCache *pCache = calloc(1, sizeof(SSqlCache));
+  if (pCache == NULL) {
+    return;
+  }
+
+  pCache->pHash = taosInitStrHash(maxEntries, POINTER_BYTES, taosHashStringStep1);
+  if (pCache->pHash == NULL) {
+    free(pCache);
+    return;
+  }
+
+  pthread_mutex_init(&pCache->mutex, NULL);
+  pCache->maxEntries = maxEntries;
+  pSqlCache = pCache;
+
+  tscTrace("sql cache is initialized, max entries:%d", maxEntries);
+}
+
+void tscClearSqlCache() {
+  if (pSqlCache == NULL) {
+    return;
+  }
+
+  pthread_mutex_lock(&pSqlCache->mutex);
+
+  while (pSqlCache->pHead != NULL) {
+    tscRemoveSqlCacheEntry(pSqlCache->pHead);
+  }
+
+  tscPrint("sql cache is cleared, hits:%lld misses:%lld parse time saved:%lldus",
+           pSqlCache->hits, pSqlCache->misses, pSqlCache->savedTime);
+
+  pthread_mutex_unlock(&pSqlCache->mutex);
+}
+
+static int32_t tscGetStmtTokens(char *sql, SSQLToken **pTokens) {
+  int32_t    numOfAlloc = 64;
+  int32_t    num = 0;
+  SSQLToken *tokens = malloc(sizeof(SSQLToken) * numOfAlloc);
+
+  for (int32_t i = 0; sql[i] != 0;) {
+    SSQLToken t = {.z = &sql[i]};
+    t.n = tSQLGetToken(&sql[i], &t.type);
+    i += t.n;
+
+    if (t.type == TK_SPACE || t.type == TK_COMMENT) {
+      continue;
+    } else if (t.type == TK_SEMI) {
+      break;
+    } else if (t.type == TK_ILLEGAL) {
+      free(tokens);
+      return -1;
+    }
+
+    if (num >= numOfAlloc) {
+      numOfAlloc <<= 1;
+      tokens = realloc(tokens, sizeof(SSQLToken) * numOfAlloc);
+    }
+
+    tokens[num++] = t;
+  }
+
+  *pTokens = tokens;
+  return num;
+}
+
+/*
+ * literal of the comparison slot: [+|-] integer/float, string, bool, now [+|- duration]
+ * the literal should not be an operand of other operators
+ */
+static int32_t tscGetStmtLiteral(SSQLToken *tokens, int32_t num, int32_t index, SSqlStmtSlot *pSlot) {
+  SSQLToken *t = &tokens[index];
+  int32_t    len = 0;
+
+  if (t[0].type == TK_INTEGER || t[0].type == TK_FLOAT || t[0].type == TK_STRING || t[0].type == TK_BOOL) {
+    pSlot->valType = t[0].type;
+    pSlot->val = t[0];
+    len = 1;
+  } else if ((t[0].type == TK_MINUS || t[0].type == TK_PLUS) && index + 1 < num &&
+             (t[1].type == TK_INTEGER || t[1].type == TK_FLOAT)) {
+    pSlot->valType = t[1].type;
+    pSlot->val = t[0];
+    pSlot->val.n += t[1].n;
+    len = 2;
+  } else if (t[0].type == TK_NOW) {
+    pSlot->valType = TK_NOW;
+    pSlot->val = t[0];
+    len = 1;
+
+    if (index + 2 < num && (t[1].type == TK_PLUS || t[1].type == TK_MINUS) && t[2].type == TK_VARIABLE) {
+      pSlot->nowOptr = t[1].type;
+      pSlot->duration = t[2];
+      len = 3;
+    }
+  } else {
+    return 0;
+  }
+
+  if (index + len < num && tscIsOperatorToken(t[len].type)) {
+    return 0;
+  }
+
+  pSlot->text.z = t[0].z;
+  pSlot->text.n = (t[len - 1].z + t[len - 1].n) - t[0].z;
+  return len;
+}
+
+static int8_t tscGetLimitSlotType(SSQLToken *tokens, int32_t num, int32_t index) {
+  uint32_t prev = tokens[index - 1].type;
+
+  if (prev == TK_LIMIT || prev == TK_SLIMIT) {
+    bool isOffset = (index + 1 < num && tokens[index + 1].type == TK_COMMA);  // limit offset, limit
+    if (prev == TK_LIMIT) {
+      return isOffset ? TSC_SLOT_OFFSET : TSC_SLOT_LIMIT;
+    } else {
+      return isOffset ? TSC_SLOT_SOFFSET : TSC_SLOT_SLIMIT;
+    }
+  } else if (prev == TK_OFFSET) {
+    return TSC_SLOT_OFFSET;
+  } else if (prev == TK_SOFFSET) {
+    return TSC_SLOT_SOFFSET;
+  } else if (prev == TK_COMMA && index >= 3 && tokens[index - 2].type == TK_INTEGER) {
+    if (tokens[index - 3].type == TK_LIMIT) {
+      return TSC_SLOT_LIMIT;
+    } else if (tokens[index - 3].type == TK_SLIMIT) {
+      return TSC_SLOT_SLIMIT;
+    }
+  }
+
+  return 0;
+}
+
+static bool tscAddStmtSlot(SSqlStmtKey *pKey, SSqlStmtSlot *pSlot) {
+  if (pKey->numOfSlots >= TSC_SQL_CACHE_MAX_SLOTS) {
+    return false;
+  }
+
+  pKey->slots[pKey->numOfSlots++] = *pSlot;
+  return true;
+}
+
+SSqlStmtKey *tscBuildSqlStmtKey(SSqlObj *pSql, const char *acct, const char *db) {
+  if (pSqlCache == NULL || pSql->pStream != NULL || pSql->sqlstr == NULL) {
+    return NULL;
+  }
+
+  // slots are filled in order, so they are not cleared
+  SSqlStmtKey *pKey = malloc(sizeof(SSqlStmtKey));
+  pKey->startTime = taosGetTimestampUs();
+  pKey->sql = strdup(pSql->sqlstr);
+  pKey->key = NULL;
+  pKey->numOfSlots = 0;
+  pKey->numOfOperands = 0;
+
+  SSQLToken *tokens = NULL;
+  int32_t    num = tscGetStmtTokens(pKey->sql, &tokens);
+  if (num <= 0 || tokens[0].type != TK_SELECT) {
+    goto _not_cached;
+  }
+
+  pKey->key = malloc(strlen(acct) + strlen(db) + strlen(pKey->sql) * 2 + 4);
+  char *p = pKey->key + sprintf(pKey->key, "%s %s\n", acct, db);
+
+  for (int32_t i = 0; i < num; ++i) {
+    SSQLToken *t = &tokens[i];
+    uint32_t   prev = (i > 0) ? tokens[i - 1].type : 0;
+
+    if (i > 0) {
+      *p++ = ' ';
+    }
+
+    // the value of now differs in each execution
+    if (t->type == TK_NOW) {
+      goto _not_cached;
+    }
+
+    if (t->type == TK_INTEGER && i > 0) {
+      SSqlStmtSlot slot = {.type = tscGetLimitSlotType(tokens, num, i), .val = *t, .text = *t};
+
+      if (slot.type != 0) {
+        if (!tscAddStmtSlot(pKey, &slot)) {
+          goto _not_cached;
+        }
+
+        *p++ = '?';
+        continue;
+      }
+    }
+
+    memcpy(p, t->z, t->n);
+    p += t->n;
+
+    if (t->type != TK_ID) {
+      continue;
+    }
+
+    if ((prev == TK_WHERE || prev == TK_AND || prev == TK_OR || prev == TK_LP) && i + 2 < num &&
+        tscIsCompareOptr(tokens[i + 1].type)) {
+      SSqlStmtSlot slot = {.type = TSC_SLOT_CMP, .optr = tokens[i + 1].type, .col = *t};
+
+      int32_t len = tscGetStmtLiteral(tokens, num, i + 2, &slot);
+      if (len > 0) {
+        if (!tscAddStmtSlot(pKey, &slot)) {
+          goto _not_cached;
+        }
+
+        *p++ = ' ';
+        memcpy(p, tokens[i + 1].z, tokens[i + 1].n);
+        p += tokens[i + 1].n;
+        *p++ = ' ';
+        *p++ = '?';
+        i += (1 + len);
+        continue;
+      }
+    }
+
+    // the column is an operand of an expression, it should not be the primary timestamp column
+    if (tscIsOperatorToken(prev) || (i + 1 < num && tscIsOperatorToken(tokens[i + 1].type))) {
+      if (pKey->numOfOperands >= TSC_SQL_CACHE_MAX_SLOTS) {
+        goto _not_cached;
+      }
+
+      pKey->operands[pKey->numOfOperands++] = *t;
+    }
+  }
+
+  *p = 0;
+  free(tokens);
+  return pKey;
+
+_not_cached:
+  tfree(tokens);
+  tscFreeSqlStmtKey(pKey);
+  return NULL;
+}
+
+void tscFreeSqlStmtKey(SSqlStmtKey *pKey) {
+  if (pKey == NULL) {
+    return;
+  }
+
+  tfree(pKey->sql);
+  tfree(pKey->key);
+  free(pKey);
+}
+
+static bool tscIsPrimaryTimestampColumn(SSQLToken *pToken, SMeterMeta *pMeterMeta) {
+  SSchema *pSchema = tsGetSchema(pMeterMeta);
+
+  // see doGetColumnIndexByName
+  if (pToken->n == 3 && strncasecmp(pToken->z, "_c0", 3) == 0) {
+    return true;
+  }
+
+  return pToken->n == strlen(pSchema[0].name) && strncasecmp(pSchema[0].name, pToken->z, pToken->n) == 0;
+}
+
+static bool tscIsSqlCmdCacheable(SSqlObj *pSql) {
+  SSqlCmd *pCmd = &pSql->cmd;
+
+  if (pCmd->command != TSDB_SQL_SELECT || pCmd->numOfTables != 1 || QUERY_IS_JOIN_QUERY(pCmd->type) ||
+      pCmd->interpoType != TSDB_INTERPO_NONE || pCmd->tsBuf != NULL || pCmd->pDataBlocks != NULL) {
+    return false;
+  }
+
+  if (tscIsTWAQuery(pCmd) || tscIsPointInterpQuery(pCmd)) {
+    return false;
+  }
+
+  return tscGetMeterMetaInfo(pCmd, 0)->pMeterMeta != NULL;
+}
+
+void tscAddSqlCmdIntoCache(SSqlObj *pSql, SSqlStmtKey *pKey, int64_t parseTime) {
+  if (pSqlCache == NULL || pKey == NULL || !tscIsSqlCmdCacheable(pSql)) {
+    return;
+  }
+
+  SSqlCmd *       pCmd = &pSql->cmd;
+  SMeterMetaInfo *pMeterMetaInfo = tscGetMeterMetaInfo(pCmd, 0);
+  SMeterMeta *    pMeterMeta = pMeterMetaInfo->pMeterMeta;
+
+  for (int32_t i = 0; i < pKey->numOfOperands; ++i) {
+    if (tscIsPrimaryTimestampColumn(&pKey->operands[i], pMeterMeta)) {
+      return;
+    }
+  }
+
+  SSqlCacheSlot *slots = calloc(pKey->numOfSlots + 1, sizeof(SSqlCacheSlot));
+  for (int32_t i = 0; i < pKey->numOfSlots; ++i) {
+    SSqlStmtSlot *pSlot = &pKey->slots[i];
+
+    if (pSlot->type != TSC_SLOT_CMP) {
+      slots[i].bind = TSC_BIND_VALUE;
+    } else if (tscIsPrimaryTimestampColumn(&pSlot->col, pMeterMeta) && pSlot->optr != TK_NE &&
+               pSlot->valType != TK_BOOL) {
+      slots[i].bind = TSC_BIND_TIME;
+    } else if (pSlot->valType != TK_NOW) {
+      slots[i].bind = TSC_BIND_EXACT;
+      slots[i].text = strndup(pSlot->text.z, pSlot->text.n);
+    } else {  // now compared with other columns
+      for (int32_t j = 0; j < i; ++j) {
+        tfree(slots[j].text);
+      }
+
+      free(slots);
+      return;
+    }
+  }
+
+  SSqlCacheEntry *pEntry = calloc(1, sizeof(SSqlCacheEntry));
+  pEntry->key = strdup(pKey->key);
+  pEntry->numOfSlots = pKey->numOfSlots;
+  pEntry->slots = slots;
+
+  strcpy(pEntry->name, pMeterMetaInfo->name);
+  pEntry->uid = pMeterMeta->uid;
+  pEntry->sversion = pMeterMeta->sversion;
+  pEntry->numOfColumns = pMeterMeta->numOfColumns;
+  pEntry->numOfTags = pMeterMeta->numOfTags;
+  pEntry->numOfQueriedTags = pMeterMetaInfo->numOfTags;
+  memcpy(pEntry->tagColumnIndex, pMeterMetaInfo->tagColumnIndex, sizeof(pEntry->tagColumnIndex));
+  pEntry->parseTime = parseTime;
+
+  tscCopyCachedSqlCmd(&pEntry->cmd, pCmd);
+  pEntry->cmd.payload = NULL;
+  pEntry->cmd.allocSize = 0;
+  pEntry->cmd.pMeterInfo = NULL;
+  pEntry->cmd.numOfTables = 0;
+
+  pthread_mutex_lock(&pSqlCache->mutex);
+
+  SSqlCacheEntry *pOld = tscGetSqlCacheEntry(pEntry->key);
+  if (pOld != NULL) {
+    tscRemoveSqlCacheEntry(pOld);
+  }
+
+  while (pSqlCache->numOfEntries >= pSqlCache->maxEntries && pSqlCache->pTail != NULL) {
+    tscRemoveSqlCacheEntry(pSqlCache->pTail);
+  }
+
+  taosAddStrHash(pSqlCache->pHash, pEntry->key, (char *)&pEntry);
+  tscLinkSqlCacheEntry(pEntry);
+  pSqlCache->numOfEntries += 1;
+
+  pthread_mutex_unlock(&pSqlCache->mutex);
+
+  tscTrace("%p sql cmd is kept in sql cache, slots:%d parse time:%lldus", pSql, pKey->numOfSlots, parseTime);
+}
+
+static bool tscIsSqlCacheEntryMatched(SSqlCacheEntry *pEntry, SSqlStmtKey *pKey) {
+  if (pEntry->numOfSlots != pKey->numOfSlots) {
+    return false;
+  }
+
+  for (int32_t i = 0; i < pKey->numOfSlots; ++i) {
+    SSqlStmtSlot *pSlot = &pKey->slots[i];
+    if (pEntry->slots[i].bind != TSC_BIND_EXACT) {
+      continue;
+    }
+
+    if (strlen(pEntry->slots[i].text) != pSlot->text.n ||
+        strncmp(pEntry->slots[i].text, pSlot->text.z, pSlot->text.n) != 0) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static tSQLExpr *tscCreateSlotExpr(SSqlStmtSlot *pSlot) {
+  SSQLToken val = pSlot->val;
+  val.type = pSlot->valType;
+
+  if (pSlot->valType != TK_NOW) {
+    return tSQLExprIdValueCreate(&val, pSlot->valType);
+  }
+
+  tSQLExpr *pExpr = tSQLExprIdValueCreate(&val, TK_NOW);
+  if (pSlot->nowOptr != 0) {
+    SSQLToken duration = pSlot->duration;
+    pExpr = tSQLExprCreate(pExpr, tSQLExprIdValueCreate(&duration, TK_VARIABLE), pSlot->nowOptr);
+  }
+
+  return pExpr;
+}
+
+static int32_t tscBindSqlCmdSlots(SSqlCmd *pCmd, int8_t *binds, SSqlStmtKey *pKey) {
+  SMeterMeta *pMeterMeta = tscGetMeterMetaInfo(pCmd, 0)->pMeterMeta;
+
+  TSKEY stime = 0;
+  TSKEY etime = INT64_MAX;
+  bool  timeBound = false;
+
+  for (int32_t i = 0; i < pKey->numOfSlots; ++i) {
+    SSqlStmtSlot *pSlot = &pKey->slots[i];
+
+    if (binds[i] == TSC_BIND_TIME) {
+      TSKEY     skey = 0;
+      TSKEY     ekey = INT64_MAX;
+      tSQLExpr *pExpr = tscCreateSlotExpr(pSlot);
+
+      int32_t ret = getTimeRange(&skey, &ekey, pExpr, pSlot->optr, pMeterMeta->precision);
+      tSQLExprDestroy(pExpr);
+
+      if (ret != TSDB_CODE_SUCCESS) {
+        return ret;
+      }
+
+      stime = (stime < skey) ? skey : stime;
+      etime = (etime > ekey) ? ekey : etime;
+      timeBound = true;
+    } else if (binds[i] == TSC_BIND_VALUE) {
+      int64_t val = strtol(pSlot->val.z, NULL, 10);
+
+      if (pSlot->type == TSC_SLOT_LIMIT) {
+        pCmd->limit.limit = val;
+      } else if (pSlot->type == TSC_SLOT_OFFSET) {
+        pCmd->limit.offset = val;
+      } else if (pSlot->type == TSC_SLOT_SLIMIT) {
+        pCmd->slimit.limit = val;
+      } else {
+        pCmd->slimit.offset = val;
+      }
+    }
+  }
+
+  if (timeBound) {
+    pCmd->stime = stime;
+    pCmd->etime = etime;
+
+    if (pMeterMeta->precision == TSDB_TIME_PRECISION_MILLI) {
+      pCmd->stime = pCmd->stime / 1000;
+      pCmd->etime = pCmd->etime / 1000;
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static bool tscMissSqlCache(SSqlObj *pSql) {
+  SSqlCmd *pCmd = &pSql->cmd;
+
+  for (int32_t i = 0; i < pCmd->exprsInfo.numOfExprs; ++i) {
+    for (int32_t j = 0; j < pCmd->exprsInfo.pExprs[i].numOfParams; ++j) {
+      tVariantDestroy(&pCmd->exprsInfo.pExprs[i].param[j]);
+    }
+  }
+
+  tscRemoveAllMeterMetaInfo(pCmd, false);
+  tscCleanSqlCmd(pCmd);
+
+  pthread_mutex_lock(&pSqlCache->mutex);
+  tscUpdateSqlCacheStat(false, 0);
+  pthread_mutex_unlock(&pSqlCache->mutex);
+
+  return false;
+}
+
+/*
+ * the rest of the checks in parseLimitClause, which depend on the limit values or the meta data
+ */
+static int32_t tscCheckCachedLimit(SSqlObj *pSql, bool *valid) {
+  SSqlCmd *       pCmd = &pSql->cmd;
+  SMeterMetaInfo *pMeterMetaInfo = tscGetMeterMetaInfo(pCmd, 0);
+
+  *valid = false;
+  if (pCmd->limit.limit == 0) {
+    pCmd->command = TSDB_SQL_RETRIEVE_EMPTY_RESULT;
+  }
+
+  if (!UTIL_METER_IS_METRIC(pMeterMetaInfo)) {
+    *valid = (pCmd->slimit.limit == -1 && pCmd->slimit.offset == 0);
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (tscProjectionQueryOnMetric(pCmd) && (pCmd->slimit.limit > 0 || pCmd->slimit.offset > 0)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  *valid = true;
+  if (pCmd->slimit.limit == 0) {
+    pCmd->command = TSDB_SQL_RETRIEVE_EMPTY_RESULT;
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t code = tscGetMetricMeta(pSql);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  SMetricMeta *pMetricMeta = pMeterMetaInfo->pMetricMeta;
+  if (pMeterMetaInfo->pMeterMeta == NULL || pMetricMeta == NULL || pMetricMeta->numOfMeters == 0) {
+    tscTrace("%p no table in metricmeta, no output result", pSql);
+    pCmd->command = TSDB_SQL_RETRIEVE_EMPTY_RESULT;
+  }
+
+  pCmd->globalLimit = pCmd->limit.limit;
+  return TSDB_CODE_SUCCESS;
+}
+
+bool tscGetSqlCmdFromCache(SSqlObj *pSql, SSqlStmtKey *pKey, int32_t *code) {
+  SSqlCmd *pCmd = &pSql->cmd;
+  if (pSqlCache == NULL || pKey == NULL) {
+    return false;
+  }
+
+  pthread_mutex_lock(&pSqlCache->mutex);
+
+  SSqlCacheEntry *pEntry = tscGetSqlCacheEntry(pKey->key);
+  if (pEntry == NULL || !tscIsSqlCacheEntryMatched(pEntry, pKey)) {
+    tscUpdateSqlCacheStat(false, 0);
+    pthread_mutex_unlock(&pSqlCache->mutex);
+    return false;
+  }
+
+  tscUnlinkSqlCacheEntry(pEntry);
+  tscLinkSqlCacheEntry(pEntry);
+
+  // the entry may be removed by others once the lock is released
+  SSqlCacheEntry entry = *pEntry;
+  tscCopyCachedSqlCmd(&entry.cmd, &pEntry->cmd);
+
+  int8_t binds[TSC_SQL_CACHE_MAX_SLOTS] = {0};
+  for (int32_t i = 0; i < pEntry->numOfSlots; ++i) {
+    binds[i] = pEntry->slots[i].bind;
+  }
+
+  pthread_mutex_unlock(&pSqlCache->mutex);
+
+  SMeterMetaInfo *pMeterMetaInfo = tscAddEmptyMeterMetaInfo(pCmd);
+  strcpy(pMeterMetaInfo->name, entry.name);
+
+  int32_t ret = tscGetMeterMeta(pSql, pMeterMetaInfo->name, 0);
+  if (ret == TSDB_CODE_ACTION_IN_PROGRESS) {  // the statement is parsed again once the meter meta is retrieved
+    tscFreeCachedSqlCmd(&entry.cmd);
+
+    *code = ret;
+    return true;
+  }
+
+  SMeterMeta *pMeterMeta = pMeterMetaInfo->pMeterMeta;
+  if (ret != TSDB_CODE_SUCCESS || pMeterMeta == NULL) {
+    tscFreeCachedSqlCmd(&entry.cmd);
+    return tscMissSqlCache(pSql);
+  }
+
+  if (pMeterMeta->uid != entry.uid || pMeterMeta->sversion != entry.sversion ||
+      pMeterMeta->numOfColumns != entry.numOfColumns || pMeterMeta->numOfTags != entry.numOfTags) {
+    tscTrace("%p meter:%s is changed, sversion:%d cached sversion:%d, remove cached sql cmd", pSql, entry.name,
+             pMeterMeta->sversion, entry.sversion);
+
+    pthread_mutex_lock(&pSqlCache->mutex);
+    pEntry = tscGetSqlCacheEntry(pKey->key);
+    if (pEntry != NULL && pEntry->uid == entry.uid && pEntry->sversion == entry.sversion) {
+      tscRemoveSqlCacheEntry(pEntry);
+    }
+    pthread_mutex_unlock(&pSqlCache->mutex);
+
+    tscFreeCachedSqlCmd(&entry.cmd);
+    return tscMissSqlCache(pSql);
+  }
+
+  // restore the plan, the payload and the meter meta of current sql object are kept
+  uint32_t         allocSize = pCmd->allocSize;
+  char *           payload = pCmd->payload;
+  SMeterMetaInfo **pMeterInfo = pCmd->pMeterInfo;
+  int16_t          numOfTables = pCmd->numOfTables;
+
+  *pCmd = entry.cmd;
+  pCmd->allocSize = allocSize;
+  pCmd->payload = payload;
+  pCmd->pMeterInfo = pMeterInfo;
+  pCmd->numOfTables = numOfTables;
+
+  pMeterMetaInfo->numOfTags = entry.numOfQueriedTags;
+  memcpy(pMeterMetaInfo->tagColumnIndex, entry.tagColumnIndex, sizeof(entry.tagColumnIndex));
+
+  ret = tscBindSqlCmdSlots(pCmd, binds, pKey);
+
+  if (ret != TSDB_CODE_SUCCESS) {  // let the parser report the error
+    return tscMissSqlCache(pSql);
+  }
+
+  // no result due to invalid query time range
+  if (pCmd->stime > pCmd->etime) {
+    pCmd->command = TSDB_SQL_RETRIEVE_EMPTY_RESULT;
+  } else {
+    bool valid = false;
+    ret = tscCheckCachedLimit(pSql, &valid);
+
+    if (ret == TSDB_CODE_SUCCESS && !valid) {
+      return tscMissSqlCache(pSql);
+    }
+  }
+
+  *code = ret;
+  if (ret == TSDB_CODE_ACTION_IN_PROGRESS) {  // parsed again once the metric meta is retrieved
+    return true;
+  }
+
+  int64_t elapsed = taosGetTimestampUs() - pKey->startTime;
+
+  pthread_mutex_lock(&pSqlCache->mutex);
+  tscUpdateSqlCacheStat(true, entry.parseTime - elapsed);
+  pthread_mutex_unlock(&pSqlCache->mutex);
+
+  tscTrace("%p sql cmd is retrieved from sql cache, bind slots:%d elapsed:%lldus, parse time:%lldus",
+           pSql, pKey->numOfSlots, elapsed, entry.parseTime);
+  return true;
+}
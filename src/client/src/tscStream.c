@@ -118,6 +118,10 @@ static void tscProcessStreamTimer(void *handle, void *tmrId) {
     if (pSql->cmd.etime > pStream->etime) {
       pSql->cmd.etime = pStream->etime;
     }
+  } else if (pStream->numOfPanes > 0 && pStream->paneEnd == pStream->stime - pStream->slidingTime) {
+    // results of the previous panes of this window are kept, only query the newest pane
+    pSql->cmd.stime = pStream->stime - pStream->slidingTime;
+    pSql->cmd.etime = pStream->stime - 1;
   } else {
     pSql->cmd.stime = pStream->stime - pStream->interval;
     pSql->cmd.etime = pStream->stime - 1;
@@ -162,6 +166,201 @@ static void tscSetTimestampForRes(SSqlStream *pStream, SSqlObj *pSql) {
   }
 }
 
+/*
+ * The window of interval slides by panes of the sliding time. If the result of a window can be merged from the
+ * results of its panes, the query is issued with the sliding time as interval on the newest pane only, the results
+ * of the older panes are kept in the stream since the last computing.
+ */
+static bool isPaneMergeableExpr(int16_t functionId, int16_t type) {
+  switch (functionId) {
+    case TSDB_FUNC_TS:
+    case TSDB_FUNC_COUNT:
+    case TSDB_FUNC_SUM:
+      return true;
+    case TSDB_FUNC_MIN:
+    case TSDB_FUNC_MAX:
+      return type != TSDB_DATA_TYPE_BINARY && type != TSDB_DATA_TYPE_NCHAR && type != TSDB_DATA_TYPE_BOOL;
+    case TSDB_FUNC_FIRST:
+    case TSDB_FUNC_LAST:
+    case TSDB_FUNC_FIRST_DST:
+    case TSDB_FUNC_LAST_DST:
+      return type != TSDB_DATA_TYPE_NCHAR;
+    default:
+      return false;
+  }
+}
+
+static void tscInitStreamPanes(SSqlStream *pStream, SSqlObj *pSql) {
+  SSqlCmd *pCmd = &pSql->cmd;
+
+  if (isProjectStream(pCmd) || pStream->slidingTime >= pStream->interval ||
+      pStream->interval % pStream->slidingTime != 0) {
+    return;
+  }
+
+  if (pCmd->groupbyExpr.numOfGroupCols > 0 || pCmd->interpoType != TSDB_INTERPO_NONE) {
+    return;
+  }
+
+  // a pane is kept as: start timestamp, null flag of each output column, data of each output column
+  int32_t size = sizeof(TSKEY);
+  for (int32_t i = 0; i < pCmd->fieldsInfo.numOfOutputCols; ++i) {
+    SSqlExpr *  pExpr = tscSqlExprGet(pCmd, i);
+    TAOS_FIELD *pField = tscFieldInfoGetField(pCmd, i);
+    if (!isPaneMergeableExpr(pExpr->functionId, pField->type)) {
+      return;
+    }
+
+    size += (1 + pField->bytes);
+  }
+
+  int32_t numOfPanes = (int32_t)(pStream->interval / pStream->slidingTime);
+  pStream->pPanes = calloc(numOfPanes, size);
+  if (pStream->pPanes == NULL) {
+    return;
+  }
+
+  pStream->numOfPanes = numOfPanes;
+  pStream->paneSize = size;
+  pStream->paneEnd = 0;
+
+  pCmd->nAggTimeInterval = pStream->slidingTime;
+  pCmd->nSlidingTime = pStream->slidingTime;
+
+  /*
+   * windows of a stream start at multiples of the interval in UTC, but the vnode aligns intervals of days and weeks
+   * to its time zone. The panes are aligned in UTC as the windows, otherwise their keys are never found by merging.
+   */
+  pCmd->intervalTimeUnit = 'a';
+}
+
+static char *tscGetStreamPane(SSqlStream *pStream, TSKEY key) {
+  int32_t index = (int32_t)((key / pStream->slidingTime) % pStream->numOfPanes);
+  return pStream->pPanes + index * pStream->paneSize;
+}
+
+static void tscSaveStreamPane(SSqlStream *pStream, SSqlObj *pSql, TAOS_ROW row) {
+  SSqlCmd *pCmd = &pSql->cmd;
+  int32_t  numOfCols = pCmd->fieldsInfo.numOfOutputCols;
+
+  TSKEY key = *(TSKEY *)row[0];
+  char *pPane = tscGetStreamPane(pStream, key);
+  char *pFlag = pPane + sizeof(TSKEY);
+  char *pData = pFlag + numOfCols;
+
+  *(TSKEY *)pPane = key;
+  for (int32_t i = 1; i < numOfCols; ++i) {
+    TAOS_FIELD *pField = tscFieldInfoGetField(pCmd, i);
+
+    pFlag[i] = (row[i] != NULL);
+    if (row[i] != NULL) {
+      memcpy(pData, row[i], pField->bytes);
+    }
+
+    pData += pField->bytes;
+  }
+}
+
+#define MERGE_PANE_MINMAX(_type, _dst, _src, _isMin)                  \
+  do {                                                                \
+    _type v = *(_type *)(_src);                                       \
+    if ((_isMin) ? (v < *(_type *)(_dst)) : (v > *(_type *)(_dst))) { \
+      *(_type *)(_dst) = v;                                           \
+    }                                                                 \
+  } while (0)
+
+static void tscMergePaneValue(int16_t functionId, TAOS_FIELD *pField, char *pDst, char *pSrc) {
+  bool isMin = (functionId == TSDB_FUNC_MIN);
+
+  switch (functionId) {
+    case TSDB_FUNC_COUNT:
+    case TSDB_FUNC_SUM: {
+      if (pField->type == TSDB_DATA_TYPE_DOUBLE) {
+        *(double *)pDst += *(double *)pSrc;
+      } else {
+        *(int64_t *)pDst += *(int64_t *)pSrc;
+      }
+      break;
+    }
+    case TSDB_FUNC_MIN:
+    case TSDB_FUNC_MAX: {
+      switch (pField->type) {
+        case TSDB_DATA_TYPE_TINYINT:  MERGE_PANE_MINMAX(int8_t, pDst, pSrc, isMin); break;
+        case TSDB_DATA_TYPE_SMALLINT: MERGE_PANE_MINMAX(int16_t, pDst, pSrc, isMin); break;
+        case TSDB_DATA_TYPE_INT:      MERGE_PANE_MINMAX(int32_t, pDst, pSrc, isMin); break;
+        case TSDB_DATA_TYPE_BIGINT:   MERGE_PANE_MINMAX(int64_t, pDst, pSrc, isMin); break;
+        case TSDB_DATA_TYPE_FLOAT:    MERGE_PANE_MINMAX(float, pDst, pSrc, isMin); break;
+        case TSDB_DATA_TYPE_DOUBLE:   MERGE_PANE_MINMAX(double, pDst, pSrc, isMin); break;
+        default:
+          break;
+      }
+      break;
+    }
+    case TSDB_FUNC_LAST:
+    case TSDB_FUNC_LAST_DST:
+      // panes are merged in ascending order of timestamp, the value of the later one wins
+      memcpy(pDst, pSrc, pField->bytes);
+      break;
+    default:  // first value, the one of the earliest pane is kept
+      break;
+  }
+}
+
+/*
+ * merge the panes of current window, which ends before pStream->stime, and send the result to user
+ */
+static void tscMergeStreamPanes(SSqlStream *pStream, SSqlObj *pSql) {
+  SSqlCmd *pCmd = &pSql->cmd;
+  int32_t  numOfCols = pCmd->fieldsInfo.numOfOutputCols;
+
+  char  result[TSDB_MAX_BYTES_PER_ROW] = {0};
+  void *row[TSDB_MAX_COLUMNS] = {0};
+  bool  hasResult = false;
+
+  TSKEY skey = pStream->stime - pStream->interval;
+  for (TSKEY key = skey; key < pStream->stime; key += pStream->slidingTime) {
+    char *pPane = tscGetStreamPane(pStream, key);
+    if (*(TSKEY *)pPane != key) {  // no data in this pane
+      continue;
+    }
+
+    hasResult = true;
+
+    char *  pFlag = pPane + sizeof(TSKEY);
+    char *  pData = pFlag + numOfCols;
+    int32_t offset = sizeof(TSKEY);
+
+    for (int32_t i = 1; i < numOfCols; ++i) {
+      TAOS_FIELD *pField = tscFieldInfoGetField(pCmd, i);
+
+      if (pFlag[i]) {
+        if (row[i] == NULL) {
+          row[i] = result + offset;
+          memcpy(row[i], pData, pField->bytes);
+        } else {
+          tscMergePaneValue(tscSqlExprGet(pCmd, i)->functionId, pField, row[i], pData);
+        }
+      }
+
+      pData += pField->bytes;
+      offset += pField->bytes;
+    }
+  }
+
+  if (!hasResult) {
+    return;
+  }
+
+  *(TSKEY *)result = skey;
+  row[0] = result;
+
+  pStream->numOfRes++;
+  tscTrace("%p stream:%p, result of window %lld merged from %d panes", pSql, pStream, skey, pStream->numOfPanes);
+
+  // user callback function
+  (*pStream->fp)(pStream->param, pSql, row);
+}
+
 static void tscProcessStreamRetrieveResult(void *param, TAOS_RES *res, int numOfRows) {
   SSqlStream *    pStream = (SSqlStream *)param;
   SSqlObj *       pSql = (SSqlObj *)res;
@@ -182,6 +381,11 @@ static void tscProcessStreamRetrieveResult(void *param, TAOS_RES *res, int numOf
     for(int32_t i = 0; i < numOfRows; ++i) {
       TAOS_ROW row = taos_fetch_row(res);
       tscTrace("%p stream:%p fetch result", pSql, pStream);
+      if (pStream->numOfPanes > 0) {
+        tscSaveStreamPane(pStream, pSql, row);
+        continue;
+      }
+
       if (isProjectStream(&pSql->cmd)) {
         pStream->stime = *(TSKEY *)row[0];
       } else {
@@ -197,7 +401,11 @@ static void tscProcessStreamRetrieveResult(void *param, TAOS_RES *res, int numOf
   } else {  // numOfRows == 0, all data has been retrieved
     pStream->useconds += pSql->res.useconds;
 
-    if (pStream->numOfRes == 0) {
+    if (pStream->numOfPanes > 0) {
+      pStream->numOfRes = 0;
+      tscMergeStreamPanes(pStream, pSql);
+      pStream->paneEnd = pStream->stime;
+    } else if (pStream->numOfRes == 0) {
       if (pSql->cmd.interpoType == TSDB_INTERPO_SET_VALUE || pSql->cmd.interpoType == TSDB_INTERPO_NULL) {
         SSqlCmd *pCmd = &pSql->cmd;
         SSqlRes *pRes = &pSql->res;
@@ -533,12 +741,14 @@ TAOS_STREAM *taos_open_stream(TAOS *taos, const char *sqlstr, void (*fp)(void *p
 
   tscSetSlidingWindowInfo(pSql, pStream);
   pStream->stime = tscGetStreamStartTimestamp(pSql, pStream, stime);
+  tscInitStreamPanes(pStream, pSql);
 
   int64_t starttime = tscGetLaunchTimestamp(pStream);
   taosTmrReset(tscProcessStreamTimer, starttime, pStream, tscTmr, &pStream->pTimer);
 
-  tscTrace("%p stream:%p is opened, query on:%s, interval:%lld, sliding:%lld, first launched in:%lld, sql:%s", pSql,
-           pStream, pMeterMetaInfo->name, pStream->interval, pStream->slidingTime, starttime, sqlstr);
+  tscTrace("%p stream:%p is opened, query on:%s, interval:%lld, sliding:%lld, panes:%d, first launched in:%lld, sql:%s",
+           pSql, pStream, pMeterMetaInfo->name, pStream->interval, pStream->slidingTime, pStream->numOfPanes, starttime,
+           sqlstr);
 
   return pStream;
 }
@@ -563,6 +773,7 @@ void taos_close_stream(TAOS_STREAM *handle) {
     pStream->pSql = NULL;
 
     tscTrace("%p stream:%p is closed", pSql, pStream);
+    tfree(pStream->pPanes);
     tfree(pStream);
   }
 }
@@ -19,6 +19,7 @@
 #include "taos.h"
 #include "tlog.h"
 #include "trpc.h"
+#include "tscUtil.h"
 #include "tsclient.h"
 #include "tsocket.h"
 #include "ttime.h"
@@ -30,6 +31,7 @@ typedef struct {
   int        mseconds;
   TSKEY      lastKey;
   uint64_t   stime;
+  int64_t    numOfRows;  // rows consumed from the current result
   TAOS_FIELD fields[TSDB_MAX_COLUMNS];
   int        numOfFields;
   TAOS *     taos;
@@ -80,10 +82,50 @@ TAOS_SUB *taos_subscribe(const char *host, const char *user, const char *pass, c
   return pSub;
 }
 
+/*
+ * the query is flagged as a subscription, the vnode holds it until there are rows after lastKey, instead of answering
+ * an empty result at once
+ */
+static int tscSubscribeQuery(SSub *pSub) {
+  STscObj *pObj = (STscObj *)pSub->taos;
+  SSqlObj *pSql = pObj->pSql;
+  SSqlRes *pRes = &pSql->res;
+  char     qstr[256];
+
+  sprintf(qstr, "select * from %s where _c0 > %lld order by _c0 asc", pSub->name, pSub->lastKey);
+
+  char *sql = realloc(pSql->sqlstr, strlen(qstr) + 1);
+  if (sql == NULL) {
+    pRes->code = TSDB_CODE_CLI_OUT_OF_MEMORY;
+    return pRes->code;
+  }
+
+  pSql->sqlstr = sql;
+  strtolower(pSql->sqlstr, qstr);
+
+  pRes->numOfRows = 1;
+  pRes->numOfTotal = 0;
+  pRes->code = (uint8_t)tsParseSql(pSql, pObj->acctId, pObj->db, false);
+
+  pRes->qhandle = 0;
+  pSql->thandle = NULL;
+
+  if (pRes->code == TSDB_CODE_SUCCESS) {
+    pSql->cmd.type |= TSDB_QUERY_TYPE_SUBSCRIBE;
+    tscDoQuery(pSql);
+  }
+
+  tscTrace("%p subscription query, lastKey:%lld, result:%d", pSql, pSub->lastKey, pRes->code);
+  if (pRes->code != TSDB_CODE_SUCCESS) {
+    tscFreeSqlObjPartial(pSql);
+  }
+
+  return pRes->code;
+}
+
 TAOS_ROW taos_consume(TAOS_SUB *tsub) {
   SSub *   pSub = (SSub *)tsub;
   TAOS_ROW row;
-  char     qstr[256];
 
   if (pSub == NULL) return NULL;
   if (pSub->signature != pSub) return NULL;
@@ -93,21 +135,29 @@ TAOS_ROW taos_consume(TAOS_SUB *tsub) {
       row = taos_fetch_row(pSub->result);
       if (row != NULL) {
         pSub->lastKey = *((uint64_t *)row[0]);
+        pSub->numOfRows++;
         return row;
       }
 
       taos_free_result(pSub->result);
       pSub->result = NULL;
-      uint64_t etime = taosGetTimestampMs();
-      int64_t  mseconds = pSub->mseconds - etime + pSub->stime;
-      if (mseconds < 0) mseconds = 0;
-      taosMsleep((int)mseconds);
+
+      /*
+       * new rows are asked for as soon as the previous ones are consumed. An empty result comes when the vnode has
+       * waited long enough, or the super table is in several vnodes and polled, so wait for the rest of the interval
+       */
+      if (pSub->numOfRows == 0) {
+        uint64_t etime = taosGetTimestampMs();
+        int64_t  mseconds = pSub->mseconds - etime + pSub->stime;
+        if (mseconds < 0) mseconds = 0;
+        taosMsleep((int)mseconds);
+      }
     }
 
     pSub->stime = taosGetTimestampMs();
+    pSub->numOfRows = 0;
 
-    sprintf(qstr, "select * from %s where _c0 > %lld order by _c0 asc", pSub->name, pSub->lastKey);
-    if (taos_query(pSub->taos, qstr)) {
+    if (tscSubscribeQuery(pSub)) {
       tscTrace("failed to select, reason:%s", taos_errstr(pSub->taos));
       return NULL;
     }
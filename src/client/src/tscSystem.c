@@ -26,12 +26,14 @@
 #include "tutil.h"
 
 #include "tsclient.h"
+#include "tscSqlCache.h"
 // global, not configurable
 void *  pVnodeConn;
 void *  pVMeterConn;
 void *  pTscMgmtConn;
 void *  pSlaveConn;
 void *  tscCacheHandle;
+void *  tscMissCacheHandle;  // meters known to be absent in mgmt
 uint8_t globalCode = 0;
 int     initialized = 0;
 int     slaveIndex;
@@ -182,6 +184,8 @@ void taos_init_imp() {
   refreshTime = refreshTime < 1 ? 1 : refreshTime;
 
   if (tscCacheHandle == NULL) tscCacheHandle = taosInitDataCache(tsMaxMeterConnections / 2, tscTmr, refreshTime);
+  if (tscMissCacheHandle == NULL) tscMissCacheHandle = taosInitDataCache(tsMaxMeterConnections / 2, tscTmr, 1);
+  tscInitSqlCache(tsSqlCacheSize);
 
   tscConnCache = taosOpenConnCache(tsMaxMeterConnections * 2, taosCloseRpcConn, tscTmr, tsShellActivityTimer * 1000);
 
@@ -1815,10 +1815,17 @@ void tscDoQuery(SSqlObj* pSql) {
 
     if (pCmd->isInsertFromFile == 1) {
       tscProcessMultiVnodesInsertForFile(pSql);
+    } else if (pCmd->command == TSDB_SQL_INSERT && pCmd->pDataBlocks != NULL && pCmd->pDataBlocks->nSize > 1) {
+      // data blocks of different vnodes are sent concurrently, pSql may be released if it is a async insertion.
+      tscProcessMultiVnodesInsert(pSql);
     } else {
       // pSql may be released in this function if it is a async insertion.
       tscProcessSql(pSql);
-      if (NULL == fp) tscProcessMultiVnodesInsert(pSql);
+
+      // the only data block has been submit to vnode, release data blocks
+      if (NULL == fp && pCmd->command == TSDB_SQL_INSERT) {
+        pCmd->pDataBlocks = tscDestroyBlockArrayList(pCmd->pDataBlocks);
+      }
     }
   }
 }
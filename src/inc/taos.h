@@ -72,9 +72,19 @@ typedef struct TAOS_BIND {
   int *          error;        // unused
 } TAOS_BIND;
 
+// a column of values for batch binding, element i belongs to row i
+typedef struct TAOS_MULTI_BIND {
+  int            buffer_type;
+  void *         buffer;
+  unsigned long  buffer_length;  // size of one element of binary/nchar column, unused for other types
+  int32_t *      length;         // actual length of each binary/nchar element
+  unsigned char *is_null;        // null bitmap, bit (i % 8) of byte (i / 8) is set if row i is null, may be NULL
+} TAOS_MULTI_BIND;
+
 TAOS_STMT *taos_stmt_init(TAOS *taos);
 int        taos_stmt_prepare(TAOS_STMT *stmt, const char *sql, unsigned long length);
 int        taos_stmt_bind_param(TAOS_STMT *stmt, TAOS_BIND *bind);
+int        taos_stmt_bind_param_batch(TAOS_STMT *stmt, TAOS_MULTI_BIND *bind, int rows);
 int        taos_stmt_add_batch(TAOS_STMT *stmt);
 int        taos_stmt_execute(TAOS_STMT *stmt);
 TAOS_RES * taos_stmt_use_result(TAOS_STMT *stmt);
@@ -90,10 +100,12 @@ int taos_num_fields(TAOS_RES *res);
 int taos_affected_rows(TAOS *taos);
 TAOS_FIELD *taos_fetch_fields(TAOS_RES *res);
 int taos_select_db(TAOS *taos, const char *db);
+int taos_set_query_parallelism(TAOS *taos, int parallelism);  // workers of a super table query in each vnode
 int taos_print_row(char *str, TAOS_ROW row, TAOS_FIELD *fields, int num_fields);
 void taos_stop_query(TAOS_RES *res);
 
 int taos_fetch_block(TAOS_RES *res, TAOS_ROW *rows);
+int taos_fetch_columns(TAOS_RES *res, void **columns);  // columns[i] is an array of the values of field i
 int taos_validate_sql(TAOS *taos, const char *sql);
 
 // TAOS_RES   *taos_list_tables(TAOS *mysql, const char *wild);
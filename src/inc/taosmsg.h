@@ -542,7 +542,7 @@ typedef struct {
   int32_t     tsLen;          // total length of ts comp block
   int32_t     tsNumOfBlocks;  // ts comp block numbers
   int32_t     tsOrder;        // ts comp block order
-  SColumnInfo colList[];
+  SColumnInfo colList[];      // an int16_t degree of parallelism for each vnode follows the ts comp block
 } SQueryMeterMsg;
 
 typedef struct {
@@ -573,6 +573,18 @@ typedef struct {
   char    data[];
 } SRetrieveMeterRsp;
 
+// compress mode of SRetrieveMeterRsp
+#define TSDB_RSP_COMP_NONE   0
+#define TSDB_RSP_COMP_LZ4    1  // the whole payload is compressed as a string
+#define TSDB_RSP_COMP_COLUMN 2  // each column is compressed by the codec of its type, and led by SRetrieveColumnHead
+
+typedef struct {
+  int8_t  type;       // data type whose codec is used
+  int8_t  algorithm;  // ONE_STAGE_COMP or TWO_STAGE_COMP
+  int16_t bytes;      // width of a value in the result, intermediate results of a sub-query are wider than the field
+  int32_t len;        // length of the compressed column
+} SRetrieveColumnHead;
+
 typedef struct {
   uint32_t vnode;
   uint32_t vgId;
@@ -629,7 +641,12 @@ typedef struct {
   int64_t totalStorage;   // In unit of bytes
   int64_t compStorage;    // In unit of bytes
   int64_t queryTime;      // In unit of second ??
-  char    reserved[64];
+  int64_t commitBlocks;   // number of blocks written by commit
+  int64_t commitBytes;    // In unit of bytes, written by commit
+  int64_t commitTime;     // In unit of microsecond, spent by commit
+  int64_t blockCacheHits;    // column chunks served by the block cache
+  int64_t blockCacheMisses;  // column chunks read from files
+  char    reserved[24];
 } SVnodeStatisticInfo;
 
 typedef struct {
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_TBITMAP_H
+#define TDENGINE_TBITMAP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * compressed bitmap of uint32_t values, in the way of roaring bitmap.
+ *
+ * The values are partitioned by the high 16 bits. The low 16 bits of each partition are kept in a sorted array
+ * if there are at most 4096 of them, otherwise in a bitset of 65536 bits. So a sparse bitmap costs 2 bytes per value
+ * and a dense one at most 1 bit per value.
+ *
+ * The bitmap is not thread safe.
+ */
+typedef struct tBitmap tBitmap;
+
+tBitmap *tBitmapCreate();
+
+void tBitmapDestroy(tBitmap *pBitmap);
+
+tBitmap *tBitmapClone(const tBitmap *pBitmap);
+
+/*
+ * @return 0: success, -1: out of memory
+ */
+int32_t tBitmapAdd(tBitmap *pBitmap, uint32_t val);
+
+void tBitmapRemove(tBitmap *pBitmap, uint32_t val);
+
+bool tBitmapContains(const tBitmap *pBitmap, uint32_t val);
+
+int64_t tBitmapCardinality(const tBitmap *pBitmap);
+
+/*
+ * pDst = pDst & pSrc, pDst = pDst | pSrc
+ * @return 0: success, -1: out of memory, pDst is left unchanged for the partition failed to compute
+ */
+int32_t tBitmapAnd(tBitmap *pDst, const tBitmap *pSrc);
+
+int32_t tBitmapOr(tBitmap *pDst, const tBitmap *pSrc);
+
+/*
+ * write all values in ascending order into pDst, which must be able to hold tBitmapCardinality() values
+ * @return number of values
+ */
+int64_t tBitmapToArray(const tBitmap *pBitmap, uint32_t *pDst);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TDENGINE_TBITMAP_H
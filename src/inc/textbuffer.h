@@ -50,9 +50,12 @@ typedef enum EXT_BUFFER_FLUSH_MODEL {
   MULTIPLE_APPEND_MODEL,
 } EXT_BUFFER_FLUSH_MODEL;
 
+struct tFilePagesItem;
+
 typedef struct tFlushoutInfo {
-  uint32_t startPageId;
-  uint32_t numOfPages;
+  uint32_t                startPageId;
+  uint32_t                numOfPages;
+  struct tFilePagesItem **pMemPages;  // pages of a run that is kept in memory, NULL if the run is in file
 } tFlushoutInfo;
 
 typedef struct tFlushoutData {
@@ -113,6 +116,8 @@ typedef struct tExtMemBuffer {
   tFilePagesItem *pHead;
   tFilePagesItem *pTail;
 
+  int32_t numOfPagesInMemRuns;  // pages of the sealed runs that are kept in memory
+
   tFileMeta fileMeta;
 
   char  dataFilePath[MAX_TMPFILE_PATH_LENGTH];
@@ -150,6 +155,17 @@ int16_t tExtMemBufferPut(tExtMemBuffer *pMemBuffer, void *data, int32_t numOfRow
  */
 bool tExtMemBufferFlush(tExtMemBuffer *pMemBuffer);
 
+/*
+ * seal all data in buffer as a new run like flush does, but keep the pages in memory instead of
+ * writing them to disk. Only available in MULTIPLE_APPEND_MODEL
+ */
+bool tExtMemBufferSeal(tExtMemBuffer *pMemBuffer);
+
+/*
+ * release all runs kept in memory, data that are not sealed yet and runs in disk are not affected
+ */
+void tExtMemBufferDropMemRuns(tExtMemBuffer *pMemBuffer);
+
 /*
  * remove all data that has been put into buffer, including in buffer or
  * ext-buffer(disk)
@@ -70,9 +70,17 @@ extern int tsVnodePeerHBTimer;
 extern int tsMgmtPeerHBTimer;
 extern int tsMeterMetaKeepTimer;
 extern int tsMetricMetaKeepTimer;
+extern int tsMeterMetaMissKeepTimer;
+extern int tsMetricMergeBufferSize;
+extern int tsMetricSubqueryConcurrency;
+extern int tsInsertVnodeConcurrency;
+extern int tsSqlCacheSize;
+extern int tsQueryParallelism;
 
 extern float tsNumOfThreadsPerCore;
 extern float tsRatioOfQueryThreads;
+extern int   tsNumOfCommitThreads;
+extern short tsSchedAffinity;
 extern char  tsPublicIp[];
 extern char  tsInternalIp[];
 extern char  tsPrivateIp[];
@@ -84,6 +92,7 @@ extern uint32_t tsServerIp;
 
 extern int tsSessionsPerVnode;
 extern int tsAverageCacheBlocks;
+extern int tsBlockCacheSize;
 extern int tsCacheBlockSize;
 
 extern int   tsRowsInFileBlock;
@@ -92,8 +101,10 @@ extern float tsFileBlockMinPercent;
 extern short tsNumOfBlocksPerMeter;
 extern short tsCommitTime;  // seconds
 extern short tsCommitLog;
+extern int   tsGroupCommitTime;  // milliseconds
 extern short tsAsyncLog;
 extern short tsCompression;
+extern short tsBlockBloomFilter;
 extern short tsDaysPerFile;
 extern int   tsDaysToKeep;
 extern int   tsReplications;
@@ -122,6 +133,7 @@ extern int tsBalanceStartInterval;
 extern int tsBalancePolicy;
 extern int tsOfflineThreshold;
 extern int tsMgmtEqualVnodeNum;
+extern int tsMetricTagIndex;
 
 extern int tsEnableHttpModule;
 extern int tsEnableMonitorModule;
@@ -146,6 +158,7 @@ extern int   tsHttpCacheSessions;
 extern int   tsHttpSessionExpire;
 extern int   tsHttpMaxThreads;
 extern int   tsHttpEnableCompress;
+extern int   tsHttpMaxBodySize;
 extern int   tsHttpEnableRecordSql;
 extern int   tsTelegrafUseFieldNum;
 extern int   tsAdminRowLimit;
@@ -251,7 +264,7 @@ extern int            tsGlobalConfigNum;
 extern char *         tsCfgStatusStr[];
 SGlobalConfig *tsGetConfigOption(const char *option);
 
-#define TSDB_CFG_MAX_NUM    110
+#define TSDB_CFG_MAX_NUM    120
 #define TSDB_CFG_PRINT_LEN  23
 #define TSDB_CFG_OPTION_LEN 24
 #define TSDB_CFG_VALUE_LEN  41
@@ -111,6 +111,9 @@ void taosGetRpcConnInfo(void *thandle, uint32_t *peerId, uint32_t *peerIp, uint1
 
 int taosGetOutType(void *thandle);
 
+// the transactions sent through the connection may be in process at peer for long, they are checked less often
+void taosSetRpcConnBackoff(void *thandle, int backoff);
+
 #ifdef __cplusplus
 }
 #endif
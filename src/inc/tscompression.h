@@ -32,6 +32,12 @@ extern "C" {
 #define ONE_STAGE_COMP 1
 #define TWO_STAGE_COMP 2
 
+#define EXTRA_BYTES 2  // for possible compression deflation
+
+// indicator of binary/nchar blocks encoded with a per-block dictionary
+#define STRING_DICT_COMP 2
+#define STRING_DICT_MAX_ENTRIES 255
+
 int tsCompressTinyint(const char* const input, int inputSize, const int nelements, char* const output, int outputSize, char algorithm,
                       char* const buffer, int bufferSize);
 int tsCompressSmallint(const char* const input, int inputSize, const int nelements, char* const output, int outputSize, char algorith,
@@ -70,6 +76,15 @@ int tsDecompressDouble(const char* const input, int compressedSize, const int ne
 int tsDecompressTimestamp(const char* const input, int compressedSize, const int nelements, char* const output,
                           int outputSize, char algorithm, char* const buffer, int bufferSize);
 
+/**
+ * get the dictionary of a binary/nchar block compressed by tsCompressString
+ * @param entries   set to the first of the distinct values, which are stored one after another
+ * @param codes     if not NULL, receives the index of the value of each element
+ * @return          number of distinct values, or 0 if the block is not dictionary encoded
+ */
+int tsGetStringDict(const char* const input, int compressedSize, const int nelements, const char** entries,
+                    uint8_t* const codes);
+
 #ifdef __cplusplus
 }
 #endif
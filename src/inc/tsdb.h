@@ -202,6 +202,10 @@ enum _vgroup_status {
 #define TSDB_MIN_COMMIT_TIME_INTERVAL   30
 #define TSDB_MAX_COMMIT_TIME_INTERVAL   40960
 
+#define TSDB_COMMIT_LOG_OFF             0
+#define TSDB_COMMIT_LOG_MMAP            1         // written into mmapped log, flushed to disk by OS
+#define TSDB_COMMIT_LOG_GROUP           2         // flushed to disk in groups, submit is acked after flush
+
 #define TSDB_MIN_ROWS_IN_FILEBLOCK      200
 #define TSDB_MAX_ROWS_IN_FILEBLOCK      500000
 
@@ -253,6 +257,8 @@ enum _vgroup_status {
 #define TSDB_QUERY_TYPE_JOIN_QUERY                     0x20U    // join query
 #define TSDB_QUERY_TYPE_PROJECTION_QUERY               0x40U    // select *,columns... query
 #define TSDB_QUERY_TYPE_JOIN_SEC_STAGE                 0x80U    // join sub query at the second stage
+#define TSDB_QUERY_TYPE_COLUMN_COMP                   0x100U    // retrieve only, client accepts TSDB_RSP_COMP_COLUMN
+#define TSDB_QUERY_TYPE_SUBSCRIBE                     0x200U    // vnode holds the query until there are new rows
 
 #ifdef __cplusplus
 }
@@ -43,6 +43,9 @@ int32_t getTimestampInUsFromStr(char* token, int32_t tokenlen, int64_t* ts);
 
 int32_t taosParseTime(char* timestr, int64_t* time, int32_t len, int32_t timePrec);
 
+// the local time offsets cached by taosParseTime are invalid once the time zone is changed
+void taosResetLocalTimeCache();
+
 #ifdef __cplusplus
 }
 #endif
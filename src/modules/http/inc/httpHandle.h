@@ -32,8 +32,8 @@
 
 #define HTTP_LABEL_SIZE             8
 #define HTTP_MAX_EVENTS             10
-#define HTTP_BUFFER_SIZE            1024*65 //65k
-#define HTTP_DECOMPRESS_BUF_SIZE    1024*64
+#define HTTP_BUFFER_SIZE            1024*65 //65k, initial size of the receive buffer
+#define HTTP_MAX_BODY_SIZE          (tsHttpMaxBodySize * 1024 * 1024)
 #define HTTP_STEP_SIZE              1024    //http message get process step by step
 #define HTTP_MAX_URL                5       //http url stack size
 #define HTTP_METHOD_SCANNER_SIZE    7       //http method fp size
@@ -103,9 +103,10 @@ typedef struct {
   int32_t numOfRows;
   int32_t code;
 
+  // typed rows written without sql, see taos_insert_rows_a
+  struct SInsertRows *rows;
+
   // these are the locations in the buffer
-  int32_t tagNames[TSDB_MAX_TAGS];
-  int32_t tagValues[TSDB_MAX_TAGS];
   int32_t timestamp;
   int32_t metric;
   int32_t stable;
@@ -151,9 +152,16 @@ typedef struct {
   int32_t len;
 } HttpBuf;
 
+/*
+ * The receive buffer starts at HTTP_BUFFER_SIZE and grows up to httpMaxBodySize, all the positions below point into it
+ * and are rebased when it is reallocated. A chunked body is decoded in place at data.pos while it arrives, data.len is
+ * the decoded length so far and the undecoded bytes follow it.
+ */
 typedef struct {
-  char              buffer[HTTP_BUFFER_SIZE];
+  char             *buffer;
   int               bufsize;
+  int               bufCapacity;
+  char             *pDecompressed;  // inflated gzip body, data.pos points to it
   char             *pLast;
   char             *pCur;
   HttpBuf           method;
@@ -268,6 +276,7 @@ bool httpGenTaosdAuthToken(HttpContext *pContext, char *token, int maxLen);
 bool httpUrlMatch(HttpContext *pContext, int pos, char *cmp);
 bool httpProcessData(HttpContext *pContext);
 bool httpReadDataImp(HttpContext *pContext);
+void httpFreeParserBuffer(HttpParser *pParser);
 bool httpParseRequest(HttpContext* pContext);
 int  httpCheckReadCompleted(HttpContext* pContext);
 void httpReadDirtyData(HttpContext *pContext);
@@ -299,7 +308,7 @@ void httpTrimTableName(char *name);
 int httpShrinkTableName(HttpContext *pContext, int pos, char *name);
 char *httpGetCmdsString(HttpContext *pContext, int pos);
 
-int httpGzipDeCompress(char *srcData, int32_t nSrcData, char *destData, int32_t *nDestData);
+int httpGzipDeCompress(char *srcData, int32_t nSrcData, char **destData, int32_t *nDestData, int32_t maxDestData);
 int httpGzipCompressInit(HttpContext *pContext);
 int httpGzipCompress(HttpContext *pContext, char *inSrcData, int32_t inSrcDataLen,
                      char *outDestData, int32_t *outDestDataLen, bool isTheLast);
@@ -241,56 +241,104 @@ bool httpParseHead(HttpContext* pContext) {
   return true;
 }
 
-bool httpParseChunkedBody(HttpContext* pContext, HttpParser* pParser, bool test) {
-  char*  pEnd = pParser->buffer + pParser->bufsize;
-  char*  pRet = pParser->data.pos;
-  char*  pSize = pParser->data.pos;
-  size_t size = strtoul(pSize, NULL, 16);
-  if (size <= 0) return false;
-
-  while (size > 0) {
-    char* pData = strstr(pSize, "\r\n");
-    if (pData == NULL || pData >= pEnd) return false;
-    pData += 2;
-
-    pSize = strstr(pData, "\r\n");
-    if (pSize == NULL || pSize >= pEnd) return false;
-    if ((size_t)(pSize - pData) != size) return false;
-    pSize += 2;
-
-    if (!test) {
-      memmove(pRet, pData, size);
-      pRet += size;
+static char* httpFindCRLF(char* pos, char* pEnd) {
+  while (pos < pEnd) {
+    char* pCR = memchr(pos, '\r', (size_t)(pEnd - pos));
+    if (pCR == NULL || pCR + 1 >= pEnd) return NULL;
+    if (pCR[1] == '\n') return pCR;
+    pos = pCR + 1;
+  }
+
+  return NULL;
+}
+
+/*
+ * decode the chunks received so far in place, the decoded body is kept at data.pos with length data.len, and the
+ * bytes of an incomplete chunk are moved right after it, so every byte is scanned only once however the body is split
+ */
+int httpDecodeChunkedBody(HttpContext* pContext, HttpParser* pParser) {
+  char* pEnd = pParser->buffer + pParser->bufsize;
+  char* pDst = pParser->data.pos + pParser->data.len;
+  char* pSrc = pDst;
+  int   ret = HTTP_CHECK_BODY_CONTINUE;
+
+  while (pSrc < pEnd) {
+    char* pLine = httpFindCRLF(pSrc, pEnd);
+    if (pLine == NULL) break;
+
+    char*  pSizeEnd = NULL;
+    size_t size = strtoul(pSrc, &pSizeEnd, 16);
+    if (pSizeEnd == pSrc || size > (size_t)HTTP_MAX_BODY_SIZE ||
+        (size_t)(pDst - pParser->data.pos) + size > (size_t)HTTP_MAX_BODY_SIZE) {
+      httpError("context:%p, fd:%d, ip:%s, invalid chunk size, decoded:%d", pContext, pContext->fd, pContext->ipstr,
+                (int)(pDst - pParser->data.pos));
+      httpSendErrorResp(pContext, HTTP_PARSE_CHUNKED_BODY_ERROR);
+      return HTTP_CHECK_BODY_ERROR;
     }
 
-    size = strtoul(pSize, NULL, 16);
-  }
+    if (size == 0) {
+      // the last chunk, trailers if any are skipped until the empty line
+      char* pTail = pLine;
+      while (pTail != NULL && pTail + 3 < pEnd && !(pTail[2] == '\r' && pTail[3] == '\n')) {
+        pTail = httpFindCRLF(pTail + 2, pEnd);
+      }
+      if (pTail == NULL || pTail + 3 >= pEnd) break;
 
-  if (!test) {
-    *pRet = '\0';
+      pSrc = pTail + 4;
+      ret = HTTP_CHECK_BODY_SUCCESS;
+      break;
+    }
+
+    char* pData = pLine + 2;
+    if ((size_t)(pEnd - pData) < size + 2) break;
+    if (pData[size] != '\r' || pData[size + 1] != '\n') {
+      httpError("context:%p, fd:%d, ip:%s, chunk not terminated by CRLF, size:%d", pContext, pContext->fd,
+                pContext->ipstr, (int)size);
+      httpSendErrorResp(pContext, HTTP_PARSE_CHUNKED_BODY_ERROR);
+      return HTTP_CHECK_BODY_ERROR;
+    }
+
+    memmove(pDst, pData, size);
+    pDst += size;
+    pSrc = pData + size + 2;
   }
 
-  return true;
+  int32_t left = (ret == HTTP_CHECK_BODY_SUCCESS) ? 0 : (int32_t)(pEnd - pSrc);
+  if (pDst != pSrc) memmove(pDst, pSrc, (size_t)left);
+
+  pParser->data.len = (int32_t)(pDst - pParser->data.pos);
+  pParser->bufsize = (int)(pDst - pParser->buffer) + left;
+  pParser->buffer[pParser->bufsize] = 0;
+  if (ret == HTTP_CHECK_BODY_SUCCESS) *pDst = 0;
+
+  return ret;
 }
 
-bool httpReadChunkedBody(HttpContext* pContext, HttpParser* pParser) {
-  bool parsedOk = httpParseChunkedBody(pContext, pParser, true);
-  if (parsedOk) {
-    httpParseChunkedBody(pContext, pParser, false);
-    return HTTP_CHECK_BODY_SUCCESS;
-  } else {
-    httpTrace("context:%p, fd:%d, ip:%s, chunked body not finished, continue read", pContext, pContext->fd,
-              pContext->ipstr);
-    if (!httpReadDataImp(pContext)) {
-      httpError("context:%p, fd:%d, ip:%s, read chunked request error", pContext, pContext->fd, pContext->ipstr);
-      return HTTP_CHECK_BODY_ERROR;
-    } else {
-      return HTTP_CHECK_BODY_CONTINUE;
-    }
+int httpReadChunkedBody(HttpContext* pContext, HttpParser* pParser) {
+  int ret = httpDecodeChunkedBody(pContext, pParser);
+  if (ret != HTTP_CHECK_BODY_CONTINUE) {
+    return ret;
   }
+
+  httpTrace("context:%p, fd:%d, ip:%s, chunked body not finished, decoded:%d, continue read", pContext, pContext->fd,
+            pContext->ipstr, pParser->data.len);
+  if (!httpReadDataImp(pContext)) {
+    httpError("context:%p, fd:%d, ip:%s, read chunked request error", pContext, pContext->fd, pContext->ipstr);
+    return HTTP_CHECK_BODY_ERROR;
+  }
+
+  return httpDecodeChunkedBody(pContext, pParser);
 }
 
 int httpReadUnChunkedBody(HttpContext* pContext, HttpParser* pParser) {
+  if (pParser->data.len < 0 || pParser->data.len > HTTP_MAX_BODY_SIZE) {
+    httpError("context:%p, fd:%d, ip:%s, un-chunked body length:%d invalid, max:%d",
+              pContext, pContext->fd, pContext->ipstr, pParser->data.len, HTTP_MAX_BODY_SIZE);
+    httpRemoveContextFromEpoll(pContext->pThread, pContext);
+    httpSendErrorResp(pContext, HTTP_REQUSET_TOO_BIG);
+    return HTTP_CHECK_BODY_ERROR;
+  }
+
   int dataReadLen = pParser->bufsize - (int)(pParser->data.pos - pParser->buffer);
   if (dataReadLen > pParser->data.len) {
     httpError("context:%p, fd:%d, ip:%s, un-chunked body length invalid, dataReadLen:%d > pContext->data.len:%d",
@@ -355,6 +403,11 @@ bool httpParseRequest(HttpContext* pContext) {
     pParser->pLast = ++pParser->pCur;
   } while (1);
 
+  // data.len of a chunked body is the decoded length, any Content-Length is ignored
+  if (pContext->httpChunked == HTTP_CHUNKED) {
+    pParser->data.len = 0;
+  }
+
   httpTrace("context:%p, fd:%d, ip:%s, parse http head ok", pContext, pContext->fd, pContext->ipstr);
 
   pContext->parsed = true;
@@ -16,6 +16,7 @@
 #include "os.h"
 
 #include "taosmsg.h"
+#include "tglobalcfg.h"
 #include "tlog.h"
 #include "tlog.h"
 #include "tsocket.h"
@@ -157,6 +158,7 @@ void httpCleanUpContext(HttpContext *pContext) {
   // avoid double free
   httpFreeJsonBuf(pContext);
   httpFreeMultiCmds(pContext);
+  httpFreeParserBuffer(&pContext->parser);
   httpFreeContext(pThread->pServer, pContext);
 }
 
@@ -173,8 +175,19 @@ bool httpInitContext(HttpContext *pContext) {
   pContext->timer = NULL;
   memset(&pContext->singleCmd, 0, sizeof(HttpSqlCmd));
 
+  // the receive buffer of the last request is kept for reuse unless it was grown by a large body
   HttpParser *pParser = &pContext->parser;
+  char       *buffer = pParser->buffer;
+  int         bufCapacity = pParser->bufCapacity;
+  if (bufCapacity > HTTP_BUFFER_SIZE) {
+    tfree(buffer);
+    bufCapacity = 0;
+  }
+  tfree(pParser->pDecompressed);
+
   memset(pParser, 0, sizeof(HttpParser));
+  pParser->buffer = buffer;
+  pParser->bufCapacity = bufCapacity;
   pParser->pCur = pParser->pLast = pParser->buffer;
 
   httpTrace("context:%p, fd:%d, ip:%s, thread:%s, accessTimes:%d, parsed:%d",
@@ -296,12 +309,79 @@ void httpReadDirtyData(HttpContext *pContext) {
   }
 }
 
+void httpFreeParserBuffer(HttpParser *pParser) {
+  tfree(pParser->buffer);
+  tfree(pParser->pDecompressed);
+  pParser->bufCapacity = 0;
+  pParser->bufsize = 0;
+}
+
+static void httpRebaseParserPos(char **pos, uintptr_t oldBuffer, char *newBuffer) {
+  if (*pos != NULL) *pos = newBuffer + ((uintptr_t)*pos - oldBuffer);
+}
+
+/*
+ * make sure there are at least HTTP_STEP_SIZE free bytes in the receive buffer, the buffer doubles until
+ * HTTP_BUFFER_SIZE + httpMaxBodySize, the room of the request line and headers
+ */
+static bool httpExpandParserBuffer(HttpContext *pContext) {
+  HttpParser *pParser = &pContext->parser;
+  if (pParser->buffer != NULL && pParser->bufCapacity - pParser->bufsize - 1 >= HTTP_STEP_SIZE) {
+    return true;
+  }
+
+  int32_t maxCapacity = HTTP_BUFFER_SIZE + HTTP_MAX_BODY_SIZE;
+  int32_t capacity = pParser->bufCapacity;
+  if (pParser->buffer == NULL || capacity < HTTP_BUFFER_SIZE) {
+    capacity = HTTP_BUFFER_SIZE;
+  } else if (capacity >= maxCapacity) {
+    return false;
+  } else {
+    capacity = (capacity > maxCapacity / 2) ? maxCapacity : capacity * 2;
+  }
+
+  uintptr_t oldBuffer = (uintptr_t)pParser->buffer;
+  char     *buffer = realloc(pParser->buffer, (size_t)capacity);
+  if (buffer == NULL) {
+    httpError("context:%p, fd:%d, ip:%s, failed to malloc receive buffer:%d", pContext, pContext->fd, pContext->ipstr,
+              capacity);
+    return false;
+  }
+
+  if (oldBuffer == 0) {
+    pParser->pCur = pParser->pLast = buffer;
+  } else if ((uintptr_t)buffer != oldBuffer) {
+    httpRebaseParserPos(&pParser->pLast, oldBuffer, buffer);
+    httpRebaseParserPos(&pParser->pCur, oldBuffer, buffer);
+    httpRebaseParserPos(&pParser->method.pos, oldBuffer, buffer);
+    for (int i = 0; i < HTTP_MAX_URL; ++i) {
+      httpRebaseParserPos(&pParser->path[i].pos, oldBuffer, buffer);
+    }
+    httpRebaseParserPos(&pParser->data.pos, oldBuffer, buffer);
+    httpRebaseParserPos(&pParser->token.pos, oldBuffer, buffer);
+  }
+
+  pParser->buffer = buffer;
+  pParser->bufCapacity = capacity;
+  return true;
+}
+
 bool httpReadDataImp(HttpContext *pContext) {
   HttpParser *pParser = &pContext->parser;
 
-  while (pParser->bufsize <= (HTTP_BUFFER_SIZE - HTTP_STEP_SIZE)) {
-    int nread = (int)taosReadSocket(pContext->fd, pParser->buffer + pParser->bufsize, HTTP_STEP_SIZE);
-    if (nread >= 0 && nread < HTTP_STEP_SIZE) {
+  while (1) {
+    if (!httpExpandParserBuffer(pContext)) {
+      httpReadDirtyData(pContext);
+      httpError("context:%p, fd:%d, ip:%s, thread:%s, request big than:%d",
+                pContext, pContext->fd, pContext->ipstr, pContext->pThread->label, pParser->bufCapacity);
+      httpRemoveContextFromEpoll(pContext->pThread, pContext);
+      httpSendErrorResp(pContext, HTTP_REQUSET_TOO_BIG);
+      return false;
+    }
+
+    int room = pParser->bufCapacity - pParser->bufsize - 1;
+    int nread = (int)taosReadSocket(pContext->fd, pParser->buffer + pParser->bufsize, room);
+    if (nread >= 0 && nread < room) {
       pParser->bufsize += nread;
       break;
     } else if (nread < 0) {
@@ -317,15 +397,6 @@ bool httpReadDataImp(HttpContext *pContext) {
     } else {
       pParser->bufsize += nread;
     }
-
-    if (pParser->bufsize >= (HTTP_BUFFER_SIZE - HTTP_STEP_SIZE)) {
-      httpReadDirtyData(pContext);
-      httpError("context:%p, fd:%d, ip:%s, thread:%s, request big than:%d",
-                pContext, pContext->fd, pContext->ipstr, pContext->pThread->label, HTTP_BUFFER_SIZE);
-      httpRemoveContextFromEpoll(pContext->pThread, pContext);
-      httpSendErrorResp(pContext, HTTP_REQUSET_TOO_BIG);
-      return false;
-    }
   }
 
   pParser->buffer[pParser->bufsize] = 0;
@@ -336,32 +407,30 @@ bool httpReadDataImp(HttpContext *pContext) {
 }
 
 bool httpDecompressData(HttpContext *pContext) {
+  HttpParser *pParser = &pContext->parser;
   if (pContext->contentEncoding != HTTP_COMPRESS_GZIP) {
-    httpDump("context:%p, fd:%d, ip:%s, content:%s", pContext, pContext->fd, pContext->ipstr, pContext->parser.data.pos);
+    httpDump("context:%p, fd:%d, ip:%s, content:%s", pContext, pContext->fd, pContext->ipstr, pParser->data.pos);
     return true;
   }
 
-  char   *decompressBuf = calloc(HTTP_DECOMPRESS_BUF_SIZE, 1);
-  int32_t decompressBufLen = HTTP_DECOMPRESS_BUF_SIZE;
-  size_t  bufsize = sizeof(pContext->parser.buffer) - (pContext->parser.data.pos - pContext->parser.buffer) - 1;
-  if (decompressBufLen > (int)bufsize) {
-    decompressBufLen = (int)bufsize;
-  }
-
-  int ret = httpGzipDeCompress(pContext->parser.data.pos, pContext->parser.data.len, decompressBuf, &decompressBufLen);
+  char   *decompressBuf = NULL;
+  int32_t decompressBufLen = 0;
+  int     ret = httpGzipDeCompress(pParser->data.pos, pParser->data.len, &decompressBuf, &decompressBufLen,
+                                   HTTP_MAX_BODY_SIZE);
 
   if (ret == 0) {
-    memcpy(pContext->parser.data.pos, decompressBuf, decompressBufLen);
-    pContext->parser.data.pos[decompressBufLen] = 0;
     httpDump("context:%p, fd:%d, ip:%s, rawSize:%d, decompressSize:%d, content:%s",
-              pContext, pContext->fd, pContext->ipstr, pContext->parser.data.len, decompressBufLen,  decompressBuf);
-    pContext->parser.data.len = decompressBufLen;
+              pContext, pContext->fd, pContext->ipstr, pParser->data.len, decompressBufLen, decompressBuf);
+    tfree(pParser->pDecompressed);
+    pParser->pDecompressed = decompressBuf;
+    pParser->data.pos = decompressBuf;
+    pParser->data.len = decompressBufLen;
   } else {
     httpError("context:%p, fd:%d, ip:%s, failed to decompress data, rawSize:%d, error:%d",
-              pContext, pContext->fd, pContext->ipstr, pContext->parser.data.len, ret);
+              pContext, pContext->fd, pContext->ipstr, pParser->data.len, ret);
+    tfree(decompressBuf);
   }
 
-  free(decompressBuf);
   return ret == 0;
 }
 
@@ -163,6 +163,13 @@ void httpProcessMultiSql(HttpContext *pContext) {
   HttpSqlCmd *cmd = multiCmds->cmds + multiCmds->pos;
 
   char *sql = httpGetCmdsString(pContext, cmd->sql);
+  if (cmd->rows != NULL) {
+    httpDump("context:%p, fd:%d, ip:%s, user:%s, process pos:%d, start insert rows:%d, table:%s", pContext,
+             pContext->fd, pContext->ipstr, pContext->user, multiCmds->pos, cmd->rows->numOfRows, cmd->rows->table);
+    taos_insert_rows_a(pContext->session->taos, cmd->rows, httpProcessMultiSqlCallBack, (void *)pContext);
+    return;
+  }
+
   httpDump("context:%p, fd:%d, ip:%s, user:%s, process pos:%d, start query, sql:%s", pContext, pContext->fd,
            pContext->ipstr, pContext->user, multiCmds->pos, sql);
   taosNotePrintHttp(sql);
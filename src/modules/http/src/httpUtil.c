@@ -26,6 +26,7 @@
 
 #include "shash.h"
 #include "taos.h"
+#include "tglobalcfg.h"
 
 bool httpCheckUsedbSql(char *sql) {
   if (strstr(sql, "use ") != NULL) {
@@ -144,6 +145,14 @@ int32_t httpAddToSqlCmdBufferWithSize(HttpContext *pContext, int mallocSize) {
   return (int32_t)(buffer - cmd->buffer);
 }
 
+static void httpFreeMultiCmdsRows(HttpSqlCmds *multiCmds) {
+  if (multiCmds->cmds == NULL) return;
+
+  for (int i = 0; i < multiCmds->size; ++i) {
+    tfree(multiCmds->cmds[i].rows);
+  }
+}
+
 bool httpMallocMultiCmds(HttpContext *pContext, int cmdSize, int bufferSize) {
   if (cmdSize > HTTP_MAX_CMD_SIZE) {
     httpError("context:%p, fd:%d, ip:%s, user:%s, mulitcmd size:%d large then %d", pContext, pContext->fd,
@@ -162,6 +171,8 @@ bool httpMallocMultiCmds(HttpContext *pContext, int cmdSize, int bufferSize) {
   }
 
   HttpSqlCmds *multiCmds = pContext->multiCmds;
+  httpFreeMultiCmdsRows(multiCmds);
+
   if (multiCmds->cmds == NULL || cmdSize > multiCmds->maxSize) {
     free(multiCmds->cmds);
     multiCmds->cmds = (HttpSqlCmd *)malloc((size_t)cmdSize * sizeof(HttpSqlCmd));
@@ -207,7 +218,7 @@ bool httpReMallocMultiCmdsSize(HttpContext *pContext, int cmdSize) {
               pContext->user, cmdSize);
     return false;
   }
-  memset(multiCmds->cmds + multiCmds->maxSize * (int16_t)sizeof(HttpSqlCmd), 0,
+  memset(multiCmds->cmds + multiCmds->maxSize, 0,
          (size_t)(cmdSize - multiCmds->maxSize) * sizeof(HttpSqlCmd));
   multiCmds->maxSize = (int16_t)cmdSize;
 
@@ -217,9 +228,11 @@ bool httpReMallocMultiCmdsSize(HttpContext *pContext, int cmdSize) {
 bool httpReMallocMultiCmdsBuffer(HttpContext *pContext, int bufferSize) {
   HttpSqlCmds *multiCmds = pContext->multiCmds;
 
-  if (bufferSize > HTTP_MAX_BUFFER_SIZE) {
+  // the sql of a large body may be longer than the body itself
+  int32_t maxBufferSize = MAX(HTTP_MAX_BUFFER_SIZE, HTTP_MAX_BODY_SIZE * 2);
+  if (bufferSize > maxBufferSize) {
     httpError("context:%p, fd:%d, ip:%s, user:%s, mulitcmd buffer size:%d large then %d",
-              pContext, pContext->fd, pContext->ipstr, pContext->user, bufferSize, HTTP_MAX_BUFFER_SIZE);
+              pContext, pContext->fd, pContext->ipstr, pContext->user, bufferSize, maxBufferSize);
     return false;
   }
 
@@ -237,6 +250,7 @@ bool httpReMallocMultiCmdsBuffer(HttpContext *pContext, int bufferSize) {
 
 void httpFreeMultiCmds(HttpContext *pContext) {
   if (pContext->multiCmds != NULL) {
+    httpFreeMultiCmdsRows(pContext->multiCmds);
     if (pContext->multiCmds->buffer != NULL) free(pContext->multiCmds->buffer);
     if (pContext->multiCmds->cmds != NULL) free(pContext->multiCmds->cmds);
     free(pContext->multiCmds);
@@ -290,6 +304,7 @@ HttpSqlCmd *httpNewSqlCmd(HttpContext *pContext) {
   cmd->cmdType = HTTP_CMD_TYPE_UN_SPECIFIED;
   cmd->cmdReturnType = HTTP_CMD_RETURN_TYPE_WITH_RETURN;
   cmd->cmdState = HTTP_CMD_STATE_NOT_RUN_YET;
+  cmd->rows = NULL;
 
   return cmd;
 }
@@ -358,46 +373,63 @@ char *httpGetCmdsString(HttpContext *pContext, int pos) {
   return multiCmds->buffer + pos;
 }
 
-int httpGzipDeCompress(char *srcData, int32_t nSrcData, char *destData, int32_t *nDestData) {
-  int err = 0;
+/*
+ * inflate a gzip or zlib body into a buffer malloced here, the buffer doubles while inflating and the output is limited
+ * to maxDestData bytes, *destData is NULL terminated and shall be freed by the caller
+ */
+int httpGzipDeCompress(char *srcData, int32_t nSrcData, char **destData, int32_t *nDestData, int32_t maxDestData) {
+  int      err = 0;
   z_stream gzipStream = {0};
 
-  static char dummyHead[2] = {
-          0x8 + 0x7 * 0x10,
-          (((0x8 + 0x7 * 0x10) * 0x100 + 30) / 31 * 31) & 0xFF,
-  };
+  *destData = NULL;
+  *nDestData = 0;
 
   gzipStream.zalloc = (alloc_func) 0;
   gzipStream.zfree = (free_func) 0;
   gzipStream.opaque = (voidpf) 0;
   gzipStream.next_in = (Bytef *) srcData;
-  gzipStream.avail_in = 0;
-  gzipStream.next_out = (Bytef *) destData;
+  gzipStream.avail_in = (uInt) nSrcData;
   if (inflateInit2(&gzipStream, 47) != Z_OK) {
     return -1;
   }
 
-  while (gzipStream.total_out < *nDestData && gzipStream.total_in < nSrcData) {
-    gzipStream.avail_in = gzipStream.avail_out = nSrcData;  //1
-    if ((err = inflate(&gzipStream, Z_NO_FLUSH)) == Z_STREAM_END) {
-      break;
+  int32_t capacity = 0;
+  char   *buffer = NULL;
+  do {
+    if ((int32_t)gzipStream.total_out + 1 >= capacity) {
+      if (capacity > maxDestData) {
+        err = -2;
+        break;
+      }
+
+      capacity = (capacity == 0) ? HTTP_BUFFER_SIZE : capacity * 2;
+      if (capacity > maxDestData + 1) capacity = maxDestData + 1;
+
+      char *tmp = realloc(buffer, (size_t)capacity);
+      if (tmp == NULL) {
+        err = -3;
+        break;
+      }
+      buffer = tmp;
     }
 
-    if (err != Z_OK) {
-      if (err == Z_DATA_ERROR) {
-        gzipStream.next_in = (Bytef *) dummyHead;
-        gzipStream.avail_in = sizeof(dummyHead);
-        if ((err = inflate(&gzipStream, Z_NO_FLUSH)) != Z_OK) {
-          return -2;
-        }
-      } else return -3;
+    gzipStream.next_out = (Bytef *) (buffer + gzipStream.total_out);
+    gzipStream.avail_out = (uInt) (capacity - (int32_t)gzipStream.total_out - 1);
+    err = inflate(&gzipStream, Z_NO_FLUSH);
+    if (err == Z_BUF_ERROR && gzipStream.avail_out > 0) {
+      err = -4;  // the input is truncated
     }
-  }
+  } while (err == Z_OK || err == Z_BUF_ERROR);
 
-  if (inflateEnd(&gzipStream) != Z_OK) {
-    return -4;
+  inflateEnd(&gzipStream);
+  if (err != Z_STREAM_END) {
+    free(buffer);
+    return err < 0 ? err : -5;
   }
-  *nDestData = gzipStream.total_out;
+
+  buffer[gzipStream.total_out] = 0;
+  *destData = buffer;
+  *nDestData = (int32_t) gzipStream.total_out;
 
   return 0;
 }
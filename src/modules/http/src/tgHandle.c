@@ -16,6 +16,7 @@
 #include "tgHandle.h"
 #include "shash.h"
 #include "taosmsg.h"
+#include "tsclient.h"
 #include "tgJson.h"
 #include "tsdb.h"
 
@@ -372,6 +373,71 @@ char *tgGetStableName(char *stname, cJSON *fields, int fieldsSize) {
    "timestamp": 1458229140
  }
  */
+static void tgSetInsertValue(tVariant *pVar, cJSON *item, bool isTag, char **pStr) {
+  if (item->type == cJSON_String) {
+    pVar->nType = TSDB_DATA_TYPE_BINARY;
+    pVar->nLen = (int32_t)strlen(item->valuestring);
+    pVar->pz = *pStr;
+    memcpy(*pStr, item->valuestring, (size_t)pVar->nLen + 1);
+    *pStr += pVar->nLen + 1;
+  } else if (item->type == cJSON_Number) {
+    // tags are bigint and fields are double in the super tables created by telegraf requests
+    if (isTag) {
+      pVar->nType = TSDB_DATA_TYPE_BIGINT;
+      pVar->i64Key = item->valueint;
+    } else {
+      pVar->nType = TSDB_DATA_TYPE_DOUBLE;
+      pVar->dKey = item->valuedouble;
+    }
+  } else if (item->type == cJSON_True || item->type == cJSON_False) {
+    pVar->nType = TSDB_DATA_TYPE_BIGINT;
+    pVar->i64Key = (item->type == cJSON_True) ? 1 : 0;
+  } else {
+    pVar->nType = TSDB_DATA_TYPE_NULL;
+  }
+}
+
+/*
+ * tags and fields of a metric are converted into typed values of one row, written into the submit block by the
+ * client directly. Strings are copied, since the json is freed before the row is written.
+ */
+static SInsertRows *tgBuildInsertRows(char *db, char *table, char *stable, cJSON **tags, int tagsSize,
+                                      cJSON *timestamp, cJSON *fields, int fieldsSize) {
+  size_t size = sizeof(SInsertRows) + (size_t)(tagsSize + fieldsSize + 1) * sizeof(tVariant);
+  for (int i = 0; i < tagsSize; ++i) {
+    if (tags[i]->type == cJSON_String) size += strlen(tags[i]->valuestring) + 1;
+  }
+  for (int i = 0; i < fieldsSize; ++i) {
+    cJSON *field = cJSON_GetArrayItem(fields, i);
+    if (field->type == cJSON_String) size += strlen(field->valuestring) + 1;
+  }
+
+  SInsertRows *pRows = calloc(1, size);
+  if (pRows == NULL) return NULL;
+
+  snprintf(pRows->table, sizeof(pRows->table), "%s.%s", db, table);
+  snprintf(pRows->stable, sizeof(pRows->stable), "%s.%s", db, stable);
+  pRows->import = true;
+  pRows->numOfTags = tagsSize;
+  pRows->tags = (tVariant *)(pRows + 1);
+  pRows->numOfColumns = fieldsSize + 1;
+  pRows->numOfRows = 1;
+  pRows->values = pRows->tags + tagsSize;
+
+  char *pStr = (char *)(pRows->values + pRows->numOfColumns);
+  for (int i = 0; i < tagsSize; ++i) {
+    tgSetInsertValue(pRows->tags + i, tags[i], true, &pStr);
+  }
+
+  pRows->values[0].nType = TSDB_DATA_TYPE_BIGINT;
+  pRows->values[0].i64Key = timestamp->valueint;
+  for (int i = 0; i < fieldsSize; ++i) {
+    tgSetInsertValue(pRows->values + i + 1, cJSON_GetArrayItem(fields, i), false, &pStr);
+  }
+
+  return pRows;
+}
+
 bool tgProcessSingleMetric(HttpContext *pContext, cJSON *metric, char *db) {
   // metric name
   cJSON *name = cJSON_GetObjectItem(metric, "name");
@@ -583,23 +649,6 @@ bool tgProcessSingleMetric(HttpContext *pContext, cJSON *metric, char *db) {
   table_cmd->stable = stable_cmd->stable =
       httpShrinkTableName(pContext, table_cmd->stable, httpGetCmdsString(pContext, table_cmd->stable));
 
-  // stable tag for detail
-  for (int i = 0; i < orderTagsLen; ++i) {
-    cJSON *tag = orderedTags[i];
-    stable_cmd->tagNames[i] = table_cmd->tagNames[i] = httpAddToSqlCmdBuffer(pContext, tag->string);
-
-    if (tag->type == cJSON_String)
-      stable_cmd->tagValues[i] = table_cmd->tagValues[i] = httpAddToSqlCmdBuffer(pContext, "'%s'", tag->valuestring);
-    else if (tag->type == cJSON_Number)
-      stable_cmd->tagValues[i] = table_cmd->tagValues[i] = httpAddToSqlCmdBuffer(pContext, "%ld", tag->valueint);
-    else if (tag->type == cJSON_True)
-      stable_cmd->tagValues[i] = table_cmd->tagValues[i] = httpAddToSqlCmdBuffer(pContext, "1");
-    else if (tag->type == cJSON_False)
-      stable_cmd->tagValues[i] = table_cmd->tagValues[i] = httpAddToSqlCmdBuffer(pContext, "0");
-    else
-      stable_cmd->tagValues[i] = table_cmd->tagValues[i] = httpAddToSqlCmdBuffer(pContext, "NULL");
-  }
-
   // table name
   if (tsTelegrafUseFieldNum == 0) {
     table_cmd->table = stable_cmd->table = httpAddToSqlCmdBufferNoTerminal(pContext, "%s_%s", stname, host->valuestring);
@@ -660,68 +709,15 @@ bool tgProcessSingleMetric(HttpContext *pContext, cJSON *metric, char *db) {
       httpAddToSqlCmdBuffer(pContext, "t_%s %s)", tag_name, tag_type);
   }
 
-  // assembling insert sql
-  table_cmd->sql = httpAddToSqlCmdBufferNoTerminal(pContext, "import into %s.%s using %s.%s tags(", db,
-                                                   httpGetCmdsString(pContext, table_cmd->table), db,
-                                                   httpGetCmdsString(pContext, table_cmd->stable));
-  for (int i = 0; i < orderTagsLen; ++i) {
-    cJSON *tag = orderedTags[i];
-    if (i != orderTagsLen - 1) {
-      if (tag->type == cJSON_Number)
-        httpAddToSqlCmdBufferNoTerminal(pContext, "%ld,", tag->valueint);
-      else if (tag->type == cJSON_String)
-        httpAddToSqlCmdBufferNoTerminal(pContext, "'%s',", tag->valuestring);
-      else if (tag->type == cJSON_False)
-        httpAddToSqlCmdBufferNoTerminal(pContext, "0,");
-      else if (tag->type == cJSON_True)
-        httpAddToSqlCmdBufferNoTerminal(pContext, "1,");
-      else {
-        httpAddToSqlCmdBufferNoTerminal(pContext, "NULL,");
-      }
-    } else {
-      if (tag->type == cJSON_Number)
-        httpAddToSqlCmdBufferNoTerminal(pContext, "%ld)", tag->valueint);
-      else if (tag->type == cJSON_String)
-        httpAddToSqlCmdBufferNoTerminal(pContext, "'%s')", tag->valuestring);
-      else if (tag->type == cJSON_False)
-        httpAddToSqlCmdBufferNoTerminal(pContext, "0)");
-      else if (tag->type == cJSON_True)
-        httpAddToSqlCmdBufferNoTerminal(pContext, "1)");
-      else {
-        httpAddToSqlCmdBufferNoTerminal(pContext, "NULL)");
-      }
-    }
-  }
-
-  httpAddToSqlCmdBufferNoTerminal(pContext, " values(%ld,", timestamp->valueint);
-  for (int i = 0; i < fieldsSize; ++i) {
-    cJSON *field = cJSON_GetArrayItem(fields, i);
-    if (i != fieldsSize - 1) {
-      if (field->type == cJSON_Number)
-        httpAddToSqlCmdBufferNoTerminal(pContext, "%lf,", field->valuedouble);
-      else if (field->type == cJSON_String)
-        httpAddToSqlCmdBufferNoTerminal(pContext, "'%s',", field->valuestring);
-      else if (field->type == cJSON_False)
-        httpAddToSqlCmdBufferNoTerminal(pContext, "0,");
-      else if (field->type == cJSON_True)
-        httpAddToSqlCmdBufferNoTerminal(pContext, "1,");
-      else {
-        httpAddToSqlCmdBufferNoTerminal(pContext, "NULL,");
-      }
-    } else {
-      if (field->type == cJSON_Number)
-        httpAddToSqlCmdBuffer(pContext, "%lf)", field->valuedouble);
-      else if (field->type == cJSON_String)
-        httpAddToSqlCmdBuffer(pContext, "'%s')", field->valuestring);
-      else if (field->type == cJSON_False)
-        httpAddToSqlCmdBuffer(pContext, "0)");
-      else if (field->type == cJSON_True)
-        httpAddToSqlCmdBuffer(pContext, "1)");
-      else {
-        httpAddToSqlCmdBuffer(pContext, "NULL)");
-      }
-    }
+  // the row is written without sql, the table name is shown in logs instead
+  table_cmd->rows = tgBuildInsertRows(db, httpGetCmdsString(pContext, table_cmd->table),
+                                      httpGetCmdsString(pContext, table_cmd->stable), orderedTags, orderTagsLen,
+                                      timestamp, fields, fieldsSize);
+  if (table_cmd->rows == NULL) {
+    httpSendErrorResp(pContext, HTTP_NO_ENOUGH_MEMORY);
+    return false;
   }
+  table_cmd->sql = table_cmd->table;
 
   return true;
 }
@@ -340,6 +340,9 @@ int taosSendTcpServerData(unsigned int ip, uint16_t port, char *data, int len, v
   exit(0);
 }
 
+// there is no TCP server in darwin, so the message is allocated by malloc as the ones from UDP
+void taosFreeTcpServerMsg(void *data) { free(data); }
+
 void taosFreeMsgHdr(void *hdr) {
   tError("function taosFreeMsgHdr is not implemented in darwin system, exit!");
   exit(0);
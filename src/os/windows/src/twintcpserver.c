@@ -13,6 +13,8 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <stdlib.h>
+
 #include "tlog.h"
 
 void taosCloseTcpServerConnection(void *chandle) {
@@ -32,3 +34,6 @@ int taosSendTcpServerData(unsigned int ip, uint16_t port, char *data, int len, v
   tError("SendTcpServerData not support in windows");
   return 0;
 }
+
+// there is no TCP server in windows, so the message is allocated by malloc as the ones from UDP
+void taosFreeTcpServerMsg(void *data) { free(data); }
@@ -63,6 +63,7 @@ typedef struct {
   char               inType;
   char               closing;
   char               rspReceived;
+  char               backoff;  // checks of the outgoing transaction in process at peer back off
   void *             chandle;  // handle passed by TCP/UDP connection layer
   void *             ahandle;  // handle returned by upper app layter
   int                retry;
@@ -110,8 +111,15 @@ typedef struct rpc_server {
 
 int      tsRpcProgressTime = 10;  // milliseocnds
 
+/*
+ * a transaction of a long waiting request, such as a subscription parked at vnode, is checked less and less often
+ * while it is in process at peer, up to every tsRpcProgressTime << RPC_MAX_PROGRESS_SHIFT ms
+ */
+#define RPC_MAX_PROGRESS_SHIFT 8
+
 // not configurable
 int tsRpcMaxRetry;
+int tsRpcMaxBackoffRetry;
 int tsRpcHeadSize;
 
 void *(*taosInitConn[])(char *ip, uint16_t port, char *label, int threads, void *fp, void *shandle) = {
@@ -132,6 +140,9 @@ void *(*taosOpenConn[])(void *shandle, void *thandle, char *ip, uint16_t port) =
 
 void (*taosCloseConn[])(void *chandle) = {NULL, NULL, taosCloseTcpServerConnection, taosCloseTcpClientConnection};
 
+// received messages of TCP server are in the slabs of the connection, they are released to the slab pool
+void (*taosFreeMsg[])(void *data) = {free, free, taosFreeTcpServerMsg, free};
+
 int   taosReSendRspToPeer(SRpcConn *pConn);
 void  taosProcessTaosTimer(void *, void *);
 void *taosProcessDataFromPeer(char *data, int dataLen, uint32_t ip, uint16_t port, void *shandle, void *thandle,
@@ -294,6 +305,7 @@ void *taosOpenRpc(SRpcInit *pRpc) {
   STaosRpc *pServer;
 
   tsRpcMaxRetry = tsRpcMaxTime * 1000 / tsRpcProgressTime;
+  tsRpcMaxBackoffRetry = tsRpcMaxTime * 1000 / (tsRpcProgressTime << RPC_MAX_PROGRESS_SHIFT) + RPC_MAX_PROGRESS_SHIFT;
   tsRpcHeadSize = sizeof(STaosHeader) + sizeof(SMsgNode);
 
   pServer = (STaosRpc *)malloc(sizeof(STaosRpc));
@@ -910,11 +922,12 @@ int taosProcessMsgHeader(STaosHeader *pHeader, SRpcConn **ppConn, STaosRpc *pSer
     pConn->retry = 0;
 
     if (*pHeader->content == TSDB_CODE_ACTION_IN_PROGRESS || pHeader->tcp) {
-      if (pConn->tretry <= tsRpcMaxRetry) {
+      if (pConn->tretry <= (pConn->backoff ? tsRpcMaxBackoffRetry : tsRpcMaxRetry)) {
         tTrace("%s cid:%d sid:%d id:%s, peer is still processing the transaction, pConn:%p", pServer->label, chann, sid,
                pHeader->meterId, pConn);
+        int shift = pConn->backoff ? MIN(pConn->tretry, RPC_MAX_PROGRESS_SHIFT) : 0;
         pConn->tretry++;
-        taosTmrReset(taosProcessTaosTimer, tsRpcProgressTime, pConn, pChann->tmrCtrl, &pConn->pTimer);
+        taosTmrReset(taosProcessTaosTimer, tsRpcProgressTime << shift, pConn, pChann->tmrCtrl, &pConn->pTimer);
         code = TSDB_CODE_ALREADY_PROCESSED;
         goto _exit;
       } else {
@@ -1037,7 +1050,7 @@ void *taosProcessDataFromPeer(char *data, int dataLen, uint32_t ip, uint16_t por
       schedMsg.thandle = pConn;
       taosScheduleTask(pChann->qhandle, &schedMsg);
     }
-    tfree(data);
+    (*taosFreeMsg[pServer->type])(data);
     return NULL;
   }
 
@@ -1059,7 +1072,7 @@ void *taosProcessDataFromPeer(char *data, int dataLen, uint32_t ip, uint16_t por
     tTrace("%s cid:%d sid:%d id:%s, %s wont be processed, source:0x%08x dest:0x%08x tranId:%d pConn:%p", pServer->label,
            chann, sid, pHeader->meterId, taosMsg[pHeader->msgType], pHeader->sourceId, htonl(pHeader->destId),
            pHeader->tranId, pConn);
-    free(data);
+    (*taosFreeMsg[pServer->type])(data);
     return pConn;
   }
 
@@ -1085,7 +1098,7 @@ void *taosProcessDataFromPeer(char *data, int dataLen, uint32_t ip, uint16_t por
              pHeader->meterId, taosMsg[pHeader->msgType], code, pConn);
     }
 
-    free(data);
+    (*taosFreeMsg[pServer->type])(data);
   } else {
     // parsing OK
 
@@ -1110,6 +1123,8 @@ void *taosProcessDataFromPeer(char *data, int dataLen, uint32_t ip, uint16_t por
     schedMsg.ahandle = pConn->ahandle;
     schedMsg.thandle = pConn;
     taosScheduleTask(pChann->qhandle, &schedMsg);
+
+    if (schedMsg.msg == NULL) (*taosFreeMsg[pServer->type])(data);
   }
 
   return pConn;
@@ -1330,6 +1345,13 @@ int taosGetOutType(void *thandle) {
   return pConn->outType;
 }
 
+void taosSetRpcConnBackoff(void *thandle, int backoff) {
+  SRpcConn *pConn = (SRpcConn *)thandle;
+  if (pConn == NULL) return;
+
+  pConn->backoff = (backoff != 0);
+}
+
 void taosProcessSchedMsg(SSchedMsg *pMsg) {
   SIntMsg * pHeader = (SIntMsg *)pMsg->msg;
   SRpcConn *pConn = (SRpcConn *)pMsg->thandle;
@@ -1345,7 +1367,7 @@ void taosProcessSchedMsg(SSchedMsg *pMsg) {
     if (pHeader && ((pHeader->msgType & 1) == 0)) taosProcessResponse(pConn);
   }
 
-  if (pMsg->msg) free(pMsg->msg - sizeof(STaosHeader) + sizeof(SIntMsg));
+  if (pMsg->msg) (*taosFreeMsg[pRpc->type])(pMsg->msg - sizeof(STaosHeader) + sizeof(SIntMsg));
 }
 
 void taosStopRpcConn(void *thandle) {
@@ -26,6 +26,27 @@
   #define EPOLLWAKEUP (1u << 29)
 #endif
 
+#define TCP_SLAB_SIZE      (64 * 1024)  // power of 2, slabs are aligned to it
+#define TCP_MAX_FREE_SLABS 16           // slabs kept by each thread for reuse
+#define TCP_COPY_MSG_SIZE  (4 * 1024)   // smaller messages are copied out instead of holding the slab
+#define TCP_COPY_MSG_ALIGN 8             // alignment of the messages copied into a shared slab
+
+/*
+ * Received bytes are kept in slabs. Large complete messages are handed to the upper layer in place, each one holds a
+ * reference on its slab, and the connection holds one more for the slab it is reading into. Small messages are
+ * copied one after another into a slab shared by all connections of the thread, which the thread holds a reference
+ * on until it is full, so a small message kept long by the upper layer does not pin the slab of a connection.
+ * Since a slab is aligned to TCP_SLAB_SIZE and a message is carved only if it starts within the first TCP_SLAB_SIZE
+ * bytes, the slab of a message is found by masking its address when the upper layer frees it.
+ */
+typedef struct _recv_slab {
+  struct _thread_obj *pThreadObj;
+  struct _recv_slab * next;  // in the free list of the thread
+  int32_t             refCount;
+  int32_t             size;  // size of data
+  char                data[];
+} SRecvSlab;
+
 typedef struct _fd_obj {
   void               *signature;
   int                 fd;       // TCP socket FD
@@ -35,6 +56,9 @@ typedef struct _fd_obj {
   uint16_t            port;
   struct _thread_obj *pThreadObj;
   struct _fd_obj *    prev, *next;
+  SRecvSlab *         pSlab;  // slab the data is received into
+  int32_t             start;  // first byte not handed to the upper layer
+  int32_t             end;    // end of the received bytes
 } SFdObj;
 
 typedef struct _thread_obj {
@@ -50,6 +74,11 @@ typedef struct _thread_obj {
   void *shandle;  // handle passed by upper layer during server initialization
   void *(*processData)(char *data, int dataLen, unsigned int ip, uint16_t port, void *shandle, void *thandle,
                        void *chandle);
+  pthread_mutex_t slabMutex;
+  SRecvSlab *     pFreeSlab;
+  int             numOfFreeSlabs;
+  SRecvSlab *     pCopySlab;   // slab the small messages are copied into, only used by the thread itself
+  int32_t         copyOffset;  // first free byte of pCopySlab
 } SThreadObj;
 
 typedef struct {
@@ -62,6 +91,84 @@ typedef struct {
   pthread_t   thread;
 } SServerObj;
 
+static SRecvSlab *taosAllocRecvSlab(SThreadObj *pThreadObj, int32_t size) {
+  SRecvSlab *pSlab = NULL;
+  size_t     slabSize = TCP_SLAB_SIZE;
+
+  while (slabSize < sizeof(SRecvSlab) + (size_t)size) slabSize += TCP_SLAB_SIZE;
+
+  if (slabSize == TCP_SLAB_SIZE) {
+    pthread_mutex_lock(&pThreadObj->slabMutex);
+    pSlab = pThreadObj->pFreeSlab;
+    if (pSlab) {
+      pThreadObj->pFreeSlab = pSlab->next;
+      pThreadObj->numOfFreeSlabs--;
+    }
+    pthread_mutex_unlock(&pThreadObj->slabMutex);
+  }
+
+  if (pSlab == NULL) {
+    if (posix_memalign((void **)&pSlab, TCP_SLAB_SIZE, slabSize) != 0) return NULL;
+    pSlab->pThreadObj = pThreadObj;
+    pSlab->size = (int32_t)(slabSize - sizeof(SRecvSlab));
+  }
+
+  pSlab->next = NULL;
+  pSlab->refCount = 1;
+
+  return pSlab;
+}
+
+static void taosReleaseRecvSlab(SRecvSlab *pSlab) {
+  if (atomic_sub_fetch_32(&pSlab->refCount, 1) > 0) return;
+
+  SThreadObj *pThreadObj = pSlab->pThreadObj;
+  if (pSlab->size == (int32_t)(TCP_SLAB_SIZE - sizeof(SRecvSlab))) {
+    pthread_mutex_lock(&pThreadObj->slabMutex);
+    if (pThreadObj->numOfFreeSlabs < TCP_MAX_FREE_SLABS) {
+      pSlab->next = pThreadObj->pFreeSlab;
+      pThreadObj->pFreeSlab = pSlab;
+      pThreadObj->numOfFreeSlabs++;
+      pSlab = NULL;
+    }
+    pthread_mutex_unlock(&pThreadObj->slabMutex);
+  }
+
+  free(pSlab);
+}
+
+/*
+ * copy a small message into the shared slab of the thread, a new slab is taken when the message does not fit
+ * @return the copy, which holds a reference on the shared slab
+ */
+static char *taosCopyToMsgSlab(SThreadObj *pThreadObj, char *data, int32_t dataLen) {
+  SRecvSlab *pSlab = pThreadObj->pCopySlab;
+
+  if (pSlab == NULL || pThreadObj->copyOffset + dataLen > pSlab->size) {
+    pSlab = taosAllocRecvSlab(pThreadObj, 0);
+    if (pSlab == NULL) return NULL;
+
+    if (pThreadObj->pCopySlab) taosReleaseRecvSlab(pThreadObj->pCopySlab);
+    pThreadObj->pCopySlab = pSlab;
+    pThreadObj->copyOffset = 0;
+  }
+
+  char *msg = pSlab->data + pThreadObj->copyOffset;
+  memcpy(msg, data, (size_t)dataLen);
+  atomic_add_fetch_32(&pSlab->refCount, 1);
+
+  pThreadObj->copyOffset += (dataLen + TCP_COPY_MSG_ALIGN - 1) & ~(TCP_COPY_MSG_ALIGN - 1);
+
+  return msg;
+}
+
+void taosFreeTcpServerMsg(void *data) {
+  if (data == NULL) return;
+
+  SRecvSlab *pSlab = (SRecvSlab *)((uintptr_t)data & ~((uintptr_t)TCP_SLAB_SIZE - 1));
+  taosReleaseRecvSlab(pSlab);
+}
+
 static void taosCleanUpFdObj(SFdObj *pFdObj) {
   SThreadObj *pThreadObj;
 
@@ -101,6 +208,8 @@ static void taosCleanUpFdObj(SFdObj *pFdObj) {
   // notify the upper layer, so it will clean the associated context
   if (pFdObj->thandle) (*(pThreadObj->processData))(NULL, 0, 0, 0, pThreadObj->shandle, pFdObj->thandle, NULL);
 
+  if (pFdObj->pSlab) taosReleaseRecvSlab(pFdObj->pSlab);
+
   tTrace("%s TCP thread:%d, FD is cleaned up, numOfFds:%d", pThreadObj->label, pThreadObj->threadId,
          pThreadObj->numOfFds);
 
@@ -140,6 +249,16 @@ void taosCleanUpTcpServer(void *handle) {
     pthread_join(pThreadObj->thread, NULL);
     pthread_cond_destroy(&(pThreadObj->fdReady));
     pthread_mutex_destroy(&(pThreadObj->threadMutex));
+
+    if (pThreadObj->pCopySlab) taosReleaseRecvSlab(pThreadObj->pCopySlab);
+    pThreadObj->pCopySlab = NULL;
+
+    while (pThreadObj->pFreeSlab) {
+      SRecvSlab *pSlab = pThreadObj->pFreeSlab;
+      pThreadObj->pFreeSlab = pSlab->next;
+      free(pSlab);
+    }
+    pthread_mutex_destroy(&(pThreadObj->slabMutex));
   }
 
   tfree(pServerObj->pThreadObj);
@@ -150,6 +269,132 @@ void taosCleanUpTcpServer(void *handle) {
 
 #define maxEvents 10
 
+/*
+ * make sure the slab has room for the pending message, or at least its header. The bytes received are moved to the
+ * front of the slab if no message is referring to it, otherwise into a new slab.
+ */
+static int taosPrepareRecvSlab(SThreadObj *pThreadObj, SFdObj *pFdObj) {
+  SRecvSlab *pSlab = pFdObj->pSlab;
+  int32_t    len = pFdObj->end - pFdObj->start;
+  int32_t    need = sizeof(STaosHeader);
+
+  if (len >= (int32_t)sizeof(STaosHeader)) {
+    need = (int32_t)htonl((uint32_t)((STaosHeader *)(pSlab->data + pFdObj->start))->msgLen);
+    if (need < (int32_t)sizeof(STaosHeader)) need = sizeof(STaosHeader);  // rejected when it is carved
+  }
+
+  if (pSlab && pFdObj->start + need <= pSlab->size && pFdObj->end < pSlab->size &&
+      sizeof(SRecvSlab) + pFdObj->start < TCP_SLAB_SIZE) {
+    return 0;
+  }
+
+  if (pSlab && need <= pSlab->size && atomic_load_32(&pSlab->refCount) == 1) {
+    memmove(pSlab->data, pSlab->data + pFdObj->start, (size_t)len);
+  } else {
+    SRecvSlab *pNew = taosAllocRecvSlab(pThreadObj, need);
+    if (pNew == NULL) {
+      tError("%s TCP thread:%d, failed to allocate receive buffer, size:%d", pThreadObj->label, pThreadObj->threadId,
+             need);
+      return -1;
+    }
+
+    if (pSlab) {
+      memcpy(pNew->data, pSlab->data + pFdObj->start, (size_t)len);
+      taosReleaseRecvSlab(pSlab);
+    }
+    pFdObj->pSlab = pNew;
+  }
+
+  pFdObj->start = 0;
+  pFdObj->end = len;
+
+  return 0;
+}
+
+/*
+ * pass each complete message in the slab to the upper layer, only the small ones are copied
+ * @return 1 if messages are left since they are beyond the first TCP_SLAB_SIZE bytes, -1 if FD is cleaned up
+ */
+static int taosCarveTcpMsgs(SThreadObj *pThreadObj, SFdObj *pFdObj) {
+  SRecvSlab *pSlab = pFdObj->pSlab;
+
+  while (pFdObj->end - pFdObj->start >= (int32_t)sizeof(STaosHeader)) {
+    if (sizeof(SRecvSlab) + pFdObj->start >= TCP_SLAB_SIZE) return 1;
+
+    char *buffer = pSlab->data + pFdObj->start;
+    int   dataLen = (int32_t)htonl((uint32_t)((STaosHeader *)buffer)->msgLen);
+
+    if (dataLen < (int32_t)sizeof(STaosHeader)) {
+      tError("%s TCP thread:%d, invalid msg length:%d", pThreadObj->label, pThreadObj->threadId, dataLen);
+      taosCleanUpFdObj(pFdObj);
+      return -1;
+    }
+
+    if (pFdObj->end - pFdObj->start < dataLen) break;
+
+    if (dataLen < TCP_COPY_MSG_SIZE) {
+      buffer = taosCopyToMsgSlab(pThreadObj, buffer, dataLen);
+      if (buffer == NULL) {
+        tError("%s TCP thread:%d, failed to allocate msg buffer, size:%d", pThreadObj->label, pThreadObj->threadId,
+               dataLen);
+        taosCleanUpFdObj(pFdObj);
+        return -1;
+      }
+    } else {
+      atomic_add_fetch_32(&pSlab->refCount, 1);
+    }
+
+    pFdObj->start += dataLen;
+
+    pFdObj->thandle = (*(pThreadObj->processData))(buffer, dataLen, pFdObj->ip, pFdObj->port, pThreadObj->shandle,
+                                                   pFdObj->thandle, pFdObj);
+
+    if (pFdObj->thandle == NULL) {
+      taosCleanUpFdObj(pFdObj);
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+/*
+ * read all the bytes available on the FD, one recv fills as much of the slab as possible
+ */
+static void taosReadTcpData(SThreadObj *pThreadObj, SFdObj *pFdObj) {
+  int more = 1;  // socket may have more bytes
+
+  while (1) {
+    if (taosPrepareRecvSlab(pThreadObj, pFdObj) < 0) {
+      taosCleanUpFdObj(pFdObj);
+      return;
+    }
+
+    if (more) {
+      SRecvSlab *pSlab = pFdObj->pSlab;
+      int32_t    room = pSlab->size - pFdObj->end;
+      ssize_t    retLen = recv(pFdObj->fd, pSlab->data + pFdObj->end, (size_t)room, MSG_DONTWAIT);
+
+      if (retLen < 0 && errno == EINTR) continue;
+
+      if (retLen < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        more = 0;
+      } else if (retLen <= 0) {
+        tError("%s read error, retLen:%d, errno:%d", pThreadObj->label, (int)retLen, errno);
+        taosCleanUpFdObj(pFdObj);
+        return;
+      } else {
+        pFdObj->end += (int32_t)retLen;
+        more = (retLen == room);
+      }
+    }
+
+    int code = taosCarveTcpMsgs(pThreadObj, pFdObj);
+    if (code < 0) return;
+    if (code == 0 && more == 0) return;
+  }
+}
+
 static void taosProcessTcpData(void *param) {
   SThreadObj *       pThreadObj;
   int                i, fdNum;
@@ -183,36 +428,7 @@ static void taosProcessTcpData(void *param) {
         continue;
       }
 
-      void *buffer = malloc(1024);
-      int   headLen = taosReadMsg(pFdObj->fd, buffer, sizeof(STaosHeader));
-
-      if (headLen != sizeof(STaosHeader)) {
-        tError("%s read error, headLen:%d, errno:%d", pThreadObj->label, headLen, errno);
-        taosCleanUpFdObj(pFdObj);
-        tfree(buffer);
-        continue;
-      }
-
-      int dataLen = (int32_t)htonl((uint32_t)((STaosHeader *)buffer)->msgLen);
-      if (dataLen > 1024) buffer = realloc(buffer, (size_t)dataLen);
-
-      int leftLen = dataLen - headLen;
-      int retLen = taosReadMsg(pFdObj->fd, buffer + headLen, leftLen);
-
-      // tTrace("%s TCP data is received, ip:%s port:%u len:%d",
-      // pThreadObj->label, pFdObj->ipstr, pFdObj->port, dataLen);
-
-      if (leftLen != retLen) {
-        tError("%s read error, leftLen:%d retLen:%d", pThreadObj->label, leftLen, retLen);
-        taosCleanUpFdObj(pFdObj);
-        tfree(buffer);
-        continue;
-      }
-
-      pFdObj->thandle = (*(pThreadObj->processData))(buffer, dataLen, pFdObj->ip, pFdObj->port,
-                                                     pThreadObj->shandle, pFdObj->thandle, pFdObj);
-
-      if (pFdObj->thandle == NULL) taosCleanUpFdObj(pFdObj);
+      taosReadTcpData(pThreadObj, pFdObj);
     }
   }
 }
@@ -404,6 +620,11 @@ void *taosInitTcpServer(char *ip, uint16_t port, char *label, int numOfThreads,
       return NULL;
     }
 
+    if (pthread_mutex_init(&(pThreadObj->slabMutex), NULL) < 0) {
+      tError("%s failed to init TCP slab mutex, reason:%s", label, strerror(errno));
+      return NULL;
+    }
+
     if (pthread_cond_init(&(pThreadObj->fdReady), NULL) != 0) {
       tError("%s init TCP condition variable failed, reason:%s\n", label, strerror(errno));
       return NULL;
@@ -119,12 +119,14 @@ typedef struct _tab_obj {
   short   nextColId;
   char    meterType : 4;
   char    status : 3;
-  char    isDirty : 1;  // if the table change tag column 1 value
+  char    isDirty : 1;  // if the table change tag value, it is re-indexed in the metric
   char    reserved[15];
   char    updateEnd[1];
 
   pthread_rwlock_t rwLock;
   tSkipList *      pSkipList;
+  struct SMetricTagIndex *pTagIndex;  // for metric, inverted index of all tag columns
+  int32_t          tagIndexOrd;       // for meter, ordinal in the tag index of its metric
   struct _tab_obj *pHead;  // for metric, a link list for all meters created
                            // according to this metric
   char *pTagData;          // TSDB_METER_ID_LEN(metric_name)+
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_MGMTTAGINDEX_H
+#define TDENGINE_MGMTTAGINDEX_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "os.h"
+
+#include "mgmt.h"
+#include "tbitmap.h"
+#include "tskiplist.h"
+
+/*
+ * one distinct value of a tag column, and the ordinals of all meters with this value
+ */
+typedef struct STagIndexEntry {
+  tBitmap *pBitmap;
+  char     val[];
+} STagIndexEntry;
+
+/*
+ * inverted index of all tag columns of a metric, each meter created from the metric gets an ordinal in the index.
+ * The index is protected by the rwLock of the metric.
+ */
+typedef struct SMetricTagIndex {
+  int32_t     numOfTags;
+  tSkipList **pColIndex;      // one for each tag column, tag value -> STagIndexEntry
+  STabObj **  pMeters;        // ordinal -> meter, NULL if the ordinal is not used
+  int32_t     numOfOrdinals;  // ordinals allocated so far
+  int32_t     capacity;
+  int32_t *   pFreeOrdinals;  // ordinals of removed meters, reused first
+  int32_t     numOfFree;
+} SMetricTagIndex;
+
+/*
+ * add a meter into the tag index of its metric. If the index does not exist yet, it is built from all meters
+ * linked to the metric, which contains pMeter already.
+ */
+void mgmtAddMeterIntoTagIndex(STabObj *pMetric, STabObj *pMeter);
+
+void mgmtRemoveMeterFromTagIndex(STabObj *pMetric, STabObj *pMeter);
+
+/*
+ * the last numOfCols tag columns of the metric are newly added, all meters have the default value of them
+ */
+void mgmtTagIndexAddTagCols(STabObj *pMetric, int32_t numOfCols);
+
+void mgmtTagIndexDropTagCol(STabObj *pMetric, int32_t col);
+
+void *mgmtTagIndexDestroy(SMetricTagIndex *pIndex);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TDENGINE_MGMTTAGINDEX_H
@@ -28,6 +28,7 @@ extern "C" {
 #include "tmempool.h"
 #include "trpc.h"
 #include "tsclient.h"
+#include "tscompression.h"
 #include "tsdb.h"
 #include "tsocket.h"
 #include "ttime.h"
@@ -42,6 +43,7 @@ extern "C" {
 #define TSDB_FILE_HEADER_VERSION_SIZE 32
 #define TSDB_CACHE_POS_BITS           13
 #define TSDB_CACHE_POS_MASK           0x1FFF
+#define TSDB_CACHE_INSERT_TILE_ROWS   64
 
 #define TSDB_ACTION_INSERT 0
 #define TSDB_ACTION_IMPORT 1
@@ -83,6 +85,12 @@ typedef struct {
   char    data[];
 } SData;
 
+typedef struct {
+  SShellObj *pObj;
+  void *     thandle;  // the response is dropped if the connection is gone before the log is flushed
+  int32_t    numOfPoints;
+} SSubmitRspInfo;
+
 #pragma pack(push, 8)
 typedef struct {
   SVnodeStatisticInfo vnodeStatistic;
@@ -126,6 +134,7 @@ typedef struct {
   int             lfd;  // last file FD
   int             tfd;  // temp last file FD
   int             dfd;  // data file FD
+  int32_t         fileVersion;  // odd while files are being replaced, keys the decompressed blocks in block cache
   int64_t         dfSize;
   int64_t         lfSize;
   uint64_t *      fmagic;  // hold magic number for each file
@@ -135,14 +144,26 @@ typedef struct {
   char            tfn[TSDB_FILENAME_LEN];  // temp last file name
   pthread_mutex_t vmutex;
 
-  int             logFd;
-  char *          pMem;
-  char *          pWrite;
-  pthread_mutex_t logMutex;
-  char            logFn[TSDB_FILENAME_LEN];
-  char            logOFn[TSDB_FILENAME_LEN];
-  int64_t         mappingSize;
-  int64_t         mappingThreshold;
+  int              logFd;
+  char *           pMem;
+  char *           pWrite;           // reserved by writers with CAS, data before it may still be in copying
+  char *           pSync;            // commit log before this position has been flushed to disk
+  int32_t          logEpoch;         // moved by each flush, it separates the writers copying before and after it
+  int32_t          numOfCopying[2];  // writers copying into the log, indexed by the parity of the epoch they start in
+  pthread_rwlock_t logLock;          // shared by writers copying into the log, exclusive for renewing the log
+  pthread_mutex_t  syncMutex;        // one flush of the commit log at a time
+  char             logFn[TSDB_FILENAME_LEN];
+  char             logOFn[TSDB_FILENAME_LEN];
+  int64_t          mappingSize;
+  int64_t          mappingThreshold;
+
+  void *          syncTimer;    // group commit timer
+  int8_t          syncInTimer;  // the group commit timer is flushing the log
+  int8_t          syncClosing;  // the group commit timer is not started any more
+  pthread_mutex_t rspMutex;
+  SSubmitRspInfo *pDelayedRsp;  // submit responses delayed until the commit log is flushed
+  int32_t         numOfDelayedRsp;
+  int32_t         maxDelayedRsp;
 
   void *         commitTimer;
   void **        meterList;
@@ -151,6 +172,7 @@ typedef struct {
   pthread_t      thread;
   int            peersOnline;
   int            shellConns;
+  int32_t        numOfSubs;  // subscriptions parked or scheduled, the shell objects are kept until it is 0
   int            meterConns;
   struct _qinfo *pQInfoList;
 
@@ -244,10 +266,15 @@ struct SColumnFilterElem;
 
 typedef bool (*__filter_func_t)(struct SColumnFilterElem *pFilter, char *val1, char *val2);
 
+// evaluate a filter on numOfRows consecutive values, res[i] is set to 1 if the i-th value is qualified, 0 otherwise
+typedef void (*__filter_batch_func_t)(struct SColumnFilterElem *pFilter, const char *data, int32_t numOfRows,
+                                      uint8_t *res);
+
 typedef struct SColumnFilterElem {
-  int16_t           bytes;  // column length
-  __filter_func_t   fp;
-  SColumnFilterInfo filterInfo;
+  int16_t               bytes;  // column length
+  __filter_func_t       fp;
+  __filter_batch_func_t fpBatch;  // NULL if the filter has no batch version, e.g., on binary/nchar column
+  SColumnFilterInfo     filterInfo;
 } SColumnFilterElem;
 
 typedef struct SSingleColumnFilterInfo {
@@ -255,6 +282,14 @@ typedef struct SSingleColumnFilterInfo {
   int32_t            numOfFilters;
   SColumnFilterElem *pFilters;
   char *             pData;
+
+  /*
+   * set when the column of current file block is dictionary encoded, the filters are evaluated once for each
+   * distinct value and the rows only look up the result of their values
+   */
+  char *             pDictData;  // column buffer the codes belong to
+  uint8_t *          pDictCodes;
+  bool               dictMatch[STRING_DICT_MAX_ENTRIES];
 } SSingleColumnFilterInfo;
 
 typedef struct SQuery {
@@ -327,6 +362,8 @@ extern uint32_t   tsRebootTime;
 extern void **    rpcQhandle;
 extern void *     dmQhandle;
 extern void *     queryQhandle;
+extern void *     queryWorkerQhandle;
+extern void *     commitQhandle;
 extern int        tsVnodePeers;
 extern int        tsMaxVnode;
 extern int        tsMaxQueues;
@@ -341,7 +378,7 @@ void *vnodeQueryInTimeRange(SMeterObj **pMeterObj, SSqlGroupbyExpr *pGroupbyExpr
                             SQueryMeterMsg *pQueryMsg, int *code);
 
 void *vnodeQueryOnMultiMeters(SMeterObj **pMeterObj, SSqlGroupbyExpr *pGroupbyExpr, SSqlFunctionExpr *pSqlExprs,
-                              SQueryMeterMsg *pQueryMsg, int *code);
+                              SQueryMeterMsg *pQueryMsg, int32_t parallelism, int *code);
 
 // assistant/tool functions
 SSqlGroupbyExpr *vnodeCreateGroupbyExpr(SQueryMeterMsg *pQuery, int32_t *code);
@@ -353,7 +390,7 @@ bool vnodeIsValidVnodeCfg(SVnodeCfg *pCfg);
 
 int32_t vnodeGetResultSize(void *handle, int32_t *numOfRows);
 
-int32_t vnodeCopyQueryResultToMsg(void *handle, char *data, int32_t numOfRows, int32_t *size);
+int32_t vnodeCopyQueryResultToMsg(void *handle, char *data, int32_t numOfRows, int32_t *size, int16_t *compress);
 
 int64_t vnodeGetOffsetVal(void *thandle);
 
@@ -361,7 +398,7 @@ bool vnodeHasRemainResults(void *handle);
 
 int vnodeRetrieveQueryResult(void *handle, int *pNum, char *argv[]);
 
-int vnodeSaveQueryResult(void *handle, char *data, int32_t* size);
+int vnodeSaveQueryResult(void *handle, char *data, int32_t* size, int16_t *compress);
 
 int vnodeRetrieveQueryInfo(void *handle, int *numOfRows, int *rowSize, int16_t *timePrec);
 
@@ -373,6 +410,8 @@ bool vnodeIsQInfoValid(void *param);
 
 int32_t vnodeConvertQueryMeterMsg(SQueryMeterMsg *pQuery);
 
+int32_t vnodeGetQueryParallelism(SQueryMeterMsg *pQuery, int32_t msgLen);
+
 void vnodeQueryData(SSchedMsg *pMsg);
 
 // meter API
@@ -388,6 +427,21 @@ int vnodeInsertPoints(SMeterObj *pObj, char *cont, int contLen, char source, voi
 
 int vnodeImportPoints(SMeterObj *pObj, char *cont, int contLen, char source, void *, int sversion, int *numOfPoints, TSKEY now);
 
+// merge the import buffers of meters in [ssid, esid] by the commit thread, before the commit log is renewed
+void vnodeMergeImportBuffers(SVnodeObj *pVnode, int ssid, int esid);
+
+/*
+ * write the imports left in the buffers of meters in [ssid, esid] into the new commit log, since the old one is going
+ * to be removed
+ * @return 0: success, -1: failed to write the commit log
+ */
+int vnodeRelogImportBuffers(SVnodeObj *pVnode, int ssid, int esid);
+
+// start a timer to merge the import buffer of a meter, once all queries on it are over
+void vnodeScheduleImportMerge(SMeterObj *pObj);
+
+void vnodeFreeImportBuffer(SCachePool *pPool, SCacheInfo *pInfo);
+
 int vnodeInsertBufferedPoints(int vnode);
 
 int vnodeSaveAllMeterObjToFile(int vnode);
@@ -411,6 +465,8 @@ void vnodeSetCommitQuery(SMeterObj *pObj, SQuery *pQuery);
 
 int vnodeInsertPointToCache(SMeterObj *pObj, char *pData);
 
+int vnodeInsertBatchToCache(SMeterObj *pObj, char *pData, int numOfPoints);
+
 int vnodeQueryFromCache(SMeterObj *pObj, SQuery *pQuery);
 
 uint64_t vnodeGetPoolCount(SVnodeObj *pVnode);
@@ -523,6 +579,8 @@ int vnodeOpenShellVnode(int vnode);
 
 void vnodeCloseShellVnode(int vnode);
 
+void vnodeNotifySubscribers(SMeterObj *pObj);
+
 // memter mgmt
 int  vnodeInitMeterMgmt();
 
@@ -570,6 +628,12 @@ int vnodeInitCommit(int vnode);
 
 void vnodeCleanUpCommit(int vnode);
 
+void vnodeSyncCommitLog(SVnodeObj *pVnode);
+
+void vnodeDelaySubmitRsp(SVnodeObj *pVnode, SShellObj *pObj, int numOfPoints);
+
+int vnodeSendShellSubmitRspMsg(SShellObj *pObj, int code, int numOfPoints);
+
 int vnodeRenewCommitLog(int vnode);
 
 void vnodeRemoveCommitLog(int vnode);
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_VNODEBLOCKCACHE_H
+#define TDENGINE_VNODEBLOCKCACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Decompressed column chunks of file blocks, shared by all queries of the dnode and bounded by blockCacheSize.
+ * A chunk is identified by (vnode, fileId, file version, block offset, last, colId). The file version of a vnode is
+ * bumped when commit, import or file removal replaces its files, so chunks read from a replaced file are never
+ * served to queries that opened the new one.
+ */
+typedef struct SBlockCacheKey {
+  int32_t vnode;
+  int32_t fileId;
+  int32_t version;
+  int16_t colId;
+  int16_t last;
+  int64_t offset;
+} SBlockCacheKey;
+
+int32_t vnodeInitBlockCache(int64_t capacity);
+
+void vnodeCleanUpBlockCache();
+
+bool vnodeBlockCacheEnabled();
+
+/**
+ * find a column chunk, the returned handle is pinned and must be released by vnodeReleaseCachedColumn
+ * @param pKey  chunk key
+ * @param data  set to the decompressed column data
+ * @param size  set to the size of the data
+ * @return      handle or NULL if not cached
+ */
+void *vnodeAcquireCachedColumn(SBlockCacheKey *pKey, char **data, int32_t *size);
+
+void vnodeReleaseCachedColumn(void *handle);
+
+/**
+ * copy a decompressed column chunk into cache, least recently used unpinned chunks are evicted for space
+ */
+void vnodePutCachedColumn(SBlockCacheKey *pKey, const char *data, int32_t size);
+
+/**
+ * drop all chunks of one file of a vnode, fileId < 0 drops all files of the vnode
+ */
+void vnodeInvalidateBlockCache(int32_t vnode, int32_t fileId);
+
+int64_t vnodeGetBlockCacheMemory();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TDENGINE_VNODEBLOCKCACHE_H
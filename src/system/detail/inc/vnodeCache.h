@@ -30,6 +30,17 @@ typedef struct {
   char *             offset[];
 } SCacheBlock;
 
+/*
+ * an import of late points accepted while the meter is busy, kept until it is merged into cache or file
+ */
+typedef struct _import_block {
+  struct _import_block *next;
+  TSKEY                 firstKey;
+  int32_t               sversion;
+  int32_t               contLen;
+  char                  cont[];  // SSubmitMsg as received
+} SImportBlock;
+
 typedef struct {
   int64_t       blocks;
   int           maxBlocks;
@@ -39,6 +50,14 @@ typedef struct {
   int32_t       commitSlot;   // which slot is committed
   int32_t       commitPoint;  // starting point for next commit
   SCacheBlock **cacheBlocks;  // cache block list, circular list
+
+  pthread_mutex_t importMutex;   // protects the import buffer below
+  SImportBlock *  pImportHead;   // imports not merged yet, ordered by first key
+  int32_t         importRows;
+  int8_t          importTimer;   // a timer is started to merge the import buffer
+
+  struct _sub_link *pSubs;       // subscription queries waiting for new rows of the meter
+  int32_t           numOfSubs;   // length of pSubs, checked without the subscription lock by writers
 } SCacheInfo;
 
 typedef struct {
@@ -50,6 +69,7 @@ typedef struct {
   int64_t         notFreeSlots;
   int64_t         threshold;
   char            commitInProcess;
+  int64_t         importBytes;  // bytes held by the import buffers of all meters
   int             cacheBlockSize;
   int             cacheNumOfBlocks;
 } SCachePool;
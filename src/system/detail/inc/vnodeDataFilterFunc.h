@@ -28,6 +28,29 @@ __filter_func_t *vnodeGetValueFilterFuncArray(int32_t type);
 
 bool vnodeSupportPrefilter(int32_t type);
 
+__filter_batch_func_t *vnodeGetRangeBatchFilterFuncArray(int32_t type);
+
+__filter_batch_func_t *vnodeGetValueBatchFilterFuncArray(int32_t type);
+
+/**
+ * apply the filters of one column on rows [start, start + numOfRows) of current block and AND the result into sel
+ * @param buf   scratch space of 2 * numOfRows bytes
+ */
+void vnodeFilterColumnBatch(SSingleColumnFilterInfo *pFilterInfo, int32_t start, int32_t numOfRows, uint8_t *sel,
+                            uint8_t *buf);
+
+/**
+ * build the bloom filter of a column in a file block, null values are not added. The filter is dropped if it is too
+ * full to tell anything, e.g., the block has too many distinct values
+ */
+void vnodeBuildBlockBloom(SField *pField, const char *data, int32_t numOfRows);
+
+/**
+ * check the equality filters of a column against its bloom filter in a block
+ * @return false if none of the filters can be satisfied by any row of the block
+ */
+bool vnodeBlockBloomMayMatch(SField *pField, SSingleColumnFilterInfo *pFilterInfo);
+
 #ifdef __cplusplus
 }
 #endif
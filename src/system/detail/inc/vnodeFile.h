@@ -24,6 +24,10 @@ extern "C" {
 
 #define TSDB_VNODE_DELIMITER 0xF00AFA0F
 
+// bloom filter of the values of a column in one file block, kept in the reserved space of SField
+#define VNODE_BLOOM_BYTES  16
+#define VNODE_BLOOM_HASHES 3
+
 typedef struct { int64_t compInfoOffset; } SCompHeader;
 
 typedef struct {
@@ -38,7 +42,9 @@ typedef struct {
   int64_t min;
   int16_t maxIndex;
   int16_t minIndex;
-  char    reserved[20];
+  int8_t  bloomHashes;  // number of hash functions of the bloom filter, 0 if there is no bloom filter
+  char    reserved[3];
+  uint8_t bloom[VNODE_BLOOM_BYTES];
 } SField;
 
 typedef struct {
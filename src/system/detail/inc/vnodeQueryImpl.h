@@ -37,6 +37,13 @@ extern "C" {
 
 #define DEFAULT_IO_ENGINE IO_ENGINE_SYNC
 
+/*
+ * columns of one block that are at most QUERY_READ_MAX_GAP bytes apart are
+ * loaded by a single preadv, the unused bytes in between are read through
+ */
+#define QUERY_READ_MAX_GAP 4096
+#define QUERY_READ_MAX_IOV 64
+
 /**
  * check if the primary column is load by default, otherwise, the program will
  * forced to load primary column explicitly.
@@ -165,6 +172,7 @@ void disableFunctForSuppleScan(SQueryRuntimeEnv* pRuntimeEnv, int32_t order);
 void enableFunctForMasterScan(SQueryRuntimeEnv* pRuntimeEnv, int32_t order);
 
 int32_t mergeMetersResultToOneGroups(SMeterQuerySupportObj* pSupporter);
+void mergeGroupResult(SMeterQuerySupportObj* pSupporter, SOutputRes* pDst, SOutputRes* pSrc);
 void copyFromGroupBuf(SQInfo* pQInfo, SOutputRes* result);
 
 SBlockInfo getBlockBasicInfo(void* pBlock, int32_t blockType);
@@ -192,6 +200,8 @@ int64_t getNextAccessedKeyInData(SQuery* pQuery, int64_t* pPrimaryCol, SBlockInf
 
 uint32_t getDataBlocksForMeters(SMeterQuerySupportObj* pSupporter, SQuery* pQuery, char* pHeaderData,
                                 int32_t numOfMeters, SQueryFileInfo* pQueryFileInfo, SMeterDataInfo** pMeterDataInfo);
+void vnodePrefetchDataBlock(SQueryRuntimeEnv* pRuntimeEnv, int32_t fileIdx, SCompBlock* pBlock);
+
 int32_t LoadDatablockOnDemand(SCompBlock* pBlock, SField** pFields, int8_t* blkStatus, SQueryRuntimeEnv* pRuntimeEnv,
                               int32_t fileIdx, int32_t slotIdx, __block_search_fn_t searchFn, bool onDemand);
 
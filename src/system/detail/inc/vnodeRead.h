@@ -69,6 +69,8 @@ typedef struct SQueryFileInfo {
   size_t   lastFileSize;
   uint64_t lastFileMappingOffset;
 
+  int32_t  fileVersion;  // version of the opened files in block cache, -1 if they are replaced during opening
+
 } SQueryFileInfo;
 
 typedef struct SQueryCostSummary {
@@ -97,6 +99,12 @@ typedef struct SQueryCostSummary {
   double  loadCompInfoUs;     // total elapsed time to read comp block info
 
   int64_t tmpBufferInDisk;  // size of buffer for intermediate result
+
+  int64_t readColumns;     // column extents loaded from data/last files
+  int64_t readSyscalls;    // read/preadv calls issued to load column data
+  int64_t prefetchBlocks;  // readahead hints issued for upcoming blocks
+  int64_t cachedColumns;   // column chunks served by block cache
+  int64_t dictFilterCols;  // filter columns evaluated on dictionary entries
 } SQueryCostSummary;
 
 typedef struct SOutputRes {
@@ -119,6 +127,12 @@ typedef struct RuntimeEnvironment {
   SData*                  primaryColBuffer;
   char*                   unzipBuffer;
   char*                   secondaryUnzipBuffer;
+  char*                   blockReadBuffer;  // staging area for the compressed columns of one block
+  int32_t                 blockReadBufSize;
+  uint8_t*                dictCodesBuffer;  // dictionary codes of the filter columns of current block
+  int32_t                 dictCodesBufSize;
+  uint8_t*                selBuffer;  // selection vector of the filters and its scratch space
+  int32_t                 selBufSize;
   SQuery*                 pQuery;
   SMeterObj*              pMeterObj;
   SQLFunctionCtx*         pCtx;
@@ -222,6 +236,13 @@ typedef struct SMeterQuerySupportObj {
   TSKEY*  tsList;
   int32_t tsNum;
 
+  /*
+   * the meters are split into morsels and each morsel is scanned by a worker query of its own, the group results
+   * of the workers are merged into pResult when all of them are completed.
+   */
+  struct _qinfo** pWorkers;
+  int32_t         numOfWorkers;
+
 } SMeterQuerySupportObj;
 
 typedef struct _qinfo {
@@ -254,6 +275,8 @@ typedef struct _qinfo {
   sem_t                  dataReady;
   SMeterQuerySupportObj* pMeterQuerySupporter;
 
+  struct _qinfo* pParent;  // the query that a worker scans a morsel of meters for
+
 } SQInfo;
 
 int32_t vnodeQuerySingleMeterPrepare(SQInfo* pQInfo, SMeterObj* pMeterObj, SMeterQuerySupportObj* pSMultiMeterObj,
@@ -265,6 +288,12 @@ bool vnodeParametersSafetyCheck(SQuery* pQuery);
 
 int32_t vnodeMultiMeterQueryPrepare(SQInfo* pQInfo, SQuery* pQuery, void* param);
 
+/*
+ * the meters of a prepared super table query can be scanned by several workers, if the result of each group is
+ * generated by functions whose intermediate results can be merged.
+ */
+bool vnodeIsQueryParallelizable(SQInfo* pQInfo);
+
 /**
  * decrease the numofQuery of each table that is queried, enable the
  * remove/close operation can be executed
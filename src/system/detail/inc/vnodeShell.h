@@ -32,6 +32,7 @@ typedef struct {
   int      numOfTotalPoints;  // track the total number of points imported
   void *   thandle;           // handle from TAOS layer
   void *   qhandle;
+  void *   pSub;              // subscription query waiting for new rows
 } SShellObj;
 
 #ifdef __cplusplus
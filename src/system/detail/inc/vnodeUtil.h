@@ -27,7 +27,6 @@ extern "C" {
   ((query)->colList[(query)->pSelectExpr[colidx].pBase.colInfo.colIdxInBuf].data.type)
 
 #define QUERY_IS_ASC_QUERY(q) (GET_FORWARD_DIRECTION_FACTOR((q)->order.order) == QUERY_ASC_FORWARD_STEP)
-#define EXTRA_BYTES 2            // for possible compression deflation
 
 #define GET_COL_DATA_POS(query, index, step) ((query)->pos + (index)*(step))
 
@@ -67,9 +66,13 @@ void vnodeUpdateQueryColumnIndex(SQuery* pQuery, SMeterObj* pMeterObj);
 
 int32_t vnodeCreateFilterInfo(void* pQInfo, SQuery *pQuery);
 
+int32_t vnodeBuildExprFromArithmeticStr(SSqlFunctionExpr* pExpr, SQueryMeterMsg* pQueryMsg);
+
 bool vnodeFilterData(SQuery* pQuery, int32_t* numOfActualRead, int32_t index);
 bool vnodeDoFilterData(SQuery* pQuery, int32_t elemPos);
 
+void vnodeDoFilterDataBatch(SQuery* pQuery, int32_t start, int32_t numOfRows, uint8_t* sel, uint8_t* buf);
+
 bool vnodeIsProjectionQuery(SSqlFunctionExpr *pExpr, int32_t numOfOutput);
 
 int32_t vnodeIncQueryRefCount(SQueryMeterMsg *pQueryMsg, SMeterSidExtInfo **pSids, SMeterObj **pMeterObjList,
@@ -18,6 +18,7 @@
 
 #include "mgmt.h"
 #include "mgmtBalance.h"
+#include "mgmtTagIndex.h"
 #include "mgmtUtil.h"
 #include "tschemautil.h"
 
@@ -146,7 +147,7 @@ int mgmtCheckDbParams(SCreateDbMsg *pCreate) {
     return TSDB_CODE_INVALID_OPTION;
   }
 
-  if (pCreate->commitLog < 0 || pCreate->commitLog > 1) {
+  if (pCreate->commitLog < TSDB_COMMIT_LOG_OFF || pCreate->commitLog > TSDB_COMMIT_LOG_GROUP) {
     mTrace("invalid db option commitLog: %d", pCreate->commitLog);
     return TSDB_CODE_INVALID_OPTION;
   }
@@ -557,6 +558,8 @@ int mgmtRemoveMetricFromDb(SDbObj *pDb, STabObj *pMetric) {
   if (pMetric->pSkipList != NULL) {
     pMetric->pSkipList = tSkipListDestroy(pMetric->pSkipList);
   }
+
+  pMetric->pTagIndex = mgmtTagIndexDestroy(pMetric->pTagIndex);
   return 0;
 }
 
@@ -17,6 +17,7 @@
 #include "os.h"
 
 #include "mgmt.h"
+#include "mgmtTagIndex.h"
 #include "mgmtUtil.h"
 #include "taosmsg.h"
 #include "tast.h"
@@ -34,6 +35,7 @@ extern int64_t sdbVersion;
   do {                                      \
     tfree(pMeter->schema);                  \
     pMeter->pSkipList = tSkipListDestroy((pMeter)->pSkipList); \
+    pMeter->pTagIndex = mgmtTagIndexDestroy((pMeter)->pTagIndex); \
     tfree(pMeter);                          \
   } while (0)
 
@@ -214,6 +216,7 @@ void *mgmtMeterActionInsert(void *row, char *str, int size, int *ssize) {
     // insert a metric
     pMeter->pHead = NULL;
     pMeter->pSkipList = NULL;
+    pMeter->pTagIndex = NULL;
     pDb = mgmtGetDbByMeterId(pMeter->meterId);
     if (pDb) {
       mgmtAddMetricIntoDb(pDb, pMeter);
@@ -280,12 +283,14 @@ void *mgmtMeterActionUpdate(void *row, char *str, int size, int *ssize) {
 
   if (pNew->isDirty) {
     pMetric = mgmtGetMeter(pMeter->pTagData);
+    pthread_rwlock_wrlock(&(pMetric->rwLock));
     removeMeterFromMetricIndex(pMetric, pMeter);
   }
   mgmtMeterActionReset(pMeter, str, size, NULL);
   pMeter->pTagData = pMeter->schema;
   if (pNew->isDirty) {
     addMeterIntoMetricIndex(pMetric, pMeter);
+    pthread_rwlock_unlock(&(pMetric->rwLock));
     pMeter->isDirty = 0;
   }
 
@@ -354,6 +359,7 @@ void *mgmtMeterActionBatchUpdate(void *row, char *str, int size, int *ssize) {
       pMeter->schemaSize = (total_cols + msg->cols) * sizeof(SSchema);
       pMeter->numOfTags += msg->cols;
       memcpy(pMeter->schema + total_cols * sizeof(SSchema), msg->data, msg->cols * sizeof(SSchema));
+      mgmtTagIndexAddTagCols(pMeter, msg->cols);
 
     } else if (msg->type == SDB_TYPE_DELETE) {  // Delete schema
       // Make sure the order of tag columns
@@ -368,6 +374,7 @@ void *mgmtMeterActionBatchUpdate(void *row, char *str, int size, int *ssize) {
       pMeter->schemaSize -= sizeof(SSchema);
       pMeter->numOfTags--;
       pMeter->schema = realloc(pMeter->schema, pMeter->schemaSize);
+      mgmtTagIndexDropTagCol(pMeter, col);
     }
 
     return pMeter->pHead;
@@ -826,9 +833,13 @@ static void addMeterIntoMetricIndex(STabObj *pMetric, STabObj *pMeter) {
 
     tSkipListDestroyKey(&key);
   }
+
+  mgmtAddMeterIntoTagIndex(pMetric, pMeter);
 }
 
 static void removeMeterFromMetricIndex(STabObj *pMetric, STabObj *pMeter) {
+  mgmtRemoveMeterFromTagIndex(pMetric, pMeter);
+
   if (pMetric->pSkipList == NULL) {
     return;
   }
@@ -1463,14 +1474,14 @@ int32_t mgmtMeterModifyTagValueByCol(STabObj *pMeter, int col, const char *nCont
 
   SSchema *schema = (SSchema *)(pMetric->schema + (pMetric->numOfColumns + col) * sizeof(SSchema));
 
-  if (col == 0) {
-    pMeter->isDirty = 1;
-    removeMeterFromMetricIndex(pMetric, pMeter);
-  }
+  pthread_rwlock_wrlock(&(pMetric->rwLock));
+
+  pMeter->isDirty = 1;
+  removeMeterFromMetricIndex(pMetric, pMeter);
   memcpy(pMeter->pTagData + mgmtGetTagsLength(pMetric, col) + TSDB_METER_ID_LEN, nContent, schema->bytes);
-  if (col == 0) {
-    addMeterIntoMetricIndex(pMetric, pMeter);
-  }
+  addMeterIntoMetricIndex(pMetric, pMeter);
+
+  pthread_rwlock_unlock(&(pMetric->rwLock));
 
   // Encode the string
   int   size = sizeof(STabObj) + TSDB_MAX_BYTES_PER_ROW + 1;
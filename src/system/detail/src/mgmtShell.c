@@ -375,6 +375,11 @@ int mgmtProcessMultiMeterMetaMsg(char *pMsg, int msgLen, SConnObj *pConn) {
       break;
     }
 
+    if (nextStr - str >= TSDB_METER_ID_LEN) {  // invalid meter id, it is not returned to client
+      str = nextStr + 1;
+      continue;
+    }
+
     memcpy(tblName, str, nextStr - str);
     tblName[nextStr - str] = '\0';
     str = nextStr + 1;
@@ -408,7 +413,7 @@ int mgmtProcessMultiMeterMetaMsg(char *pMsg, int msgLen, SConnObj *pConn) {
       mTrace("%s, uid:%lld sversion:%d meter meta is retrieved", tblName, pMeterObj->uid, pMeterObj->sversion);
       pMeta = (SMultiMeterMeta *)pCurMeter;
 
-      memcpy(pMeta->meterId, tblName, strlen(tblName));
+      strcpy(pMeta->meterId, tblName);
       pMeta->meta.uid = htobe64(pMeterObj->uid);
       pMeta->meta.sid = htonl(pMeterObj->gid.sid);
       pMeta->meta.vgid = htonl(pMeterObj->gid.vgId);
@@ -17,6 +17,7 @@
 #include "os.h"
 
 #include "mgmt.h"
+#include "mgmtTagIndex.h"
 #include "mgmtUtil.h"
 #include "textbuffer.h"
 #include "tschemautil.h"
@@ -41,6 +42,7 @@ typedef struct SMeterNameFilterSupporter {
 } SMeterNameFilterSupporter;
 
 static void tansformQueryResult(tQueryResultset* pRes);
+static bool mgmtTagValueFilter(char* val, tQueryInfo* pInfo);
 
 static int32_t tabObjVGIDComparator(const void* pLeft, const void* pRight) {
   STabObj* p1 = *(STabObj**)pLeft;
@@ -677,6 +679,152 @@ void tSQLListTraverseDestroyInfo(void* param) {
   free(param);
 }
 
+static bool tagIndexEntryFilterCallback(tSkipListNode* pNode, void* param) {
+  return mgmtTagValueFilter(((STagIndexEntry*)pNode->pData)->val, (tQueryInfo*)param);
+}
+
+static tBitmap* mgmtFilterLeafByTagIndex(SMetricTagIndex* pIndex, tQueryInfo* pInfo) {
+  tBitmap* pRes = tBitmapCreate();
+  if (pRes == NULL) {
+    return NULL;
+  }
+
+  int32_t ret = 0;
+
+  if (pInfo->colIdx == TSDB_TBNAME_COLUMN_INDEX) {  // table name is not indexed, check each meter
+    tSkipListNode node = {0};
+
+    for (int32_t i = 0; i < pIndex->numOfOrdinals && ret == 0; ++i) {
+      if (pIndex->pMeters[i] == NULL) {
+        continue;
+      }
+
+      node.pData = (char*)pIndex->pMeters[i];
+      if (tSkipListNodeFilterCallback(&node, pInfo)) {
+        ret = tBitmapAdd(pRes, i);
+      }
+    }
+  } else if (pInfo->optr == TSDB_RELATION_EQUAL) {
+    tSkipListNode* pNode = tSkipListGetOne(pIndex->pColIndex[pInfo->colIdx], &pInfo->q);
+    if (pNode != NULL) {
+      ret = tBitmapOr(pRes, ((STagIndexEntry*)pNode->pData)->pBitmap);
+    }
+  } else {
+    /*
+     * range, not equal and like conditions are checked once for each distinct value of the tag, instead of each
+     * meter. Since like is case insensitive, it can not be bounded by the prefix on the sorted values.
+     */
+    tSkipListNode** pNodes = NULL;
+
+    int32_t num = tSkipListIterateList(pIndex->pColIndex[pInfo->colIdx], &pNodes, tagIndexEntryFilterCallback, pInfo);
+    if (num < 0) {
+      ret = -1;
+    }
+
+    for (int32_t i = 0; i < num && ret == 0; ++i) {
+      ret = tBitmapOr(pRes, ((STagIndexEntry*)pNodes[i]->pData)->pBitmap);
+    }
+
+    tfree(pNodes);
+  }
+
+  if (ret != 0) {
+    tBitmapDestroy(pRes);
+    return NULL;
+  }
+
+  return pRes;
+}
+
+/*
+ * evaluate the expression on the tag index of metric, AND/OR are the intersection/union of the bitmaps of meter
+ * ordinals of two children.
+ *
+ * @return ordinals of qualified meters, or NULL if out of memory
+ */
+static tBitmap* mgmtFilterByTagIndex(SMetricTagIndex* pIndex, tSQLBinaryExpr* pExpr, SBinaryFilterSupp* param) {
+  tSQLSyntaxNode* pLeft = pExpr->pLeft;
+  tSQLSyntaxNode* pRight = pExpr->pRight;
+
+  if (pLeft->nodeType == TSQL_NODE_COL) {
+    assert(pRight->nodeType == TSQL_NODE_VALUE);
+
+    param->setupInfoFn(pExpr, param->pExtInfo);
+    return mgmtFilterLeafByTagIndex(pIndex, pExpr->info);
+  }
+
+  assert(pLeft->nodeType == TSQL_NODE_EXPR && pRight->nodeType == TSQL_NODE_EXPR);
+
+  tBitmap* pLeftRes = mgmtFilterByTagIndex(pIndex, pLeft->pExpr, param);
+  if (pLeftRes == NULL) {
+    return NULL;
+  }
+
+  // no need to check the right child
+  if (pExpr->nSQLBinaryOptr == TSDB_RELATION_AND && tBitmapCardinality(pLeftRes) == 0) {
+    return pLeftRes;
+  }
+
+  tBitmap* pRightRes = mgmtFilterByTagIndex(pIndex, pRight->pExpr, param);
+  if (pRightRes == NULL) {
+    tBitmapDestroy(pLeftRes);
+    return NULL;
+  }
+
+  int32_t ret = 0;
+  if (pExpr->nSQLBinaryOptr == TSDB_RELATION_AND) {
+    ret = tBitmapAnd(pLeftRes, pRightRes);
+  } else {
+    assert(pExpr->nSQLBinaryOptr == TSDB_RELATION_OR);
+    ret = tBitmapOr(pLeftRes, pRightRes);
+  }
+
+  tBitmapDestroy(pRightRes);
+
+  if (ret != 0) {
+    tBitmapDestroy(pLeftRes);
+    return NULL;
+  }
+
+  return pLeftRes;
+}
+
+static int32_t mgmtRetrieveByTagIndex(STabObj* pMetric, tQueryResultset* pRes, tSQLBinaryExpr* pExpr,
+                                      SBinaryFilterSupp* param) {
+  SMetricTagIndex* pIndex = pMetric->pTagIndex;
+
+  tBitmap* pBitmap = mgmtFilterByTagIndex(pIndex, pExpr, param);
+  if (pBitmap == NULL) {
+    return TSDB_CODE_SERV_OUT_OF_MEMORY;
+  }
+
+  int64_t num = tBitmapCardinality(pBitmap);
+  if (num == 0) {
+    tBitmapDestroy(pBitmap);
+    return TSDB_CODE_SUCCESS;
+  }
+
+  uint32_t* pOrdinals = malloc(num * sizeof(uint32_t));
+  pRes->pRes = malloc(num * POINTER_BYTES);
+  if (pOrdinals == NULL || pRes->pRes == NULL) {
+    tfree(pOrdinals);
+    tfree(pRes->pRes);
+    tBitmapDestroy(pBitmap);
+    return TSDB_CODE_SERV_OUT_OF_MEMORY;
+  }
+
+  tBitmapToArray(pBitmap, pOrdinals);
+  for (int64_t i = 0; i < num; ++i) {
+    pRes->pRes[i] = pIndex->pMeters[pOrdinals[i]];
+  }
+
+  pRes->num = num;
+
+  free(pOrdinals);
+  tBitmapDestroy(pBitmap);
+  return TSDB_CODE_SUCCESS;
+}
+
 static int32_t mgmtFilterMeterByIndex(STabObj* pMetric, tQueryResultset* pRes, char* pCond, int32_t condLen) {
   SSchema* pTagSchema = (SSchema*)(pMetric->schema + pMetric->numOfColumns * sizeof(SSchema));
 
@@ -693,7 +841,19 @@ static int32_t mgmtFilterMeterByIndex(STabObj* pMetric, tQueryResultset* pRes, c
     SSyntaxTreeFilterSupporter s = {.pTagSchema = pTagSchema, .numOfTags = pMetric->numOfTags};
     SBinaryFilterSupp          supp = {.fp = tSkipListNodeFilterCallback, .setupInfoFn = filterPrepare, .pExtInfo = &s};
 
+    pthread_rwlock_rdlock(&(pMetric->rwLock));
+
+    if (pMetric->pTagIndex != NULL) {
+      int32_t ret = mgmtRetrieveByTagIndex(pMetric, pRes, pExpr, &supp);
+      pthread_rwlock_unlock(&(pMetric->rwLock));
+
+      tSQLBinaryExprDestroy(&pExpr, tSQLListTraverseDestroyInfo);
+      return ret;
+    }
+
     tSQLBinaryExprTraverse(pExpr, pMetric->pSkipList, pRes, &supp);
+    pthread_rwlock_unlock(&(pMetric->rwLock));
+
     tSQLBinaryExprDestroy(&pExpr, tSQLListTraverseDestroyInfo);
   }
 
@@ -795,8 +955,13 @@ bool tSkipListNodeFilterCallback(tSkipListNode* pNode, void* param) {
   tQueryInfo* pInfo = (tQueryInfo*)param;
   STabObj*    pMeter = (STabObj*)pNode->pData;
 
-  char   name[TSDB_METER_NAME_LEN + 1] = {0};
-  char*  val = getTagValueFromMeter(pMeter, pInfo->offset, name);
+  char  name[TSDB_METER_NAME_LEN + 1] = {0};
+  char* val = getTagValueFromMeter(pMeter, pInfo->offset, name);
+
+  return mgmtTagValueFilter(val, pInfo);
+}
+
+static bool mgmtTagValueFilter(char* val, tQueryInfo* pInfo) {
   int8_t type = pInfo->sch.type;
 
   int32_t ret = 0;
@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _DEFAULT_SOURCE
+#include "os.h"
+
+#include "mgmt.h"
+#include "mgmtTagIndex.h"
+#include "mgmtUtil.h"
+#include "tglobalcfg.h"
+#include "tutil.h"
+
+static SSchema *getTagSchema(STabObj *pMetric) {
+  return (SSchema *)(pMetric->schema + pMetric->numOfColumns * sizeof(SSchema));
+}
+
+static void destroyColIndex(tSkipList *pColIndex) {
+  if (pColIndex == NULL) {
+    return;
+  }
+
+  tSkipListNode *pNode = pColIndex->pHead.pForward[0];
+  while (pNode != NULL) {
+    STagIndexEntry *pEntry = (STagIndexEntry *)pNode->pData;
+    tBitmapDestroy(pEntry->pBitmap);
+    free(pEntry);
+
+    pNode = pNode->pForward[0];
+  }
+
+  tSkipListDestroy(pColIndex);
+}
+
+static tSkipList *createColIndex(SSchema *pSchema) {
+  return tSkipListCreate(MAX_SKIP_LIST_LEVEL, pSchema->type, pSchema->bytes);
+}
+
+void *mgmtTagIndexDestroy(SMetricTagIndex *pIndex) {
+  if (pIndex == NULL) {
+    return NULL;
+  }
+
+  for (int32_t i = 0; i < pIndex->numOfTags; ++i) {
+    destroyColIndex(pIndex->pColIndex[i]);
+  }
+
+  tfree(pIndex->pColIndex);
+  tfree(pIndex->pMeters);
+  tfree(pIndex->pFreeOrdinals);
+  free(pIndex);
+
+  return NULL;
+}
+
+static SMetricTagIndex *createTagIndex(STabObj *pMetric) {
+  SMetricTagIndex *pIndex = calloc(1, sizeof(SMetricTagIndex));
+  if (pIndex == NULL) {
+    return NULL;
+  }
+
+  pIndex->pColIndex = calloc(TSDB_MAX_TAGS, POINTER_BYTES);
+  if (pIndex->pColIndex == NULL) {
+    free(pIndex);
+    return NULL;
+  }
+
+  SSchema *pTagSchema = getTagSchema(pMetric);
+  for (int32_t i = 0; i < pMetric->numOfTags; ++i) {
+    pIndex->pColIndex[i] = createColIndex(&pTagSchema[i]);
+    if (pIndex->pColIndex[i] == NULL) {
+      return mgmtTagIndexDestroy(pIndex);
+    }
+
+    pIndex->numOfTags++;
+  }
+
+  return pIndex;
+}
+
+static int32_t allocOrdinal(SMetricTagIndex *pIndex, STabObj *pMeter) {
+  int32_t ord = -1;
+
+  if (pIndex->numOfFree > 0) {
+    ord = pIndex->pFreeOrdinals[--pIndex->numOfFree];
+  } else {
+    if (pIndex->numOfOrdinals >= pIndex->capacity) {
+      int32_t capacity = MAX(pIndex->capacity << 1, 64);
+
+      STabObj **pMeters = realloc(pIndex->pMeters, capacity * POINTER_BYTES);
+      if (pMeters == NULL) {
+        return -1;
+      }
+      pIndex->pMeters = pMeters;
+
+      int32_t *pFree = realloc(pIndex->pFreeOrdinals, capacity * sizeof(int32_t));
+      if (pFree == NULL) {
+        return -1;
+      }
+
+      pIndex->pFreeOrdinals = pFree;
+      pIndex->capacity = capacity;
+    }
+
+    ord = pIndex->numOfOrdinals++;
+  }
+
+  pIndex->pMeters[ord] = pMeter;
+  pMeter->tagIndexOrd = ord;
+
+  return ord;
+}
+
+static void freeOrdinal(SMetricTagIndex *pIndex, int32_t ord) {
+  pIndex->pMeters[ord] = NULL;
+  pIndex->pFreeOrdinals[pIndex->numOfFree++] = ord;
+}
+
+static int32_t addIntoColIndex(tSkipList *pColIndex, SSchema *pSchema, char *val, int32_t ord) {
+  tSkipListKey key = tSkipListCreateKey(pSchema->type, val, pSchema->bytes);
+  int32_t      ret = 0;
+
+  tSkipListNode *pNode = tSkipListGetOne(pColIndex, &key);
+  if (pNode != NULL) {
+    ret = tBitmapAdd(((STagIndexEntry *)pNode->pData)->pBitmap, ord);
+  } else {
+    STagIndexEntry *pEntry = malloc(sizeof(STagIndexEntry) + pSchema->bytes);
+    if (pEntry == NULL || (pEntry->pBitmap = tBitmapCreate()) == NULL) {
+      tfree(pEntry);
+      ret = -1;
+    } else {
+      memcpy(pEntry->val, val, pSchema->bytes);
+
+      if (tBitmapAdd(pEntry->pBitmap, ord) != 0 || tSkipListPut(pColIndex, pEntry, &key, 0) == NULL) {
+        tBitmapDestroy(pEntry->pBitmap);
+        free(pEntry);
+        ret = -1;
+      }
+    }
+  }
+
+  tSkipListDestroyKey(&key);
+  return ret;
+}
+
+static void removeFromColIndex(tSkipList *pColIndex, SSchema *pSchema, char *val, int32_t ord) {
+  tSkipListKey key = tSkipListCreateKey(pSchema->type, val, pSchema->bytes);
+
+  tSkipListNode *pNode = tSkipListGetOne(pColIndex, &key);
+  if (pNode != NULL) {
+    STagIndexEntry *pEntry = (STagIndexEntry *)pNode->pData;
+    tBitmapRemove(pEntry->pBitmap, ord);
+
+    if (tBitmapCardinality(pEntry->pBitmap) == 0) {
+      tSkipListRemoveNode(pColIndex, pNode);
+
+      tBitmapDestroy(pEntry->pBitmap);
+      free(pEntry);
+    }
+  }
+
+  tSkipListDestroyKey(&key);
+}
+
+static int32_t addMeterIntoTagIndex(SMetricTagIndex *pIndex, STabObj *pMetric, STabObj *pMeter) {
+  int32_t ord = allocOrdinal(pIndex, pMeter);
+  if (ord < 0) {
+    return -1;
+  }
+
+  SSchema *pTagSchema = getTagSchema(pMetric);
+  char *   tags = pMeter->pTagData + TSDB_METER_ID_LEN;
+
+  int32_t offset = 0;
+  for (int32_t i = 0; i < pIndex->numOfTags; ++i) {
+    if (addIntoColIndex(pIndex->pColIndex[i], &pTagSchema[i], tags + offset, ord) != 0) {
+      return -1;
+    }
+
+    offset += pTagSchema[i].bytes;
+  }
+
+  return 0;
+}
+
+static SMetricTagIndex *buildTagIndex(STabObj *pMetric) {
+  SMetricTagIndex *pIndex = createTagIndex(pMetric);
+  if (pIndex == NULL) {
+    return NULL;
+  }
+
+  for (STabObj *pMeter = pMetric->pHead; pMeter != NULL; pMeter = pMeter->next) {
+    if (addMeterIntoTagIndex(pIndex, pMetric, pMeter) != 0) {
+      return mgmtTagIndexDestroy(pIndex);
+    }
+  }
+
+  return pIndex;
+}
+
+/*
+ * An index failed to be maintained is dropped, the query falls back to scan all meters then, and the index is
+ * rebuilt with the next meter added into the metric.
+ */
+static void dropTagIndexOnError(STabObj *pMetric) {
+  mError("metric:%s, failed to maintain tag index, out of memory, index dropped", pMetric->meterId);
+  pMetric->pTagIndex = mgmtTagIndexDestroy(pMetric->pTagIndex);
+}
+
+void mgmtAddMeterIntoTagIndex(STabObj *pMetric, STabObj *pMeter) {
+  if (!tsMetricTagIndex) {
+    return;
+  }
+
+  if (pMetric->pTagIndex == NULL) {
+    pMetric->pTagIndex = buildTagIndex(pMetric);
+    if (pMetric->pTagIndex == NULL) {
+      mError("metric:%s, failed to build tag index of %d meters", pMetric->meterId, pMetric->numOfMeters);
+    } else {
+      mTrace("metric:%s, tag index of %d meters is built", pMetric->meterId, pMetric->numOfMeters);
+    }
+
+    return;
+  }
+
+  if (addMeterIntoTagIndex(pMetric->pTagIndex, pMetric, pMeter) != 0) {
+    dropTagIndexOnError(pMetric);
+  }
+}
+
+void mgmtRemoveMeterFromTagIndex(STabObj *pMetric, STabObj *pMeter) {
+  SMetricTagIndex *pIndex = pMetric->pTagIndex;
+  if (pIndex == NULL) {
+    return;
+  }
+
+  int32_t ord = pMeter->tagIndexOrd;
+  if (ord < 0 || ord >= pIndex->numOfOrdinals || pIndex->pMeters[ord] != pMeter) {
+    return;
+  }
+
+  SSchema *pTagSchema = getTagSchema(pMetric);
+  char *   tags = pMeter->pTagData + TSDB_METER_ID_LEN;
+
+  int32_t offset = 0;
+  for (int32_t i = 0; i < pIndex->numOfTags; ++i) {
+    removeFromColIndex(pIndex->pColIndex[i], &pTagSchema[i], tags + offset, ord);
+    offset += pTagSchema[i].bytes;
+  }
+
+  freeOrdinal(pIndex, ord);
+}
+
+void mgmtTagIndexAddTagCols(STabObj *pMetric, int32_t numOfCols) {
+  SMetricTagIndex *pIndex = pMetric->pTagIndex;
+  if (pIndex == NULL) {
+    return;
+  }
+
+  assert(pIndex->numOfTags + numOfCols == pMetric->numOfTags);
+
+  tBitmap *pAll = tBitmapCreate();
+  if (pAll == NULL) {
+    dropTagIndexOnError(pMetric);
+    return;
+  }
+
+  for (int32_t i = 0; i < pIndex->numOfOrdinals; ++i) {
+    if (pIndex->pMeters[i] != NULL && tBitmapAdd(pAll, i) != 0) {
+      tBitmapDestroy(pAll);
+      dropTagIndexOnError(pMetric);
+      return;
+    }
+  }
+
+  // the tag values of all meters are reset to zero, so all of them are in one entry
+  SSchema *pTagSchema = getTagSchema(pMetric);
+  for (int32_t i = pIndex->numOfTags; i < pMetric->numOfTags; ++i) {
+    tSkipList *pColIndex = createColIndex(&pTagSchema[i]);
+    if (pColIndex == NULL) {
+      tBitmapDestroy(pAll);
+      dropTagIndexOnError(pMetric);
+      return;
+    }
+
+    pIndex->pColIndex[pIndex->numOfTags++] = pColIndex;
+
+    if (tBitmapCardinality(pAll) == 0) {
+      continue;
+    }
+
+    STagIndexEntry *pEntry = calloc(1, sizeof(STagIndexEntry) + pTagSchema[i].bytes);
+    if (pEntry == NULL || (pEntry->pBitmap = tBitmapClone(pAll)) == NULL) {
+      tfree(pEntry);
+      tBitmapDestroy(pAll);
+      dropTagIndexOnError(pMetric);
+      return;
+    }
+
+    tSkipListKey key = tSkipListCreateKey(pTagSchema[i].type, pEntry->val, pTagSchema[i].bytes);
+    tSkipListPut(pColIndex, pEntry, &key, 0);
+    tSkipListDestroyKey(&key);
+  }
+
+  tBitmapDestroy(pAll);
+}
+
+void mgmtTagIndexDropTagCol(STabObj *pMetric, int32_t col) {
+  SMetricTagIndex *pIndex = pMetric->pTagIndex;
+  if (pIndex == NULL) {
+    return;
+  }
+
+  assert(col >= 0 && col < pIndex->numOfTags);
+  destroyColIndex(pIndex->pColIndex[col]);
+
+  memmove(&pIndex->pColIndex[col], &pIndex->pColIndex[col + 1], (pIndex->numOfTags - col - 1) * POINTER_BYTES);
+  pIndex->numOfTags--;
+}
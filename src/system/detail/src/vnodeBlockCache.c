@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "os.h"
+
+#include "tlog.h"
+#include "tutil.h"
+#include "vnode.h"
+#include "vnodeBlockCache.h"
+
+#define BLOCK_CACHE_MIN_SLOTS 1024
+#define BLOCK_CACHE_MAX_SLOTS (1 << 20)
+
+typedef struct SBlockCacheNode {
+  SBlockCacheKey          key;
+  struct SBlockCacheNode *hnext;  // next node in the same hash slot
+  struct SBlockCacheNode *prev;   // lru list, head is the most recently used one
+  struct SBlockCacheNode *next;
+  int32_t                 refCount;
+  int8_t                  removed;  // dropped from cache while pinned, freed by the last release
+  int32_t                 size;
+  char                    data[];
+} SBlockCacheNode;
+
+typedef struct {
+  pthread_mutex_t   mutex;
+  SBlockCacheNode **hashList;
+  int32_t           numOfSlots;
+  SBlockCacheNode * head;
+  SBlockCacheNode * tail;
+  int64_t           capacity;
+  int64_t           used;
+  int32_t           numOfNodes;
+} SBlockCache;
+
+static SBlockCache *pBlockCache = NULL;
+
+static uint32_t vnodeHashBlockCacheKey(SBlockCacheKey *pKey) {
+  return MurmurHash3_32(pKey, sizeof(SBlockCacheKey)) & (pBlockCache->numOfSlots - 1);
+}
+
+static void vnodeUnlinkBlockCacheNode(SBlockCacheNode *pNode) {
+  if (pNode->prev) {
+    pNode->prev->next = pNode->next;
+  } else {
+    pBlockCache->head = pNode->next;
+  }
+
+  if (pNode->next) {
+    pNode->next->prev = pNode->prev;
+  } else {
+    pBlockCache->tail = pNode->prev;
+  }
+
+  pNode->prev = NULL;
+  pNode->next = NULL;
+}
+
+static void vnodeLinkBlockCacheNodeAtHead(SBlockCacheNode *pNode) {
+  pNode->prev = NULL;
+  pNode->next = pBlockCache->head;
+  if (pBlockCache->head) pBlockCache->head->prev = pNode;
+  pBlockCache->head = pNode;
+  if (pBlockCache->tail == NULL) pBlockCache->tail = pNode;
+}
+
+/* take the node out of hash list and lru list, the memory is freed now or by the last release */
+static void vnodeRemoveBlockCacheNode(SBlockCacheNode *pNode) {
+  SBlockCacheNode **pp = &pBlockCache->hashList[vnodeHashBlockCacheKey(&pNode->key)];
+  while (*pp != pNode) pp = &(*pp)->hnext;
+  *pp = pNode->hnext;
+
+  vnodeUnlinkBlockCacheNode(pNode);
+  pBlockCache->used -= pNode->size;
+  pBlockCache->numOfNodes--;
+
+  if (pNode->refCount > 0) {
+    pNode->removed = 1;
+  } else {
+    free(pNode);
+  }
+}
+
+static SBlockCacheNode *vnodeFindBlockCacheNode(SBlockCacheKey *pKey) {
+  SBlockCacheNode *pNode = pBlockCache->hashList[vnodeHashBlockCacheKey(pKey)];
+  while (pNode && memcmp(&pNode->key, pKey, sizeof(SBlockCacheKey)) != 0) pNode = pNode->hnext;
+
+  return pNode;
+}
+
+int32_t vnodeInitBlockCache(int64_t capacity) {
+  if (capacity <= 0) return 0;
+
+  pBlockCache = (SBlockCache *)calloc(1, sizeof(SBlockCache));
+  if (pBlockCache == NULL) return -1;
+
+  int32_t slots = BLOCK_CACHE_MIN_SLOTS;
+  while (slots < BLOCK_CACHE_MAX_SLOTS && (int64_t)slots * 4096 < capacity) slots <<= 1;
+
+  pBlockCache->hashList = (SBlockCacheNode **)calloc(slots, sizeof(SBlockCacheNode *));
+  if (pBlockCache->hashList == NULL) {
+    tfree(pBlockCache);
+    return -1;
+  }
+
+  pBlockCache->numOfSlots = slots;
+  pBlockCache->capacity = capacity;
+  pthread_mutex_init(&pBlockCache->mutex, NULL);
+
+  dPrint("block cache is initialized, capacity:%ld bytes, slots:%d", capacity, slots);
+  return 0;
+}
+
+void vnodeCleanUpBlockCache() {
+  if (pBlockCache == NULL) return;
+
+  pthread_mutex_lock(&pBlockCache->mutex);
+  while (pBlockCache->head) vnodeRemoveBlockCacheNode(pBlockCache->head);
+  pthread_mutex_unlock(&pBlockCache->mutex);
+
+  pthread_mutex_destroy(&pBlockCache->mutex);
+  tfree(pBlockCache->hashList);
+  tfree(pBlockCache);
+}
+
+bool vnodeBlockCacheEnabled() { return pBlockCache != NULL; }
+
+void *vnodeAcquireCachedColumn(SBlockCacheKey *pKey, char **data, int32_t *size) {
+  if (pBlockCache == NULL) return NULL;
+
+  pthread_mutex_lock(&pBlockCache->mutex);
+
+  SBlockCacheNode *pNode = vnodeFindBlockCacheNode(pKey);
+  if (pNode != NULL) {
+    pNode->refCount++;
+    vnodeUnlinkBlockCacheNode(pNode);
+    vnodeLinkBlockCacheNodeAtHead(pNode);
+
+    *data = pNode->data;
+    *size = pNode->size;
+  }
+
+  pthread_mutex_unlock(&pBlockCache->mutex);
+
+  SVnodeObj *pVnode = vnodeList + pKey->vnode;
+  if (pNode != NULL) {
+    atomic_fetch_add_64(&pVnode->vnodeStatistic.blockCacheHits, 1);
+  } else {
+    atomic_fetch_add_64(&pVnode->vnodeStatistic.blockCacheMisses, 1);
+  }
+
+  return pNode;
+}
+
+void vnodeReleaseCachedColumn(void *handle) {
+  SBlockCacheNode *pNode = (SBlockCacheNode *)handle;
+  if (pNode == NULL) return;
+
+  pthread_mutex_lock(&pBlockCache->mutex);
+
+  pNode->refCount--;
+  if (pNode->refCount == 0 && pNode->removed) free(pNode);
+
+  pthread_mutex_unlock(&pBlockCache->mutex);
+}
+
+void vnodePutCachedColumn(SBlockCacheKey *pKey, const char *data, int32_t size) {
+  if (pBlockCache == NULL) return;
+
+  // a single chunk shall not flush most of the cache
+  if (size <= 0 || size > pBlockCache->capacity / 8) return;
+
+  SBlockCacheNode *pNew = (SBlockCacheNode *)malloc(sizeof(SBlockCacheNode) + size);
+  if (pNew == NULL) return;
+
+  memset(pNew, 0, sizeof(SBlockCacheNode));
+  pNew->key = *pKey;
+  pNew->size = size;
+  memcpy(pNew->data, data, size);
+
+  pthread_mutex_lock(&pBlockCache->mutex);
+
+  // loaded by another query in the meantime
+  if (vnodeFindBlockCacheNode(pKey) != NULL) {
+    pthread_mutex_unlock(&pBlockCache->mutex);
+    free(pNew);
+    return;
+  }
+
+  SBlockCacheNode *pNode = pBlockCache->tail;
+  while (pBlockCache->used + size > pBlockCache->capacity && pNode != NULL) {
+    SBlockCacheNode *pPrev = pNode->prev;
+    if (pNode->refCount == 0) vnodeRemoveBlockCacheNode(pNode);
+    pNode = pPrev;
+  }
+
+  if (pBlockCache->used + size > pBlockCache->capacity) {  // all remaining chunks are pinned
+    pthread_mutex_unlock(&pBlockCache->mutex);
+    free(pNew);
+    return;
+  }
+
+  uint32_t slot = vnodeHashBlockCacheKey(pKey);
+  pNew->hnext = pBlockCache->hashList[slot];
+  pBlockCache->hashList[slot] = pNew;
+  vnodeLinkBlockCacheNodeAtHead(pNew);
+
+  pBlockCache->used += size;
+  pBlockCache->numOfNodes++;
+
+  pthread_mutex_unlock(&pBlockCache->mutex);
+}
+
+void vnodeInvalidateBlockCache(int32_t vnode, int32_t fileId) {
+  if (pBlockCache == NULL) return;
+
+  int32_t num = 0;
+  pthread_mutex_lock(&pBlockCache->mutex);
+
+  SBlockCacheNode *pNode = pBlockCache->head;
+  while (pNode != NULL) {
+    SBlockCacheNode *pNext = pNode->next;
+    if (pNode->key.vnode == vnode && (fileId < 0 || pNode->key.fileId == fileId)) {
+      vnodeRemoveBlockCacheNode(pNode);
+      num++;
+    }
+    pNode = pNext;
+  }
+
+  pthread_mutex_unlock(&pBlockCache->mutex);
+
+  if (num > 0) {
+    dTrace("vid:%d fileId:%d, %d chunks are dropped from block cache", vnode, fileId, num);
+  }
+}
+
+int64_t vnodeGetBlockCacheMemory() {
+  if (pBlockCache == NULL) return 0;
+  return pBlockCache->used;
+}
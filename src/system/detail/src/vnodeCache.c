@@ -137,6 +137,7 @@ void *vnodeAllocateCacheInfo(SMeterObj *pObj) {
   }
   memset(pInfo->cacheBlocks, 0, size);
   pInfo->currentSlot = -1;
+  pthread_mutex_init(&pInfo->importMutex, NULL);
 
   pObj->pointsPerBlock =
       (pCfg->cacheBlockSize - sizeof(SCacheBlock) - pObj->numOfColumns * sizeof(char *)) / pObj->bytesPerPoint;
@@ -202,6 +203,9 @@ void vnodeFreeCacheInfo(SMeterObj *pObj) {
   pInfo = (SCacheInfo *)pObj->pCache;
   if (pPool == NULL || pInfo == NULL) return;
 
+  // parked subscriptions are answered with the failure of their queries on the dropped meter
+  vnodeNotifySubscribers(pObj);
+
   pthread_mutex_lock(&pPool->vmutex);
   numOfBlocks = pInfo->numOfBlocks;
   slot = pInfo->currentSlot;
@@ -214,8 +218,11 @@ void vnodeFreeCacheInfo(SMeterObj *pObj) {
 
   pObj->pCache = NULL;
   tfree(pInfo->cacheBlocks);
-  tfree(pInfo);
   pthread_mutex_unlock(&pPool->vmutex);
+
+  vnodeFreeImportBuffer(pPool, pInfo);
+  pthread_mutex_destroy(&pInfo->importMutex);
+  tfree(pInfo);
 }
 
 uint64_t vnodeGetPoolCount(SVnodeObj *pVnode) {
@@ -511,6 +518,93 @@ int vnodeInsertPointToCache(SMeterObj *pObj, char *pData) {
   return 0;
 }
 
+/*
+ * transpose row-major points into the column arrays of a cache block. Rows are processed in tiles so that the
+ * source rows stay in L1 while every column is scattered, and the fixed-width copies are expanded per column width
+ * so the compiler emits plain loads/stores (vectorized where the target allows) instead of a memcpy call per value.
+ */
+static void vnodeTransposeRowsToCache(SMeterObj *pObj, SCacheBlock *pCacheBlock, char *pData, int numOfPoints) {
+  int32_t bytesPerPoint = pObj->bytesPerPoint;
+  int32_t pos = pCacheBlock->numOfPoints;
+
+  for (int32_t start = 0; start < numOfPoints; start += TSDB_CACHE_INSERT_TILE_ROWS) {
+    int32_t rows = numOfPoints - start;
+    if (rows > TSDB_CACHE_INSERT_TILE_ROWS) rows = TSDB_CACHE_INSERT_TILE_ROWS;
+
+    char *pSrc = pData + start * bytesPerPoint;
+
+    for (int32_t col = 0; col < pObj->numOfColumns; ++col) {
+      int32_t bytes = pObj->schema[col].bytes;
+      char *  pDst = pCacheBlock->offset[col] + (pos + start) * bytes;
+
+      switch (bytes) {
+        case 1:
+          for (int32_t r = 0; r < rows; ++r) pDst[r] = pSrc[r * bytesPerPoint];
+          break;
+        case 2:
+          for (int32_t r = 0; r < rows; ++r) memcpy(pDst + r * 2, pSrc + r * bytesPerPoint, 2);
+          break;
+        case 4:
+          for (int32_t r = 0; r < rows; ++r) memcpy(pDst + r * 4, pSrc + r * bytesPerPoint, 4);
+          break;
+        case 8:
+          for (int32_t r = 0; r < rows; ++r) memcpy(pDst + r * 8, pSrc + r * bytesPerPoint, 8);
+          break;
+        default:
+          for (int32_t r = 0; r < rows; ++r) memcpy(pDst + r * bytes, pSrc + r * bytesPerPoint, bytes);
+          break;
+      }
+
+      pSrc += bytes;
+    }
+  }
+}
+
+/*
+ * insert a run of points whose keys have already been validated to be ascending and larger than the meter's
+ * lastKey. The points fill the current cache block and then the following blocks; return the number of points
+ * inserted, which is less than numOfPoints if a new cache block can not be allocated or the meter is being dropped.
+ */
+int vnodeInsertBatchToCache(SMeterObj *pObj, char *pData, int numOfPoints) {
+  SCacheBlock *pCacheBlock;
+  SCacheInfo * pInfo;
+  SCachePool * pPool;
+  int          points = 0;
+
+  pInfo = (SCacheInfo *)pObj->pCache;
+  pPool = (SCachePool *)vnodeList[pObj->vnode].pCachePool;
+
+  if (pInfo->numOfBlocks == 0) {
+    if (vnodeAllocateCacheBlock(pObj) < 0) return 0;
+  }
+
+  while (points < numOfPoints) {
+    if (pObj->state >= TSDB_METER_STATE_DELETING) break;
+    if (pInfo->currentSlot < 0) break;
+
+    pCacheBlock = pInfo->cacheBlocks[pInfo->currentSlot];
+    if (pCacheBlock->numOfPoints >= pObj->pointsPerBlock) {
+      if (vnodeAllocateCacheBlock(pObj) < 0) break;
+      pCacheBlock = pInfo->cacheBlocks[pInfo->currentSlot];
+    }
+
+    int rows = pObj->pointsPerBlock - pCacheBlock->numOfPoints;
+    if (rows > numOfPoints - points) rows = numOfPoints - points;
+
+    vnodeTransposeRowsToCache(pObj, pCacheBlock, pData, rows);
+
+    pObj->lastKey = *(TSKEY *)(pData + (rows - 1) * pObj->bytesPerPoint);
+    atomic_fetch_sub_32(&pObj->freePoints, rows);
+    pCacheBlock->numOfPoints += rows;
+    pPool->count += rows;
+
+    pData += rows * pObj->bytesPerPoint;
+    points += rows;
+  }
+
+  return points;
+}
+
 void vnodeUpdateQuerySlotPos(SCacheInfo *pInfo, SQuery *pQuery) {
   SCacheBlock *pCacheBlock;
 
@@ -1136,6 +1230,7 @@ int vnodeIsCacheCommitted(SMeterObj *pObj) {
   if (pObj->pCache == NULL) return 1;
 
   SCacheInfo *pInfo = (SCacheInfo *)pObj->pCache;
+  if (pInfo->importRows > 0) return 0;
   if (pInfo->currentSlot < 0) return 1;
 
   SCacheBlock *pBlock = pInfo->cacheBlocks[pInfo->currentSlot];
@@ -64,6 +64,7 @@ int vnodeOpenCommitLog(int vnode, uint64_t firstV) {
   pVnode->pWrite = pVnode->pMem;
   memcpy(pVnode->pWrite, &(firstV), sizeof(firstV));
   pVnode->pWrite += sizeof(firstV);
+  pVnode->pSync = pVnode->pMem;
 
   return pVnode->logFd;
 
@@ -79,9 +80,11 @@ int vnodeRenewCommitLog(int vnode) {
   char *     fileName = pVnode->logFn;
   char *     oldName = pVnode->logOFn;
 
-  pthread_mutex_lock(&(pVnode->logMutex));
+  pthread_rwlock_wrlock(&(pVnode->logLock));
 
   if (VALIDFD(pVnode->logFd)) {
+    // delayed submit responses may still refer to data in the old log, it shall be on disk before unmapping
+    if (pVnode->cfg.commitLog == TSDB_COMMIT_LOG_GROUP) msync(pVnode->pMem, pVnode->mappingSize, MS_SYNC);
     munmap(pVnode->pMem, pVnode->mappingSize);
     close(pVnode->logFd);
     rename(fileName, oldName);
@@ -89,13 +92,79 @@ int vnodeRenewCommitLog(int vnode) {
 
   if (pVnode->cfg.commitLog) vnodeOpenCommitLog(vnode, vnodeList[vnode].version);
 
-  pthread_mutex_unlock(&(pVnode->logMutex));
+  pthread_rwlock_unlock(&(pVnode->logLock));
 
   return pVnode->logFd;
 }
 
 void vnodeRemoveCommitLog(int vnode) { remove(vnodeList[vnode].logOFn); }
 
+static bool vnodeIsValidCommitHead(SCommitHead *pHead, int maxSessions) {
+  if (((pHead->sversion + pHead->sid + pHead->contLen + pHead->action) & 0xFFFFFF) != pHead->simpleCheck) return false;
+
+  // an all-zero head of a reserved but unfilled slot passes the check above, every record has content
+  return pHead->contLen > 0 && pHead->sid >= 0 && pHead->sid < maxSessions && pHead->action >= 0 &&
+         pHead->action < TSDB_ACTION_MAX;
+}
+
+// return the position of the first non-zero byte at or after pos, or size if the rest of the file is zeros
+static int64_t vnodeSkipZeros(char *pMem, int64_t pos, int64_t size) {
+  for (; pos < size && (pos & 7) != 0; ++pos) {
+    if (pMem[pos] != 0) return pos;
+  }
+
+  for (; pos + 8 <= size; pos += 8) {
+    if (*(uint64_t *)(pMem + pos) != 0) break;
+  }
+
+  for (; pos < size; ++pos) {
+    if (pMem[pos] != 0) return pos;
+  }
+
+  return size;
+}
+
+/*
+ * find the first complete record at or after offset, the slot of a writer that did not finish copying is skipped.
+ * Runs of zeros, i.e. unfilled slots and the preallocated tail of the log, are skipped without checking each byte.
+ * Return -1 if no record is found before the end of the file.
+ */
+static int64_t vnodeFindNextCommitRecord(int fd, int64_t offset, int64_t size, int maxSessions) {
+  if (offset + (int64_t)(sizeof(SCommitHead) + sizeof(int)) > size) return -1;
+
+  char *pMem = mmap(0, size, PROT_READ, MAP_SHARED, fd, 0);
+  if (pMem == MAP_FAILED) return -1;
+
+  static const SCommitHead zeroHead;
+
+  int64_t next = -1;
+  for (int64_t pos = offset; pos + (int64_t)(sizeof(SCommitHead) + sizeof(int)) <= size; ++pos) {
+    SCommitHead head;
+    memcpy(&head, pMem + pos, sizeof(head));
+
+    if (memcmp(&head, &zeroHead, sizeof(head)) == 0) {
+      // a record after the zeros may start with zero bytes, the scan goes on from where they may be
+      int64_t nonZero = vnodeSkipZeros(pMem, pos, size);
+      if (nonZero >= size) break;
+      if (nonZero - (int64_t)sizeof(SCommitHead) > pos) pos = nonZero - (int64_t)sizeof(SCommitHead);
+      continue;
+    }
+
+    if (!vnodeIsValidCommitHead(&head, maxSessions)) continue;
+    if (pos + sizeof(head) + head.contLen + sizeof(int) > size) continue;
+
+    int simpleCheck = 0;
+    memcpy(&simpleCheck, pMem + pos + sizeof(head) + head.contLen, sizeof(simpleCheck));
+    if (simpleCheck == head.simpleCheck) {
+      next = pos;
+      break;
+    }
+  }
+
+  munmap(pMem, size);
+  return next;
+}
+
 size_t vnodeRestoreDataFromLog(int vnode, char *fileName, uint64_t *firstV) {
   int    fd, ret;
   char * cont = NULL;
@@ -138,49 +207,56 @@ size_t vnodeRestoreDataFromLog(int vnode, char *fileName, uint64_t *firstV) {
   TSKEY now = taosGetTimestamp(pVnode->cfg.precision);
 
   SCommitHead head;
-  int simpleCheck = 0;
+  int     simpleCheck = 0;
+  int64_t offset = sizeof(pVnode->version);  // position of the record to read
   while (1) {
     ret = read(fd, &head, sizeof(head));
     if (ret < 0) goto _error;
-    if (ret == 0) break;
-    if (((head.sversion+head.sid+head.contLen+head.action) & 0xFFFFFF) != head.simpleCheck) break;
+    if (ret < sizeof(head)) break;
+
+    if (!vnodeIsValidCommitHead(&head, pVnode->cfg.maxSessions)) {
+      // a record reserved but never copied leaves a hole of zeros, records copied after it are still restored
+      offset = vnodeFindNextCommitRecord(fd, offset + 1, fstat.st_size, pVnode->cfg.maxSessions);
+      if (offset < 0) break;
+      dWarn("vid:%d, hole in commit log is skipped, next record at offset:%ld", vnode, offset);
+      if (lseek(fd, offset, SEEK_SET) < 0) goto _error;
+      continue;
+    }
     simpleCheck = head.simpleCheck;
 
-    // head.contLen validation is removed
-    if (head.sid >= pVnode->cfg.maxSessions || head.sid < 0 || head.action >= TSDB_ACTION_MAX) {
-      dError("vid, invalid commit head, sid:%d contLen:%d action:%d", head.sid, head.contLen, head.action);
-    } else {
-      if (head.contLen > 0) {
-        if (bufLen < head.contLen+sizeof(simpleCheck)) {  // pre-allocated buffer is not enough
-          cont = realloc(cont, head.contLen+sizeof(simpleCheck));
-          bufLen = head.contLen+sizeof(simpleCheck);
-        }
-
-        if (read(fd, cont, head.contLen+sizeof(simpleCheck)) < 0) goto _error;
-        if (*(int *)(cont+head.contLen) != simpleCheck) break;
-        SMeterObj *pObj = pVnode->meterList[head.sid];
-        if (pObj == NULL) {
-          dError("vid:%d, sid:%d not exists, ignore data in commit log, contLen:%d action:%d",
-              vnode, head.sid, head.contLen, head.action);
-          continue;
-        }
-
-        if (vnodeIsMeterState(pObj, TSDB_METER_STATE_DELETING)) {
-          dWarn("vid:%d sid:%d id:%s, meter is dropped, ignore data in commit log, contLen:%d action:%d",
-                 vnode, head.sid, head.contLen, head.action);
-          continue;
-        }
-
-        int32_t numOfPoints = 0;
-        (*vnodeProcessAction[head.action])(pObj, cont, head.contLen, TSDB_DATA_SOURCE_LOG, NULL, head.sversion,
-                                           &numOfPoints, now);
-        actions++;
-      } else {
-        break;
-      }
+    if (bufLen < head.contLen+sizeof(simpleCheck)) {  // pre-allocated buffer is not enough
+      cont = realloc(cont, head.contLen+sizeof(simpleCheck));
+      bufLen = head.contLen+sizeof(simpleCheck);
+    }
+
+    if (read(fd, cont, head.contLen+sizeof(simpleCheck)) < 0) goto _error;
+    offset += sizeof(head) + head.contLen + sizeof(simpleCheck);
+
+    // writers copy into the log concurrently, a torn record may be followed by complete ones
+    if (*(int *)(cont+head.contLen) != simpleCheck) {
+      dWarn("vid:%d sid:%d, torn record in commit log is skipped, contLen:%d action:%d", vnode, head.sid,
+            head.contLen, head.action);
+      continue;
+    }
+    totalLen = offset - sizeof(pVnode->version);
+
+    SMeterObj *pObj = pVnode->meterList[head.sid];
+    if (pObj == NULL) {
+      dError("vid:%d, sid:%d not exists, ignore data in commit log, contLen:%d action:%d",
+          vnode, head.sid, head.contLen, head.action);
+      continue;
+    }
+
+    if (vnodeIsMeterState(pObj, TSDB_METER_STATE_DELETING)) {
+      dWarn("vid:%d sid:%d id:%s, meter is dropped, ignore data in commit log, contLen:%d action:%d",
+             vnode, head.sid, head.contLen, head.action);
+      continue;
     }
 
-    totalLen += sizeof(head) + head.contLen + sizeof(simpleCheck);
+    int32_t numOfPoints = 0;
+    (*vnodeProcessAction[head.action])(pObj, cont, head.contLen, TSDB_DATA_SOURCE_LOG, NULL, head.sversion,
+                                       &numOfPoints, now);
+    actions++;
   }
 
   tclose(fd);
@@ -207,7 +283,11 @@ int vnodeInitCommit(int vnode) {
   uint64_t   firstV = 0;
   SVnodeObj *pVnode = vnodeList + vnode;
 
-  pthread_mutex_init(&(pVnode->logMutex), NULL);
+  pthread_rwlock_init(&(pVnode->logLock), NULL);
+  pthread_mutex_init(&(pVnode->syncMutex), NULL);
+  pthread_mutex_init(&(pVnode->rspMutex), NULL);
+  pVnode->syncInTimer = 0;
+  pVnode->syncClosing = 0;
 
   sprintf(pVnode->logFn, "%s/vnode%d/db/submit%d.log", tsDirectory, vnode, vnode);
   sprintf(pVnode->logOFn, "%s/vnode%d/db/submit%d.olog", tsDirectory, vnode, vnode);
@@ -243,6 +323,23 @@ int vnodeInitCommit(int vnode) {
 void vnodeCleanUpCommit(int vnode) {
   SVnodeObj *pVnode = vnodeList + vnode;
 
+  pthread_mutex_lock(&(pVnode->rspMutex));
+  pVnode->syncClosing = 1;
+  if (pVnode->syncTimer != NULL && taosTmrStop(pVnode->syncTimer)) pVnode->syncTimer = NULL;
+  pthread_mutex_unlock(&(pVnode->rspMutex));
+
+  // a timer that can not be stopped is running or about to run, the locks are destroyed after it is over
+  while (1) {
+    pthread_mutex_lock(&(pVnode->rspMutex));
+    bool over = pVnode->syncTimer == NULL && pVnode->syncInTimer == 0;
+    pthread_mutex_unlock(&(pVnode->rspMutex));
+
+    if (over) break;
+    taosMsleep(1);
+  }
+
+  vnodeSyncCommitLog(pVnode);
+
   if (VALIDFD(pVnode->logFd)) close(pVnode->logFd);
 
   if (pVnode->cfg.commitLog && (pVnode->logFd > 0 && remove(pVnode->logFn) < 0)) {
@@ -250,7 +347,9 @@ void vnodeCleanUpCommit(int vnode) {
     taosLogError("vid:%d, failed to remove:%s", vnode, pVnode->logFn);
   }
 
-  pthread_mutex_destroy(&(pVnode->logMutex));
+  pthread_rwlock_destroy(&(pVnode->logLock));
+  pthread_mutex_destroy(&(pVnode->syncMutex));
+  pthread_mutex_destroy(&(pVnode->rspMutex));
 }
 
 int vnodeWriteToCommitLog(SMeterObj *pObj, char action, char *cont, int contLen, int sverion) {
@@ -264,23 +363,48 @@ int vnodeWriteToCommitLog(SMeterObj *pObj, char action, char *cont, int contLen,
   head.contLen = contLen;
   head.simpleCheck = (head.sversion+head.sid+head.contLen+head.action) & 0xFFFFFF;
   int simpleCheck = head.simpleCheck;
+  int len = sizeof(head) + contLen + sizeof(simpleCheck);
 
-  pthread_mutex_lock(&(pVnode->logMutex));
-  // 100 bytes redundant mem space
-  if (pVnode->mappingSize - (pVnode->pWrite - pVnode->pMem) < contLen + sizeof(SCommitHead) + sizeof(simpleCheck) + 100) {
-    pthread_mutex_unlock(&(pVnode->logMutex));
-    dTrace("vid:%d, mem mapping space is not enough, wait for commit", pObj->vnode);
-    vnodeProcessCommitTimer(pVnode, NULL);
-    return TSDB_CODE_ACTION_IN_PROGRESS;
+  /*
+   * the space is reserved by moving the write cursor with CAS, so writers for different meters copy into the log
+   * in parallel. The shared lock only keeps the mapping from being renewed while copying. The writer is counted in
+   * the current epoch before it reserves, so a flush knows when the records reserved before it are all copied,
+   * see vnodeSyncCommitLog. Writers never wait for each other.
+   */
+  pthread_rwlock_rdlock(&(pVnode->logLock));
+
+  int32_t epoch = 0;
+  while (1) {
+    epoch = atomic_load_32(&pVnode->logEpoch);
+    atomic_add_fetch_32(&pVnode->numOfCopying[epoch & 1], 1);
+    if (atomic_load_32(&pVnode->logEpoch) == epoch) break;
+    atomic_sub_fetch_32(&pVnode->numOfCopying[epoch & 1], 1);
+  }
+
+  char *pWrite = atomic_load_ptr(&pVnode->pWrite);
+  while (1) {
+    // 100 bytes redundant mem space
+    if (pVnode->mappingSize - (pWrite - pVnode->pMem) < len + 100) {
+      atomic_sub_fetch_32(&pVnode->numOfCopying[epoch & 1], 1);
+      pthread_rwlock_unlock(&(pVnode->logLock));
+      dTrace("vid:%d, mem mapping space is not enough, wait for commit", pObj->vnode);
+      vnodeProcessCommitTimer(pVnode, NULL);
+      return TSDB_CODE_ACTION_IN_PROGRESS;
+    }
+
+    char *pOld = atomic_val_compare_exchange_ptr(&pVnode->pWrite, pWrite, pWrite + len);
+    if (pOld == pWrite) break;
+    pWrite = pOld;
   }
-  char *pWrite = pVnode->pWrite;
-  pVnode->pWrite += sizeof(head) + contLen + sizeof(simpleCheck);
+
   memcpy(pWrite, (char *)&head, sizeof(head));
   memcpy(pWrite + sizeof(head), cont, contLen);
   memcpy(pWrite + sizeof(head) + contLen, &simpleCheck, sizeof(simpleCheck));
-  pthread_mutex_unlock(&(pVnode->logMutex));
 
-  if (pVnode->pWrite - pVnode->pMem > pVnode->mappingThreshold) {
+  atomic_sub_fetch_32(&pVnode->numOfCopying[epoch & 1], 1);
+  pthread_rwlock_unlock(&(pVnode->logLock));
+
+  if (pWrite + len - pVnode->pMem > pVnode->mappingThreshold) {
     dTrace("vid:%d, mem mapping is close to limit, commit", pObj->vnode);
     vnodeProcessCommitTimer(pVnode, NULL);
   }
@@ -289,3 +413,107 @@ int vnodeWriteToCommitLog(SMeterObj *pObj, char action, char *cont, int contLen,
 
   return 0;
 }
+
+/*
+ * flush the commit log copied so far to disk, then send the submit responses delayed by group commit. A response
+ * is added only after its record is copied, so its record is reserved before the end of the flush taken below.
+ */
+void vnodeSyncCommitLog(SVnodeObj *pVnode) {
+  pthread_mutex_lock(&(pVnode->syncMutex));
+
+  pthread_mutex_lock(&(pVnode->rspMutex));
+  SSubmitRspInfo *pRsp = pVnode->pDelayedRsp;
+  int32_t         numOfRsp = pVnode->numOfDelayedRsp;
+  pVnode->pDelayedRsp = NULL;
+  pVnode->numOfDelayedRsp = 0;
+  pVnode->maxDelayedRsp = 0;
+  pthread_mutex_unlock(&(pVnode->rspMutex));
+
+  int code = TSDB_CODE_SUCCESS;
+
+  pthread_rwlock_rdlock(&(pVnode->logLock));
+  if (VALIDFD(pVnode->logFd) && pVnode->pMem != NULL) {
+    /*
+     * a writer reserving before pEnd is read counts itself in the epoch before the move, or sees the move and
+     * reserves after pEnd. Once the writers of the old epoch are gone, all records before pEnd are copied.
+     */
+    char *  pEnd = atomic_load_ptr(&pVnode->pWrite);
+    int32_t epoch = atomic_fetch_add_32(&pVnode->logEpoch, 1);
+    while (atomic_load_32(&pVnode->numOfCopying[epoch & 1]) > 0) sched_yield();
+
+    if (pEnd > pVnode->pSync) {
+      int64_t pageSize = sysconf(_SC_PAGESIZE);
+      char *  pStart = pVnode->pMem + ((pVnode->pSync - pVnode->pMem) / pageSize) * pageSize;
+
+      if (msync(pStart, pEnd - pStart, MS_SYNC) < 0) {
+        dError("vid:%d, failed to flush commit log, reason:%s", pVnode->vnode, strerror(errno));
+        code = TSDB_CODE_OTHERS;
+      } else {
+        pVnode->pSync = pEnd;
+      }
+    }
+  }
+  pthread_rwlock_unlock(&(pVnode->logLock));
+
+  pthread_mutex_unlock(&(pVnode->syncMutex));
+
+  for (int32_t i = 0; i < numOfRsp; ++i) {
+    SShellObj *pObj = pRsp[i].pObj;
+    if (pObj->thandle == NULL || pObj->thandle != pRsp[i].thandle) continue;  // connection is gone
+
+    vnodeSendShellSubmitRspMsg(pObj, code, (code == TSDB_CODE_SUCCESS) ? pRsp[i].numOfPoints : 0);
+  }
+
+  dTrace("vid:%d, commit log is flushed, %d submit responses are sent", pVnode->vnode, numOfRsp);
+  tfree(pRsp);
+}
+
+static void vnodeProcessGroupCommitTimer(void *param, void *tmrId) {
+  SVnodeObj *pVnode = (SVnodeObj *)param;
+
+  pthread_mutex_lock(&(pVnode->rspMutex));
+  pVnode->syncTimer = NULL;
+  if (pVnode->syncClosing) {
+    // the vnode is being closed, the log is flushed by vnodeCleanUpCommit
+    pthread_mutex_unlock(&(pVnode->rspMutex));
+    return;
+  }
+  pVnode->syncInTimer = 1;
+  pthread_mutex_unlock(&(pVnode->rspMutex));
+
+  vnodeSyncCommitLog(pVnode);
+
+  pthread_mutex_lock(&(pVnode->rspMutex));
+  pVnode->syncInTimer = 0;
+  pthread_mutex_unlock(&(pVnode->rspMutex));
+}
+
+void vnodeDelaySubmitRsp(SVnodeObj *pVnode, SShellObj *pObj, int numOfPoints) {
+  pthread_mutex_lock(&(pVnode->rspMutex));
+
+  if (pVnode->numOfDelayedRsp >= pVnode->maxDelayedRsp) {
+    int32_t         maxRsp = (pVnode->maxDelayedRsp == 0) ? 64 : pVnode->maxDelayedRsp * 2;
+    SSubmitRspInfo *pRsp = realloc(pVnode->pDelayedRsp, maxRsp * sizeof(SSubmitRspInfo));
+    if (pRsp == NULL) {
+      pthread_mutex_unlock(&(pVnode->rspMutex));
+      dError("vid:%d, failed to delay submit response, flush commit log now", pVnode->vnode);
+      vnodeSyncCommitLog(pVnode);
+      vnodeSendShellSubmitRspMsg(pObj, TSDB_CODE_SUCCESS, numOfPoints);
+      return;
+    }
+
+    pVnode->pDelayedRsp = pRsp;
+    pVnode->maxDelayedRsp = maxRsp;
+  }
+
+  SSubmitRspInfo *pRsp = &pVnode->pDelayedRsp[pVnode->numOfDelayedRsp++];
+  pRsp->pObj = pObj;
+  pRsp->thandle = pObj->thandle;
+  pRsp->numOfPoints = numOfPoints;
+
+  if (pVnode->syncTimer == NULL && !pVnode->syncClosing) {
+    taosTmrReset(vnodeProcessGroupCommitTimer, tsGroupCommitTime, pVnode, vnodeTmrCtrl, &pVnode->syncTimer);
+  }
+
+  pthread_mutex_unlock(&(pVnode->rspMutex));
+}
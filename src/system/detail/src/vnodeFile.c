@@ -19,11 +19,16 @@
 #include "tscompression.h"
 #include "tutil.h"
 #include "vnode.h"
+#include "vnodeBlockCache.h"
+#include "vnodeDataFilterFunc.h"
 #include "vnodeFile.h"
 #include "vnodeUtil.h"
 
 #define FILE_QUERY_NEW_BLOCK -5  // a special negative number
 
+// a block with too few points is written into last file, and merged with new points in next commit
+#define VNODE_IS_LAST_BLOCK(pObj, points) ((points) < (pObj)->pointsPerFileBlock * tsFileBlockMinPercent)
+
 const int16_t vnodeFileVersion = 0;
 
 int (*pCompFunc[])(const char *const input, int inputSize, const int elements, char *const output, int outputSize,
@@ -64,6 +69,9 @@ void vnodeAdustVnodeFile(SVnodeObj *pVnode);
 int vnodeSyncRetrieveFile(int vnode, int fd, uint32_t peerFid, uint64_t *fmagic);
 int vnodeSyncRestoreFile(int vnode, int sfd);
 void vnodeAdjustFileTier(int vnode);
+static SField *vnodeCompressBlock(SMeterObj *pObj, SData *data[], SData *cdata[], int points);
+static int vnodeWriteCompressedBlock(SMeterObj *pObj, SCompBlock *pCompBlock, SField *fields, SData *data[],
+                                     SData *cdata[], int points);
 
 void vnodeGetHeadDataLname(char *headName, char *dataName, char *lastName, int vnode, int fileId) {
   if (headName != NULL) sprintf(headName, "%s/vnode%d/db/v%df%d.head", tsDirectory, vnode, vnode, fileId);
@@ -407,12 +415,16 @@ void vnodeRemoveFile(int vnode, int fileId) {
     close(fd);
   }
 
+  atomic_add_fetch_32(&pVnode->fileVersion, 1);
   remove(headName);
   remove(dataName);
   remove(lastName);
   remove(dHeadName);
   remove(dDataName);
   remove(dLastName);
+  atomic_add_fetch_32(&pVnode->fileVersion, 1);
+
+  vnodeInvalidateBlockCache(vnode, fileId);
 
   dTrace("vid:%d fileId:%d on disk: %s is removed, numOfFiles:%d maxFiles:%d", vnode, fileId, path,
          pVnode->numOfFiles, pVnode->maxFiles);
@@ -442,6 +454,7 @@ void vnodeCloseCommitFiles(SVnodeObj *pVnode) {
   if (pVnode->tfd > 0) close(pVnode->tfd);
 
   pthread_mutex_lock(&(pVnode->vmutex));
+  atomic_add_fetch_32(&pVnode->fileVersion, 1);
 
   readlink(pVnode->cfn, dpath, TSDB_FILENAME_LEN);
   ret = rename(pVnode->nfn, pVnode->cfn);
@@ -460,8 +473,10 @@ void vnodeCloseCommitFiles(SVnodeObj *pVnode) {
     remove(dpath);
   }
 
+  atomic_add_fetch_32(&pVnode->fileVersion, 1);
   pthread_mutex_unlock(&(pVnode->vmutex));
 
+  vnodeInvalidateBlockCache(pVnode->vnode, pVnode->commitFileId);
   pVnode->tfd = 0;
 
   dTrace("vid:%d, %s and %s is saved", pVnode->vnode, pVnode->cfn, pVnode->lfn);
@@ -473,10 +488,165 @@ void vnodeCloseCommitFiles(SVnodeObj *pVnode) {
 
 void vnodeBroadcastStatusToUnsyncedPeer(SVnodeObj *pVnode);
 
+/*
+ * blocks to be committed flow through a pipe: the commit thread reads a block from cache into a free slot and
+ * submits it, the block is compressed by the commit workers, and the commit thread writes the compressed blocks in
+ * the submitted order, so the layout of head/data/last files is the same as committing block by block.
+ */
+typedef struct {
+  SMeterObj * pObj;
+  SCompBlock *pCompBlock;
+  SField *    fields;
+  int         points;
+  tsem_t      sem;  // posted when the block is compressed
+  char *      dmem;
+  char *      cmem;
+  SData *     data[TSDB_MAX_COLUMNS];
+  SData *     cdata[TSDB_MAX_COLUMNS];
+} SCommitBlock;
+
+typedef struct {
+  int32_t      numOfSlots;
+  int32_t      head;         // the first block submitted but not written yet
+  int32_t      numOfBlocks;  // number of blocks submitted but not written yet
+  SCommitBlock slots[];
+} SCommitPipe;
+
+static void vnodeCloseCommitPipe(SCommitPipe *pPipe) {
+  if (pPipe == NULL) return;
+
+  // blocks still being compressed shall be waited for, but they are not written any more
+  while (pPipe->numOfBlocks > 0) {
+    SCommitBlock *pBlock = pPipe->slots + pPipe->head;
+    tsem_wait(&pBlock->sem);
+    tfree(pBlock->fields);
+
+    pPipe->head = (pPipe->head + 1) % pPipe->numOfSlots;
+    pPipe->numOfBlocks--;
+  }
+
+  for (int32_t i = 0; i < pPipe->numOfSlots; ++i) {
+    tsem_destroy(&pPipe->slots[i].sem);
+    tfree(pPipe->slots[i].dmem);
+  }
+
+  free(pPipe);
+}
+
+static SCommitPipe *vnodeOpenCommitPipe(int dmsize, int cmsize) {
+  int32_t numOfSlots = (commitQhandle == NULL) ? 1 : tsNumOfCommitThreads * 2;
+
+  SCommitPipe *pPipe = calloc(1, sizeof(SCommitPipe) + numOfSlots * sizeof(SCommitBlock));
+  if (pPipe == NULL) return NULL;
+
+  pPipe->numOfSlots = numOfSlots;
+  for (int32_t i = 0; i < numOfSlots; ++i) {
+    SCommitBlock *pBlock = pPipe->slots + i;
+    tsem_init(&pBlock->sem, 0, 0);
+
+    pBlock->dmem = malloc(dmsize + cmsize);
+    if (pBlock->dmem == NULL) {
+      pPipe->numOfSlots = i + 1;
+      vnodeCloseCommitPipe(pPipe);
+      return NULL;
+    }
+    pBlock->cmem = pBlock->dmem + dmsize;
+  }
+
+  return pPipe;
+}
+
+static void vnodeProcessCommitBlock(SSchedMsg *pMsg) {
+  SCommitBlock *pBlock = (SCommitBlock *)pMsg->ahandle;
+
+  pBlock->fields = vnodeCompressBlock(pBlock->pObj, pBlock->data, pBlock->cdata, pBlock->points);
+  tsem_post(&pBlock->sem);
+}
+
+static int vnodeWriteFirstCommitBlock(SCommitPipe *pPipe) {
+  SCommitBlock *pBlock = pPipe->slots + pPipe->head;
+  int           code = -1;
+
+  tsem_wait(&pBlock->sem);
+  if (pBlock->fields != NULL) {
+    code = vnodeWriteCompressedBlock(pBlock->pObj, pBlock->pCompBlock, pBlock->fields, pBlock->data, pBlock->cdata,
+                                     pBlock->points);
+  }
+
+  tfree(pBlock->fields);
+  pPipe->head = (pPipe->head + 1) % pPipe->numOfSlots;
+  pPipe->numOfBlocks--;
+
+  return code;
+}
+
+/*
+ * get a free slot to read the next block of meter into, the oldest block is written out if the pipe is full. The
+ * slot is not occupied until the block is submitted, so it can be simply abandoned if no data is read into it.
+ */
+static SCommitBlock *vnodeGetCommitBlock(SCommitPipe *pPipe, SMeterObj *pObj) {
+  if (pPipe->numOfBlocks == pPipe->numOfSlots) {
+    if (vnodeWriteFirstCommitBlock(pPipe) < 0) return NULL;
+  }
+
+  SCommitBlock *pBlock = pPipe->slots + (pPipe->head + pPipe->numOfBlocks) % pPipe->numOfSlots;
+  pBlock->pObj = pObj;
+
+  pBlock->data[0] = (SData *)pBlock->dmem;
+  pBlock->cdata[0] = (SData *)pBlock->cmem;
+  for (int col = 1; col < pObj->numOfColumns; ++col) {
+    pBlock->data[col] = (SData *)(((char *)pBlock->data[col - 1]) + sizeof(SData) +
+                                  pObj->pointsPerFileBlock * pObj->schema[col - 1].bytes + EXTRA_BYTES + sizeof(TSCKSUM));
+    pBlock->cdata[col] = (SData *)(((char *)pBlock->cdata[col - 1]) + sizeof(SData) +
+                                   pObj->pointsPerFileBlock * pObj->schema[col - 1].bytes + EXTRA_BYTES + sizeof(TSCKSUM));
+  }
+
+  return pBlock;
+}
+
+/*
+ * hand the block over to the commit workers. Fields of pCompBlock which do not depend on the file position are
+ * filled here, so the commit thread can go on with the next block before this one is written.
+ */
+static int vnodeSubmitCommitBlock(SCommitPipe *pPipe, SCommitBlock *pBlock, SCompBlock *pCompBlock, int points) {
+  SMeterObj *pObj = pBlock->pObj;
+
+  pBlock->pCompBlock = pCompBlock;
+  pBlock->points = points;
+  pPipe->numOfBlocks++;
+
+  pCompBlock->last = VNODE_IS_LAST_BLOCK(pObj, points);
+  pCompBlock->numOfPoints = points;
+  pCompBlock->keyFirst = *((TSKEY *)(pBlock->data[0]->data));
+  pCompBlock->keyLast = *((TSKEY *)(pBlock->data[0]->data + (points - 1) * pObj->schema[0].bytes));
+
+  if (commitQhandle == NULL) {
+    pBlock->fields = vnodeCompressBlock(pObj, pBlock->data, pBlock->cdata, points);
+    tsem_post(&pBlock->sem);
+    return vnodeWriteFirstCommitBlock(pPipe);
+  }
+
+  SSchedMsg schedMsg = {0};
+  schedMsg.fp = vnodeProcessCommitBlock;
+  schedMsg.ahandle = pBlock;
+  taosScheduleTask(commitQhandle, &schedMsg);
+
+  return 0;
+}
+
+static int vnodeFlushCommitPipe(SCommitPipe *pPipe) {
+  while (pPipe->numOfBlocks > 0) {
+    if (vnodeWriteFirstCommitBlock(pPipe) < 0) return -1;
+  }
+
+  return 0;
+}
+
 void *vnodeCommitMultiToFile(SVnodeObj *pVnode, int ssid, int esid) {
   int              vnode = pVnode->vnode;
-  SData *          data[TSDB_MAX_COLUMNS], *cdata[TSDB_MAX_COLUMNS];  // first 4 bytes are length
-  char *           buffer = NULL, *dmem = NULL, *cmem = NULL, *hmem = NULL, *tmem = NULL;
+  char *           buffer = NULL, *hmem = NULL, *tmem = NULL;
+  SCommitPipe *    pPipe = NULL;
+  SCommitBlock *   pBlock = NULL;
   SMeterObj *      pObj = NULL;
   SCompInfo        compInfo = {0};
   SCompHeader *    pHeader;
@@ -485,17 +655,26 @@ void *vnodeCommitMultiToFile(SVnodeObj *pVnode, int ssid, int esid) {
   SColumnInfoEx    colList[TSDB_MAX_COLUMNS] = {0};
   SSqlFunctionExpr pExprs[TSDB_MAX_COLUMNS] = {0};
   int              commitAgain;
-  int              headLen, sid, col;
+  int              headLen, sid;
   int64_t          pointsRead;
   int64_t          pointsReadLast;
   SCompBlock *     pCompBlock = NULL;
   SVnodeCfg *      pCfg = &pVnode->cfg;
   TSCKSUM          chksum;
   SVnodeHeadInfo   headInfo;
-  uint8_t *        pOldCompBlocks;
+  uint8_t *        pOldCompBlocks = NULL;
+  int64_t          commitStart = taosGetTimestampUs();
+  int64_t          commitBlocks = pVnode->vnodeStatistic.commitBlocks;
+  int64_t          commitBytes = pVnode->vnodeStatistic.commitBytes;
 
   dPrint("vid:%d, committing to file, firstKey:%ld lastKey:%ld ssid:%d esid:%d", vnode, pVnode->firstKey,
          pVnode->lastKey, ssid, esid);
+
+  /*
+   * imports kept in buffers are merged before the commit log is renewed, the rows merged into cache are committed
+   * below and the old log is not needed by them any more
+   */
+  vnodeMergeImportBuffers(pVnode, ssid, esid);
   if (pVnode->lastKey == 0) goto _over;
 
   vnodeCloseAllSyncFds(vnode);
@@ -536,7 +715,7 @@ void *vnodeCommitMultiToFile(SVnodeObj *pVnode, int ssid, int esid) {
   // buffer to hold meterInfo
   int misize = pVnode->cfg.maxSessions * sizeof(SMeterInfo);
 
-  int totalSize = hmsize + dmsize + cmsize + misize + tmsize;
+  int totalSize = hmsize + misize + tmsize;
   buffer = malloc(totalSize);
   if (buffer == NULL) {
     dError("no enough memory for committing buffer");
@@ -544,11 +723,17 @@ void *vnodeCommitMultiToFile(SVnodeObj *pVnode, int ssid, int esid) {
   }
 
   hmem = buffer;
-  dmem = hmem + hmsize;
-  cmem = dmem + dmsize;
-  tmem = cmem + cmsize;
+  tmem = hmem + hmsize;
   meterInfo = (SMeterInfo *)(tmem + tmsize);
 
+  // uncompressed and compressed data of the blocks in committing
+  pPipe = vnodeOpenCommitPipe(dmsize, cmsize);
+  if (pPipe == NULL) {
+    dError("no enough memory for committing buffer");
+    tfree(buffer);
+    return NULL;
+  }
+
   pthread_mutex_lock(&(pVnode->vmutex));
   pVnode->commitFirstKey = pVnode->firstKey;
   pVnode->firstKey = pVnode->lastKey + 1;
@@ -648,15 +833,6 @@ _again:
     pObj = (SMeterObj *)(pVnode->meterList[sid]);
     if ((pObj == NULL) || (pObj->pCache == NULL)) continue;
 
-    data[0] = (SData *)dmem;
-    cdata[0] = (SData *)cmem;
-    for (col = 1; col < pObj->numOfColumns; ++col) {
-      data[col] = (SData *)(((char *)data[col - 1]) + sizeof(SData) +
-                            pObj->pointsPerFileBlock * pObj->schema[col - 1].bytes + EXTRA_BYTES + sizeof(TSCKSUM));
-      cdata[col] = (SData *)(((char *)cdata[col - 1]) + sizeof(SData) +
-                             pObj->pointsPerFileBlock * pObj->schema[col - 1].bytes + EXTRA_BYTES + sizeof(TSCKSUM));
-    }
-
     pMeter = meterInfo + sid;
     pMeter->tempHeadOffset = headLen;
 
@@ -668,7 +844,6 @@ _again:
     query.skey = pVnode->commitFirstKey;
     query.lastKey = query.skey;
 
-    query.sdata = data;
     vnodeSetCommitQuery(pObj, &query);
 
     dTrace("vid:%d sid:%d id:%s, start to commit, startKey:%lld slot:%d pos:%d", pObj->vnode, pObj->sid, pObj->meterId,
@@ -676,14 +851,18 @@ _again:
 
     pointsRead = 0;
     pointsReadLast = 0;
+    pBlock = NULL;
 
     // last block is at last file
     if (pMeter->last) {
       if ((pMeter->lastBlock.sversion != pObj->sversion) || (query.over)) {
+        // the last block is copied into file directly, blocks in the pipe shall be written ahead of it
+        if (vnodeFlushCommitPipe(pPipe) < 0) goto _over;
+
         // TODO : Check the correctness of this code. write the last block to
         // .data file
         pCompBlock = (SCompBlock *)(hmem + headLen);
-        assert(dmem - (char *)pCompBlock >= sizeof(SCompBlock));
+        assert(hmsize - headLen >= sizeof(SCompBlock));
         *pCompBlock = pMeter->lastBlock;
         if (pMeter->lastBlock.sversion != pObj->sversion) {
           pCompBlock->last = 0;
@@ -709,7 +888,8 @@ _again:
         pMeter->newNumOfBlocks++;
       } else {
         // read last block into memory
-        if (vnodeReadLastBlockToMem(pObj, &pMeter->lastBlock, data) < 0) goto _over;
+        if ((pBlock = vnodeGetCommitBlock(pPipe, pObj)) == NULL) goto _over;
+        if (vnodeReadLastBlockToMem(pObj, &pMeter->lastBlock, pBlock->data) < 0) goto _over;
         pMeter->last = 0;
         pointsReadLast = pMeter->lastBlock.numOfPoints;
         query.over = 0;
@@ -725,7 +905,10 @@ _again:
 
     while (query.over == 0) {
       pCompBlock = (SCompBlock *)(hmem + headLen);
-      assert(dmem - (char *)pCompBlock >= sizeof(SCompBlock));
+      assert(hmsize - headLen >= sizeof(SCompBlock));
+      if (pBlock == NULL && (pBlock = vnodeGetCommitBlock(pPipe, pObj)) == NULL) goto _over;
+
+      query.sdata = pBlock->data;
       pointsRead += pointsReadLast;
 
       while (pointsRead < pObj->pointsPerFileBlock) {
@@ -738,8 +921,9 @@ _again:
       if (pointsRead == 0) break;
 
       headInfo.totalStorage += ((pointsRead - pointsReadLast) * pObj->bytesPerPoint);
-      pCompBlock->last = 1;
-      if (vnodeWriteBlockToFile(pObj, pCompBlock, data, cdata, pointsRead) < 0) goto _over;
+      if (vnodeSubmitCommitBlock(pPipe, pBlock, pCompBlock, pointsRead) < 0) goto _over;
+      pBlock = NULL;
+
       if (pCompBlock->keyLast > pObj->lastKeyOnFile) pObj->lastKeyOnFile = pCompBlock->keyLast;
       pMeter->last = pCompBlock->last;
 
@@ -781,6 +965,7 @@ _again:
 
   if (pVnode->lastKey > pVnode->commitLastKey) commitAgain = 1;
 
+  if (vnodeFlushCommitPipe(pPipe) < 0) goto _over;
   dTrace("vid:%d, finish appending the data file", vnode);
 
   // calculate the new compInfoOffset
@@ -892,9 +1077,13 @@ _again:
     goto _again;
   }
 
-  vnodeRemoveCommitLog(vnode);
+  // imports left in buffers are in the old commit log, they shall be written into the new one
+  if (vnodeRelogImportBuffers(pVnode, ssid, esid) == 0) {
+    vnodeRemoveCommitLog(vnode);
+  }
 
 _over:
+  vnodeCloseCommitPipe(pPipe);
   pVnode->commitInProcess = 0;
   vnodeCommitOver(pVnode);
   memset(&(vnodeList[vnode].commitThread), 0, sizeof(vnodeList[vnode].commitThread));
@@ -902,7 +1091,21 @@ _over:
   tfree(pOldCompBlocks);
 
   vnodeBroadcastStatusToUnsyncedPeer(pVnode);
-  dPrint("vid:%d, committing is over", vnode);
+
+  int64_t commitTime = taosGetTimestampUs() - commitStart;
+  pVnode->vnodeStatistic.commitTime += commitTime;
+  commitBlocks = pVnode->vnodeStatistic.commitBlocks - commitBlocks;
+  commitBytes = pVnode->vnodeStatistic.commitBytes - commitBytes;
+  dPrint("vid:%d, committing is over, %ld blocks %ld bytes in %ld us, %.2f MB/s %.2f blocks/s", vnode, commitBlocks,
+         commitBytes, commitTime, commitBytes * 1000000.0 / (1024 * 1024) / MAX(commitTime, 1),
+         commitBlocks * 1000000.0 / MAX(commitTime, 1));
+
+  if (vnodeBlockCacheEnabled()) {
+    int64_t hits = pVnode->vnodeStatistic.blockCacheHits;
+    int64_t misses = pVnode->vnodeStatistic.blockCacheMisses;
+    dPrint("vid:%d, block cache hits:%ld misses:%ld hit rate:%.2f%%, memory used by all vnodes:%ld bytes", vnode, hits,
+           misses, hits * 100.0 / MAX(hits + misses, 1), vnodeGetBlockCacheMemory());
+  }
 
   return pVnode;
 }
@@ -1042,8 +1245,7 @@ int vnodeReadColumnToMem(int fd, SCompBlock *pBlock, SField **fields, int col, c
   if (*fields == NULL) {
     size = sizeof(SField) * (pBlock->numOfCols) + sizeof(TSCKSUM);
     *fields = (SField *)calloc(1, size);
-    lseek(fd, pBlock->offset, SEEK_SET);
-    read(fd, *fields, size);
+    pread(fd, *fields, size, pBlock->offset);
     if (!taosCheckChecksumWhole((uint8_t *)(*fields), size)) {
       dError("SField checksum error, col: %d", col);
       taosLogError("SField checksum error, col: %d", col);
@@ -1056,11 +1258,15 @@ int vnodeReadColumnToMem(int fd, SCompBlock *pBlock, SField **fields, int col, c
   /* If data is NULL, that means only to read SField content. So no need to read data part. */
   if (data == NULL) return 0;
 
-  lseek(fd, pBlock->offset + tfields[col].offset, SEEK_SET);
+  /* column data and its checksum are adjacent, load both in one call */
+  struct iovec iov[2];
+  iov[0].iov_base = (pBlock->algorithm) ? temp : data;
+  iov[0].iov_len = tfields[col].len;
+  iov[1].iov_base = &chksum;
+  iov[1].iov_len = sizeof(TSCKSUM);
+  len = preadv(fd, iov, 2, pBlock->offset + tfields[col].offset);
 
   if (pBlock->algorithm) {
-    len = read(fd, temp, tfields[col].len);
-    read(fd, &chksum, sizeof(TSCKSUM));
     if (chksum != taosCalcChecksum(0, (uint8_t *)temp, tfields[col].len)) {
       dError("data column checksum error, col: %d", col);
       taosLogError("data column checksum error, col: %d", col);
@@ -1071,8 +1277,6 @@ int vnodeReadColumnToMem(int fd, SCompBlock *pBlock, SField **fields, int col, c
                                       pBlock->algorithm, buffer, bufferSize);
 
   } else {
-    len = read(fd, data, tfields[col].len);
-    read(fd, &chksum, sizeof(TSCKSUM));
     if (chksum != taosCalcChecksum(0, (uint8_t *)data, tfields[col].len)) {
       dError("data column checksum error, col: %d", col);
       taosLogError("data column checksum error, col: %d", col);
@@ -1193,33 +1397,19 @@ int vnodeReadLastBlockToMem(SMeterObj *pObj, SCompBlock *pBlock, SData *sdata[])
   return code;
 }
 
-int vnodeWriteBlockToFile(SMeterObj *pObj, SCompBlock *pCompBlock, SData *data[], SData *cdata[], int points) {
-  SVnodeObj *pVnode = &vnodeList[pObj->vnode];
-  SVnodeCfg *pCfg = &pVnode->cfg;
-  int        wlen = 0;
-  SField *   fields = NULL;
+/*
+ * compress all columns of a block into cdata and calculate the statistics, it touches no file so it can be done
+ * by the commit workers in parallel. Return the SField list which shall be freed by caller.
+ */
+static SField *vnodeCompressBlock(SMeterObj *pObj, SData *data[], SData *cdata[], int points) {
+  SVnodeCfg *pCfg = &vnodeList[pObj->vnode].cfg;
   int        size = sizeof(SField) * pObj->numOfColumns + sizeof(TSCKSUM);
   int32_t    offset = size;
   char *     buffer = NULL;
   int        bufferSize = 0;
 
-  int dfd = pVnode->dfd;
-
-  if (pCompBlock->last && (points < pObj->pointsPerFileBlock * tsFileBlockMinPercent)) {
-    dTrace("vid:%d sid:%d id:%s, points:%d are written to last block, block stime: %ld, block etime: %ld",
-           pObj->vnode, pObj->sid, pObj->meterId, points, *((TSKEY *)(data[0]->data)),
-           *((TSKEY * )(data[0]->data + (points - 1) * pObj->schema[0].bytes)));
-    pCompBlock->last = 1;
-    dfd = pVnode->tfd > 0 ? pVnode->tfd : pVnode->lfd;
-  } else {
-    pCompBlock->last = 0;
-  }
-
-  pCompBlock->offset = lseek(dfd, 0, SEEK_END);
-  pCompBlock->len = 0;
-
-  fields = (SField *)calloc(1, size);
-  if (fields == NULL) return -1;
+  SField *fields = (SField *)calloc(1, size);
+  if (fields == NULL) return NULL;
 
   if (pCfg->compression == TWO_STAGE_COMP){
     bufferSize = pObj->maxBytes * points + EXTRA_BYTES;
@@ -1249,15 +1439,40 @@ int vnodeWriteBlockToFile(SMeterObj *pObj, SCompBlock *pCompBlock, SData *data[]
 
     getStatistics(data[0]->data, data[i]->data, pObj->schema[i].bytes, points, pObj->schema[i].type, &fields[i].min,
                   &fields[i].max, &fields[i].sum, &fields[i].minIndex, &fields[i].maxIndex, &fields[i].numOfNullPoints);
+    vnodeBuildBlockBloom(&fields[i], data[i]->data, points);
   }
 
   tfree(buffer);
 
-  // Write SField part
   taosCalcChecksumAppend(0, (uint8_t *)fields, size);
+  return fields;
+}
+
+static int vnodeWriteCompressedBlock(SMeterObj *pObj, SCompBlock *pCompBlock, SField *fields, SData *data[],
+                                     SData *cdata[], int points) {
+  SVnodeObj *pVnode = &vnodeList[pObj->vnode];
+  SVnodeCfg *pCfg = &pVnode->cfg;
+  int        wlen = 0;
+  int        size = sizeof(SField) * pObj->numOfColumns + sizeof(TSCKSUM);
+
+  int dfd = pVnode->dfd;
+
+  if (pCompBlock->last && VNODE_IS_LAST_BLOCK(pObj, points)) {
+    dTrace("vid:%d sid:%d id:%s, points:%d are written to last block, block stime: %ld, block etime: %ld",
+           pObj->vnode, pObj->sid, pObj->meterId, points, *((TSKEY *)(data[0]->data)),
+           *((TSKEY * )(data[0]->data + (points - 1) * pObj->schema[0].bytes)));
+    pCompBlock->last = 1;
+    dfd = pVnode->tfd > 0 ? pVnode->tfd : pVnode->lfd;
+  } else {
+    pCompBlock->last = 0;
+  }
+
+  pCompBlock->offset = lseek(dfd, 0, SEEK_END);
+  pCompBlock->len = 0;
+
+  // Write SField part
   wlen = twrite(dfd, fields, size);
   if (wlen <= 0) {
-    tfree(fields);
     dError("vid:%d sid:%d id:%s, failed to write block, wlen:%d reason:%s", pObj->vnode, pObj->sid, pObj->meterId, wlen,
            strerror(errno));
 #ifdef CLUSTER		   
@@ -1269,7 +1484,6 @@ int vnodeWriteBlockToFile(SMeterObj *pObj, SCompBlock *pCompBlock, SData *data[]
   pVnode->vnodeStatistic.compStorage += wlen;
   pVnode->dfSize += wlen;
   pCompBlock->len += wlen;
-  tfree(fields);
 
   // Write data part
   for (int i = 0; i < pObj->numOfColumns; ++i) {
@@ -1290,6 +1504,8 @@ int vnodeWriteBlockToFile(SMeterObj *pObj, SCompBlock *pCompBlock, SData *data[]
     pCompBlock->len += wlen;
   }
 
+  pVnode->vnodeStatistic.commitBlocks++;
+  pVnode->vnodeStatistic.commitBytes += pCompBlock->len;
   dTrace("vid:%d, vnode compStorage size is: %ld", pObj->vnode, pVnode->vnodeStatistic.compStorage);
 
   pCompBlock->algorithm = pCfg->compression;
@@ -1302,6 +1518,16 @@ int vnodeWriteBlockToFile(SMeterObj *pObj, SCompBlock *pCompBlock, SData *data[]
   return 0;
 }
 
+int vnodeWriteBlockToFile(SMeterObj *pObj, SCompBlock *pCompBlock, SData *data[], SData *cdata[], int points) {
+  SField *fields = vnodeCompressBlock(pObj, data, cdata, points);
+  if (fields == NULL) return -1;
+
+  int code = vnodeWriteCompressedBlock(pObj, pCompBlock, fields, data, cdata, points);
+  tfree(fields);
+
+  return code;
+}
+
 static int forwardInFile(SQuery *pQuery, int32_t midSlot, int32_t step, SVnodeObj *pVnode, SMeterObj *pObj);
 
 int vnodeSearchPointInFile(SMeterObj *pObj, SQuery *pQuery) {
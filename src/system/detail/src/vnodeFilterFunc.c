@@ -556,3 +556,271 @@ __filter_func_t* vnodeGetValueFilterFuncArray(int32_t type) {
 }
 
 bool vnodeSupportPrefilter(int32_t type) { return type != TSDB_DATA_TYPE_BINARY && type != TSDB_DATA_TYPE_NCHAR; }
+
+static bool vnodeSupportBloomFilter(int32_t type) {
+  return type == TSDB_DATA_TYPE_TINYINT || type == TSDB_DATA_TYPE_SMALLINT || type == TSDB_DATA_TYPE_INT ||
+         type == TSDB_DATA_TYPE_BIGINT || type == TSDB_DATA_TYPE_BINARY || type == TSDB_DATA_TYPE_NCHAR;
+}
+
+static uint64_t vnodeMixHash(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb33fe1a85ec9ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+/*
+ * the value is hashed in the same form as it is compared by the filter functions: integers are widened to int64,
+ * binary is compared by strncmp and nchar by wcsncmp, so only the characters before the terminator count.
+ */
+static uint64_t vnodeBloomHash(const char *val, int32_t type, int32_t bytes) {
+  int64_t v = 0;
+
+  switch (type) {
+    case TSDB_DATA_TYPE_TINYINT: v = *(int8_t *)val; break;
+    case TSDB_DATA_TYPE_SMALLINT: v = *(int16_t *)val; break;
+    case TSDB_DATA_TYPE_INT: v = *(int32_t *)val; break;
+    case TSDB_DATA_TYPE_BIGINT: v = *(int64_t *)val; break;
+    case TSDB_DATA_TYPE_BINARY: v = MurmurHash3_32(val, strnlen(val, bytes)); break;
+    case TSDB_DATA_TYPE_NCHAR: {
+      int32_t len = 0;
+      while (len + TSDB_NCHAR_SIZE <= bytes && *(wchar_t *)(val + len) != 0) len += TSDB_NCHAR_SIZE;
+      v = MurmurHash3_32(val, len);
+      break;
+    }
+    default: assert(0);
+  }
+
+  return vnodeMixHash((uint64_t)v);
+}
+
+static void vnodeSetBloomBits(uint8_t *bloom, uint64_t h) {
+  uint32_t h1 = (uint32_t)h, h2 = (uint32_t)(h >> 32);
+  for (int32_t i = 0; i < VNODE_BLOOM_HASHES; ++i) {
+    uint32_t bit = (h1 + i * h2) % (VNODE_BLOOM_BYTES * 8);
+    bloom[bit >> 3] |= (uint8_t)(1 << (bit & 7));
+  }
+}
+
+static bool vnodeTestBloomBits(const uint8_t *bloom, uint64_t h) {
+  uint32_t h1 = (uint32_t)h, h2 = (uint32_t)(h >> 32);
+  for (int32_t i = 0; i < VNODE_BLOOM_HASHES; ++i) {
+    uint32_t bit = (h1 + i * h2) % (VNODE_BLOOM_BYTES * 8);
+    if ((bloom[bit >> 3] & (1 << (bit & 7))) == 0) return false;
+  }
+
+  return true;
+}
+
+void vnodeBuildBlockBloom(SField *pField, const char *data, int32_t numOfRows) {
+  pField->bloomHashes = 0;
+  memset(pField->bloom, 0, VNODE_BLOOM_BYTES);
+
+  if (!tsBlockBloomFilter || !vnodeSupportBloomFilter(pField->type)) {
+    return;
+  }
+
+  int32_t bytes = pField->bytes;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    const char *val = data + i * bytes;
+
+    // adjacent rows often have the same value
+    if (i > 0 && memcmp(val, val - bytes, bytes) == 0) continue;
+    if (isNull(val, pField->type)) continue;
+
+    vnodeSetBloomBits(pField->bloom, vnodeBloomHash(val, pField->type, bytes));
+  }
+
+  // with more than half of the bits set, the false positive rate is too high to skip any block
+  int32_t numOfBits = 0;
+  for (int32_t i = 0; i < VNODE_BLOOM_BYTES; ++i) {
+    numOfBits += __builtin_popcount(pField->bloom[i]);
+  }
+
+  if (numOfBits > VNODE_BLOOM_BYTES * 4) {
+    memset(pField->bloom, 0, VNODE_BLOOM_BYTES);
+  } else {
+    pField->bloomHashes = VNODE_BLOOM_HASHES;
+  }
+}
+
+bool vnodeBlockBloomMayMatch(SField *pField, SSingleColumnFilterInfo *pFilterInfo) {
+  if (pField->bloomHashes != VNODE_BLOOM_HASHES || pField->type != pFilterInfo->info.data.type) {
+    return true;
+  }
+
+  // filters of one column are OR'ed, the block is skipped only if all of them are equality checks that fail
+  for (int32_t i = 0; i < pFilterInfo->numOfFilters; ++i) {
+    SColumnFilterInfo *pInfo = &pFilterInfo->pFilters[i].filterInfo;
+    if (pInfo->lowerRelOptr != TSDB_RELATION_EQUAL || pInfo->upperRelOptr != TSDB_RELATION_INVALID) {
+      return true;
+    }
+
+    uint64_t h = 0;
+    if (pField->type == TSDB_DATA_TYPE_BINARY || pField->type == TSDB_DATA_TYPE_NCHAR) {
+      if (pInfo->len > pField->bytes) continue;  // never equal
+
+      // pz may be shorter than a column value, pad it as a value stored in block
+      char val[TSDB_MAX_BYTES_PER_ROW];
+      memset(val, 0, pField->bytes);
+      memcpy(val, (char *)pInfo->pz, pInfo->len);
+      h = vnodeBloomHash(val, pField->type, pField->bytes);
+    } else {
+      h = vnodeMixHash((uint64_t)pInfo->lowerBndi);
+    }
+
+    if (vnodeTestBloomBits(pField->bloom, h)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/*
+ * Batch filters. Each one is a plain loop over a slice of the column without branches, so that the compiler
+ * vectorizes it. The comparisons are the same as the row filters above, e.g., integers are compared with the int64
+ * bounds and float with the double bounds.
+ */
+#define DEFINE_BATCH_FILTER(name, ctype, bndtype, bnd, cond)                                                     \
+  static void name(SColumnFilterElem *pFilter, const char *data, int32_t numOfRows, uint8_t *res) {               \
+    const ctype * v = (const ctype *)data;                                                                       \
+    const bndtype L = pFilter->filterInfo.lower##bnd;                                                           \
+    const bndtype U = pFilter->filterInfo.upper##bnd;                                                           \
+    (void)L;                                                                                                     \
+    (void)U;                                                                                                     \
+    for (int32_t i = 0; i < numOfRows; ++i) {                                                                    \
+      res[i] = (cond);                                                                                           \
+    }                                                                                                            \
+  }
+
+#define DEFINE_BATCH_FILTERS(t, ctype, bndtype, bnd, equalCond)                                                  \
+  DEFINE_BATCH_FILTER(less_##t##_batch, ctype, bndtype, bnd, v[i] < U)                                          \
+  DEFINE_BATCH_FILTER(large_##t##_batch, ctype, bndtype, bnd, v[i] > L)                                         \
+  DEFINE_BATCH_FILTER(equal_##t##_batch, ctype, bndtype, bnd, equalCond)                                        \
+  DEFINE_BATCH_FILTER(lessEqual_##t##_batch, ctype, bndtype, bnd, v[i] <= U)                                    \
+  DEFINE_BATCH_FILTER(largeEqual_##t##_batch, ctype, bndtype, bnd, v[i] >= L)                                   \
+  DEFINE_BATCH_FILTER(nequal_##t##_batch, ctype, bndtype, bnd, v[i] != L)                                       \
+  DEFINE_BATCH_FILTER(rangeFilter_##t##_ee_batch, ctype, bndtype, bnd, (v[i] < U) & (v[i] > L))                 \
+  DEFINE_BATCH_FILTER(rangeFilter_##t##_ie_batch, ctype, bndtype, bnd, (v[i] < U) & (v[i] >= L))                \
+  DEFINE_BATCH_FILTER(rangeFilter_##t##_ei_batch, ctype, bndtype, bnd, (v[i] <= U) & (v[i] > L))                \
+  DEFINE_BATCH_FILTER(rangeFilter_##t##_ii_batch, ctype, bndtype, bnd, (v[i] <= U) & (v[i] >= L))               \
+                                                                                                                 \
+  static __filter_batch_func_t batchFilterFunc_##t[] = {                                                         \
+      NULL, less_##t##_batch, large_##t##_batch, equal_##t##_batch, lessEqual_##t##_batch,                       \
+      largeEqual_##t##_batch, nequal_##t##_batch, NULL,                                                          \
+  };                                                                                                             \
+                                                                                                                 \
+  static __filter_batch_func_t rangeBatchFilterFunc_##t[] = {                                                    \
+      NULL, rangeFilter_##t##_ee_batch, rangeFilter_##t##_ie_batch, rangeFilter_##t##_ei_batch,                  \
+      rangeFilter_##t##_ii_batch,                                                                                \
+  };
+
+DEFINE_BATCH_FILTERS(i8, int8_t, int64_t, Bndi, v[i] == L)
+DEFINE_BATCH_FILTERS(i16, int16_t, int64_t, Bndi, v[i] == L)
+DEFINE_BATCH_FILTERS(i32, int32_t, int64_t, Bndi, v[i] == L)
+DEFINE_BATCH_FILTERS(i64, int64_t, int64_t, Bndi, v[i] == L)
+DEFINE_BATCH_FILTERS(ds, float, double, Bndd, fabs(v[i] - L) <= FLT_EPSILON)
+DEFINE_BATCH_FILTERS(dd, double, double, Bndd, v[i] == L)
+
+__filter_batch_func_t *vnodeGetRangeBatchFilterFuncArray(int32_t type) {
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:       return rangeBatchFilterFunc_i8;
+    case TSDB_DATA_TYPE_TINYINT:    return rangeBatchFilterFunc_i8;
+    case TSDB_DATA_TYPE_SMALLINT:   return rangeBatchFilterFunc_i16;
+    case TSDB_DATA_TYPE_INT:        return rangeBatchFilterFunc_i32;
+    case TSDB_DATA_TYPE_TIMESTAMP:  // timestamp uses bigint filter
+    case TSDB_DATA_TYPE_BIGINT:     return rangeBatchFilterFunc_i64;
+    case TSDB_DATA_TYPE_FLOAT:      return rangeBatchFilterFunc_ds;
+    case TSDB_DATA_TYPE_DOUBLE:     return rangeBatchFilterFunc_dd;
+    default: return NULL;
+  }
+}
+
+__filter_batch_func_t *vnodeGetValueBatchFilterFuncArray(int32_t type) {
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:       return batchFilterFunc_i8;
+    case TSDB_DATA_TYPE_TINYINT:    return batchFilterFunc_i8;
+    case TSDB_DATA_TYPE_SMALLINT:   return batchFilterFunc_i16;
+    case TSDB_DATA_TYPE_INT:        return batchFilterFunc_i32;
+    case TSDB_DATA_TYPE_TIMESTAMP:  // timestamp uses bigint filter
+    case TSDB_DATA_TYPE_BIGINT:     return batchFilterFunc_i64;
+    case TSDB_DATA_TYPE_FLOAT:      return batchFilterFunc_ds;
+    case TSDB_DATA_TYPE_DOUBLE:     return batchFilterFunc_dd;
+    default: return NULL;  // binary/nchar are filtered row by row
+  }
+}
+
+// clear sel[i] if the i-th value is null, null values never satisfy any filter
+static void vnodeFilterNullBatch(const char *data, int32_t type, int32_t bytes, int32_t numOfRows, uint8_t *sel) {
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT: {
+      const uint8_t *v = (const uint8_t *)data;
+      const uint8_t  null = (type == TSDB_DATA_TYPE_BOOL) ? TSDB_DATA_BOOL_NULL : TSDB_DATA_TINYINT_NULL;
+      for (int32_t i = 0; i < numOfRows; ++i) sel[i] &= (v[i] != null);
+      break;
+    }
+    case TSDB_DATA_TYPE_SMALLINT: {
+      const uint16_t *v = (const uint16_t *)data;
+      for (int32_t i = 0; i < numOfRows; ++i) sel[i] &= (v[i] != TSDB_DATA_SMALLINT_NULL);
+      break;
+    }
+    case TSDB_DATA_TYPE_INT:
+    case TSDB_DATA_TYPE_FLOAT: {
+      const uint32_t *v = (const uint32_t *)data;
+      const uint32_t  null = (type == TSDB_DATA_TYPE_INT) ? TSDB_DATA_INT_NULL : TSDB_DATA_FLOAT_NULL;
+      for (int32_t i = 0; i < numOfRows; ++i) sel[i] &= (v[i] != null);
+      break;
+    }
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+    case TSDB_DATA_TYPE_DOUBLE: {
+      const uint64_t *v = (const uint64_t *)data;
+      const uint64_t  null = (type == TSDB_DATA_TYPE_DOUBLE) ? TSDB_DATA_DOUBLE_NULL : TSDB_DATA_BIGINT_NULL;
+      for (int32_t i = 0; i < numOfRows; ++i) sel[i] &= (v[i] != null);
+      break;
+    }
+    default:
+      for (int32_t i = 0; i < numOfRows; ++i) sel[i] &= !isNull(data + i * bytes, type);
+  }
+}
+
+void vnodeFilterColumnBatch(SSingleColumnFilterInfo *pFilterInfo, int32_t start, int32_t numOfRows, uint8_t *sel,
+                            uint8_t *buf) {
+  // filters have been evaluated on the dictionary of this column
+  if (pFilterInfo->pDictData != NULL && pFilterInfo->pDictData == pFilterInfo->pData) {
+    const uint8_t *codes = pFilterInfo->pDictCodes + start;
+    for (int32_t i = 0; i < numOfRows; ++i) sel[i] &= pFilterInfo->dictMatch[codes[i]];
+    return;
+  }
+
+  int32_t     bytes = pFilterInfo->info.data.bytes;
+  int16_t     type = pFilterInfo->info.data.type;
+  const char *data = pFilterInfo->pData + bytes * start;
+
+  uint8_t *colSel = buf;
+  uint8_t *res = buf + numOfRows;
+
+  // filters on the same column are OR'ed
+  memset(colSel, 0, numOfRows);
+  for (int32_t j = 0; j < pFilterInfo->numOfFilters; ++j) {
+    SColumnFilterElem *pFilterElem = &pFilterInfo->pFilters[j];
+
+    if (pFilterElem->fpBatch != NULL) {
+      pFilterElem->fpBatch(pFilterElem, data, numOfRows, res);
+      for (int32_t i = 0; i < numOfRows; ++i) colSel[i] |= res[i];
+    } else {
+      for (int32_t i = 0; i < numOfRows; ++i) {
+        char *val = (char *)data + i * bytes;
+        colSel[i] |= pFilterElem->fp(pFilterElem, val, val);
+      }
+    }
+  }
+
+  vnodeFilterNullBatch(data, type, bytes, numOfRows, colSel);
+  for (int32_t i = 0; i < numOfRows; ++i) sel[i] &= colSel[i];
+}
@@ -38,10 +38,7 @@ typedef struct {
 } SHeadInfo;
 
 typedef struct {
-  void *     signature;
-  SShellObj *pShell;
   SMeterObj *pObj;
-  int        retry;
   TSKEY      firstKey;
   TSKEY      lastKey;
   int        importedRows;
@@ -58,10 +55,16 @@ typedef struct {
   SData  *sdata[TSDB_MAX_COLUMNS];
   char   *buffer;
   char   *payload;
-  char   *opayload;
   int     rows;
 } SImportInfo;
 
+// the meter is looked up again when the timer is fired, it may have been dropped
+typedef struct {
+  int32_t  vnode;
+  int32_t  sid;
+  uint64_t uid;
+} SImportMergeParam;
+
 int vnodeImportData(SMeterObj *pObj, SImportInfo *pImport);
 
 int vnodeGetImportStartPart(SMeterObj *pObj, char *payload, int rows, TSKEY key1) {
@@ -270,74 +273,6 @@ int vnodeOpenFileForImport(SImportInfo *pImport, char *payload, SHeadInfo *pHinf
   return rowsBefore;
 }
 
-extern int vnodeSendShellSubmitRspMsg(SShellObj *pObj, int code, int numOfPoints);
-int vnodeImportToFile(SImportInfo *pImport);
-
-void vnodeProcessImportTimer(void *param, void *tmrId) {
-  SImportInfo *pImport = (SImportInfo *)param;
-  if (pImport == NULL || pImport->signature != param) {
-    dError("import timer is messed up, signature:%p", pImport);
-    return;
-  }
-
-  SMeterObj  *pObj = pImport->pObj;
-  SVnodeObj  *pVnode = &vnodeList[pObj->vnode];
-  SCachePool *pPool = (SCachePool *)pVnode->pCachePool;
-  SShellObj  *pShell = pImport->pShell;
-
-  pImport->retry++;
-  
-  int32_t code = vnodeSetMeterInsertImportStateEx(pObj, TSDB_METER_STATE_IMPORTING);
-  if (code == TSDB_CODE_NOT_ACTIVE_TABLE) {
-    return;
-  }
-
-  int32_t num = 0;
-  pthread_mutex_lock(&pVnode->vmutex);
-  num = pObj->numOfQueries;
-  pthread_mutex_unlock(&pVnode->vmutex);
-
-  //if the num == 0, it will never be increased before state is set to TSDB_METER_STATE_READY
-  int32_t commitInProcess = 0;
-  pthread_mutex_lock(&pPool->vmutex);
-  if (((commitInProcess = pPool->commitInProcess) == 1) || num > 0 || code == TSDB_CODE_ACTION_IN_PROGRESS) {
-    pthread_mutex_unlock(&pPool->vmutex);
-    vnodeClearMeterState(pObj, TSDB_METER_STATE_IMPORTING);
-
-    if (pImport->retry < 1000) {
-      dTrace("vid:%d sid:%d id:%s, import failed, retry later. commit in process or queries on it, or not ready."
-             "commitInProcess:%d, numOfQueries:%d, state:%d", pObj->vnode, pObj->sid, pObj->meterId,
-             commitInProcess, num, pObj->state);
-
-      taosTmrStart(vnodeProcessImportTimer, 10, pImport, vnodeTmrCtrl);
-      return;
-    } else {
-      pShell->code = TSDB_CODE_TOO_SLOW;
-    }
-  } else {
-    pPool->commitInProcess = 1;
-    pthread_mutex_unlock(&pPool->vmutex);
-    int32_t ret = vnodeImportData(pObj, pImport);
-    if (pShell) {
-      pShell->code = ret;
-      pShell->numOfTotalPoints += pImport->importedRows;
-    }
-  }
-
-  vnodeClearMeterState(pObj, TSDB_METER_STATE_IMPORTING);
-  pVnode->version++;
-
-  // send response back to shell
-  if (pShell) {
-    pShell->count--;
-    if (pShell->count <= 0) vnodeSendShellSubmitRspMsg(pImport->pShell, pShell->code, pShell->numOfTotalPoints);
-  }
-
-  pImport->signature = NULL;
-  free(pImport->opayload);
-  free(pImport);
-}
-
 int vnodeImportToFile(SImportInfo *pImport) {
   SMeterObj  *pObj = pImport->pObj;
   SVnodeObj  *pVnode = &vnodeList[pObj->vnode];
@@ -858,6 +793,303 @@ int vnodeImportWholeToCache(SImportInfo *pImport, char *payload, int rows) {
   return code;
 }
 
+/*
+ * Late points are merged into cache or file only when the meter is owned exclusively, i.e. no query is running on it
+ * and no commit or other import is in process. If the meter is busy, the import is kept in the import buffer of the
+ * meter and acknowledged at once, the buffer is merged in key order by whoever gets the meter later: the next import,
+ * the commit thread, or a timer started once the last query on the meter is over. Imports in buffers are written into
+ * the commit log, so they are restored after restart as other imports.
+ */
+static int vnodeImportBlock(SMeterObj *pObj, char *cont, int *pImportedRows, int *pCommit) {
+  SSubmitMsg *pSubmit = (SSubmitMsg *)cont;
+  SImportInfo import;
+
+  memset(&import, 0, sizeof(import));
+  import.pObj = pObj;
+  import.payload = pSubmit->payLoad;
+  import.rows = htons(pSubmit->numOfRows);
+  import.firstKey = *((TSKEY *)(import.payload));
+  import.lastKey = *((TSKEY *)(import.payload + (import.rows - 1) * pObj->bytesPerPoint));
+
+  int code = vnodeImportData(pObj, &import);
+
+  *pImportedRows = import.importedRows;
+  if (import.commit) *pCommit = 1;
+
+  return code;
+}
+
+static void vnodeInsertImportBlock(SCacheInfo *pInfo, SImportBlock *pBlock) {
+  SImportBlock **ppBlock = &pInfo->pImportHead;
+
+  // imports with the same first key are kept in the order they arrive
+  while (*ppBlock != NULL && (*ppBlock)->firstKey <= pBlock->firstKey) ppBlock = &(*ppBlock)->next;
+
+  pBlock->next = *ppBlock;
+  *ppBlock = pBlock;
+  pInfo->importRows += htons(((SSubmitMsg *)pBlock->cont)->numOfRows);
+}
+
+/*
+ * the import buffers of a vnode are bounded by the commit log, all imports left in them shall fit into a new log
+ */
+static bool vnodeIsImportBufferFull(SVnodeObj *pVnode, int contLen) {
+  SCachePool *pPool = (SCachePool *)pVnode->pCachePool;
+  return atomic_load_64(&pPool->importBytes) + contLen > (pVnode->mappingThreshold >> 2);
+}
+
+static int vnodeAddIntoImportBuffer(SMeterObj *pObj, char *cont, int contLen, int sversion) {
+  SVnodeObj *  pVnode = &vnodeList[pObj->vnode];
+  SCachePool * pPool = (SCachePool *)pVnode->pCachePool;
+  SCacheInfo * pInfo = (SCacheInfo *)pObj->pCache;
+  SSubmitMsg * pSubmit = (SSubmitMsg *)cont;
+
+  if (vnodeIsImportBufferFull(pVnode, contLen)) {
+    dTrace("vid:%d sid:%d id:%s, import buffers are full, %ld bytes", pObj->vnode, pObj->sid, pObj->meterId,
+           pPool->importBytes);
+    vnodeProcessCommitTimer(pVnode, NULL);
+    return TSDB_CODE_ACTION_IN_PROGRESS;
+  }
+
+  SImportBlock *pBlock = (SImportBlock *)malloc(sizeof(SImportBlock) + contLen);
+  if (pBlock == NULL) {
+    dError("vid:%d sid:%d id:%s, no memory for import buffer", pObj->vnode, pObj->sid, pObj->meterId);
+    return TSDB_CODE_SERV_OUT_OF_MEMORY;
+  }
+
+  pBlock->next = NULL;
+  pBlock->firstKey = *((TSKEY *)pSubmit->payLoad);
+  pBlock->sversion = sversion;
+  pBlock->contLen = contLen;
+  memcpy(pBlock->cont, cont, contLen);
+
+  atomic_fetch_add_64(&pPool->importBytes, contLen);
+
+  pthread_mutex_lock(&pInfo->importMutex);
+  vnodeInsertImportBlock(pInfo, pBlock);
+  pthread_mutex_unlock(&pInfo->importMutex);
+
+  dTrace("vid:%d sid:%d id:%s, %d rows are kept in import buffer, firstKey:%ld, rows in buffer:%d", pObj->vnode,
+         pObj->sid, pObj->meterId, htons(pSubmit->numOfRows), pBlock->firstKey, pInfo->importRows);
+
+  return TSDB_CODE_SUCCESS;
+}
+
+/*
+ * merge the import buffer into cache or file, the meter shall be owned by the caller. Imports failed to be merged for
+ * a transient reason, e.g. since the cache is full, are kept in the buffer and tried again by the next merge, they are
+ * acknowledged already. Imports that can never be merged, e.g. of an old schema or failed on the data file, are
+ * dropped, otherwise the cache of the meter is never committed and the meter can not be altered.
+ * @return 1 if cache shall be committed
+ */
+static int vnodeMergeImportBuffer(SMeterObj *pObj) {
+  SCachePool *  pPool = (SCachePool *)vnodeList[pObj->vnode].pCachePool;
+  SCacheInfo *  pInfo = (SCacheInfo *)pObj->pCache;
+  int           commit = 0, merged = 0;
+
+  pthread_mutex_lock(&pInfo->importMutex);
+  SImportBlock *pBlock = pInfo->pImportHead;
+  pInfo->pImportHead = NULL;
+  pInfo->importRows = 0;
+  pthread_mutex_unlock(&pInfo->importMutex);
+
+  while (pBlock != NULL) {
+    SImportBlock *pNext = pBlock->next;
+    int           importedRows = 0;
+    int           code = TSDB_CODE_OTHERS;
+
+    if (pBlock->sversion == pObj->sversion) {
+      code = vnodeImportBlock(pObj, pBlock->cont, &importedRows, &commit);
+    }
+
+    merged += importedRows;
+    if (code == TSDB_CODE_ACTION_IN_PROGRESS || code == TSDB_CODE_SERV_OUT_OF_MEMORY) {
+      pthread_mutex_lock(&pInfo->importMutex);
+      vnodeInsertImportBlock(pInfo, pBlock);
+      pthread_mutex_unlock(&pInfo->importMutex);
+    } else {
+      if (code != TSDB_CODE_SUCCESS) {
+        dError("vid:%d sid:%d id:%s, failed to merge import, it is dropped, firstKey:%ld sversion:%d:%d, code:%d",
+               pObj->vnode, pObj->sid, pObj->meterId, pBlock->firstKey, pBlock->sversion, pObj->sversion, code);
+      }
+
+      atomic_fetch_sub_64(&pPool->importBytes, pBlock->contLen);
+      free(pBlock);
+    }
+
+    pBlock = pNext;
+  }
+
+  if (merged > 0) {
+    dTrace("vid:%d sid:%d id:%s, %d rows in import buffer are merged, rows left:%d", pObj->vnode, pObj->sid,
+           pObj->meterId, merged, pInfo->importRows);
+  }
+
+  return commit;
+}
+
+/*
+ * get the meter exclusively for import, the commit is blocked until vnodeReleaseMeterForImport is called
+ */
+static int32_t vnodeAcquireMeterForImport(SMeterObj *pObj) {
+  SVnodeObj * pVnode = &vnodeList[pObj->vnode];
+  SCachePool *pPool = (SCachePool *)pVnode->pCachePool;
+
+  int32_t code = vnodeSetMeterInsertImportStateEx(pObj, TSDB_METER_STATE_IMPORTING);
+  if (code != TSDB_CODE_SUCCESS) return code;
+
+  // if the num == 0, it will never be increased before state is set to TSDB_METER_STATE_READY
+  int32_t num = 0;
+  pthread_mutex_lock(&pVnode->vmutex);
+  num = pObj->numOfQueries;
+  pthread_mutex_unlock(&pVnode->vmutex);
+
+  int32_t commitInProcess = 0;
+  pthread_mutex_lock(&pPool->vmutex);
+  if ((commitInProcess = pPool->commitInProcess) == 0 && num == 0) pPool->commitInProcess = 1;
+  pthread_mutex_unlock(&pPool->vmutex);
+
+  if (commitInProcess || num > 0) {
+    vnodeClearMeterState(pObj, TSDB_METER_STATE_IMPORTING);
+    dTrace("vid:%d sid:%d id:%s, meter is busy, commit in process:%d, numOfQueries:%d", pObj->vnode, pObj->sid,
+           pObj->meterId, commitInProcess, num);
+    return TSDB_CODE_ACTION_IN_PROGRESS;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static void vnodeReleaseMeterForImport(SMeterObj *pObj, int commit) {
+  SVnodeObj * pVnode = &vnodeList[pObj->vnode];
+  SCachePool *pPool = (SCachePool *)pVnode->pCachePool;
+
+  pPool->commitInProcess = 0;
+  if (commit) vnodeProcessCommitTimer(pVnode, NULL);
+
+  vnodeClearMeterState(pObj, TSDB_METER_STATE_IMPORTING);
+}
+
+static void vnodeProcessImportMergeTimer(void *param, void *tmrId) {
+  SImportMergeParam *pParam = (SImportMergeParam *)param;
+  SVnodeObj *        pVnode = &vnodeList[pParam->vnode];
+  SMeterObj *        pObj = NULL;
+
+  // the meter may have been dropped with the vnode, or dropped alone, the sid may be taken by another meter
+  if (pVnode->meterList != NULL) pObj = (SMeterObj *)pVnode->meterList[pParam->sid];
+  if (pObj == NULL || pObj->uid != pParam->uid || pObj->pCache == NULL) {
+    dTrace("vid:%d sid:%d uid:%ld, meter is dropped, abort merging import buffer", pParam->vnode, pParam->sid,
+           pParam->uid);
+    free(pParam);
+    return;
+  }
+
+  free(pParam);
+
+  SCachePool *pPool = (SCachePool *)pVnode->pCachePool;
+  SCacheInfo *pInfo = (SCacheInfo *)pObj->pCache;
+  pInfo->importTimer = 0;
+
+  int32_t code = vnodeAcquireMeterForImport(pObj);
+  if (code == TSDB_CODE_SUCCESS) {
+    int commit = vnodeMergeImportBuffer(pObj);
+    vnodeReleaseMeterForImport(pObj, commit);
+    pVnode->version++;
+  } else if (code == TSDB_CODE_ACTION_IN_PROGRESS && pObj->numOfQueries == 0 && pPool->commitInProcess == 0) {
+    // an insertion or import is writing the meter, it is quick
+    vnodeScheduleImportMerge(pObj);
+  }
+
+  // otherwise the buffer is merged when the queries are over, or by the commit thread
+}
+
+void vnodeScheduleImportMerge(SMeterObj *pObj) {
+  SCacheInfo *pInfo = (SCacheInfo *)pObj->pCache;
+  if (pInfo == NULL || pInfo->importRows == 0) return;
+
+  if (atomic_val_compare_exchange_8(&pInfo->importTimer, 0, 1) != 0) return;
+
+  // the meter may be freed before the timer is fired, it is looked up again by the timer
+  SImportMergeParam *pParam = (SImportMergeParam *)malloc(sizeof(SImportMergeParam));
+  if (pParam != NULL) {
+    pParam->vnode = pObj->vnode;
+    pParam->sid = pObj->sid;
+    pParam->uid = pObj->uid;
+  }
+
+  if (pParam == NULL || taosTmrStart(vnodeProcessImportMergeTimer, 10, pParam, vnodeTmrCtrl) == NULL) {
+    dError("vid:%d sid:%d id:%s, failed to start timer to merge import buffer", pObj->vnode, pObj->sid, pObj->meterId);
+    tfree(pParam);
+    pInfo->importTimer = 0;
+  }
+}
+
+void vnodeMergeImportBuffers(SVnodeObj *pVnode, int ssid, int esid) {
+  for (int sid = ssid; sid <= esid; ++sid) {
+    SMeterObj *pObj = (SMeterObj *)(pVnode->meterList[sid]);
+    if (pObj == NULL || pObj->pCache == NULL) continue;
+
+    SCacheInfo *pInfo = (SCacheInfo *)pObj->pCache;
+    if (pInfo->importRows == 0) continue;
+
+    // commit is in process already, only the queries on the meter need to be checked
+    if (vnodeSetMeterInsertImportStateEx(pObj, TSDB_METER_STATE_IMPORTING) != TSDB_CODE_SUCCESS) continue;
+
+    int32_t num = 0;
+    pthread_mutex_lock(&pVnode->vmutex);
+    num = pObj->numOfQueries;
+    pthread_mutex_unlock(&pVnode->vmutex);
+
+    if (num == 0) {
+      vnodeMergeImportBuffer(pObj);
+      pVnode->version++;
+    }
+
+    vnodeClearMeterState(pObj, TSDB_METER_STATE_IMPORTING);
+  }
+}
+
+int vnodeRelogImportBuffers(SVnodeObj *pVnode, int ssid, int esid) {
+  if (pVnode->cfg.commitLog == 0) return 0;
+
+  for (int sid = ssid; sid <= esid; ++sid) {
+    SMeterObj *pObj = (SMeterObj *)(pVnode->meterList[sid]);
+    if (pObj == NULL || pObj->pCache == NULL) continue;
+
+    SCacheInfo *pInfo = (SCacheInfo *)pObj->pCache;
+    int         ret = 0;
+
+    pthread_mutex_lock(&pInfo->importMutex);
+    for (SImportBlock *pBlock = pInfo->pImportHead; pBlock != NULL; pBlock = pBlock->next) {
+      if (vnodeWriteToCommitLog(pObj, TSDB_ACTION_IMPORT, pBlock->cont, pBlock->contLen, pBlock->sversion) != 0) {
+        dError("vid:%d sid:%d id:%s, failed to write import buffer into commit log, firstKey:%ld", pObj->vnode,
+               pObj->sid, pObj->meterId, pBlock->firstKey);
+        ret = -1;
+        break;
+      }
+    }
+    pthread_mutex_unlock(&pInfo->importMutex);
+
+    if (ret != 0) return ret;
+  }
+
+  return 0;
+}
+
+void vnodeFreeImportBuffer(SCachePool *pPool, SCacheInfo *pInfo) {
+  pthread_mutex_lock(&pInfo->importMutex);
+  SImportBlock *pBlock = pInfo->pImportHead;
+  while (pBlock != NULL) {
+    SImportBlock *pNext = pBlock->next;
+    atomic_fetch_sub_64(&pPool->importBytes, pBlock->contLen);
+    free(pBlock);
+    pBlock = pNext;
+  }
+
+  pInfo->pImportHead = NULL;
+  pInfo->importRows = 0;
+  pthread_mutex_unlock(&pInfo->importMutex);
+}
+
 int vnodeImportPoints(SMeterObj *pObj, char *cont, int contLen, char source, void *param, int sversion,
                       int *pNumOfPoints, TSKEY now) {
   SSubmitMsg *pSubmit = (SSubmitMsg *)cont;
@@ -865,7 +1097,6 @@ int vnodeImportPoints(SMeterObj *pObj, char *cont, int contLen, char source, voi
   int         rows;
   char       *payload;
   int         code = TSDB_CODE_ACTION_IN_PROGRESS;
-  SCachePool *pPool = (SCachePool *)pVnode->pCachePool;
   SShellObj  *pShell = (SShellObj *)param;
   int         pointsImported = 0;
 
@@ -895,6 +1126,13 @@ int vnodeImportPoints(SMeterObj *pObj, char *cont, int contLen, char source, voi
     return TSDB_CODE_TIMESTAMP_OUT_OF_RANGE;
   }
 
+  // late points may be kept in the import buffer, reject them before being forwarded and logged if it is full
+  if (lastKey <= pObj->lastKey && vnodeIsImportBufferFull(pVnode, contLen)) {
+    dTrace("vid:%d sid:%d id:%s, import buffers are full, try again later", pObj->vnode, pObj->sid, pObj->meterId);
+    vnodeProcessCommitTimer(pVnode, NULL);
+    return TSDB_CODE_ACTION_IN_PROGRESS;
+  }
+
   // forward to peers
   if (pShell && pVnode->cfg.replications > 1) {
     code = vnodeForwardToPeer(pObj, cont, contLen, TSDB_ACTION_IMPORT, sversion);
@@ -909,69 +1147,40 @@ int vnodeImportPoints(SMeterObj *pObj, char *cont, int contLen, char source, voi
 
   if (*((TSKEY *)(pSubmit->payLoad + (rows - 1) * pObj->bytesPerPoint)) > pObj->lastKey) {
     code = vnodeInsertPoints(pObj, cont, contLen, TSDB_DATA_SOURCE_LOG, NULL, pObj->sversion, &pointsImported, now);
-
-    if (pShell) {
-      pShell->code = code;
-      pShell->numOfTotalPoints += pointsImported;
-    }
   } else {
-    SImportInfo *pNew, import;
-
     dTrace("vid:%d sid:%d id:%s, import %d rows data", pObj->vnode, pObj->sid, pObj->meterId, rows);
-    memset(&import, 0, sizeof(import));
-    import.firstKey = *((TSKEY *)(payload));
-    import.lastKey = *((TSKEY *)(pSubmit->payLoad + (rows - 1) * pObj->bytesPerPoint));
-    import.pObj = pObj;
-    import.pShell = pShell;
-    import.payload = payload;
-    import.rows = rows;
-  
-    if ((code = vnodeSetMeterInsertImportStateEx(pObj, TSDB_METER_STATE_IMPORTING)) != TSDB_CODE_SUCCESS) {
-      return code;
-    }
-    
-    int32_t num = 0;
-    pthread_mutex_lock(&pVnode->vmutex);
-    num = pObj->numOfQueries;
-    pthread_mutex_unlock(&pVnode->vmutex);
 
-    int32_t commitInProcess = 0;
-
-    pthread_mutex_lock(&pPool->vmutex);
-    if (((commitInProcess = pPool->commitInProcess) == 1) || num > 0) {
-      pthread_mutex_unlock(&pPool->vmutex);
-      vnodeClearMeterState(pObj, TSDB_METER_STATE_IMPORTING);
-  
-      pNew = (SImportInfo *)malloc(sizeof(SImportInfo));
-      memcpy(pNew, &import, sizeof(SImportInfo));
-      pNew->signature = pNew;
-      int payloadLen = contLen - sizeof(SSubmitMsg);
-      pNew->payload = malloc(payloadLen);
-      pNew->opayload = pNew->payload;
-      memcpy(pNew->payload, payload, payloadLen);
-
-      dTrace("vid:%d sid:%d id:%s, import later, commit in process:%d, numOfQueries:%d", pObj->vnode, pObj->sid,
-             pObj->meterId, commitInProcess, pObj->numOfQueries);
-
-      /*
-       * vnodeProcessImportTimer will set the import status for this table, so need to
-       * set the import flag here
-       */
-      taosTmrStart(vnodeProcessImportTimer, 10, pNew, vnodeTmrCtrl);
-      return 0;
+    code = vnodeAcquireMeterForImport(pObj);
+    if (code == TSDB_CODE_NOT_ACTIVE_TABLE) return code;
+
+    if (code == TSDB_CODE_SUCCESS) {
+      // imports buffered arrived earlier, merge them first
+      int commit = vnodeMergeImportBuffer(pObj);
+
+      code = vnodeImportBlock(pObj, cont, &pointsImported, &commit);
+      if (code == TSDB_CODE_ACTION_IN_PROGRESS) {
+        // cache is full, keep the points until the cache is committed
+        code = vnodeAddIntoImportBuffer(pObj, cont, contLen, sversion);
+        pointsImported = (code == TSDB_CODE_SUCCESS) ? rows : 0;
+      }
+
+      vnodeReleaseMeterForImport(pObj, commit);
     } else {
-      pPool->commitInProcess = 1;
-      pthread_mutex_unlock(&pPool->vmutex);
-      
-      int ret = vnodeImportData(pObj, &import);
-      if (pShell) {
-        pShell->code = ret;
-        pShell->numOfTotalPoints += import.importedRows;
+      code = vnodeAddIntoImportBuffer(pObj, cont, contLen, sversion);
+      if (code == TSDB_CODE_SUCCESS) {
+        pointsImported = rows;
+
+        // the meter may be written by an insertion, rather than being queried or committed
+        vnodeScheduleImportMerge(pObj);
       }
     }
   }
 
-  vnodeClearMeterState(pObj, TSDB_METER_STATE_IMPORTING);
+  if (pShell) {
+    pShell->code = code;
+    pShell->numOfTotalPoints += pointsImported;
+  }
+
   pVnode->version++;
 
   if (pShell) {
@@ -994,11 +1203,5 @@ int vnodeImportData(SMeterObj *pObj, SImportInfo *pImport) {
     code = vnodeImportStartToFile(pImport, pImport->payload, pImport->rows);
   }
 
-  SVnodeObj  *pVnode = &vnodeList[pObj->vnode];
-  SCachePool *pPool = (SCachePool *)pVnode->pCachePool;
-  pPool->commitInProcess = 0;
-
-  if (pImport->commit) vnodeProcessCommitTimer(pVnode, NULL);
-
   return code;
 }
@@ -528,6 +528,25 @@ int vnodeRemoveMeterObj(int vnode, int sid) {
   return 0;
 }
 
+/*
+ * all points of a submit block can be appended to cache in one pass only if no point would be skipped or rejected
+ * by the row-by-row checks, i.e. keys are strictly ascending, larger than the lastKey of meter and all valid
+ */
+static int vnodeIsBatchInsertable(SMeterObj *pObj, char *pData, int numOfPoints, TSKEY curKey, int precision) {
+  TSKEY firstKey = *((TSKEY *)pData);
+  TSKEY prevKey = pObj->lastKey;
+
+  for (int i = 0; i < numOfPoints; ++i) {
+    TSKEY key = *((TSKEY *)pData);
+    if (key <= prevKey) return 0;
+
+    prevKey = key;
+    pData += pObj->bytesPerPoint;
+  }
+
+  return VALID_TIMESTAMP(firstKey, curKey, precision) && VALID_TIMESTAMP(prevKey, curKey, precision);
+}
+
 int vnodeInsertPoints(SMeterObj *pObj, char *cont, int contLen, char source, void *param, int sversion,
                       int *numOfInsertPoints, TSKEY now) {
   int         expectedLen, i;
@@ -612,37 +631,45 @@ int vnodeInsertPoints(SMeterObj *pObj, char *cont, int contLen, char source, voi
   if ((code = vnodeSetMeterInsertImportStateEx(pObj, TSDB_METER_STATE_INSERT)) != TSDB_CODE_SUCCESS) {
     goto _over;
   }
-  
-  for (i = 0; i < numOfPoints; ++i) { // meter will be dropped, abort current insertion
-    if (pObj->state >= TSDB_METER_STATE_DELETING) {
-      dWarn("vid:%d sid:%d id:%s, meter is dropped, abort insert, state:%d", pObj->vnode, pObj->sid, pObj->meterId,
-            pObj->state);
 
-      code = TSDB_CODE_NOT_ACTIVE_TABLE;
-      break;
+  if (numOfPoints > 1 && vnodeIsBatchInsertable(pObj, pData, numOfPoints, tsKey, pVnode->cfg.precision)) {
+    points = vnodeInsertBatchToCache(pObj, pData, numOfPoints);
+    if (points < numOfPoints) {
+      code = (pObj->state >= TSDB_METER_STATE_DELETING) ? TSDB_CODE_NOT_ACTIVE_TABLE : TSDB_CODE_ACTION_IN_PROGRESS;
     }
-
-    if (*((TSKEY *)pData) <= pObj->lastKey) {
-      dWarn("vid:%d sid:%d id:%s, received key:%ld not larger than lastKey:%ld", pObj->vnode, pObj->sid, pObj->meterId,
-            *((TSKEY *)pData), pObj->lastKey);
+  } else {
+    for (i = 0; i < numOfPoints; ++i) { // meter will be dropped, abort current insertion
+      if (pObj->state >= TSDB_METER_STATE_DELETING) {
+        dWarn("vid:%d sid:%d id:%s, meter is dropped, abort insert, state:%d", pObj->vnode, pObj->sid, pObj->meterId,
+              pObj->state);
+
+        code = TSDB_CODE_NOT_ACTIVE_TABLE;
+        break;
+      }
+
+      if (*((TSKEY *)pData) <= pObj->lastKey) {
+        dWarn("vid:%d sid:%d id:%s, received key:%ld not larger than lastKey:%ld", pObj->vnode, pObj->sid,
+              pObj->meterId, *((TSKEY *)pData), pObj->lastKey);
+        pData += pObj->bytesPerPoint;
+        continue;
+      }
+
+      if (!VALID_TIMESTAMP(*((TSKEY *)pData), tsKey, pVnode->cfg.precision)) {
+        code = TSDB_CODE_TIMESTAMP_OUT_OF_RANGE;
+        break;
+      }
+
+      if (vnodeInsertPointToCache(pObj, pData) < 0) {
+        code = TSDB_CODE_ACTION_IN_PROGRESS;
+        break;
+      }
+
+      pObj->lastKey = *((TSKEY *)pData);
       pData += pObj->bytesPerPoint;
-      continue;
+      points++;
     }
-
-    if (!VALID_TIMESTAMP(*((TSKEY *)pData), tsKey, pVnode->cfg.precision)) {
-      code = TSDB_CODE_TIMESTAMP_OUT_OF_RANGE;
-      break;
-    }
-
-    if (vnodeInsertPointToCache(pObj, pData) < 0) {
-      code = TSDB_CODE_ACTION_IN_PROGRESS;
-      break;
-    }
-
-    pObj->lastKey = *((TSKEY *)pData);
-    pData += pObj->bytesPerPoint;
-    points++;
   }
+
   atomic_fetch_add_64(&(pVnode->vnodeStatistic.pointsWritten), points * (pObj->numOfColumns - 1));
   atomic_fetch_add_64(&(pVnode->vnodeStatistic.totalStorage), points * pObj->bytesPerPoint);
 
@@ -657,6 +684,8 @@ int vnodeInsertPoints(SMeterObj *pObj, char *cont, int contLen, char source, voi
   pthread_mutex_unlock(&(pVnode->vmutex));
   vnodeClearMeterState(pObj, TSDB_METER_STATE_INSERT);
 
+  if (points > 0) vnodeNotifySubscribers(pObj);
+
 _over:
   dTrace("vid:%d sid:%d id:%s, %d out of %d points are inserted, lastKey:%ld source:%d, vnode total storage: %ld",
          pObj->vnode, pObj->sid, pObj->meterId, points, numOfPoints, pObj->lastKey, source,
@@ -28,6 +28,7 @@
 #include "vnodeUtil.h"
 
 #include "vnodeCache.h"
+#include "vnodeBlockCache.h"
 #include "vnodeDataFilterFunc.h"
 #include "vnodeFile.h"
 #include "vnodeQueryImpl.h"
@@ -530,17 +531,17 @@ static int32_t readDataFromDiskFile(int fd, SQInfo *pQInfo, SQueryFileInfo *pQue
                                     int32_t size) {
   assert(size >= 0);
 
-  int32_t ret = (int32_t)lseek(fd, offset, SEEK_SET);
-  if (ret == -1) {
-    //        qTrace("QInfo:%p seek failed, reason:%s", pQInfo, strerror(errno));
+  ssize_t ret = pread(fd, buf, size, offset);
+  if (ret != size) {
+    //        qTrace("QInfo:%p read failed, reason:%s", pQInfo, strerror(errno));
     return -1;
   }
 
-  ret = read(fd, buf, size);
   //    qTrace("QInfo:%p read data %d completed", pQInfo, size);
   return 0;
 }
 
+#if DEFAULT_IO_ENGINE == IO_ENGINE_MMAP
 static int32_t loadColumnIntoMem(SQuery *pQuery, SQueryFileInfo *pQueryFileInfo, SCompBlock *pBlock, SField *pFields,
                                  int32_t col, SData *sdata, void *tmpBuf, char *buffer, int32_t buffersize) {
   char *dst = (pBlock->algorithm) ? tmpBuf : sdata->data;
@@ -577,6 +578,258 @@ static int32_t loadColumnIntoMem(SQuery *pQuery, SQueryFileInfo *pQueryFileInfo,
 
   return 0;
 }
+#endif
+
+typedef struct SColumnExtent {
+  int32_t field;  // index of the column in SField array of the block
+  SData * sdata;  // destination buffer of the decompressed column
+} SColumnExtent;
+
+#if DEFAULT_IO_ENGINE == IO_ENGINE_SYNC
+static int32_t ensureBlockReadBuffer(SQueryRuntimeEnv *pRuntimeEnv, int32_t size) {
+  if (pRuntimeEnv->blockReadBufSize >= size) {
+    return 0;
+  }
+
+  char *tmp = realloc(pRuntimeEnv->blockReadBuffer, size);
+  if (tmp == NULL) {
+    return -1;
+  }
+
+  pRuntimeEnv->blockReadBuffer = tmp;
+  pRuntimeEnv->blockReadBufSize = size;
+  return 0;
+}
+
+/*
+ * If a filter column of the block is dictionary encoded, evaluate its filters on each distinct value and keep the
+ * value index of each row, so vnodeDoFilterData only needs a lookup for the rows of this block.
+ */
+static void setFilterColumnDict(SQueryRuntimeEnv *pRuntimeEnv, SData *sdata, SField *pField, const char *src,
+                                int32_t numOfPoints) {
+  SQuery *pQuery = pRuntimeEnv->pQuery;
+
+  if ((pField->type != TSDB_DATA_TYPE_BINARY && pField->type != TSDB_DATA_TYPE_NCHAR) || src[0] != STRING_DICT_COMP) {
+    return;
+  }
+
+  for (int32_t k = 0; k < pQuery->numOfFilterCols; ++k) {
+    SSingleColumnFilterInfo *pFilterInfo = &pQuery->pFilterInfo[k];
+    if (pRuntimeEnv->colDataBuffer[pFilterInfo->info.colIdxInBuf] != sdata) {
+      continue;
+    }
+
+    int32_t size = pQuery->numOfFilterCols * numOfPoints;
+    if (pRuntimeEnv->dictCodesBufSize < size) {
+      uint8_t *tmp = realloc(pRuntimeEnv->dictCodesBuffer, size);
+      if (tmp == NULL) {
+        return;
+      }
+
+      // codes of other columns of current block are in the old buffer
+      for (int32_t i = 0; i < pQuery->numOfFilterCols; ++i) {
+        pQuery->pFilterInfo[i].pDictData = NULL;
+      }
+
+      pRuntimeEnv->dictCodesBuffer = tmp;
+      pRuntimeEnv->dictCodesBufSize = size;
+    }
+
+    const char *entries = NULL;
+    uint8_t *   codes = pRuntimeEnv->dictCodesBuffer + k * numOfPoints;
+
+    int32_t numOfEntries = tsGetStringDict(src, pField->len, numOfPoints, &entries, codes);
+    if (numOfEntries <= 0) {
+      return;
+    }
+
+    for (int32_t i = 0; i < numOfEntries; ++i) {
+      char *val = (char *)entries + i * pField->bytes;
+
+      pFilterInfo->dictMatch[i] = false;
+      if (isNull(val, pField->type)) {
+        continue;
+      }
+
+      for (int32_t j = 0; j < pFilterInfo->numOfFilters; ++j) {
+        SColumnFilterElem *pFilterElem = &pFilterInfo->pFilters[j];
+        if (pFilterElem->fp(pFilterElem, val, val)) {
+          pFilterInfo->dictMatch[i] = true;
+          break;
+        }
+      }
+    }
+
+    pFilterInfo->pDictCodes = codes;
+    pFilterInfo->pDictData = sdata->data;
+    pRuntimeEnv->summary.dictFilterCols++;
+    return;
+  }
+}
+
+static void appendIOVec(struct iovec *iov, int32_t *niov, char *base, size_t len) {
+  // merge with the previous one if they are consecutive in memory
+  if (*niov > 0 && (char *)iov[*niov - 1].iov_base + iov[*niov - 1].iov_len == base) {
+    iov[*niov - 1].iov_len += len;
+  } else {
+    iov[*niov].iov_base = base;
+    iov[*niov].iov_len = len;
+    (*niov)++;
+  }
+}
+#endif
+
+/*
+ * Load all required columns of one block with as few syscalls as possible. The column extents are known from SField
+ * before any data is read, so adjacent columns are grouped into runs and each run is loaded by one preadv.
+ * Compressed columns and all checksums land in blockReadBuffer at their offset within the block, uncompressed columns
+ * are read directly into the column buffer.
+ */
+static int32_t loadColumnsIntoMem(SQueryRuntimeEnv *pRuntimeEnv, SQueryFileInfo *pQueryFileInfo, SCompBlock *pBlock,
+                                  SField *pFields, SColumnExtent *pExtent, int32_t numOfExtents) {
+  SQuery *           pQuery = pRuntimeEnv->pQuery;
+  SQueryCostSummary *pSummary = &pRuntimeEnv->summary;
+
+#if DEFAULT_IO_ENGINE == IO_ENGINE_MMAP
+  pSummary->readColumns += numOfExtents;
+  for (int32_t i = 0; i < numOfExtents; ++i) {
+    int32_t ret = loadColumnIntoMem(pQuery, pQueryFileInfo, pBlock, pFields, pExtent[i].field, pExtent[i].sdata,
+                                    pRuntimeEnv->unzipBuffer, pRuntimeEnv->secondaryUnzipBuffer,
+                                    pRuntimeEnv->unzipBufSize);
+    if (ret != 0) {
+      return ret;
+    }
+  }
+
+  return 0;
+#else
+  SBlockCacheKey key = {0};
+  bool           useCache = vnodeBlockCacheEnabled() && pQueryFileInfo->fileVersion >= 0;
+
+  if (useCache) {
+    key.vnode = pRuntimeEnv->pMeterObj->vnode;
+    key.fileId = pQueryFileInfo->fileID;
+    key.version = pQueryFileInfo->fileVersion;
+    key.last = pBlock->last;
+    key.offset = pBlock->offset;
+
+    // columns found in block cache are copied out, the remaining ones are loaded from file
+    int32_t num = 0;
+    for (int32_t i = 0; i < numOfExtents; ++i) {
+      SField *pField = &pFields[pExtent[i].field];
+      char *  data = NULL;
+      int32_t size = 0;
+
+      key.colId = pField->colId;
+      void *handle = vnodeAcquireCachedColumn(&key, &data, &size);
+      if (handle != NULL && size == pField->bytes * pBlock->numOfPoints) {
+        memcpy(pExtent[i].sdata->data, data, size);
+        pSummary->cachedColumns++;
+      } else {
+        pExtent[num++] = pExtent[i];
+      }
+
+      vnodeReleaseCachedColumn(handle);
+    }
+
+    numOfExtents = num;
+  }
+
+  pSummary->readColumns += numOfExtents;
+
+  int32_t size = 0;
+  for (int32_t i = 0; i < numOfExtents; ++i) {
+    SField *pField = &pFields[pExtent[i].field];
+    if (pField->offset + pField->len + (int32_t)sizeof(TSCKSUM) > size) {
+      size = pField->offset + pField->len + sizeof(TSCKSUM);
+    }
+  }
+
+  if (ensureBlockReadBuffer(pRuntimeEnv, size) != 0) {
+    return -1;
+  }
+
+  char *  buf = pRuntimeEnv->blockReadBuffer;
+  int     fd = pBlock->last ? pQueryFileInfo->lastFd : pQueryFileInfo->dataFd;
+  int32_t s = 0;
+
+  while (s < numOfExtents) {
+    struct iovec iov[QUERY_READ_MAX_IOV];
+    int32_t      niov = 0;
+
+    int32_t start = pFields[pExtent[s].field].offset;
+    int32_t end = start;
+
+    int32_t e = s;
+    for (; e < numOfExtents; ++e) {
+      SField *pField = &pFields[pExtent[e].field];
+      if (e > s && (pField->offset < end || pField->offset - end > QUERY_READ_MAX_GAP ||
+                    niov + 3 > QUERY_READ_MAX_IOV)) {
+        break;
+      }
+
+      if (pField->offset > end) {  // read through the gap
+        appendIOVec(iov, &niov, buf + end, pField->offset - end);
+      }
+
+      char *dst = (pBlock->algorithm) ? buf + pField->offset : pExtent[e].sdata->data;
+      appendIOVec(iov, &niov, dst, pField->len);
+      appendIOVec(iov, &niov, buf + pField->offset + pField->len, sizeof(TSCKSUM));
+
+      end = pField->offset + pField->len + sizeof(TSCKSUM);
+    }
+
+    pSummary->readSyscalls++;
+    if (preadv(fd, iov, niov, pBlock->offset + start) != end - start) {
+      dError("QInfo:%p failed to read block, file:%s, offset:%ld, size:%d, reason:%s", GET_QINFO_ADDR(pQuery),
+             pQueryFileInfo->dataFilePath, pBlock->offset + start, end - start, strerror(errno));
+      return -1;
+    }
+
+    s = e;
+  }
+
+  for (int32_t i = 0; i < numOfExtents; ++i) {
+    SField *pField = &pFields[pExtent[i].field];
+    char *  src = (pBlock->algorithm) ? buf + pField->offset : pExtent[i].sdata->data;
+
+    // check column data integrity
+    if (*(TSCKSUM *)(buf + pField->offset + pField->len) != taosCalcChecksum(0, (const uint8_t *)src, pField->len)) {
+      dLError("QInfo:%p, column data checksum error, file:%s, col: %d, offset:%ld", GET_QINFO_ADDR(pQuery),
+              pQueryFileInfo->dataFilePath, pExtent[i].field, pBlock->offset + pField->offset);
+      return -1;
+    }
+
+    if (pBlock->algorithm) {
+      (*pDecompFunc[pField->type])(src, pField->len, pBlock->numOfPoints, pExtent[i].sdata->data,
+                                   pField->bytes * pBlock->numOfPoints, pBlock->algorithm,
+                                   pRuntimeEnv->secondaryUnzipBuffer, pRuntimeEnv->unzipBufSize);
+
+      if (pQuery->numOfFilterCols > 0) {
+        setFilterColumnDict(pRuntimeEnv, pExtent[i].sdata, pField, src, pBlock->numOfPoints);
+      }
+    }
+
+    if (useCache) {
+      key.colId = pField->colId;
+      vnodePutCachedColumn(&key, pExtent[i].sdata->data, pField->bytes * pBlock->numOfPoints);
+    }
+  }
+
+  return 0;
+#endif
+}
+
+void vnodePrefetchDataBlock(SQueryRuntimeEnv *pRuntimeEnv, int32_t fileIdx, SCompBlock *pBlock) {
+#if DEFAULT_IO_ENGINE == IO_ENGINE_SYNC
+  SQueryFileInfo *pQueryFileInfo = &pRuntimeEnv->pHeaderFiles[fileIdx];
+
+  int fd = pBlock->last ? pQueryFileInfo->lastFd : pQueryFileInfo->dataFd;
+  if (posix_fadvise(fd, pBlock->offset, pBlock->len, POSIX_FADV_WILLNEED) == 0) {
+    pRuntimeEnv->summary.prefetchBlocks++;
+  }
+#endif
+}
 
 static int32_t loadDataBlockFieldsInfo(SQueryRuntimeEnv *pRuntimeEnv, SQueryFileInfo *pQueryFileInfo,
                                        SCompBlock *pBlock, SField **pField) {
@@ -638,7 +891,9 @@ static int32_t loadDataBlockIntoMem(SCompBlock *pBlock, SField **pField, SQueryR
 
   SQueryFileInfo *pQueryFileInfo = &pRuntimeEnv->pHeaderFiles[fileIdx];
   SData **        primaryTSBuf = &pRuntimeEnv->primaryColBuffer;
-  void *          tmpBuf = pRuntimeEnv->unzipBuffer;
+
+  SColumnExtent extent[TSDB_MAX_COLUMNS + 1];
+  int32_t       numOfExtents = 0;
 
   if (vnodeIsDatablockLoaded(pRuntimeEnv, pMeterObj, fileIdx)) {
     dTrace("QInfo:%p vid:%d sid:%d id:%s, data block has been loaded, ts:%d, slot:%d, brange:%lld-%lld, rows:%d",
@@ -648,6 +903,11 @@ static int32_t loadDataBlockIntoMem(SCompBlock *pBlock, SField **pField, SQueryR
     return 0;
   }
 
+  // the column buffers are about to be overwritten by a new block
+  for (int32_t k = 0; k < pQuery->numOfFilterCols; ++k) {
+    pQuery->pFilterInfo[k].pDictData = NULL;
+  }
+
   /* failed to load fields info, return with error info */
   if (loadSField && (loadDataBlockFieldsInfo(pRuntimeEnv, pQueryFileInfo, pBlock, pField) != 0)) {
     return -1;
@@ -663,14 +923,7 @@ static int32_t loadDataBlockIntoMem(SCompBlock *pBlock, SField **pField, SQueryR
       *primaryTSBuf = sdata[0];
     } else {
       columnBytes += (*pField)[PRIMARYKEY_TIMESTAMP_COL_INDEX].len + sizeof(TSCKSUM);
-      int32_t ret =
-          loadColumnIntoMem(pQuery, pQueryFileInfo, pBlock, *pField, PRIMARYKEY_TIMESTAMP_COL_INDEX, *primaryTSBuf,
-                            tmpBuf, pRuntimeEnv->secondaryUnzipBuffer, pRuntimeEnv->unzipBufSize);
-      if (ret != 0) {
-        return -1;
-      }
-
-      pSummary->numOfSeek++;
+      extent[numOfExtents++] = (SColumnExtent){PRIMARYKEY_TIMESTAMP_COL_INDEX, *primaryTSBuf};
       j += 1;  // first column of timestamp is not needed to be read again
     }
   }
@@ -702,10 +955,7 @@ static int32_t loadDataBlockIntoMem(SCompBlock *pBlock, SField **pField, SQueryR
           fillWithNull(pQuery, sdata[i]->data, i, pBlock->numOfPoints);
         } else {
           columnBytes += (*pField)[j].len + sizeof(TSCKSUM);
-          ret = loadColumnIntoMem(pQuery, pQueryFileInfo, pBlock, *pField, j, sdata[i], tmpBuf,
-                                  pRuntimeEnv->secondaryUnzipBuffer, pRuntimeEnv->unzipBufSize);
-
-          pSummary->numOfSeek++;
+          extent[numOfExtents++] = (SColumnExtent){j, sdata[i]};
         }
       }
       ++i;
@@ -732,6 +982,25 @@ static int32_t loadDataBlockIntoMem(SCompBlock *pBlock, SField **pField, SQueryR
     }
   }
 
+  if (ret == TSDB_CODE_SUCCESS && numOfExtents > 0) {
+    if (loadColumnsIntoMem(pRuntimeEnv, pQueryFileInfo, pBlock, *pField, extent, numOfExtents) != 0) {
+      return -1;
+    }
+
+    pSummary->numOfSeek++;
+  }
+
+  /*
+   * hint the kernel to read ahead the next block of this meter, so that the disk works while current block is being
+   * aggregated. Only applied when the block comes from the block list of current meter.
+   */
+  if (pQuery->pBlock != NULL && pBlock == &pQuery->pBlock[pQuery->slot]) {
+    int32_t next = pQuery->slot + GET_FORWARD_DIRECTION_FACTOR(pQuery->order.order);
+    if (next >= 0 && next < pQuery->numOfBlocks) {
+      vnodePrefetchDataBlock(pRuntimeEnv, fileIdx, &pQuery->pBlock[next]);
+    }
+  }
+
   int64_t et = taosGetTimestampUs();
   qTrace("QInfo:%p vid:%d sid:%d id:%s, slot:%d, load block completed, ts loaded:%d, rec:%d, elapsed:%f ms",
          GET_QINFO_ADDR(pQuery), pMeterObj->vnode, pMeterObj->sid, pMeterObj->meterId, pQuery->slot, loadPrimaryCol,
@@ -1186,6 +1455,11 @@ static bool needToLoadDataBlock(SQuery *pQuery, SField *pField, SQLFunctionCtx *
       continue;
     }
 
+    // equality on integer, binary and nchar columns can be checked against the bloom filter of the block
+    if (!vnodeBlockBloomMayMatch(&pField[colIndex], pFilterInfo)) {
+      return false;
+    }
+
     // not support pre-filter operation on binary/nchar data type
     if (!vnodeSupportPrefilter(pFilterInfo->info.data.type)) {
       continue;
@@ -1376,6 +1650,22 @@ static bool functionNeedToExecute(SQueryRuntimeEnv *pRuntimeEnv, SQLFunctionCtx
   return true;
 }
 
+// the selection vector of numOfRows rows followed by the scratch space of vnodeDoFilterDataBatch
+static uint8_t *getSelectionBuffer(SQueryRuntimeEnv *pRuntimeEnv, int32_t numOfRows) {
+  int32_t size = numOfRows * 3;
+  if (pRuntimeEnv->selBufSize < size) {
+    uint8_t *tmp = realloc(pRuntimeEnv->selBuffer, size);
+    if (tmp == NULL) {
+      return NULL;
+    }
+
+    pRuntimeEnv->selBuffer = tmp;
+    pRuntimeEnv->selBufSize = size;
+  }
+
+  return pRuntimeEnv->selBuffer;
+}
+
 static int32_t rowwiseApplyAllFunctions(SQueryRuntimeEnv *pRuntimeEnv, int32_t *forwardStep, TSKEY *primaryKeyCol,
                                         char *data, SField *pFields, SBlockInfo *pBlockInfo, bool isDiskFileBlock) {
   SQLFunctionCtx *pCtx = pRuntimeEnv->pCtx;
@@ -1424,11 +1714,29 @@ static int32_t rowwiseApplyAllFunctions(SQueryRuntimeEnv *pRuntimeEnv, int32_t *
      */
     pFilterInfo->pData = doGetDataBlocks(isDiskFileBlock, pRuntimeEnv, data, colIdx, pColumnInfo->colId,
                                          pColumnInfo->type, pColumnInfo->bytes, pFilterInfo->info.colIdxInBuf);
+
+    // the column buffer may be filled with null values for a cache block
+    if (!isDiskFileBlock) {
+      pFilterInfo->pDictData = NULL;
+    }
   }
 
   int32_t numOfRes = 0;
   int32_t step = GET_FORWARD_DIRECTION_FACTOR(pQuery->order.order);
 
+  /*
+   * evaluate the filters on all rows of this round at once, the rows of [selStart, selStart + forwardStep) are
+   * qualified if their flags in sel are set
+   */
+  uint8_t *sel = NULL;
+  int32_t  selStart = QUERY_IS_ASC_QUERY(pQuery) ? pQuery->pos : pQuery->pos - (*forwardStep - 1);
+  if (pQuery->numOfFilterCols > 0 && (*forwardStep) > 0) {
+    sel = getSelectionBuffer(pRuntimeEnv, *forwardStep);
+    if (sel != NULL) {
+      vnodeDoFilterDataBatch(pQuery, selStart, *forwardStep, sel, sel + (*forwardStep));
+    }
+  }
+
   // from top to bottom in desc
   // from bottom to top in asc order
   if (pRuntimeEnv->pTSBuf != NULL) {
@@ -1452,7 +1760,11 @@ static int32_t rowwiseApplyAllFunctions(SQueryRuntimeEnv *pRuntimeEnv, int32_t *
       }
     }
 
-    if (pQuery->numOfFilterCols > 0 && (!vnodeDoFilterData(pQuery, offset))) {
+    if (sel != NULL) {
+      if (!sel[offset - selStart]) {
+        continue;
+      }
+    } else if (pQuery->numOfFilterCols > 0 && (!vnodeDoFilterData(pQuery, offset))) {
       continue;
     }
 
@@ -2018,6 +2330,12 @@ static void teardownQueryRuntimeEnv(SQueryRuntimeEnv *pRuntimeEnv) {
   }
 
   tfree(pRuntimeEnv->unzipBuffer);
+  tfree(pRuntimeEnv->blockReadBuffer);
+  pRuntimeEnv->blockReadBufSize = 0;
+  tfree(pRuntimeEnv->dictCodesBuffer);
+  pRuntimeEnv->dictCodesBufSize = 0;
+  tfree(pRuntimeEnv->selBuffer);
+  pRuntimeEnv->selBufSize = 0;
 
   if (pRuntimeEnv->pQuery && (!PRIMARY_TSCOL_LOADED(pRuntimeEnv->pQuery))) {
     tfree(pRuntimeEnv->primaryColBuffer);
@@ -2076,6 +2394,11 @@ bool isQueryKilled(SQuery *pQuery) {
     return true;
   }
 
+  // the worker stops with the query it scans for
+  if (pQInfo->pParent != NULL && pQInfo->pParent->killed == 1) {
+    return true;
+  }
+
   return (pQInfo->killed == 1);
 }
 
@@ -2870,6 +3193,8 @@ static int32_t vnodeOpenVnodeDBFiles(SQInfo *pQInfo, SQueryFileInfo *pVnodeFiles
   pVnodeFiles->fileID = fid;
   pVnodeFiles->defaultMappingSize = DEFAULT_DATA_FILE_MMAP_WINDOW_SIZE;
 
+  int32_t fileVersion = atomic_load_32(&vnodeList[vnodeId].fileVersion);
+
   snprintf(pVnodeFiles->headerFilePath, 256, "%s%s", prefix, fileName);
 
 #if 1
@@ -2937,6 +3262,12 @@ static int32_t vnodeOpenVnodeDBFiles(SQInfo *pQInfo, SQueryFileInfo *pVnodeFiles
   if (stat(pVnodeFiles->lastFilePath, &fstat) < 0) return -1;
   pVnodeFiles->lastFileSize = fstat.st_size;
 
+  /* files replaced by commit or import while they are being opened are not known to block cache */
+  if (fileVersion != atomic_load_32(&vnodeList[vnodeId].fileVersion) || (fileVersion & 1) != 0) {
+    fileVersion = -1;
+  }
+  pVnodeFiles->fileVersion = fileVersion;
+
 #if DEFAULT_IO_ENGINE == IO_ENGINE_MMAP
   /* enforce kernel to preload data when the file is mapping */
   pVnodeFiles->pDataFileData = mmap(NULL, pVnodeFiles->defaultMappingSize, PROT_READ, MAP_PRIVATE | MAP_POPULATE,
@@ -3882,6 +4213,37 @@ int32_t vnodeMultiMeterQueryPrepare(SQInfo *pQInfo, SQuery *pQuery, void *param)
   return TSDB_CODE_SUCCESS;
 }
 
+bool vnodeIsQueryParallelizable(SQInfo *pQInfo) {
+  SQuery *               pQuery = &pQInfo->query;
+  SMeterQuerySupportObj *pSupporter = pQInfo->pMeterQuerySupporter;
+
+  if (pQuery->nAggTimeInterval != 0 || isPointInterpoQuery(pQuery) || isGroupbyNormalCol(pQuery->pGroupbyExpr) ||
+      pSupporter->runtimeEnv.pTSBuf != NULL || pSupporter->numOfMeters < 2) {
+    return false;
+  }
+
+  // the partial results of a group generated by workers are merged by the first stage merge of these functions
+  for (int32_t i = 0; i < pQuery->numOfOutputCols; ++i) {
+    switch (pQuery->pSelectExpr[i].pBase.functionId) {
+      case TSDB_FUNC_COUNT:
+      case TSDB_FUNC_SUM:
+      case TSDB_FUNC_AVG:
+      case TSDB_FUNC_MIN:
+      case TSDB_FUNC_MAX:
+      case TSDB_FUNC_SPREAD:
+      case TSDB_FUNC_FIRST_DST:
+      case TSDB_FUNC_LAST_DST:
+      case TSDB_FUNC_TAG:
+      case TSDB_FUNC_TAG_DUMMY:
+        break;
+      default:
+        return false;
+    }
+  }
+
+  return true;
+}
+
 /**
  * decrease the refcount for each table involved in this query
  * @param pQInfo
@@ -3890,14 +4252,19 @@ void vnodeDecMeterRefcnt(SQInfo *pQInfo) {
   SMeterQuerySupportObj *pSupporter = pQInfo->pMeterQuerySupporter;
 
   if (pSupporter == NULL || pSupporter->numOfMeters == 1) {
-    atomic_fetch_sub_32(&pQInfo->pObj->numOfQueries, 1);
+    if (atomic_fetch_sub_32(&pQInfo->pObj->numOfQueries, 1) == 1) {
+      vnodeScheduleImportMerge(pQInfo->pObj);
+    }
+
     dTrace("QInfo:%p vid:%d sid:%d meterId:%s, query is over, numOfQueries:%d", pQInfo, pQInfo->pObj->vnode,
            pQInfo->pObj->sid, pQInfo->pObj->meterId, pQInfo->pObj->numOfQueries);
   } else {
     int32_t num = 0;
     for (int32_t i = 0; i < pSupporter->numOfMeters; ++i) {
       SMeterObj *pMeter = getMeterObj(pSupporter->pMeterObj, pSupporter->pSidSet->pSids[i]->sid);
-      atomic_fetch_sub_32(&(pMeter->numOfQueries), 1);
+      if (atomic_fetch_sub_32(&(pMeter->numOfQueries), 1) == 1) {
+        vnodeScheduleImportMerge(pMeter);
+      }
 
       if (pMeter->numOfQueries > 0) {
         dTrace("QInfo:%p vid:%d sid:%d meterId:%s, query is over, numOfQueries:%d", pQInfo, pMeter->vnode, pMeter->sid,
@@ -4660,6 +5027,55 @@ int32_t meterResultComparator(const void *pLeft, const void *pRight, void *param
   return leftTimestamp > rightTimestamp ? 1 : -1;
 }
 
+/**
+ * merge the group result of a worker, which is in the intermediate format of super table query, into the group
+ * result of the query by the first stage merge functions
+ * @param pSupporter
+ * @param pDst    group result of the query
+ * @param pSrc    group result of the worker
+ */
+void mergeGroupResult(SMeterQuerySupportObj *pSupporter, SOutputRes *pDst, SOutputRes *pSrc) {
+  SQueryRuntimeEnv *pRuntimeEnv = &pSupporter->runtimeEnv;
+  SQuery *          pQuery = pRuntimeEnv->pQuery;
+  SQLFunctionCtx *  pCtx = pRuntimeEnv->pCtx;
+
+  for (int32_t i = 0; i < pQuery->numOfOutputCols; ++i) {
+    int32_t functionId = pQuery->pSelectExpr[i].pBase.functionId;
+
+    pCtx[i].aOutputBuf = pDst->result[i]->data;
+    pCtx[i].resultInfo = &pDst->resultInfo[i];
+    pCtx[i].currentStage = FIRST_STAGE_MERGE;
+
+    // the first merged result initializes the output of group
+    if (pDst->numOfRows == 0) {
+      resetResultInfo(pCtx[i].resultInfo);
+      aAggs[functionId].init(&pCtx[i]);
+    }
+
+    pCtx[i].size = 1;
+    pCtx[i].startOffset = 0;
+    pCtx[i].hasNull = true;
+    pCtx[i].aInputElemBuf = pSrc->result[i]->data;
+
+    // in case of tag column, the tag information should be extracted from input buffer
+    if (functionId == TSDB_FUNC_TAG_DUMMY || functionId == TSDB_FUNC_TAG) {
+      tVariantDestroy(&pCtx[i].tag);
+      tVariantCreateFromBinary(&pCtx[i].tag, pCtx[i].aInputElemBuf, pCtx[i].inputBytes, pCtx[i].inputType);
+    }
+  }
+
+  for (int32_t i = 0; i < pQuery->numOfOutputCols; ++i) {
+    int32_t functionId = pQuery->pSelectExpr[i].pBase.functionId;
+    if (functionId == TSDB_FUNC_TAG_DUMMY) {
+      continue;
+    }
+
+    aAggs[functionId].distMergeFunc(&pCtx[i]);
+  }
+
+  pDst->numOfRows = 1;
+}
+
 int32_t mergeMetersResultToOneGroups(SMeterQuerySupportObj *pSupporter) {
   SQueryRuntimeEnv *pRuntimeEnv = &pSupporter->runtimeEnv;
   SQuery *          pQuery = pRuntimeEnv->pQuery;
@@ -6914,14 +7330,70 @@ static int32_t resultInterpolate(SQInfo *pQInfo, tFilePage **data, tFilePage **p
   return numOfRes;
 }
 
-static void doCopyQueryResultToMsg(SQInfo *pQInfo, int32_t numOfRows, char* data, int32_t* size) {
+/*
+ * compress each column with the codec of its type as the data file does. Columns whose bytes do not match their
+ * type, like the intermediate results of super table query, are compressed as binary.
+ */
+static int32_t doCompressQueryResultColumns(SQInfo *pQInfo, int32_t numOfRows, char *data) {
+  SMeterObj *pObj = pQInfo->pObj;
+  SQuery *   pQuery = &pQInfo->query;
+
+  int   tnumOfRows = vnodeList[pObj->vnode].cfg.rowsInFileBlock;
+  char  algorithm = (vnodeList[pObj->vnode].cfg.compression == TWO_STAGE_COMP) ? TWO_STAGE_COMP : ONE_STAGE_COMP;
+  char *buffer = NULL;
+  int   bufferSize = 0;
+
+  if (algorithm == TWO_STAGE_COMP) {
+    int32_t maxBytes = 0;
+    for (int32_t col = 0; col < pQuery->numOfOutputCols; ++col) {
+      maxBytes = MAX(maxBytes, pQuery->pSelectExpr[col].resBytes);
+    }
+
+    bufferSize = maxBytes * numOfRows + EXTRA_BYTES;
+    buffer = (char *)malloc((size_t)bufferSize);
+    if (buffer == NULL) algorithm = ONE_STAGE_COMP;
+  }
+
+  char *d = data;
+  for (int32_t col = 0; col < pQuery->numOfOutputCols; ++col) {  // pQInfo->bufIndex == 0
+    int32_t bytes = pQuery->pSelectExpr[col].resBytes;
+    int16_t type = pQuery->pSelectExpr[col].resType;
+    char *  src = pQuery->sdata[col]->data + bytes * tnumOfRows * pQInfo->bufIndex;
+
+    if (type < TSDB_DATA_TYPE_BOOL || type > TSDB_DATA_TYPE_NCHAR ||
+        (type != TSDB_DATA_TYPE_BINARY && type != TSDB_DATA_TYPE_NCHAR && bytes != tDataTypeDesc[type].nSize)) {
+      type = TSDB_DATA_TYPE_BINARY;
+    }
+
+    SRetrieveColumnHead *pHead = (SRetrieveColumnHead *)d;
+    d += sizeof(SRetrieveColumnHead);
+
+    int32_t len = (*pCompFunc[type])(src, bytes * numOfRows, numOfRows, d, bytes * numOfRows + EXTRA_BYTES, algorithm,
+                                     buffer, bufferSize);
+    pHead->type = (int8_t)type;
+    pHead->algorithm = algorithm;
+    pHead->bytes = htons((uint16_t)bytes);
+    pHead->len = htonl(len);
+    d += len;
+  }
+
+  tfree(buffer);
+  return (int32_t)(d - data);
+}
+
+static void doCopyQueryResultToMsg(SQInfo *pQInfo, int32_t numOfRows, char* data, int32_t* size, int16_t *compress) {
   SMeterObj* pObj = pQInfo->pObj;
   SQuery* pQuery = &pQInfo->query;
 
   int tnumOfRows = vnodeList[pObj->vnode].cfg.rowsInFileBlock;
   int32_t dataSize = pQInfo->query.rowSize * numOfRows;
 
-  if (dataSize >= tsCompressMsgSize && tsCompressMsgSize > 0) {
+  if (dataSize >= tsCompressMsgSize && tsCompressMsgSize > 0 && *compress == TSDB_RSP_COMP_COLUMN) {
+    *size = doCompressQueryResultColumns(pQInfo, numOfRows, data);
+
+    dTrace("QInfo:%p compress rsp msg by column, before:%d, after:%d", pQInfo, dataSize, *size);
+    if (*size < dataSize) return;
+  } else if (dataSize >= tsCompressMsgSize && tsCompressMsgSize > 0) {
     char* compBuf = malloc((size_t) dataSize);
 
     // for metric query, bufIndex always be 0.
@@ -6937,14 +7409,23 @@ static void doCopyQueryResultToMsg(SQInfo *pQInfo, int32_t numOfRows, char* data
 
     dTrace("QInfo:%p compress rsp msg, before:%d, after:%d", pQInfo, dataSize, *size);
     free(compBuf);
-  } else { // for metric query, bufIndex always be 0.
-    for (int32_t col = 0; col < pQuery->numOfOutputCols; ++col) {  // pQInfo->bufIndex == 0
-      int32_t bytes = pQuery->pSelectExpr[col].resBytes;
 
-      memmove(data, pQuery->sdata[col]->data + bytes * tnumOfRows * pQInfo->bufIndex, bytes * numOfRows);
-      data += bytes * numOfRows;
+    if (*size < dataSize) {
+      *compress = TSDB_RSP_COMP_LZ4;
+      return;
     }
   }
+
+  // not compressed, or the compressed one is not smaller. for metric query, bufIndex always be 0.
+  *compress = TSDB_RSP_COMP_NONE;
+  *size = dataSize;
+
+  for (int32_t col = 0; col < pQuery->numOfOutputCols; ++col) {  // pQInfo->bufIndex == 0
+    int32_t bytes = pQuery->pSelectExpr[col].resBytes;
+
+    memmove(data, pQuery->sdata[col]->data + bytes * tnumOfRows * pQInfo->bufIndex, bytes * numOfRows);
+    data += bytes * numOfRows;
+  }
 }
 
 /**
@@ -6956,9 +7437,10 @@ static void doCopyQueryResultToMsg(SQInfo *pQInfo, int32_t numOfRows, char* data
  * @param handle
  * @param data
  * @param numOfRows the number of rows that are not returned in current retrieve
+ * @param compress  compress mode accepted by client, set to the one actually used
  * @return
  */
-int32_t vnodeCopyQueryResultToMsg(void *handle, char *data, int32_t numOfRows, int32_t* size) {
+int32_t vnodeCopyQueryResultToMsg(void *handle, char *data, int32_t numOfRows, int32_t* size, int16_t *compress) {
   SQInfo *pQInfo = (SQInfo *)handle;
   SQuery *   pQuery = &pQInfo->query;
 
@@ -6966,6 +7448,7 @@ int32_t vnodeCopyQueryResultToMsg(void *handle, char *data, int32_t numOfRows, i
 
   // load data from file to msg buffer
   if (isTSCompQuery(pQuery)) {
+    *compress = TSDB_RSP_COMP_NONE;
     int32_t fd = open(pQuery->sdata[0]->data, O_RDONLY, 0666);
 
     // make sure file exist
@@ -6983,7 +7466,7 @@ int32_t vnodeCopyQueryResultToMsg(void *handle, char *data, int32_t numOfRows, i
              pQuery->sdata[0]->data, strerror(errno));
     }
   } else {
-    doCopyQueryResultToMsg(pQInfo, numOfRows, data, size);
+    doCopyQueryResultToMsg(pQInfo, numOfRows, data, size, compress);
   }
 
   return numOfRows;
@@ -7068,6 +7551,13 @@ void vnodePrintQueryStatistics(SMeterQuerySupportObj *pSupporter) {
   dTrace("QInfo:%p statis: file:%d, table:%d", pQInfo, pSummary->numOfFiles, pSummary->numOfTables);
   dTrace("QInfo:%p statis: seek ops:%d", pQInfo, pSummary->numOfSeek);
 
+  /* each column used to cost a seek and a read for its data and again for its checksum */
+  dTrace("QInfo:%p statis: columns read:%d, read syscalls:%d (per-column:%d), blocks prefetched:%d", pQInfo,
+         pSummary->readColumns, pSummary->readSyscalls, pSummary->readColumns * 4, pSummary->prefetchBlocks);
+  dTrace("QInfo:%p statis: columns from block cache:%d, block cache memory:%ld Bytes", pQInfo,
+         pSummary->cachedColumns, vnodeGetBlockCacheMemory());
+  dTrace("QInfo:%p statis: filter columns evaluated on dictionary:%d", pQInfo, pSummary->dictFilterCols);
+
   double total = pSummary->fileTimeUs + pSummary->cacheTimeUs;
   double io = pSummary->loadCompInfoUs + pSummary->loadBlocksUs + pSummary->loadFieldUs;
   //    assert(io <= pSummary->fileTimeUs);
@@ -388,6 +388,12 @@ static SMeterDataInfo *queryOnMultiDataFiles(SQInfo *pQInfo, SMeterDataInfo *pMe
       }
 
       SCompBlock *pBlock = pInfoEx->pBlock.compBlock;
+
+      // let the disk read the next block in the list while this one is processed
+      if (j + step < numOfBlocks && j + step >= 0) {
+        vnodePrefetchDataBlock(pRuntimeEnv, fileIdx, pDataBlockInfoEx[j + step].pBlock.compBlock);
+      }
+
       bool        ondemandLoad = onDemandLoadDatablock(pQuery, pMeterQueryInfo->queryRangeSet);
       int32_t     ret = LoadDatablockOnDemand(pBlock, &pInfoEx->pBlock.fields, &pRuntimeEnv->blockStatus, pRuntimeEnv,
                                           fileIdx, pInfoEx->blockIndex, searchFn, ondemandLoad);
@@ -845,6 +851,110 @@ static void doMultiMeterSupplementaryScan(SQInfo *pQInfo) {
   SET_MASTER_SCAN_FLAG(pRuntimeEnv);
 }
 
+static void vnodeMultiMeterQueryWorker(SSchedMsg *pMsg) {
+  SQInfo *               pWorker = (SQInfo *)pMsg->ahandle;
+  SMeterQuerySupportObj *pSupporter = pWorker->pMeterQuerySupporter;
+
+  pSupporter->pMeterDataInfo = (SMeterDataInfo *)calloc(1, sizeof(SMeterDataInfo) * pSupporter->numOfMeters);
+  if (pSupporter->pMeterDataInfo == NULL) {
+    dError("QInfo:%p failed to allocate memory, %s", pWorker, strerror(errno));
+    pWorker->code = TSDB_CODE_SERV_OUT_OF_MEMORY;
+  } else {
+    dTrace("QInfo:%p worker of QInfo:%p scan start, meters:%d, group:%d", pWorker, pWorker->pParent,
+           pSupporter->numOfMeters, pSupporter->pSidSet->numOfSubSet);
+
+    doOrderedScan(pWorker);
+    doMultiMeterSupplementaryScan(pWorker);
+    vnodePrintQueryStatistics(pSupporter);
+  }
+
+  sem_post(&pWorker->dataReady);
+}
+
+/*
+ * the group results of workers are in the intermediate format of super table query, the results of workers that
+ * belong to the same group of the query are merged into the group result of the query.
+ */
+static void doMergeWorkersResult(SQInfo *pQInfo) {
+  SMeterQuerySupportObj *pSupporter = pQInfo->pMeterQuerySupporter;
+  tSidSet *              pSidSet = pSupporter->pSidSet;
+
+  void *pGroupIdx = taosInitIntHash(pSidSet->numOfSids, sizeof(int32_t), taosHashInt);
+  for (int32_t i = 0; i < pSidSet->numOfSubSet; ++i) {
+    for (int32_t k = pSidSet->starterPos[i]; k < pSidSet->starterPos[i + 1]; ++k) {
+      taosAddIntHash(pGroupIdx, pSidSet->pSids[k]->sid, (char *)&i);
+    }
+  }
+
+  for (int32_t i = 0; i < pSupporter->numOfWorkers; ++i) {
+    SMeterQuerySupportObj *pWorkerSupporter = pSupporter->pWorkers[i]->pMeterQuerySupporter;
+    tSidSet *              pWorkerSidSet = pWorkerSupporter->pSidSet;
+
+    for (int32_t j = 0; j < pWorkerSidSet->numOfSubSet; ++j) {
+      if (pWorkerSupporter->pResult[j].numOfRows == 0) {
+        continue;
+      }
+
+      int32_t sid = pWorkerSidSet->pSids[pWorkerSidSet->starterPos[j]]->sid;
+      int32_t groupIdx = *(int32_t *)taosGetIntHashData(pGroupIdx, sid);
+
+      mergeGroupResult(pSupporter, &pSupporter->pResult[groupIdx], &pWorkerSupporter->pResult[j]);
+    }
+  }
+
+  taosCleanUpIntHash(pGroupIdx);
+}
+
+/*
+ * the meters are split into morsels when the query is created, and each morsel is scanned by a worker in the pool of
+ * query workers. The query thread waits for all of the workers and merges their group results.
+ */
+static void vnodeMultiMeterParallelProcessor(SQInfo *pQInfo) {
+  SMeterQuerySupportObj *pSupporter = pQInfo->pMeterQuerySupporter;
+  SQuery *               pQuery = &pQInfo->query;
+
+  dTrace("QInfo:%p query start, qrange:%lld-%lld, order:%d, group:%d, workers:%d", pQInfo, pSupporter->rawSKey,
+         pSupporter->rawEKey, pQuery->order.order, pSupporter->pSidSet->numOfSubSet, pSupporter->numOfWorkers);
+
+  int64_t st = taosGetTimestampMs();
+
+  for (int32_t i = 0; i < pSupporter->numOfWorkers; ++i) {
+    SSchedMsg schedMsg = {0};
+    schedMsg.fp = vnodeMultiMeterQueryWorker;
+    schedMsg.ahandle = pSupporter->pWorkers[i];
+
+    taosScheduleTask(queryWorkerQhandle, &schedMsg);
+  }
+
+  // a worker failed or killed by a dropped meter stops the query, and the other workers with it
+  for (int32_t i = 0; i < pSupporter->numOfWorkers; ++i) {
+    SQInfo *pWorker = pSupporter->pWorkers[i];
+    sem_wait(&pWorker->dataReady);
+
+    if (pWorker->code != TSDB_CODE_SUCCESS) {
+      pQInfo->code = pWorker->code;
+      pQInfo->killed = 1;
+    } else if (pWorker->killed == 1) {
+      pQInfo->killed = 1;
+    }
+  }
+
+  dTrace("QInfo:%p %d workers completed, elapsed time: %lldms", pQInfo, pSupporter->numOfWorkers,
+         taosGetTimestampMs() - st);
+
+  if (isQueryKilled(pQuery)) {
+    dTrace("QInfo:%p query killed, abort", pQInfo);
+    return;
+  }
+
+  doMergeWorkersResult(pQInfo);
+  copyFromGroupBuf(pQInfo, pSupporter->pResult);
+
+  pQInfo->pointsRead += pQuery->pointsRead;
+  dTrace("QInfo:%p points returned:%d, totalRead:%d totalReturn:%d", pQInfo, pQuery->pointsRead, pQInfo->pointsRead,
+         pQInfo->pointsReturned);
+}
+
 static void vnodeMultiMeterQueryProcessor(SQInfo *pQInfo) {
   SMeterQuerySupportObj *pSupporter = pQInfo->pMeterQuerySupporter;
   SQuery *               pQuery = &pQInfo->query;
@@ -875,6 +985,11 @@ static void vnodeMultiMeterQueryProcessor(SQInfo *pQInfo) {
     return;
   }
 
+  if (pSupporter->numOfWorkers > 0) {
+    vnodeMultiMeterParallelProcessor(pQInfo);
+    return;
+  }
+
   pSupporter->pMeterDataInfo = (SMeterDataInfo *)calloc(1, sizeof(SMeterDataInfo) * pSupporter->numOfMeters);
   if (pSupporter->pMeterDataInfo == NULL) {
     dError("QInfo:%p failed to allocate memory, %s", pQInfo, strerror(errno));
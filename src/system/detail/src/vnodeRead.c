@@ -26,6 +26,8 @@
 #include "vnodeRead.h"
 #include "vnodeUtil.h"
 
+#include "vnodeQueryImpl.h"
+
 #pragma GCC diagnostic ignored "-Wint-conversion"
 
 int (*pQueryFunc[])(SMeterObj *, SQuery *) = {vnodeQueryFromCache, vnodeQueryFromFile};
@@ -416,6 +418,21 @@ void vnodeFreeQInfoInQueue(void *param) {
   taosScheduleTask(queryQhandle, &schedMsg);
 }
 
+static void vnodeFreeQueryWorkers(SQInfo *pQInfo) {
+  SMeterQuerySupportObj *pSupporter = pQInfo->pMeterQuerySupporter;
+  if (pSupporter == NULL || pSupporter->pWorkers == NULL) {
+    return;
+  }
+
+  // the meters queried by workers are referenced by the query, not by the workers
+  for (int32_t i = 0; i < pSupporter->numOfWorkers; ++i) {
+    vnodeFreeQInfo(pSupporter->pWorkers[i], false);
+  }
+
+  tfree(pSupporter->pWorkers);
+  pSupporter->numOfWorkers = 0;
+}
+
 void vnodeFreeQInfo(void *param, bool decQueryRef) {
   SQInfo *pQInfo = (SQInfo *)param;
   if (!vnodeIsQInfoValid(param)) return;
@@ -452,6 +469,7 @@ void vnodeFreeQInfo(void *param, bool decQueryRef) {
   }
 
   sem_destroy(&(pQInfo->dataReady));
+  vnodeFreeQueryWorkers(pQInfo);
   vnodeQueryFreeQInfoEx(pQInfo);
 
   for (int32_t i = 0; i < pQuery->numOfFilterCols; ++i) {
@@ -691,11 +709,152 @@ _error:
   return NULL;
 }
 
+static void vnodeFreeQueryWorkerExprs(SSqlFunctionExpr *pExprs, int32_t numOfExprs) {
+  for (int32_t i = 0; i < numOfExprs; ++i) {
+    SSqlBinaryExprInfo *pBinExprInfo = &pExprs[i].pBinExprInfo;
+
+    if (pBinExprInfo->numOfCols > 0) {
+      tfree(pBinExprInfo->pReqColumns);
+      tSQLBinaryExprDestroy(&pBinExprInfo->pBinExpr, NULL);
+    }
+  }
+
+  free(pExprs);
+}
+
+/*
+ * the worker scans a morsel of meters: the meters at position index, index + degree, ... of the sorted meter list of
+ * the query. It owns a copy of the query expressions and keeps the results of its groups in its own group buffers.
+ */
+static SQInfo *vnodeCreateQueryWorker(SQInfo *pQInfo, SQueryMeterMsg *pQueryMsg, int32_t index, int32_t degree) {
+  SQuery *               pQuery = &pQInfo->query;
+  SMeterQuerySupportObj *pSupporter = pQInfo->pMeterQuerySupporter;
+  tSidSet *              pSidSet = pSupporter->pSidSet;
+
+  SSqlFunctionExpr *pExprs = (SSqlFunctionExpr *)malloc(sizeof(SSqlFunctionExpr) * pQuery->numOfOutputCols);
+  SSqlGroupbyExpr * pGroupbyExpr = NULL;
+  if (pExprs == NULL) {
+    return NULL;
+  }
+
+  memcpy(pExprs, pQuery->pSelectExpr, sizeof(SSqlFunctionExpr) * pQuery->numOfOutputCols);
+
+  /*
+   * the binary expression and its required columns are freed with the query that owns them, and the column index of
+   * the required columns is updated by each query, so the worker builds its own ones from the query message
+   */
+  for (int32_t i = 0; i < pQuery->numOfOutputCols; ++i) {
+    SSqlBinaryExprInfo *pBinExprInfo = &pExprs[i].pBinExprInfo;
+    if (pBinExprInfo->numOfCols == 0) {
+      continue;
+    }
+
+    memset(pBinExprInfo, 0, sizeof(SSqlBinaryExprInfo));
+    if (vnodeBuildExprFromArithmeticStr(&pExprs[i], pQueryMsg) != TSDB_CODE_SUCCESS) {
+      vnodeFreeQueryWorkerExprs(pExprs, i);
+      return NULL;
+    }
+  }
+
+  if (pQuery->pGroupbyExpr != NULL) {
+    pGroupbyExpr = (SSqlGroupbyExpr *)malloc(sizeof(SSqlGroupbyExpr));
+    if (pGroupbyExpr == NULL) {
+      vnodeFreeQueryWorkerExprs(pExprs, pQuery->numOfOutputCols);
+      return NULL;
+    }
+
+    memcpy(pGroupbyExpr, pQuery->pGroupbyExpr, sizeof(SSqlGroupbyExpr));
+  }
+
+  SMeterObj *pMeterObj = getMeterObj(pSupporter->pMeterObj, pSidSet->pSids[index]->sid);
+
+  SQInfo *pWorker = vnodeAllocateQInfoEx(pQueryMsg, pGroupbyExpr, pExprs, pMeterObj);
+  if (pWorker == NULL) {
+    return NULL;
+  }
+
+  SQuery *pWorkerQuery = &pWorker->query;
+  pWorkerQuery->skey = pQueryMsg->skey;
+  pWorkerQuery->ekey = pQueryMsg->ekey;
+
+  pWorker->num = pQueryMsg->num;
+  pWorker->pParent = pQInfo;
+
+  SMeterQuerySupportObj *pWorkerSupporter = (SMeterQuerySupportObj *)calloc(1, sizeof(SMeterQuerySupportObj));
+  if (sem_init(&(pWorker->dataReady), 0, 0) != 0 || pWorkerSupporter == NULL) {
+    tfree(pWorkerSupporter);
+    vnodeFreeQInfo(pWorker, false);
+    return NULL;
+  }
+
+  pWorker->pMeterQuerySupporter = pWorkerSupporter;
+
+  int32_t numOfMeters = (pSidSet->numOfSids - index + degree - 1) / degree;
+  int32_t sidElemLen = pQueryMsg->tagLength + sizeof(SMeterSidExtInfo);
+
+  pWorkerSupporter->numOfMeters = numOfMeters;
+  pWorkerSupporter->pMeterObj = taosInitIntHash(numOfMeters, POINTER_BYTES, taosHashInt);
+  pWorkerSupporter->pMeterSidExtInfo = (SMeterSidExtInfo **)malloc((POINTER_BYTES + sidElemLen) * numOfMeters);
+  if (pWorkerSupporter->pMeterSidExtInfo == NULL) {
+    vnodeFreeQInfo(pWorker, false);
+    return NULL;
+  }
+
+  char *px = ((char *)pWorkerSupporter->pMeterSidExtInfo) + POINTER_BYTES * numOfMeters;
+
+  for (int32_t i = 0, k = index; k < pSidSet->numOfSids; ++i, k += degree) {
+    SMeterObj *pObj = getMeterObj(pSupporter->pMeterObj, pSidSet->pSids[k]->sid);
+    taosAddIntHash(pWorkerSupporter->pMeterObj, pObj->sid, (char *)&pObj);
+
+    pWorkerSupporter->pMeterSidExtInfo[i] = (SMeterSidExtInfo *)px;
+    memcpy(px, pSidSet->pSids[k], sidElemLen);
+    px += sidElemLen;
+  }
+
+  if (pGroupbyExpr != NULL && pGroupbyExpr->numOfGroupCols > 0) {
+    pWorkerSupporter->pSidSet =
+        tSidSetCreate(pWorkerSupporter->pMeterSidExtInfo, numOfMeters, (SSchema *)pQueryMsg->pTagSchema,
+                      pQueryMsg->numOfTagsCols, pGroupbyExpr->columnInfo, pGroupbyExpr->numOfGroupCols);
+  } else {
+    pWorkerSupporter->pSidSet = tSidSetCreate(pWorkerSupporter->pMeterSidExtInfo, numOfMeters,
+                                              (SSchema *)pQueryMsg->pTagSchema, pQueryMsg->numOfTagsCols, NULL, 0);
+  }
+
+  if (vnodeMultiMeterQueryPrepare(pWorker, pWorkerQuery, NULL) != TSDB_CODE_SUCCESS) {
+    vnodeFreeQInfo(pWorker, false);
+    return NULL;
+  }
+
+  return pWorker;
+}
+
+static int32_t vnodeCreateQueryWorkers(SQInfo *pQInfo, SQueryMeterMsg *pQueryMsg, int32_t degree) {
+  SMeterQuerySupportObj *pSupporter = pQInfo->pMeterQuerySupporter;
+
+  pSupporter->pWorkers = (SQInfo **)calloc(degree, POINTER_BYTES);
+  if (pSupporter->pWorkers == NULL) {
+    return TSDB_CODE_SERV_OUT_OF_MEMORY;
+  }
+
+  for (int32_t i = 0; i < degree; ++i) {
+    pSupporter->pWorkers[i] = vnodeCreateQueryWorker(pQInfo, pQueryMsg, i, degree);
+    if (pSupporter->pWorkers[i] == NULL) {
+      vnodeFreeQueryWorkers(pQInfo);
+      return TSDB_CODE_SERV_OUT_OF_MEMORY;
+    }
+
+    pSupporter->numOfWorkers++;
+  }
+
+  dTrace("QInfo:%p %d meters are split into %d morsels", pQInfo, pSupporter->numOfMeters, degree);
+  return TSDB_CODE_SUCCESS;
+}
+
 /*
  * query on multi-meters
  */
 void *vnodeQueryOnMultiMeters(SMeterObj **pMetersObj, SSqlGroupbyExpr *pGroupbyExpr, SSqlFunctionExpr *pSqlExprs,
-                              SQueryMeterMsg *pQueryMsg, int32_t *code) {
+                              SQueryMeterMsg *pQueryMsg, int32_t parallelism, int32_t *code) {
   SQInfo *pQInfo;
   SQuery *pQuery;
 
@@ -785,6 +944,13 @@ void *vnodeQueryOnMultiMeters(SMeterObj **pMetersObj, SSqlGroupbyExpr *pGroupbyE
     return pQInfo;
   }
 
+  // the degree of parallelism requested by the query is limited by the dnode
+  int32_t degree = MIN(MIN(parallelism, tsQueryParallelism), pSupporter->numOfMeters);
+  if (degree > 1 && queryWorkerQhandle != NULL && vnodeIsQueryParallelizable(pQInfo) &&
+      vnodeCreateQueryWorkers(pQInfo, pQueryMsg, degree) != TSDB_CODE_SUCCESS) {
+    dError("QInfo:%p failed to create %d workers, meters are scanned by the query thread", pQInfo, degree);
+  }
+
   pQInfo->signature = TSDB_QINFO_QUERY_FLAG;
 
   schedMsg.msg = NULL;
@@ -848,13 +1014,13 @@ int vnodeRetrieveQueryInfo(void *handle, int *numOfRows, int *rowSize, int16_t *
 }
 
 // vnodeRetrieveQueryInfo must be called first
-int vnodeSaveQueryResult(void *handle, char *data, int32_t *size) {
+int vnodeSaveQueryResult(void *handle, char *data, int32_t *size, int16_t *compress) {
   SQInfo *pQInfo = (SQInfo *)handle;
 
   // the remained number of retrieved rows, not the interpolated result
   int numOfRows = pQInfo->pointsRead - pQInfo->pointsReturned;
 
-  int32_t numOfFinal = vnodeCopyQueryResultToMsg(pQInfo, data, numOfRows, size);
+  int32_t numOfFinal = vnodeCopyQueryResultToMsg(pQInfo, data, numOfRows, size, compress);
   pQInfo->pointsReturned += numOfFinal;
 
   dTrace("QInfo:%p %d are returned, totalReturned:%d totalRead:%d", pQInfo, numOfFinal, pQInfo->pointsReturned,
@@ -940,6 +1106,20 @@ static int32_t validateQueryMeterMsg(SQueryMeterMsg *pQueryMsg) {
   return 0;
 }
 
+/*
+ * the degree of parallelism follows the ts comp block at the end of a converted message, a message without it comes
+ * from a client of an older version and is scanned by one thread
+ */
+int32_t vnodeGetQueryParallelism(SQueryMeterMsg *pQueryMsg, int32_t msgLen) {
+  if (pQueryMsg->tsOffset <= 0 || pQueryMsg->tsLen < 0 ||
+      (int64_t)pQueryMsg->tsOffset + pQueryMsg->tsLen + sizeof(int16_t) > msgLen) {
+    return 1;
+  }
+
+  int16_t parallelism = htons(*(int16_t *)((char *)pQueryMsg + pQueryMsg->tsOffset + pQueryMsg->tsLen));
+  return (parallelism > 1) ? parallelism : 1;
+}
+
 int32_t vnodeConvertQueryMeterMsg(SQueryMeterMsg *pQueryMsg) {
   pQueryMsg->vnode = htons(pQueryMsg->vnode);
   pQueryMsg->numOfSids = htonl(pQueryMsg->numOfSids);
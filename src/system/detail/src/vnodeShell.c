@@ -38,6 +38,7 @@ SShellObj **shellList = NULL;
 int vnodeProcessRetrieveRequest(char *pMsg, int msgLen, SShellObj *pObj);
 int vnodeProcessQueryRequest(char *pMsg, int msgLen, SShellObj *pObj);
 int vnodeProcessShellSubmitRequest(char *pMsg, int msgLen, SShellObj *pObj);
+static void vnodeDropSubscription(SShellObj *pShell);
 
 int vnodeSelectReqNum = 0;
 int vnodeInsertReqNum = 0;
@@ -53,6 +54,7 @@ void *vnodeProcessMsgFromShell(char *msg, void *ahandle, void *thandle) {
   if (msg == NULL) {
     if (pObj) {
       pObj->thandle = NULL;
+      vnodeDropSubscription(pObj);
       dTrace("QInfo:%p %s free qhandle", pObj->qhandle, __FUNCTION__);
       vnodeFreeQInfoInQueue(pObj->qhandle);
       pObj->qhandle = NULL;
@@ -183,6 +185,15 @@ int vnodeOpenShellVnode(int vnode) {
 
 static void vnodeDelayedFreeResource(void *param, void *tmrId) {
   int32_t vnode = *(int32_t*) param;
+
+  // subscriptions woken up when the meters are closed may be still in the query queue, they refer to shell objects
+  int32_t numOfSubs = atomic_load_32(&vnodeList[vnode].numOfSubs);
+  if (numOfSubs > 0) {
+    dTrace("vid:%d, %d subscriptions are not processed yet, free resources later", vnode, numOfSubs);
+    taosTmrStart(vnodeDelayedFreeResource, 500, param, vnodeTmrCtrl);
+    return;
+  }
+
   dTrace("vid:%d, start to free resources", vnode);
 
   taosCloseRpcChann(pShellServer, vnode); // close connection
@@ -197,6 +208,7 @@ void vnodeCloseShellVnode(int vnode) {
   if (shellList[vnode] == NULL) return;
 
   for (int i = 0; i < vnodeList[vnode].cfg.maxSessions; ++i) {
+    vnodeDropSubscription(shellList[vnode] + i);
     vnodeFreeQInfo(shellList[vnode][i].qhandle, true);
   }
 
@@ -258,6 +270,276 @@ int vnodeSendShellSubmitRspMsg(SShellObj *pObj, int code, int numOfPoints) {
   return msgLen;
 }
 
+/*
+ * A subscription query asks for the rows after the last key consumed by the client. If none of its meters has such
+ * rows, the query is parked instead of being answered with an empty result: it is linked to the cache info of all its
+ * meters, and processed as a normal query once one of them gets new rows, or it has waited for VNODE_SUB_MAX_WAIT ms.
+ * The client sends the next subscription query only after the rows are consumed, so a parked query costs nothing
+ * but its memory.
+ */
+#define VNODE_SUB_MAX_WAIT 30000
+
+// states of a subscription, it is reachable from its shell object in all of them
+#define VNODE_SUB_PARKED  0  // linked to the meters, waiting for new rows or the timer
+#define VNODE_SUB_QUEUED  1  // unlinked and scheduled in the query queue
+#define VNODE_SUB_RUNNING 2  // being processed as a normal query
+
+typedef struct _sub_link {
+  struct _sub_link * prev;
+  struct _sub_link * next;
+  struct _shell_sub *pSub;
+  SCacheInfo *       pInfo;
+} SSubLink;
+
+typedef struct _shell_sub {
+  struct _shell_sub *next;  // used when a batch of subscriptions is woken up
+  SShellObj *        pShell;
+  void *             pTimer;
+  char *             msg;  // query message as received
+  int32_t            msgLen;
+  int8_t             state;
+  int8_t             cancelled;  // the connection is gone while the subscription is queued
+  int32_t            numOfLinks;
+  SSubLink           links[];
+} SShellSub;
+
+// protects the subscription lists of all meters, SShellObj.pSub and the state of subscriptions
+static pthread_mutex_t vnodeSubMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  vnodeSubCond = PTHREAD_COND_INITIALIZER;
+
+static void vnodeUnlinkSubscription(SShellSub *pSub) {
+  for (int32_t i = 0; i < pSub->numOfLinks; ++i) {
+    SSubLink *pLink = pSub->links + i;
+
+    if (pLink->prev != NULL) {
+      pLink->prev->next = pLink->next;
+    } else {
+      pLink->pInfo->pSubs = pLink->next;
+    }
+
+    if (pLink->next != NULL) {
+      pLink->next->prev = pLink->prev;
+    }
+
+    atomic_sub_fetch_32(&pLink->pInfo->numOfSubs, 1);
+  }
+
+  pSub->state = VNODE_SUB_QUEUED;
+}
+
+static void vnodeFreeSubscription(SShellSub *pSub) {
+  int32_t vnode = pSub->pShell->vnode;
+
+  taosTmrStopA(&pSub->pTimer);
+  free(pSub->msg);
+  free(pSub);
+
+  atomic_sub_fetch_32(&vnodeList[vnode].numOfSubs, 1);
+}
+
+static void vnodeProcessSubscription(SSchedMsg *pSched) {
+  SShellSub *     pSub = (SShellSub *)pSched->msg;
+  SShellObj *     pShell = pSub->pShell;
+  SQueryMeterMsg *pQueryMsg = (SQueryMeterMsg *)pSub->msg;
+
+  pthread_mutex_lock(&vnodeSubMutex);
+  if (pSub->cancelled) {
+    pthread_mutex_unlock(&vnodeSubMutex);
+    dTrace("vid:%d sid:%d, queued subscription is dropped", pShell->vnode, pShell->sid);
+    vnodeFreeSubscription(pSub);
+    return;
+  }
+  pSub->state = VNODE_SUB_RUNNING;
+  pthread_mutex_unlock(&vnodeSubMutex);
+
+  // answered as a normal query, no matter there are new rows or not
+  pQueryMsg->queryType = htons(htons(pQueryMsg->queryType) & (~TSDB_QUERY_TYPE_SUBSCRIBE));
+  vnodeProcessQueryRequest(pSub->msg, pSub->msgLen, pShell);
+
+  // the connection can not be closed and reused before the query handle is set, see vnodeDropSubscription
+  pthread_mutex_lock(&vnodeSubMutex);
+  pShell->pSub = NULL;
+  pthread_cond_broadcast(&vnodeSubCond);
+  pthread_mutex_unlock(&vnodeSubMutex);
+
+  vnodeFreeSubscription(pSub);
+}
+
+static void vnodeScheduleSubscription(SShellSub *pSub) {
+  SSchedMsg schedMsg;
+
+  taosTmrStopA(&pSub->pTimer);
+
+  schedMsg.msg = (char *)pSub;
+  schedMsg.ahandle = pSub->pShell;
+  schedMsg.fp = vnodeProcessSubscription;
+  taosScheduleTask(queryQhandle, &schedMsg);
+}
+
+static void vnodeProcessSubscriptionTimer(void *param, void *tmrId) {
+  SShellObj *pShell = (SShellObj *)param;
+  SShellSub *pSub = NULL;
+
+  pthread_mutex_lock(&vnodeSubMutex);
+  if (pShell->pSub != NULL && ((SShellSub *)pShell->pSub)->pTimer == tmrId &&
+      ((SShellSub *)pShell->pSub)->state == VNODE_SUB_PARKED) {
+    pSub = (SShellSub *)pShell->pSub;
+    pSub->pTimer = NULL;
+    vnodeUnlinkSubscription(pSub);
+  }
+  pthread_mutex_unlock(&vnodeSubMutex);
+
+  if (pSub != NULL) {
+    dTrace("vid:%d sid:%d, no new rows for subscription in %d ms", pShell->vnode, pShell->sid, VNODE_SUB_MAX_WAIT);
+    vnodeScheduleSubscription(pSub);
+  }
+}
+
+static void vnodeWakeSubscription(SShellObj *pShell) {
+  SShellSub *pSub = NULL;
+
+  pthread_mutex_lock(&vnodeSubMutex);
+  if (pShell->pSub != NULL && ((SShellSub *)pShell->pSub)->state == VNODE_SUB_PARKED) {
+    pSub = (SShellSub *)pShell->pSub;
+    vnodeUnlinkSubscription(pSub);
+  }
+  pthread_mutex_unlock(&vnodeSubMutex);
+
+  if (pSub != NULL) vnodeScheduleSubscription(pSub);
+}
+
+/*
+ * a parked subscription is freed here, a queued one is marked as cancelled and freed by the query thread, and a
+ * running one is waited for, so that the query handle it sets on the shell object is freed by the caller
+ */
+static void vnodeDropSubscription(SShellObj *pShell) {
+  SShellSub *pSub = NULL;
+
+  if (pShell->pSub == NULL) return;
+
+  pthread_mutex_lock(&vnodeSubMutex);
+  while (pShell->pSub != NULL && ((SShellSub *)pShell->pSub)->state == VNODE_SUB_RUNNING) {
+    pthread_cond_wait(&vnodeSubCond, &vnodeSubMutex);
+  }
+
+  if (pShell->pSub != NULL) {
+    SShellSub *pShellSub = (SShellSub *)pShell->pSub;
+    if (pShellSub->state == VNODE_SUB_PARKED) {
+      vnodeUnlinkSubscription(pShellSub);
+      pSub = pShellSub;
+    } else {
+      pShellSub->cancelled = 1;
+    }
+    pShell->pSub = NULL;
+  }
+  pthread_mutex_unlock(&vnodeSubMutex);
+
+  if (pSub != NULL) {
+    dTrace("vid:%d sid:%d, parked subscription is dropped", pShell->vnode, pShell->sid);
+    vnodeFreeSubscription(pSub);
+  }
+}
+
+static bool vnodeHasNewRows(SMeterObj **pMeterObjList, int32_t numOfMeters, TSKEY skey) {
+  for (int32_t i = 0; i < numOfMeters; ++i) {
+    if (pMeterObjList[i]->lastKey >= skey) return true;
+  }
+
+  return false;
+}
+
+/*
+ * the meters are referenced by the caller only while the subscription is linked, they are not referenced during the
+ * park. A meter to be dropped wakes up its subscriptions before its cache info is freed, and the meters are looked up
+ * and referenced again when the subscription is processed as a normal query.
+ * @return 0: the subscription is parked and owns msg, -1: it shall be answered now
+ */
+static int vnodeParkSubscription(SShellObj *pShell, char *msg, int msgLen, SMeterObj **pMeterObjList,
+                                 int32_t numOfMeters, TSKEY skey) {
+  for (int32_t i = 0; i < numOfMeters; ++i) {
+    if (pMeterObjList[i]->pCache == NULL) return -1;
+  }
+
+  SShellSub *pSub = (SShellSub *)calloc(1, sizeof(SShellSub) + numOfMeters * sizeof(SSubLink));
+  if (pSub == NULL) return -1;
+
+  pSub->pShell = pShell;
+  pSub->numOfLinks = numOfMeters;
+
+  pthread_mutex_lock(&vnodeSubMutex);
+
+  pSub->pTimer = taosTmrStart(vnodeProcessSubscriptionTimer, VNODE_SUB_MAX_WAIT, pShell, vnodeTmrCtrl);
+  if (pSub->pTimer == NULL) {
+    pthread_mutex_unlock(&vnodeSubMutex);
+    free(pSub);
+    return -1;
+  }
+
+  for (int32_t i = 0; i < numOfMeters; ++i) {
+    SSubLink *  pLink = pSub->links + i;
+    SCacheInfo *pInfo = (SCacheInfo *)pMeterObjList[i]->pCache;
+
+    pLink->pSub = pSub;
+    pLink->pInfo = pInfo;
+    pLink->next = pInfo->pSubs;
+    if (pInfo->pSubs != NULL) pInfo->pSubs->prev = pLink;
+    pInfo->pSubs = pLink;
+
+    // pairs with the one in vnodeNotifySubscribers, the lastKey read below is not older than the one seen there
+    atomic_add_fetch_32(&pInfo->numOfSubs, 1);
+  }
+
+  pSub->msg = msg;
+  pSub->msgLen = msgLen;
+  pShell->pSub = pSub;
+  atomic_add_fetch_32(&vnodeList[pShell->vnode].numOfSubs, 1);
+
+  pthread_mutex_unlock(&vnodeSubMutex);
+
+  dTrace("vid:%d sid:%d, subscription on %d meters is parked, skey:%ld", pShell->vnode, pShell->sid, numOfMeters, skey);
+
+  // rows inserted before the subscription is linked are not notified
+  if (vnodeHasNewRows(pMeterObjList, numOfMeters, skey)) vnodeWakeSubscription(pShell);
+
+  return 0;
+}
+
+/*
+ * called after rows are inserted into the meter, or before the meter is dropped. All parked subscriptions on it are
+ * woken up. It costs an atomic operation on the meter only if there are no subscriptions.
+ */
+void vnodeNotifySubscribers(SMeterObj *pObj) {
+  SCacheInfo *pInfo = (SCacheInfo *)pObj->pCache;
+  SShellSub * pList = NULL;
+
+  if (pInfo == NULL) return;
+
+  /*
+   * a read-modify-write rather than a load, so that it is ordered with the increment of a subscription being parked:
+   * either the lastKey written before is seen by the subscription, or the subscription is seen here
+   */
+  if (atomic_add_fetch_32(&pInfo->numOfSubs, 0) == 0) return;
+
+  pthread_mutex_lock(&vnodeSubMutex);
+  while (pInfo->pSubs != NULL) {
+    SShellSub *pSub = pInfo->pSubs->pSub;
+    vnodeUnlinkSubscription(pSub);
+
+    pSub->next = pList;
+    pList = pSub;
+  }
+  pthread_mutex_unlock(&vnodeSubMutex);
+
+  while (pList != NULL) {
+    SShellSub *pSub = pList;
+    pList = pList->next;
+
+    dTrace("vid:%d sid:%d id:%s, new rows for the subscription of shell:%d", pObj->vnode, pObj->sid, pObj->meterId,
+           pSub->pShell->sid);
+    vnodeScheduleSubscription(pSub);
+  }
+}
+
 int vnodeProcessQueryRequest(char *pMsg, int msgLen, SShellObj *pObj) {
   int                ret, code = 0;
   SQueryMeterMsg *   pQueryMsg;
@@ -266,8 +548,16 @@ int vnodeProcessQueryRequest(char *pMsg, int msgLen, SShellObj *pObj) {
   SSqlFunctionExpr * pExprs = NULL;
   SSqlGroupbyExpr *  pGroupbyExpr = NULL;
   SMeterObj **       pMeterObjList = NULL;
+  char *             pSubMsg = NULL;
+  bool               parked = false;
 
   pQueryMsg = (SQueryMeterMsg *)pMsg;
+
+  // the message is converted in place, keep the original one of a subscription in case it is parked
+  if ((htons(pQueryMsg->queryType) & TSDB_QUERY_TYPE_SUBSCRIBE) != 0 && (pSubMsg = malloc(msgLen)) != NULL) {
+    memcpy(pSubMsg, pMsg, msgLen);
+  }
+
   if ((code = vnodeConvertQueryMeterMsg(pQueryMsg)) != TSDB_CODE_SUCCESS) {
     goto _query_over;
   }
@@ -337,6 +627,15 @@ int vnodeProcessQueryRequest(char *pMsg, int msgLen, SShellObj *pObj) {
     goto _query_over;
   }
 
+  if (pSubMsg != NULL && pQueryMsg->order == TSQL_SO_ASC &&
+      !vnodeHasNewRows(pMeterObjList, pQueryMsg->numOfSids, pQueryMsg->skey) &&
+      vnodeParkSubscription(pObj, pSubMsg, msgLen, pMeterObjList, pQueryMsg->numOfSids, pQueryMsg->skey) == 0) {
+    pSubMsg = NULL;
+    parked = true;
+    vnodeDecQueryRefCount(pQueryMsg, pMeterObjList, incNumber);
+    goto _query_over;
+  }
+
   pExprs = vnodeCreateSqlFunctionExpr(pQueryMsg, &code);
   if (pExprs == NULL) {
     assert(code != TSDB_CODE_SUCCESS);
@@ -355,7 +654,8 @@ int vnodeProcessQueryRequest(char *pMsg, int msgLen, SShellObj *pObj) {
   }
 
   if (QUERY_IS_STABLE_QUERY(pQueryMsg->queryType)) {
-    pObj->qhandle = vnodeQueryOnMultiMeters(pMeterObjList, pGroupbyExpr, pExprs, pQueryMsg, &code);
+    pObj->qhandle = vnodeQueryOnMultiMeters(pMeterObjList, pGroupbyExpr, pExprs, pQueryMsg,
+                                             vnodeGetQueryParallelism(pQueryMsg, msgLen), &code);
   } else {
     pObj->qhandle = vnodeQueryInTimeRange(pMeterObjList, pGroupbyExpr, pExprs, pQueryMsg, &code);
   }
@@ -368,13 +668,18 @@ _query_over:
 
   tfree(pQueryMsg->pSqlFuncExprs);
   tfree(pMeterObjList);
-  ret = vnodeSendQueryRspMsg(pObj, code, pObj->qhandle);
+  tfree(pSubMsg);
 
   free(pQueryMsg->pSidExtInfo);
   for(int32_t i = 0; i < pQueryMsg->numOfCols; ++i) {
     vnodeFreeColumnInfo(&pQueryMsg->colList[i]);
   }
 
+  // a parked subscription is answered when it is processed again
+  if (parked) return 0;
+
+  ret = vnodeSendQueryRspMsg(pObj, code, pObj->qhandle);
+
   atomic_fetch_add_32(&vnodeSelectReqNum, 1);
   return ret;
 }
@@ -386,7 +691,7 @@ void vnodeExecuteRetrieveReq(SSchedMsg *pSched) {
 
   SRetrieveMeterMsg *pRetrieve;
   SRetrieveMeterRsp *pRsp;
-  int                numOfRows = 0, rowSize = 0, size = 0;
+  int                numOfRows = 0, rowSize = 0, size = 0, extraSize = 0;
   int16_t            timePrec = TSDB_TIME_PRECISION_MILLI;
 
   char *pStart;
@@ -417,9 +722,14 @@ void vnodeExecuteRetrieveReq(SSchedMsg *pSched) {
 
   if (code == TSDB_CODE_SUCCESS) {
     size = vnodeGetResultSize((void *)(pRetrieve->qhandle), &numOfRows);
+
+    // room for the head and possible deflation of each column
+    if (pRetrieve->free & TSDB_QUERY_TYPE_COLUMN_COMP) {
+      extraSize = ((SQInfo *)(pRetrieve->qhandle))->query.numOfOutputCols * (sizeof(SRetrieveColumnHead) + EXTRA_BYTES);
+    }
   }
 
-  pStart = taosBuildRspMsgWithSize(pObj->thandle, TSDB_MSG_TYPE_RETRIEVE_RSP, size + 100);
+  pStart = taosBuildRspMsgWithSize(pObj->thandle, TSDB_MSG_TYPE_RETRIEVE_RSP, size + extraSize + 100);
   if (pStart == NULL) {
     taosSendSimpleRsp(pObj->thandle, TSDB_MSG_TYPE_RETRIEVE_RSP, TSDB_CODE_SERV_OUT_OF_MEMORY);
     goto _exit;
@@ -444,14 +754,14 @@ void vnodeExecuteRetrieveReq(SSchedMsg *pSched) {
 
   pMsg = pRsp->data;
 
+  int16_t compress = TSDB_RSP_COMP_NONE;
   if (numOfRows > 0 && code == TSDB_CODE_SUCCESS) {
-    int32_t oldSize = size;
-    vnodeSaveQueryResult((void *)(pRetrieve->qhandle), pRsp->data, &size);
-    if (oldSize > size) {
-      pRsp->compress = htons(1); // denote that the response msg is compressed
-    }
+    compress = (pRetrieve->free & TSDB_QUERY_TYPE_COLUMN_COMP) ? TSDB_RSP_COMP_COLUMN : TSDB_RSP_COMP_LZ4;
+    vnodeSaveQueryResult((void *)(pRetrieve->qhandle), pRsp->data, &size, &compress);
   }
 
+  pRsp->compress = htons(compress);
+
   pMsg += size;
   msgLen = pMsg - pStart;
 
@@ -486,6 +796,7 @@ int vnodeProcessShellSubmitRequest(char *pMsg, int msgLen, SShellObj *pObj) {
   int              code = 0, ret = 0;
   SShellSubmitMsg  shellSubmit = *(SShellSubmitMsg *)pMsg;
   SShellSubmitMsg *pSubmit = &shellSubmit;
+  SVnodeObj *      pVnode = NULL;
 
   pSubmit->vnode = htons(pSubmit->vnode);
   pSubmit->numOfSid = htonl(pSubmit->numOfSid);
@@ -502,7 +813,7 @@ int vnodeProcessShellSubmitRequest(char *pMsg, int msgLen, SShellObj *pObj) {
     goto _submit_over;
   }
 
-  SVnodeObj *pVnode = vnodeList + pSubmit->vnode;
+  pVnode = vnodeList + pSubmit->vnode;
   if (pVnode->cfg.maxSessions == 0 || pVnode->meterList == NULL) {
     dError("vid:%d is not activated for submit", pSubmit->vnode);
     vnodeSendVpeerCfgMsg(pSubmit->vnode);
@@ -582,7 +893,14 @@ int vnodeProcessShellSubmitRequest(char *pMsg, int msgLen, SShellObj *pObj) {
 
 _submit_over:
   // for import, send the submit response only when return code is not zero
-  if (pSubmit->import == 0 || code != 0) ret = vnodeSendShellSubmitRspMsg(pObj, code, numOfTotalPoints);
+  if (pSubmit->import == 0 || code != 0) {
+    // with group commit, the response is sent after the commit log is flushed to disk
+    if (code == TSDB_CODE_SUCCESS && pVnode->cfg.commitLog == TSDB_COMMIT_LOG_GROUP && VALIDFD(pVnode->logFd)) {
+      vnodeDelaySubmitRsp(pVnode, pObj, numOfTotalPoints);
+    } else {
+      ret = vnodeSendShellSubmitRspMsg(pObj, code, numOfTotalPoints);
+    }
+  }
 
   atomic_fetch_add_32(&vnodeInsertReqNum, 1);
   return ret;
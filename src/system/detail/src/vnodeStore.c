@@ -20,6 +20,7 @@
 #include "trpc.h"
 #include "ttime.h"
 #include "vnode.h"
+#include "vnodeBlockCache.h"
 #include "vnodeStore.h"
 #include "vnodeUtil.h"
 #include "tstatus.h"
@@ -270,6 +271,7 @@ int vnodeRemoveVnode(int vnode) {
       }
 
       vnodeRemoveDataFiles(vnode);
+      vnodeInvalidateBlockCache(vnode, -1);
     }
 
   } else {
@@ -19,6 +19,7 @@
 #include "tsdb.h"
 #include "tsocket.h"
 #include "vnode.h"
+#include "vnodeBlockCache.h"
 #include "vnodeSystem.h"
 
 // internal global, not configurable
@@ -26,21 +27,42 @@ void *   vnodeTmrCtrl;
 void **  rpcQhandle;
 void *   dmQhandle;
 void *   queryQhandle;
+void *   queryWorkerQhandle;
+void *   commitQhandle;
 int      tsVnodePeers = TSDB_VNODES_SUPPORT - 1;
 int      tsMaxQueues;
 uint32_t tsRebootTime;
 
 void vnodeCleanUpSystem() {
   vnodeCleanUpVnodes();
+  vnodeCleanUpBlockCache();
 }
 
 bool vnodeInitQueryHandle() {
   int numOfThreads = tsRatioOfQueryThreads * tsNumOfCores * tsNumOfThreadsPerCore;
   if (numOfThreads < 1) numOfThreads = 1;
   queryQhandle = taosInitScheduler(tsNumOfVnodesPerCore * tsNumOfCores * tsSessionsPerVnode, numOfThreads, "query");
+
+  /*
+   * the morsels of a super table query run in threads of their own, the query thread waiting for them can not block
+   * them. The pool is sized like the query pool, so that the queries do not oversubscribe the cores
+   */
+  if (tsQueryParallelism > 1) {
+    if (numOfThreads < tsQueryParallelism) numOfThreads = tsQueryParallelism;
+    queryWorkerQhandle =
+        taosInitScheduler(tsNumOfVnodesPerCore * tsNumOfCores * tsSessionsPerVnode, numOfThreads, "qworker");
+  }
+
   return true;
 }
 
+bool vnodeInitCommitHandle() {
+  if (tsNumOfCommitThreads <= 0) return true;  // blocks are compressed by the commit thread itself
+
+  commitQhandle = taosInitScheduler(tsNumOfCommitThreads * 2 * TSDB_MAX_VNODES, tsNumOfCommitThreads, "commit");
+  return commitQhandle != NULL;
+}
+
 bool vnodeInitTmrCtl() {
   vnodeTmrCtrl = taosTmrInit(TSDB_MAX_VNODES * (tsVnodePeers + 10) + tsSessionsPerVnode + 1000, 200, 60000, "DND-vnode");
   if (vnodeTmrCtrl == NULL) {
@@ -57,11 +79,21 @@ int vnodeInitSystem() {
     return -1;
   }
 
+  if (!vnodeInitCommitHandle()) {
+    dError("failed to init commit qhandle, exit");
+    return -1;
+  }
+
   if (!vnodeInitTmrCtl()) {
     dError("failed to init timer, exit");
     return -1;
   }
 
+  if (vnodeInitBlockCache((int64_t)tsBlockCacheSize * 1024 * 1024) < 0) {
+    dError("failed to init block cache, exit");
+    return -1;
+  }
+
   if (vnodeInitStore() < 0) {
     dError("failed to init vnode storage");
     return -1;
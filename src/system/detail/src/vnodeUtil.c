@@ -157,7 +157,7 @@ static int32_t id_compar(const void* left, const void* right) {
   DEFAULT_COMP(GET_INT16_VAL(left), GET_INT16_VAL(right));
 }
 
-static int32_t vnodeBuildExprFromArithmeticStr(SSqlFunctionExpr* pExpr, SQueryMeterMsg* pQueryMsg) {
+int32_t vnodeBuildExprFromArithmeticStr(SSqlFunctionExpr* pExpr, SQueryMeterMsg* pQueryMsg) {
   SSqlBinaryExprInfo* pBinaryExprInfo = &pExpr->pBinExprInfo;
   SColumnInfo*   pColMsg = pQueryMsg->colList;
 
@@ -432,37 +432,46 @@ int32_t vnodeCreateFilterInfo(void* pQInfo, SQuery* pQuery) {
         __filter_func_t *rangeFilterArray = vnodeGetRangeFilterFuncArray(type);
         __filter_func_t *filterArray = vnodeGetValueFilterFuncArray(type);
 
+        __filter_batch_func_t *rangeBatchFilterArray = vnodeGetRangeBatchFilterFuncArray(type);
+        __filter_batch_func_t *batchFilterArray = vnodeGetValueBatchFilterFuncArray(type);
+
         if (rangeFilterArray == NULL && filterArray == NULL) {
           dError("QInfo:%p failed to get filter function, invalid data type:%d", pQInfo, type);
           return TSDB_CODE_INVALID_QUERY_MSG;
         }
 
+        int32_t rangeIndex = 0;
         if ((lower == TSDB_RELATION_LARGE_EQUAL || lower == TSDB_RELATION_LARGE) &&
             (upper == TSDB_RELATION_LESS_EQUAL || upper == TSDB_RELATION_LESS)) {
           if (lower == TSDB_RELATION_LARGE_EQUAL) {
             if (upper == TSDB_RELATION_LESS_EQUAL) {
-              pSingleColFilter->fp = rangeFilterArray[4];
+              rangeIndex = 4;
             } else {
-              pSingleColFilter->fp = rangeFilterArray[2];
+              rangeIndex = 2;
             }
           } else {
             if (upper == TSDB_RELATION_LESS_EQUAL) {
-              pSingleColFilter->fp = rangeFilterArray[3];
+              rangeIndex = 3;
             } else {
-              pSingleColFilter->fp = rangeFilterArray[1];
+              rangeIndex = 1;
             }
           }
+
+          pSingleColFilter->fp = rangeFilterArray[rangeIndex];
+          pSingleColFilter->fpBatch = (rangeBatchFilterArray != NULL) ? rangeBatchFilterArray[rangeIndex] : NULL;
         } else {  // set callback filter function
+          int32_t optr = upper;
           if (lower != TSDB_RELATION_INVALID) {
-            pSingleColFilter->fp = filterArray[lower];
+            optr = lower;
 
             if (upper != TSDB_RELATION_INVALID) {
               dError("pQInfo:%p failed to get filter function, invalid filter condition", pQInfo, type);
               return TSDB_CODE_INVALID_QUERY_MSG;
             }
-          } else {
-            pSingleColFilter->fp = filterArray[upper];
           }
+
+          pSingleColFilter->fp = filterArray[optr];
+          pSingleColFilter->fpBatch = (batchFilterArray != NULL) ? batchFilterArray[optr] : NULL;
         }
         assert (pSingleColFilter->fp != NULL);
         pSingleColFilter->bytes = bytes;
@@ -478,6 +487,15 @@ int32_t vnodeCreateFilterInfo(void* pQInfo, SQuery* pQuery) {
 bool vnodeDoFilterData(SQuery* pQuery, int32_t elemPos) {
   for (int32_t k = 0; k < pQuery->numOfFilterCols; ++k) {
     SSingleColumnFilterInfo *pFilterInfo = &pQuery->pFilterInfo[k];
+
+    // filters have been evaluated on the dictionary of this column
+    if (pFilterInfo->pDictData != NULL && pFilterInfo->pDictData == pFilterInfo->pData) {
+      if (!pFilterInfo->dictMatch[pFilterInfo->pDictCodes[elemPos]]) {
+        return false;
+      }
+      continue;
+    }
+
     char* pElem = pFilterInfo->pData + pFilterInfo->info.data.bytes * elemPos;
 
     if(isNull(pElem, pFilterInfo->info.data.type)) {
@@ -502,6 +520,18 @@ bool vnodeDoFilterData(SQuery* pQuery, int32_t elemPos) {
   return true;
 }
 
+/*
+ * batch version of vnodeDoFilterData on rows [start, start + numOfRows) of current block, sel[i] is set to 1 if row
+ * start + i is qualified. buf is the scratch space of 2 * numOfRows bytes.
+ */
+void vnodeDoFilterDataBatch(SQuery* pQuery, int32_t start, int32_t numOfRows, uint8_t* sel, uint8_t* buf) {
+  memset(sel, 1, numOfRows);
+
+  for (int32_t k = 0; k < pQuery->numOfFilterCols; ++k) {
+    vnodeFilterColumnBatch(&pQuery->pFilterInfo[k], start, numOfRows, sel, buf);
+  }
+}
+
 bool vnodeFilterData(SQuery* pQuery, int32_t* numOfActualRead, int32_t index) {
   (*numOfActualRead)++;
   if (!vnodeDoFilterData(pQuery, index)) {
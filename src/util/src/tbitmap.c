@@ -0,0 +1,573 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "os.h"
+#include "tbitmap.h"
+#include "tutil.h"
+
+#define BITMAP_ARRAY_MAX_SIZE 4096  // a partition with more values is kept in a bitset
+#define BITMAP_BITSET_WORDS   1024  // 65536 bits of a bitset partition
+
+/*
+ * values sharing the same high 16 bits, the low 16 bits are kept in pArray, or in pBits if it is not NULL
+ */
+typedef struct SBitmapContainer {
+  uint16_t  key;
+  int32_t   num;       // number of values
+  int32_t   capacity;  // capacity of pArray
+  uint16_t *pArray;
+  uint64_t *pBits;
+} SBitmapContainer;
+
+struct tBitmap {
+  int32_t           numOfContainers;
+  int32_t           capacity;
+  SBitmapContainer *pContainers;  // sorted by key
+};
+
+static FORCE_INLINE int32_t bitCount(uint64_t w) {
+  w = w - ((w >> 1) & 0x5555555555555555ULL);
+  w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL);
+  w = (w + (w >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  return (int32_t)((w * 0x0101010101010101ULL) >> 56);
+}
+
+/*
+ * binary search, return the index of val, or -(insert position + 1) if not found
+ */
+static int32_t arraySearch(const uint16_t *pArray, int32_t num, uint16_t val) {
+  int32_t low = 0;
+  int32_t high = num - 1;
+
+  while (low <= high) {
+    int32_t  mid = (low + high) >> 1;
+    uint16_t v = pArray[mid];
+
+    if (v < val) {
+      low = mid + 1;
+    } else if (v > val) {
+      high = mid - 1;
+    } else {
+      return mid;
+    }
+  }
+
+  return -(low + 1);
+}
+
+static int32_t containerSearch(const tBitmap *pBitmap, uint16_t key) {
+  int32_t low = 0;
+  int32_t high = pBitmap->numOfContainers - 1;
+
+  while (low <= high) {
+    int32_t  mid = (low + high) >> 1;
+    uint16_t k = pBitmap->pContainers[mid].key;
+
+    if (k < key) {
+      low = mid + 1;
+    } else if (k > key) {
+      high = mid - 1;
+    } else {
+      return mid;
+    }
+  }
+
+  return -(low + 1);
+}
+
+static void containerFree(SBitmapContainer *pContainer) {
+  tfree(pContainer->pArray);
+  tfree(pContainer->pBits);
+
+  pContainer->num = 0;
+  pContainer->capacity = 0;
+}
+
+static int32_t containerToBitset(SBitmapContainer *pContainer) {
+  uint64_t *pBits = calloc(BITMAP_BITSET_WORDS, sizeof(uint64_t));
+  if (pBits == NULL) {
+    return -1;
+  }
+
+  for (int32_t i = 0; i < pContainer->num; ++i) {
+    uint16_t v = pContainer->pArray[i];
+    pBits[v >> 6] |= (1ULL << (v & 63));
+  }
+
+  tfree(pContainer->pArray);
+  pContainer->capacity = 0;
+  pContainer->pBits = pBits;
+  return 0;
+}
+
+static int32_t containerToArray(SBitmapContainer *pContainer) {
+  uint16_t *pArray = malloc(MAX(pContainer->num, 1) * sizeof(uint16_t));
+  if (pArray == NULL) {
+    return -1;
+  }
+
+  int32_t n = 0;
+  for (int32_t i = 0; i < BITMAP_BITSET_WORDS; ++i) {
+    uint64_t w = pContainer->pBits[i];
+    while (w != 0) {
+      pArray[n++] = (uint16_t)((i << 6) + BUILDIN_CTZL(w));
+      w &= (w - 1);
+    }
+  }
+
+  assert(n == pContainer->num);
+
+  tfree(pContainer->pBits);
+  pContainer->pArray = pArray;
+  pContainer->capacity = MAX(pContainer->num, 1);
+  return 0;
+}
+
+static int32_t containerClone(SBitmapContainer *pDst, const SBitmapContainer *pSrc) {
+  *pDst = *pSrc;
+  pDst->pArray = NULL;
+  pDst->pBits = NULL;
+
+  if (pSrc->pBits != NULL) {
+    pDst->pBits = malloc(BITMAP_BITSET_WORDS * sizeof(uint64_t));
+    if (pDst->pBits == NULL) {
+      return -1;
+    }
+
+    memcpy(pDst->pBits, pSrc->pBits, BITMAP_BITSET_WORDS * sizeof(uint64_t));
+  } else {
+    pDst->capacity = MAX(pSrc->num, 1);
+    pDst->pArray = malloc(pDst->capacity * sizeof(uint16_t));
+    if (pDst->pArray == NULL) {
+      return -1;
+    }
+
+    memcpy(pDst->pArray, pSrc->pArray, pSrc->num * sizeof(uint16_t));
+  }
+
+  return 0;
+}
+
+static int32_t containerAdd(SBitmapContainer *pContainer, uint16_t val) {
+  if (pContainer->pBits == NULL) {
+    int32_t idx = arraySearch(pContainer->pArray, pContainer->num, val);
+    if (idx >= 0) {
+      return 0;
+    }
+
+    if (pContainer->num < BITMAP_ARRAY_MAX_SIZE) {
+      if (pContainer->num >= pContainer->capacity) {
+        int32_t   capacity = MIN(MAX(pContainer->capacity << 1, 4), BITMAP_ARRAY_MAX_SIZE);
+        uint16_t *tmp = realloc(pContainer->pArray, capacity * sizeof(uint16_t));
+        if (tmp == NULL) {
+          return -1;
+        }
+
+        pContainer->pArray = tmp;
+        pContainer->capacity = capacity;
+      }
+
+      int32_t pos = -(idx + 1);
+      memmove(&pContainer->pArray[pos + 1], &pContainer->pArray[pos], (pContainer->num - pos) * sizeof(uint16_t));
+      pContainer->pArray[pos] = val;
+      pContainer->num++;
+      return 0;
+    }
+
+    if (containerToBitset(pContainer) != 0) {
+      return -1;
+    }
+  }
+
+  uint64_t mask = (1ULL << (val & 63));
+  if ((pContainer->pBits[val >> 6] & mask) == 0) {
+    pContainer->pBits[val >> 6] |= mask;
+    pContainer->num++;
+  }
+
+  return 0;
+}
+
+static void containerRemove(SBitmapContainer *pContainer, uint16_t val) {
+  if (pContainer->pBits == NULL) {
+    int32_t idx = arraySearch(pContainer->pArray, pContainer->num, val);
+    if (idx >= 0) {
+      memmove(&pContainer->pArray[idx], &pContainer->pArray[idx + 1], (pContainer->num - idx - 1) * sizeof(uint16_t));
+      pContainer->num--;
+    }
+
+    return;
+  }
+
+  uint64_t mask = (1ULL << (val & 63));
+  if ((pContainer->pBits[val >> 6] & mask) != 0) {
+    pContainer->pBits[val >> 6] &= ~mask;
+    pContainer->num--;
+
+    // keep it as a bitset if failed, which is still correct
+    if (pContainer->num <= BITMAP_ARRAY_MAX_SIZE / 2) {
+      containerToArray(pContainer);
+    }
+  }
+}
+
+static bool containerContains(const SBitmapContainer *pContainer, uint16_t val) {
+  if (pContainer->pBits != NULL) {
+    return (pContainer->pBits[val >> 6] & (1ULL << (val & 63))) != 0;
+  }
+
+  return arraySearch(pContainer->pArray, pContainer->num, val) >= 0;
+}
+
+static int32_t containerAnd(SBitmapContainer *pDst, const SBitmapContainer *pSrc) {
+  if (pDst->pBits == NULL) {  // filter the array in place
+    int32_t n = 0;
+    for (int32_t i = 0; i < pDst->num; ++i) {
+      if (containerContains(pSrc, pDst->pArray[i])) {
+        pDst->pArray[n++] = pDst->pArray[i];
+      }
+    }
+
+    pDst->num = n;
+    return 0;
+  }
+
+  if (pSrc->pBits == NULL) {  // the result is a subset of the array of pSrc
+    uint16_t *pArray = malloc(MAX(pSrc->num, 1) * sizeof(uint16_t));
+    if (pArray == NULL) {
+      return -1;
+    }
+
+    int32_t n = 0;
+    for (int32_t i = 0; i < pSrc->num; ++i) {
+      if (containerContains(pDst, pSrc->pArray[i])) {
+        pArray[n++] = pSrc->pArray[i];
+      }
+    }
+
+    tfree(pDst->pBits);
+    pDst->pArray = pArray;
+    pDst->capacity = MAX(pSrc->num, 1);
+    pDst->num = n;
+    return 0;
+  }
+
+  int32_t num = 0;
+  for (int32_t i = 0; i < BITMAP_BITSET_WORDS; ++i) {
+    pDst->pBits[i] &= pSrc->pBits[i];
+    num += bitCount(pDst->pBits[i]);
+  }
+
+  pDst->num = num;
+  if (num <= BITMAP_ARRAY_MAX_SIZE) {
+    containerToArray(pDst);
+  }
+
+  return 0;
+}
+
+static int32_t containerOr(SBitmapContainer *pDst, const SBitmapContainer *pSrc) {
+  if (pDst->pBits == NULL && pSrc->pBits == NULL) {  // merge two sorted arrays
+    uint16_t *pArray = malloc((pDst->num + pSrc->num) * sizeof(uint16_t));
+    if (pArray == NULL) {
+      return -1;
+    }
+
+    int32_t i = 0, j = 0, n = 0;
+    while (i < pDst->num && j < pSrc->num) {
+      if (pDst->pArray[i] < pSrc->pArray[j]) {
+        pArray[n++] = pDst->pArray[i++];
+      } else if (pDst->pArray[i] > pSrc->pArray[j]) {
+        pArray[n++] = pSrc->pArray[j++];
+      } else {
+        pArray[n++] = pDst->pArray[i++];
+        j++;
+      }
+    }
+
+    while (i < pDst->num) {
+      pArray[n++] = pDst->pArray[i++];
+    }
+
+    while (j < pSrc->num) {
+      pArray[n++] = pSrc->pArray[j++];
+    }
+
+    tfree(pDst->pArray);
+    pDst->pArray = pArray;
+    pDst->capacity = pDst->num + pSrc->num;
+    pDst->num = n;
+
+    if (n > BITMAP_ARRAY_MAX_SIZE) {
+      return containerToBitset(pDst);
+    }
+
+    return 0;
+  }
+
+  if (pDst->pBits == NULL) {  // set the values of pDst into a copy of the bitset of pSrc
+    uint64_t *pBits = malloc(BITMAP_BITSET_WORDS * sizeof(uint64_t));
+    if (pBits == NULL) {
+      return -1;
+    }
+
+    memcpy(pBits, pSrc->pBits, BITMAP_BITSET_WORDS * sizeof(uint64_t));
+
+    int32_t num = pSrc->num;
+    for (int32_t i = 0; i < pDst->num; ++i) {
+      uint16_t v = pDst->pArray[i];
+      uint64_t mask = (1ULL << (v & 63));
+
+      if ((pBits[v >> 6] & mask) == 0) {
+        pBits[v >> 6] |= mask;
+        num++;
+      }
+    }
+
+    tfree(pDst->pArray);
+    pDst->capacity = 0;
+    pDst->pBits = pBits;
+    pDst->num = num;
+    return 0;
+  }
+
+  if (pSrc->pBits == NULL) {
+    for (int32_t i = 0; i < pSrc->num; ++i) {
+      containerAdd(pDst, pSrc->pArray[i]);
+    }
+
+    return 0;
+  }
+
+  int32_t num = 0;
+  for (int32_t i = 0; i < BITMAP_BITSET_WORDS; ++i) {
+    pDst->pBits[i] |= pSrc->pBits[i];
+    num += bitCount(pDst->pBits[i]);
+  }
+
+  pDst->num = num;
+  return 0;
+}
+
+/*
+ * insert an empty container at pos
+ */
+static SBitmapContainer *bitmapInsertContainer(tBitmap *pBitmap, int32_t pos, uint16_t key) {
+  if (pBitmap->numOfContainers >= pBitmap->capacity) {
+    int32_t           capacity = MAX(pBitmap->capacity << 1, 4);
+    SBitmapContainer *tmp = realloc(pBitmap->pContainers, capacity * sizeof(SBitmapContainer));
+    if (tmp == NULL) {
+      return NULL;
+    }
+
+    pBitmap->pContainers = tmp;
+    pBitmap->capacity = capacity;
+  }
+
+  SBitmapContainer *pContainers = pBitmap->pContainers;
+  memmove(&pContainers[pos + 1], &pContainers[pos], (pBitmap->numOfContainers - pos) * sizeof(SBitmapContainer));
+  memset(&pContainers[pos], 0, sizeof(SBitmapContainer));
+
+  pContainers[pos].key = key;
+  pBitmap->numOfContainers++;
+
+  return &pContainers[pos];
+}
+
+static void bitmapRemoveContainer(tBitmap *pBitmap, int32_t idx) {
+  SBitmapContainer *pContainers = pBitmap->pContainers;
+  containerFree(&pContainers[idx]);
+
+  memmove(&pContainers[idx], &pContainers[idx + 1], (pBitmap->numOfContainers - idx - 1) * sizeof(SBitmapContainer));
+  pBitmap->numOfContainers--;
+}
+
+tBitmap *tBitmapCreate() { return calloc(1, sizeof(tBitmap)); }
+
+void tBitmapDestroy(tBitmap *pBitmap) {
+  if (pBitmap == NULL) {
+    return;
+  }
+
+  for (int32_t i = 0; i < pBitmap->numOfContainers; ++i) {
+    containerFree(&pBitmap->pContainers[i]);
+  }
+
+  tfree(pBitmap->pContainers);
+  free(pBitmap);
+}
+
+tBitmap *tBitmapClone(const tBitmap *pBitmap) {
+  tBitmap *pNew = tBitmapCreate();
+  if (pNew == NULL || pBitmap->numOfContainers == 0) {
+    return pNew;
+  }
+
+  pNew->pContainers = calloc(pBitmap->numOfContainers, sizeof(SBitmapContainer));
+  if (pNew->pContainers == NULL) {
+    free(pNew);
+    return NULL;
+  }
+
+  pNew->capacity = pBitmap->numOfContainers;
+
+  for (int32_t i = 0; i < pBitmap->numOfContainers; ++i) {
+    if (containerClone(&pNew->pContainers[i], &pBitmap->pContainers[i]) != 0) {
+      containerFree(&pNew->pContainers[i]);
+      tBitmapDestroy(pNew);
+      return NULL;
+    }
+
+    pNew->numOfContainers++;
+  }
+
+  return pNew;
+}
+
+int32_t tBitmapAdd(tBitmap *pBitmap, uint32_t val) {
+  uint16_t key = (uint16_t)(val >> 16);
+  int32_t  idx = containerSearch(pBitmap, key);
+
+  SBitmapContainer *pContainer = NULL;
+  if (idx >= 0) {
+    pContainer = &pBitmap->pContainers[idx];
+  } else {
+    pContainer = bitmapInsertContainer(pBitmap, -(idx + 1), key);
+    if (pContainer == NULL) {
+      return -1;
+    }
+  }
+
+  int32_t ret = containerAdd(pContainer, (uint16_t)(val & 0xFFFF));
+  if (pContainer->num == 0) {
+    bitmapRemoveContainer(pBitmap, (int32_t)(pContainer - pBitmap->pContainers));
+  }
+
+  return ret;
+}
+
+void tBitmapRemove(tBitmap *pBitmap, uint32_t val) {
+  int32_t idx = containerSearch(pBitmap, (uint16_t)(val >> 16));
+  if (idx < 0) {
+    return;
+  }
+
+  containerRemove(&pBitmap->pContainers[idx], (uint16_t)(val & 0xFFFF));
+  if (pBitmap->pContainers[idx].num == 0) {
+    bitmapRemoveContainer(pBitmap, idx);
+  }
+}
+
+bool tBitmapContains(const tBitmap *pBitmap, uint32_t val) {
+  int32_t idx = containerSearch(pBitmap, (uint16_t)(val >> 16));
+  if (idx < 0) {
+    return false;
+  }
+
+  return containerContains(&pBitmap->pContainers[idx], (uint16_t)(val & 0xFFFF));
+}
+
+int64_t tBitmapCardinality(const tBitmap *pBitmap) {
+  int64_t num = 0;
+  for (int32_t i = 0; i < pBitmap->numOfContainers; ++i) {
+    num += pBitmap->pContainers[i].num;
+  }
+
+  return num;
+}
+
+int32_t tBitmapAnd(tBitmap *pDst, const tBitmap *pSrc) {
+  int32_t ret = 0;
+  int32_t n = 0;
+  int32_t j = 0;
+
+  for (int32_t i = 0; i < pDst->numOfContainers; ++i) {
+    SBitmapContainer *pContainer = &pDst->pContainers[i];
+
+    while (j < pSrc->numOfContainers && pSrc->pContainers[j].key < pContainer->key) {
+      j++;
+    }
+
+    if (j < pSrc->numOfContainers && pSrc->pContainers[j].key == pContainer->key) {
+      if (containerAnd(pContainer, &pSrc->pContainers[j]) != 0) {
+        ret = -1;
+      }
+    } else {
+      containerFree(pContainer);
+    }
+
+    if (pContainer->num == 0) {
+      containerFree(pContainer);
+    } else {
+      pDst->pContainers[n++] = *pContainer;
+    }
+  }
+
+  pDst->numOfContainers = n;
+  return ret;
+}
+
+int32_t tBitmapOr(tBitmap *pDst, const tBitmap *pSrc) {
+  int32_t ret = 0;
+
+  for (int32_t i = 0; i < pSrc->numOfContainers; ++i) {
+    const SBitmapContainer *pContainer = &pSrc->pContainers[i];
+
+    int32_t idx = containerSearch(pDst, pContainer->key);
+    if (idx >= 0) {
+      if (containerOr(&pDst->pContainers[idx], pContainer) != 0) {
+        ret = -1;
+      }
+
+      continue;
+    }
+
+    SBitmapContainer *pNew = bitmapInsertContainer(pDst, -(idx + 1), pContainer->key);
+    if (pNew == NULL || containerClone(pNew, pContainer) != 0) {
+      if (pNew != NULL) {
+        bitmapRemoveContainer(pDst, -(idx + 1));
+      }
+
+      ret = -1;
+    }
+  }
+
+  return ret;
+}
+
+int64_t tBitmapToArray(const tBitmap *pBitmap, uint32_t *pDst) {
+  int64_t n = 0;
+
+  for (int32_t i = 0; i < pBitmap->numOfContainers; ++i) {
+    const SBitmapContainer *pContainer = &pBitmap->pContainers[i];
+    uint32_t                high = ((uint32_t)pContainer->key) << 16;
+
+    if (pContainer->pBits == NULL) {
+      for (int32_t j = 0; j < pContainer->num; ++j) {
+        pDst[n++] = high | pContainer->pArray[j];
+      }
+    } else {
+      for (int32_t j = 0; j < BITMAP_BITSET_WORDS; ++j) {
+        uint64_t w = pContainer->pBits[j];
+        while (w != 0) {
+          pDst[n++] = high | (uint32_t)((j << 6) + BUILDIN_CTZL(w));
+          w &= (w - 1);
+        }
+      }
+    }
+  }
+
+  return n;
+}
@@ -36,7 +36,11 @@
  *   better when there are a lot of consecutive true values or false values.
  *
  * STRING Compression Algorithm:
- *   We us LZ4 method to compress the string type.
+ *   We us LZ4 method to compress the string type. For binary and nchar columns, a block with no more than
+ *   STRING_DICT_MAX_ENTRIES distinct values is encoded with a dictionary instead: the distinct values are stored
+ *   once and each row is represented by the index of its value, either bit packed or as runs of the same index,
+ *   whichever is shorter. Such a block can be decoded without LZ4 and a filter can be evaluated on the dictionary
+ *   entries instead of each row.
  *
  * FLOAT Compression Algorithm:
  *   We use the same method with Akumuli to compress float and double types. The compression
@@ -52,10 +56,22 @@
 #include "tscompression.h"
 #include "tsdb.h"
 #include "ttypes.h"
+#include "tutil.h"
 
 const int TEST_NUMBER = 1;
 #define is_bigendian() ((*(char *)&TEST_NUMBER) == 0)
 #define SIMPLE8B_MAX_INT64 ((uint64_t)2305843009213693951L)
+#define SIMPLE8B_MAX_ELEMS 240
+
+/*
+ * The decoders are written as plain loops without data dependent branches, so that the compiler can vectorize them.
+ * Where ifunc is available, they are built for AVX2 in addition to the baseline and the best one is picked at load.
+ */
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__)
+#define DECOMP_TARGET_CLONES __attribute__((target_clones("avx2", "default")))
+#else
+#define DECOMP_TARGET_CLONES
+#endif
 
 // Function declarations
 int tsCompressINTImp(const char *const input, const int nelements, char *const output, const char type);
@@ -64,6 +80,10 @@ int tsCompressBoolImp(const char *const input, const int nelements, char *const
 int tsDecompressBoolImp(const char *const input, const int nelements, char *const output);
 int tsCompressStringImp(const char *const input, int inputSize, char *const output, int outputSize);
 int tsDecompressStringImp(const char *const input, int compressedSize, char *const output, int outputSize);
+int tsCompressStringDictImp(const char *const input, int inputSize, const int nelements, char *const output,
+                            int outputSize);
+int tsDecompressStringDictImp(const char *const input, int compressedSize, const int nelements, char *const output,
+                              int outputSize);
 int tsCompressTimestampImp(const char *const input, const int nelements, char *const output);
 int tsDecompressTimestampImp(const char *const input, const int nelements, char *const output);
 int tsCompressDoubleImp(const char *const input, const int nelements, char *const output);
@@ -195,11 +215,20 @@ int tsDecompressBool(const char *const input, int compressedSize, const int nele
 
 int tsCompressString(const char *const input, int inputSize, const int nelements, char *const output, int outputSize,
                      char algorithm, char *const buffer, int bufferSize) {
+  if (algorithm != NO_COMPRESSION) {
+    int len = tsCompressStringDictImp(input, inputSize, nelements, output, outputSize);
+    if (len > 0) return len;
+  }
+
   return tsCompressStringImp(input, inputSize, output, outputSize);
 }
 
 int tsDecompressString(const char *const input, int compressedSize, const int nelements, char *const output,
                        int outputSize, char algorithm, char *const buffer, int bufferSize) {
+  if (input[0] == STRING_DICT_COMP) {
+    return tsDecompressStringDictImp(input, compressedSize, nelements, output, outputSize);
+  }
+
   return tsDecompressStringImp(input, compressedSize, output, outputSize);
 }
 
@@ -412,6 +441,57 @@ int tsCompressINTImp(const char *const input, const int nelements, char *const o
   return opos;
 }
 
+/*
+ * unpack the zigzag encoded deltas of one simple8b word, the constant bit width of each selector lets the compiler
+ * unroll the loop with fixed shifts
+ */
+#define SIMPLE8B_UNPACK(w, bit, elems, values)                                        \
+  do {                                                                                \
+    for (int _i = 0; _i < (elems); _i++) {                                            \
+      uint64_t _zigzag_value = ((w) >> (4 + (bit) * _i)) & INT64MASK(bit);            \
+      (values)[_i] = (int64_t)((_zigzag_value >> 1) ^ -(_zigzag_value & 1));          \
+    }                                                                                 \
+  } while (0)
+
+/* words are unpacked into a batch of deltas, the prefix sum and narrowing are done per batch */
+#define SIMPLE8B_BATCH_ELEMS 1024
+
+static FORCE_INLINE void tsUnpackSimple8bWord(uint64_t w, int elems, int64_t *values) {
+  // Selector value:              0    1   2   3   4   5   6   7   8  9  10  11
+  // 12  13  14  15
+  static const char bit_per_integer[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
+  static const int  selector_to_elems[] = {240, 120, 60, 30, 20, 15, 12, 10, 8, 7, 6, 5, 4, 3, 2, 1};
+
+  int selector = (int)(w & INT64MASK(4));
+
+  if (elems < selector_to_elems[selector]) {  // the last word may be partially used
+    SIMPLE8B_UNPACK(w, bit_per_integer[selector], elems, values);
+    return;
+  }
+
+  switch (selector) {
+    case 0:
+    case 1:
+      memset(values, 0, elems * LONG_BYTES);
+      break;
+    case 2: SIMPLE8B_UNPACK(w, 1, 60, values); break;
+    case 3: SIMPLE8B_UNPACK(w, 2, 30, values); break;
+    case 4: SIMPLE8B_UNPACK(w, 3, 20, values); break;
+    case 5: SIMPLE8B_UNPACK(w, 4, 15, values); break;
+    case 6: SIMPLE8B_UNPACK(w, 5, 12, values); break;
+    case 7: SIMPLE8B_UNPACK(w, 6, 10, values); break;
+    case 8: SIMPLE8B_UNPACK(w, 7, 8, values); break;
+    case 9: SIMPLE8B_UNPACK(w, 8, 7, values); break;
+    case 10: SIMPLE8B_UNPACK(w, 10, 6, values); break;
+    case 11: SIMPLE8B_UNPACK(w, 12, 5, values); break;
+    case 12: SIMPLE8B_UNPACK(w, 15, 4, values); break;
+    case 13: SIMPLE8B_UNPACK(w, 20, 3, values); break;
+    case 14: SIMPLE8B_UNPACK(w, 30, 2, values); break;
+    default: SIMPLE8B_UNPACK(w, 60, 1, values); break;
+  }
+}
+
+DECOMP_TARGET_CLONES
 int tsDecompressINTImp(const char *const input, const int nelements, char *const output, const char type) {
   int word_length = 0;
   switch (type) {
@@ -438,63 +518,52 @@ int tsDecompressINTImp(const char *const input, const int nelements, char *const
     return nelements * word_length;
   }
 
-  // Selector value:              0    1   2   3   4   5   6   7   8  9  10  11
-  // 12  13  14  15
-  char bit_per_integer[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
-  int  selector_to_elems[] = {240, 120, 60, 30, 20, 15, 12, 10, 8, 7, 6, 5, 4, 3, 2, 1};
+  static const int selector_to_elems[] = {240, 120, 60, 30, 20, 15, 12, 10, 8, 7, 6, 5, 4, 3, 2, 1};
 
   const char *ip = input + 1;
   int         count = 0;
-  int         _pos = 0;
   int64_t     prev_value = 0;
+  int64_t     values[SIMPLE8B_BATCH_ELEMS + SIMPLE8B_MAX_ELEMS];
 
-  while (1) {
-    if (count == nelements) break;
-
-    uint64_t w = 0;
-    memcpy(&w, ip, LONG_BYTES);
+  while (count < nelements) {
+    int n = 0;
+    while (n < SIMPLE8B_BATCH_ELEMS && count + n < nelements) {
+      uint64_t w = 0;
+      memcpy(&w, ip, LONG_BYTES);
+      ip += LONG_BYTES;
 
-    char selector = (char)(w & INT64MASK(4));  // selector = 4
-    char bit = bit_per_integer[selector];      // bit = 3
-    int  elems = selector_to_elems[selector];
+      int elems = selector_to_elems[w & INT64MASK(4)];
+      if (elems > nelements - count - n) elems = nelements - count - n;
 
-    for (int i = 0; i < elems; i++) {
-      uint64_t zigzag_value;
+      tsUnpackSimple8bWord(w, elems, values + n);
+      n += elems;
+    }
 
-      if (selector == 0 || selector == 1) {
-        zigzag_value = 0;
-      } else {
-        zigzag_value = ((w >> (4 + bit * i)) & INT64MASK(bit));
-      }
-      int64_t diff = (zigzag_value >> 1) ^ -(zigzag_value & 1);
-      int64_t curr_value = diff + prev_value;
-      prev_value = curr_value;
+    for (int i = 0; i < n; i++) {
+      prev_value += values[i];
+      values[i] = prev_value;
+    }
 
-      switch (type) {
-        case TSDB_DATA_TYPE_BIGINT:
-          *((int64_t *)output + _pos) = curr_value;
-          _pos++;
-          break;
-        case TSDB_DATA_TYPE_INT:
-          *((int32_t *)output + _pos) = curr_value;
-          _pos++;
-          break;
-        case TSDB_DATA_TYPE_SMALLINT:
-          *((int16_t *)output + _pos) = curr_value;
-          _pos++;
-          break;
-        case TSDB_DATA_TYPE_TINYINT:
-          *((int8_t *)output + _pos) = curr_value;
-          _pos++;
-          break;
-        default:
-          perror("Wrong integer types.\n");
-          exit(1);
-      }
-      count++;
-      if (count == nelements) break;
+    // narrow to the output type in a separate loop, instead of switching on every value
+    switch (type) {
+      case TSDB_DATA_TYPE_BIGINT:
+        memcpy((int64_t *)output + count, values, n * LONG_BYTES);
+        break;
+      case TSDB_DATA_TYPE_INT:
+        for (int i = 0; i < n; i++) *((int32_t *)output + count + i) = (int32_t)values[i];
+        break;
+      case TSDB_DATA_TYPE_SMALLINT:
+        for (int i = 0; i < n; i++) *((int16_t *)output + count + i) = (int16_t)values[i];
+        break;
+      case TSDB_DATA_TYPE_TINYINT:
+        for (int i = 0; i < n; i++) *((int8_t *)output + count + i) = (int8_t)values[i];
+        break;
+      default:
+        perror("Wrong integer types.\n");
+        exit(1);
     }
-    ip += LONG_BYTES;
+
+    count += n;
   }
 
   return nelements * word_length;
@@ -649,6 +718,230 @@ int tsDecompressStringImp(const char *const input, int compressedSize, char *con
   }
 }
 
+/* --------------------------------------------String Dictionary Compression
+ * ---------------------------------------------- */
+/*
+ * Layout: indicator(1) | mode(1) | bytes(2) | numOfEntries(2) | entries(numOfEntries * bytes) | codes
+ * In STRING_DICT_PACKED mode, codes are the entry indices packed with the least number of bits, in
+ * STRING_DICT_RLE mode they are runs of index(1) | length(2).
+ */
+#define STRING_DICT_PACKED 0
+#define STRING_DICT_RLE 1
+#define STRING_DICT_HEAD_SIZE 6
+#define STRING_DICT_HASH_SLOTS 512
+#define STRING_DICT_MAX_RUN 65535
+
+static FORCE_INLINE int tsStringDictBits(int numOfEntries) {
+  int bits = 0;
+  while ((1 << bits) < numOfEntries) bits++;
+  return bits;
+}
+
+int tsCompressStringDictImp(const char *const input, int inputSize, const int nelements, char *const output,
+                            int outputSize) {
+  if (nelements <= 1 || inputSize % nelements != 0) return -1;
+
+  const int bytes = inputSize / nelements;
+  if (bytes > INT16_MAX) return -1;
+
+  int16_t  slots[STRING_DICT_HASH_SLOTS];
+  uint8_t *codes = (uint8_t *)malloc(nelements);
+  if (codes == NULL) return -1;
+
+  memset(slots, 0xFF, sizeof(slots));
+
+  const char *entries[STRING_DICT_MAX_ENTRIES];
+  int         numOfEntries = 0;
+
+  for (int i = 0; i < nelements; i++) {
+    const char *val = input + i * bytes;
+
+    // values of adjacent rows are often the same
+    if (i > 0 && memcmp(val, val - bytes, bytes) == 0) {
+      codes[i] = codes[i - 1];
+      continue;
+    }
+
+    uint32_t slot = MurmurHash3_32(val, bytes) & (STRING_DICT_HASH_SLOTS - 1);
+    while (slots[slot] >= 0 && memcmp(entries[slots[slot]], val, bytes) != 0) {
+      slot = (slot + 1) & (STRING_DICT_HASH_SLOTS - 1);
+    }
+
+    if (slots[slot] < 0) {
+      if (numOfEntries == STRING_DICT_MAX_ENTRIES) {  // too many distinct values
+        free(codes);
+        return -1;
+      }
+
+      slots[slot] = numOfEntries;
+      entries[numOfEntries++] = val;
+    }
+
+    codes[i] = (uint8_t)slots[slot];
+  }
+
+  int bits = tsStringDictBits(numOfEntries);
+  int packedSize = (int)(((int64_t)nelements * bits + BITS_PER_BYTE - 1) / BITS_PER_BYTE);
+  int rleSize = 0;
+  for (int i = 0; i < nelements;) {  // runs longer than STRING_DICT_MAX_RUN are split
+    int len = 1;
+    while (i + len < nelements && codes[i + len] == codes[i] && len < STRING_DICT_MAX_RUN) len++;
+    rleSize += 3;
+    i += len;
+  }
+
+  uint8_t mode = (rleSize < packedSize) ? STRING_DICT_RLE : STRING_DICT_PACKED;
+  int     size = STRING_DICT_HEAD_SIZE + numOfEntries * bytes + ((mode == STRING_DICT_RLE) ? rleSize : packedSize);
+  if (size >= inputSize || size > outputSize) {
+    free(codes);
+    return -1;
+  }
+
+  int16_t width = (int16_t)bytes;
+  int16_t num = (int16_t)numOfEntries;
+
+  output[0] = STRING_DICT_COMP;
+  output[1] = mode;
+  memcpy(output + 2, &width, sizeof(int16_t));
+  memcpy(output + 4, &num, sizeof(int16_t));
+
+  char *pos = output + STRING_DICT_HEAD_SIZE;
+  for (int i = 0; i < numOfEntries; i++) {
+    memcpy(pos, entries[i], bytes);
+    pos += bytes;
+  }
+
+  if (mode == STRING_DICT_RLE) {
+    for (int i = 0; i < nelements;) {
+      uint16_t len = 1;
+      while (i + len < nelements && codes[i + len] == codes[i] && len < STRING_DICT_MAX_RUN) len++;
+
+      *(uint8_t *)pos = codes[i];
+      memcpy(pos + 1, &len, sizeof(uint16_t));
+      pos += 3;
+      i += len;
+    }
+  } else if (bits > 0) {
+    uint64_t buf = 0;
+    int      nbits = 0;
+    for (int i = 0; i < nelements; i++) {
+      buf |= (uint64_t)codes[i] << nbits;
+      nbits += bits;
+      if (nbits >= BITS_PER_BYTE * 4) {
+        memcpy(pos, &buf, 4);
+        pos += 4;
+        buf >>= BITS_PER_BYTE * 4;
+        nbits -= BITS_PER_BYTE * 4;
+      }
+    }
+
+    while (nbits > 0) {
+      *pos++ = (char)(buf & 0xFF);
+      buf >>= BITS_PER_BYTE;
+      nbits -= BITS_PER_BYTE;
+    }
+  }
+
+  assert(pos - output == size);
+  free(codes);
+  return size;
+}
+
+static int tsDecodeStringDictCodes(const char *const input, int compressedSize, const int nelements,
+                                   uint8_t *const codes) {
+  int16_t bytes = 0, numOfEntries = 0;
+  memcpy(&bytes, input + 2, sizeof(int16_t));
+  memcpy(&numOfEntries, input + 4, sizeof(int16_t));
+
+  const char *pos = input + STRING_DICT_HEAD_SIZE + numOfEntries * bytes;
+  const char *end = input + compressedSize;
+
+  if (input[1] == STRING_DICT_RLE) {
+    int i = 0;
+    while (i < nelements && pos + 3 <= end) {
+      uint16_t len = 0;
+      memcpy(&len, pos + 1, sizeof(uint16_t));
+      if (len > nelements - i) return -1;
+
+      memset(codes + i, *(uint8_t *)pos, len);
+      i += len;
+      pos += 3;
+    }
+
+    return (i == nelements) ? 0 : -1;
+  }
+
+  int bits = tsStringDictBits(numOfEntries);
+  if (bits == 0) {
+    memset(codes, 0, nelements);
+    return 0;
+  }
+
+  if (pos + ((int64_t)nelements * bits + BITS_PER_BYTE - 1) / BITS_PER_BYTE > end) return -1;
+
+  const uint8_t *src = (const uint8_t *)pos;
+  const uint8_t  mask = (uint8_t)INT8MASK(bits);
+
+  uint32_t buf = 0;
+  int      nbits = 0;
+  for (int i = 0; i < nelements; i++) {
+    if (nbits < bits) {
+      buf |= (uint32_t)(*src++) << nbits;
+      nbits += BITS_PER_BYTE;
+    }
+
+    codes[i] = (uint8_t)(buf & mask);
+    buf >>= bits;
+    nbits -= bits;
+  }
+
+  return 0;
+}
+
+int tsDecompressStringDictImp(const char *const input, int compressedSize, const int nelements, char *const output,
+                              int outputSize) {
+  int16_t bytes = 0, numOfEntries = 0;
+  memcpy(&bytes, input + 2, sizeof(int16_t));
+  memcpy(&numOfEntries, input + 4, sizeof(int16_t));
+
+  int size = nelements * bytes;
+  if (size > outputSize || bytes <= 0 || numOfEntries <= 0) {
+    perror("Wrong dictionary compressed string!\n");
+    exit(EXIT_FAILURE);
+  }
+
+  /*
+   * the codes are decoded into the tail of output and expanded from the head, the value of row i never overwrites
+   * the code of a later row since each code takes no more space than a value.
+   */
+  uint8_t *codes = (uint8_t *)output + size - nelements;
+  if (tsDecodeStringDictCodes(input, compressedSize, nelements, codes) != 0) {
+    perror("Wrong dictionary compressed string!\n");
+    exit(EXIT_FAILURE);
+  }
+
+  const char *entries = input + STRING_DICT_HEAD_SIZE;
+  for (int i = 0; i < nelements; i++) {
+    uint8_t code = codes[i];
+    memcpy(output + i * bytes, entries + code * bytes, bytes);
+  }
+
+  return size;
+}
+
+int tsGetStringDict(const char *const input, int compressedSize, const int nelements, const char **entries,
+                    uint8_t *const codes) {
+  if (compressedSize < STRING_DICT_HEAD_SIZE || input[0] != STRING_DICT_COMP) return 0;
+
+  int16_t numOfEntries = 0;
+  memcpy(&numOfEntries, input + 4, sizeof(int16_t));
+
+  if (codes != NULL && tsDecodeStringDictCodes(input, compressedSize, nelements, codes) != 0) return 0;
+
+  *entries = input + STRING_DICT_HEAD_SIZE;
+  return numOfEntries;
+}
+
 /* --------------------------------------------Timestamp Compression
  * ---------------------------------------------- */
 // TODO: Take care here, we assumes little endian encoding.
@@ -744,6 +1037,21 @@ _exit_over:
   return nelements * LONG_BYTES + 1;
 }
 
+/*
+ * read a delta of delta stored in nbytes little endian bytes, and zigzag decode it
+ */
+static FORCE_INLINE int64_t tsReadDeltaOfDelta(const char *const input, int ipos, int nbytes) {
+  uint64_t dd = 0;
+  if (is_bigendian()) {
+    memcpy((char *)(&dd) + LONG_BYTES - nbytes, input + ipos, nbytes);
+  } else {
+    for (int i = 0; i < nbytes; i++) dd |= (uint64_t)(uint8_t)input[ipos + i] << (BITS_PER_BYTE * i);
+  }
+
+  return (dd >> 1) ^ -(dd & 1);
+}
+
+DECOMP_TARGET_CLONES
 int tsDecompressTimestampImp(const char *const input, const int nelements, char *const output) {
   assert(nelements >= 0);
   if (nelements == 0) return 0;
@@ -754,60 +1062,39 @@ int tsDecompressTimestampImp(const char *const input, const int nelements, char
   } else if (input[0] == 1) {  // Decompress
     int64_t *ostream = (int64_t *)output;
 
-    int     ipos = 1, opos = 0;
-    int8_t  nbytes = 0;
-    int64_t prev_value = 0;
-    int64_t prev_delta = 0;
-    int64_t delta_of_delta = 0;
-
-    while (1) {
+    /*
+     * the first pass only parses the variable length fields into delta of delta, it is the part with branches. The
+     * two prefix sums to rebuild the values are done in a second pass over the output.
+     */
+    int ipos = 1;
+    for (int opos = 0; opos < nelements; opos += 2) {
       uint8_t flags = input[ipos++];
-      // Decode dd1
-      uint64_t dd1 = 0;
-      nbytes = flags & INT8MASK(4);
-      if (nbytes == 0) {
-        delta_of_delta = 0;
-      } else {
-        if (is_bigendian()) {
-          memcpy(&dd1 + LONG_BYTES - nbytes, input + ipos, nbytes);
-        } else {
-          memcpy(&dd1, input + ipos, nbytes);
-        }
-        delta_of_delta = (dd1 >> 1) ^ -(dd1 & 1);
-      }
-      ipos += nbytes;
-      if (opos == 0) {
-        prev_value = delta_of_delta;
-        prev_delta = 0;
-        ostream[opos++] = delta_of_delta;
-      } else {
-        prev_delta = delta_of_delta + prev_delta;
-        prev_value = prev_value + prev_delta;
-        ostream[opos++] = prev_value;
-      }
-      if (opos == nelements) return nelements * LONG_BYTES;
+      int     nbytes1 = flags & INT8MASK(4);
+      int     nbytes2 = (flags >> 4) & INT8MASK(4);
 
-      // Decode dd2
-      uint64_t dd2 = 0;
-      nbytes = (flags >> 4) & INT8MASK(4);
-      if (nbytes == 0) {
-        delta_of_delta = 0;
-      } else {
-        if (is_bigendian()) {
-          memcpy(&dd2 + LONG_BYTES - nbytes, input + ipos, nbytes);
-        } else {
-          memcpy(&dd2, input + ipos, nbytes);
-        }
-        // zigzag_decoding
-        delta_of_delta = (dd2 >> 1) ^ -(dd2 & 1);
+      ostream[opos] = tsReadDeltaOfDelta(input, ipos, nbytes1);
+      ipos += nbytes1;
+
+      if (opos + 1 < nelements) {
+        ostream[opos + 1] = tsReadDeltaOfDelta(input, ipos, nbytes2);
+        ipos += nbytes2;
       }
-      ipos += nbytes;
-      prev_delta = delta_of_delta + prev_delta;
-      prev_value = prev_value + prev_delta;
-      ostream[opos++] = prev_value;
-      if (opos == nelements) return nelements * LONG_BYTES;
     }
 
+    // the first delta of delta is the first value, and the delta of it is 0
+    int64_t prev_delta = 0;
+    for (int i = 1; i < nelements; i++) {
+      prev_delta += ostream[i];
+      ostream[i] = prev_delta;
+    }
+
+    int64_t prev_value = ostream[0];
+    for (int i = 1; i < nelements; i++) {
+      prev_value += ostream[i];
+      ostream[i] = prev_value;
+    }
+
+    return nelements * LONG_BYTES;
   } else {
     assert(0);
   }
@@ -85,7 +85,9 @@ void tExtMemBufferDestroy(tExtMemBuffer **pMemBuffer) {
     return;
   }
 
-  // release flush out info link
+  // release the runs kept in memory and flush out info link
+  tExtMemBufferDropMemRuns(*pMemBuffer);
+
   tFileMeta *pFileMeta = &(*pMemBuffer)->fileMeta;
   if (pFileMeta->flushoutData.nAllocSize != 0 && pFileMeta->flushoutData.pFlushoutInfo != NULL) {
     tfree(pFileMeta->flushoutData.pFlushoutInfo);
@@ -236,17 +238,14 @@ static bool tExtMemBufferUpdateFlushoutInfo(tExtMemBuffer *pMemBuffer) {
       return false;
     }
 
+    /*
+     * the runs kept in memory do not occupy any page in file, so the start page is derived from the file size
+     * instead of the previous flush out entry. Only the page still in buffer is flushed out to disk.
+     */
     tFlushoutInfo *pFlushoutInfo = &pFileMeta->flushoutData.pFlushoutInfo[pFileMeta->flushoutData.nLength];
-    if (pFileMeta->flushoutData.nLength == 0) {
-      pFlushoutInfo->startPageId = 0;
-    } else {
-      pFlushoutInfo->startPageId =
-          pFileMeta->flushoutData.pFlushoutInfo[pFileMeta->flushoutData.nLength - 1].startPageId +
-          pFileMeta->flushoutData.pFlushoutInfo[pFileMeta->flushoutData.nLength - 1].numOfPages;
-    }
-
-    // only the page still in buffer is flushed out to disk
+    pFlushoutInfo->startPageId = pFileMeta->nFileSize - pMemBuffer->numOfPagesInMem;
     pFlushoutInfo->numOfPages = pMemBuffer->numOfPagesInMem;
+    pFlushoutInfo->pMemPages = NULL;
     pFileMeta->flushoutData.nLength += 1;
   } else {
     // always update the first flushout array in single_flush_model
@@ -311,9 +310,78 @@ bool tExtMemBufferFlush(tExtMemBuffer *pMemBuffer) {
   return ret;
 }
 
+bool tExtMemBufferSeal(tExtMemBuffer *pMemBuffer) {
+  assert(pMemBuffer->flushModel == MULTIPLE_APPEND_MODEL);
+
+  if (pMemBuffer->numOfElemsInBuffer == 0) {
+    return true;
+  }
+
+  tFileMeta *pFileMeta = &pMemBuffer->fileMeta;
+  if (pFileMeta->flushoutData.nLength == pFileMeta->flushoutData.nAllocSize && !allocFlushoutInfoEntries(pFileMeta)) {
+    return false;
+  }
+
+  tFilePagesItem **pPages = (tFilePagesItem **)malloc(sizeof(tFilePagesItem *) * pMemBuffer->numOfPagesInMem);
+  if (pPages == NULL) {
+    return false;
+  }
+
+  int32_t numOfPages = 0;
+  for (tFilePagesItem *item = pMemBuffer->pHead; item != NULL; item = item->pNext) {
+    pPages[numOfPages++] = item;
+  }
+
+  assert(numOfPages == pMemBuffer->numOfPagesInMem);
+
+  tFlushoutInfo *pFlushoutInfo = &pFileMeta->flushoutData.pFlushoutInfo[pFileMeta->flushoutData.nLength];
+  pFlushoutInfo->startPageId = 0;
+  pFlushoutInfo->numOfPages = numOfPages;
+  pFlushoutInfo->pMemPages = pPages;
+  pFileMeta->flushoutData.nLength += 1;
+
+  pMemBuffer->numOfPagesInMemRuns += numOfPages;
+
+  // the pages are owned by the run now
+  pMemBuffer->numOfElemsInBuffer = 0;
+  pMemBuffer->numOfPagesInMem = 0;
+  pMemBuffer->pHead = NULL;
+  pMemBuffer->pTail = NULL;
+
+  return true;
+}
+
+void tExtMemBufferDropMemRuns(tExtMemBuffer *pMemBuffer) {
+  tFlushoutData *pFlushoutData = &pMemBuffer->fileMeta.flushoutData;
+  if (pMemBuffer->numOfPagesInMemRuns == 0) {
+    return;
+  }
+
+  // keep the runs in disk, and retain their order
+  uint32_t numOfRuns = 0;
+  for (uint32_t i = 0; i < pFlushoutData->nLength; ++i) {
+    tFlushoutInfo *pInfo = &pFlushoutData->pFlushoutInfo[i];
+    if (pInfo->pMemPages == NULL) {
+      pFlushoutData->pFlushoutInfo[numOfRuns++] = *pInfo;
+      continue;
+    }
+
+    for (uint32_t j = 0; j < pInfo->numOfPages; ++j) {
+      tfree(pInfo->pMemPages[j]);
+    }
+
+    tfree(pInfo->pMemPages);
+  }
+
+  pFlushoutData->nLength = numOfRuns;
+  pMemBuffer->numOfPagesInMemRuns = 0;
+}
+
 void tExtMemBufferClear(tExtMemBuffer *pMemBuffer) {
   if (pMemBuffer == NULL || pMemBuffer->numOfAllElems == 0) return;
 
+  tExtMemBufferDropMemRuns(pMemBuffer);
+
   /*
    * release all data in memory buffer
    */
@@ -350,6 +418,15 @@ bool tExtMemBufferLoadData(tExtMemBuffer *pMemBuffer, tFilePage *pFilePage, int3
     return false;
   }
 
+  if (pInfo->pMemPages != NULL) {
+    if (pageIdx == (int32_t)pInfo->numOfPages) {
+      return false;
+    }
+
+    memcpy(pFilePage, &pInfo->pMemPages[pageIdx]->item, pMemBuffer->nPageSize);
+    return true;
+  }
+
   size_t ret = fseek(pMemBuffer->dataFile, (pInfo->startPageId + pageIdx) * pMemBuffer->nPageSize, SEEK_SET);
   ret = fread(pFilePage, pMemBuffer->nPageSize, 1, pMemBuffer->dataFile);
 
@@ -22,6 +22,7 @@
 #include "tsdb.h"
 #include "tsocket.h"
 #include "tsystem.h"
+#include "ttime.h"
 #include "tutil.h"
 
 // monitor module api
@@ -71,9 +72,17 @@ int tsVnodePeerHBTimer = 1;       // second
 int tsMgmtPeerHBTimer = 1;        // second
 int tsMeterMetaKeepTimer = 7200;  // second
 int tsMetricMetaKeepTimer = 600;  // second
+int tsMeterMetaMissKeepTimer = 3;  // second, time to remember a meter that does not exist
+int tsMetricMergeBufferSize = 64;       // MB, sorted runs of a super table query kept in memory
+int tsMetricSubqueryConcurrency = 64;  // sub-queries of a super table query launched at the same time
+int tsInsertVnodeConcurrency = 16;    // submit msgs of a multi-vnode insertion sent at the same time
+int tsSqlCacheSize = 512;              // parsed select statements kept by the client, 0 means no cache
+int tsQueryParallelism = 1;            // workers scanning the meters of a super table query in one vnode
 
 float tsNumOfThreadsPerCore = 1.0;
 float tsRatioOfQueryThreads = 0.5;
+int   tsNumOfCommitThreads = 0;
+short tsSchedAffinity = 0;
 char  tsPublicIp[TSDB_IPv4ADDR_LEN] = {0};
 char  tsInternalIp[TSDB_IPv4ADDR_LEN] = {0};
 char  tsPrivateIp[TSDB_IPv4ADDR_LEN] = {0};
@@ -85,6 +94,7 @@ short tsCheckHeaderFile = 0;
 int tsSessionsPerVnode = 1000;
 int tsCacheBlockSize = 16384;  // 256 columns
 int tsAverageCacheBlocks = 4;
+int tsBlockCacheSize = 0;  // MB, decompressed file blocks shared by queries
 
 int   tsRowsInFileBlock = 4096;
 float tsFileBlockMinPercent = 0.05;
@@ -92,7 +102,9 @@ float tsFileBlockMinPercent = 0.05;
 short tsNumOfBlocksPerMeter = 100;
 short tsCommitTime = 3600;  // seconds
 short tsCommitLog = 1;
+int   tsGroupCommitTime = 10;  // milliseconds
 short tsCompression = 2;
+short tsBlockBloomFilter = 1;
 short tsDaysPerFile = 10;
 int   tsDaysToKeep = 3650;
 int   tsReplications = 1;
@@ -120,6 +132,7 @@ int tsBalanceStartInterval = 300;  // seconds
 int tsBalancePolicy = 0;           // 1-use sys.montor
 int tsOfflineThreshold = 864000;   // seconds 10days
 int tsMgmtEqualVnodeNum = 0;
+int tsMetricTagIndex = 1;          // 1-index all tag columns of super tables in mgmt
 
 int tsEnableHttpModule = 1;
 int tsEnableMonitorModule = 1;
@@ -158,6 +171,7 @@ int tsHttpCacheSessions = 100;
 int tsHttpSessionExpire = 36000;
 int tsHttpMaxThreads = 2;
 int tsHttpEnableCompress = 0;
+int tsHttpMaxBodySize = 16;  // MB
 int tsHttpEnableRecordSql = 0;
 int tsTelegrafUseFieldNum = 0;
 int tsAdminRowLimit = 10240;
@@ -499,9 +513,15 @@ static void doInitGlobalConfig() {
   tsInitConfigOption(cfg++, "numOfThreadsPerCore", &tsNumOfThreadsPerCore, TSDB_CFG_VTYPE_FLOAT,
                      TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_CLIENT,
                      0, 10, 0, TSDB_CFG_UTYPE_NONE);
+  tsInitConfigOption(cfg++, "schedAffinity", &tsSchedAffinity, TSDB_CFG_VTYPE_SHORT,
+                     TSDB_CFG_CTYPE_B_CONFIG,
+                     0, 1, 0, TSDB_CFG_UTYPE_NONE);
   tsInitConfigOption(cfg++, "ratioOfQueryThreads", &tsRatioOfQueryThreads, TSDB_CFG_VTYPE_FLOAT,
                      TSDB_CFG_CTYPE_B_CONFIG,
                      0.1, 0.9, 0, TSDB_CFG_UTYPE_NONE);
+  tsInitConfigOption(cfg++, "numOfCommitThreads", &tsNumOfCommitThreads, TSDB_CFG_VTYPE_INT,
+                     TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW,
+                     0, 64, 0, TSDB_CFG_UTYPE_NONE);
   tsInitConfigOption(cfg++, "numOfVnodesPerCore", &tsNumOfVnodesPerCore, TSDB_CFG_VTYPE_SHORT,
                      TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW,
                      1, 64, 0, TSDB_CFG_UTYPE_NONE);
@@ -526,6 +546,9 @@ static void doInitGlobalConfig() {
   tsInitConfigOption(cfg++, "tblocks", &tsNumOfBlocksPerMeter, TSDB_CFG_VTYPE_SHORT,
                      TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW,
                      32, 4096, 0, TSDB_CFG_UTYPE_NONE);
+  tsInitConfigOption(cfg++, "blockCacheSize", &tsBlockCacheSize, TSDB_CFG_VTYPE_INT,
+                     TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW,
+                     0, 65536, 0, TSDB_CFG_UTYPE_MB);
   tsInitConfigOption(cfg++, "numOfMPeers", &tsNumOfMPeers, TSDB_CFG_VTYPE_INT,
                      TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW | TSDB_CFG_CTYPE_B_CLUSTER,
                      1, 3, 0, TSDB_CFG_UTYPE_NONE);
@@ -576,6 +599,24 @@ static void doInitGlobalConfig() {
   tsInitConfigOption(cfg++, "metricMetaKeepTimer", &tsMetricMetaKeepTimer, TSDB_CFG_VTYPE_INT,
                      TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_CLIENT,
                      1, 8640000, 0, TSDB_CFG_UTYPE_SECOND);
+  tsInitConfigOption(cfg++, "meterMetaMissKeepTimer", &tsMeterMetaMissKeepTimer, TSDB_CFG_VTYPE_INT,
+                     TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_CLIENT,
+                     1, 3600, 0, TSDB_CFG_UTYPE_SECOND);
+  tsInitConfigOption(cfg++, "metricMergeBufferSize", &tsMetricMergeBufferSize, TSDB_CFG_VTYPE_INT,
+                     TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_CLIENT,
+                     0, 65536, 0, TSDB_CFG_UTYPE_MB);
+  tsInitConfigOption(cfg++, "metricSubqueryConcurrency", &tsMetricSubqueryConcurrency, TSDB_CFG_VTYPE_INT,
+                     TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_CLIENT,
+                     1, 10000, 0, TSDB_CFG_UTYPE_NONE);
+  tsInitConfigOption(cfg++, "insertVnodeConcurrency", &tsInsertVnodeConcurrency, TSDB_CFG_VTYPE_INT,
+                     TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_CLIENT,
+                     1, 10000, 0, TSDB_CFG_UTYPE_NONE);
+  tsInitConfigOption(cfg++, "sqlCacheSize", &tsSqlCacheSize, TSDB_CFG_VTYPE_INT,
+                     TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_CLIENT,
+                     0, 65536, 0, TSDB_CFG_UTYPE_NONE);
+  tsInitConfigOption(cfg++, "queryParallelism", &tsQueryParallelism, TSDB_CFG_VTYPE_INT,
+                     TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW | TSDB_CFG_CTYPE_B_CLIENT,
+                     1, 64, 0, TSDB_CFG_UTYPE_NONE);
 
   // mgmt configs
   tsInitConfigOption(cfg++, "mgmtZone", tsMgmtZone, TSDB_CFG_VTYPE_STRING,
@@ -618,10 +659,16 @@ static void doInitGlobalConfig() {
 
   tsInitConfigOption(cfg++, "clog", &tsCommitLog, TSDB_CFG_VTYPE_SHORT,
                      TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW,
-                     0, 1, 0, TSDB_CFG_UTYPE_NONE);
+                     0, 2, 0, TSDB_CFG_UTYPE_NONE);
+  tsInitConfigOption(cfg++, "groupCommitTime", &tsGroupCommitTime, TSDB_CFG_VTYPE_INT,
+                     TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW,
+                     1, 1000, 0, TSDB_CFG_UTYPE_MS);
   tsInitConfigOption(cfg++, "comp", &tsCompression, TSDB_CFG_VTYPE_SHORT,
                      TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW,
                      0, 2, 0, TSDB_CFG_UTYPE_NONE);
+  tsInitConfigOption(cfg++, "blockBloomFilter", &tsBlockBloomFilter, TSDB_CFG_VTYPE_SHORT,
+                     TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW,
+                     0, 1, 0, TSDB_CFG_UTYPE_NONE);
 
   // database configs
   tsInitConfigOption(cfg++, "days", &tsDaysPerFile, TSDB_CFG_VTYPE_SHORT,
@@ -692,6 +739,9 @@ static void doInitGlobalConfig() {
   tsInitConfigOption(cfg++, "mgmtEqualVnodeNum", &tsMgmtEqualVnodeNum, TSDB_CFG_VTYPE_INT,
                      TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW | TSDB_CFG_CTYPE_B_CLUSTER,
                      0, 1000, 0, TSDB_CFG_UTYPE_NONE);
+  tsInitConfigOption(cfg++, "metricTagIndex", &tsMetricTagIndex, TSDB_CFG_VTYPE_INT,
+                     TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW,
+                     0, 1, 0, TSDB_CFG_UTYPE_NONE);
   tsInitConfigOption(cfg++, "http", &tsEnableHttpModule, TSDB_CFG_VTYPE_INT,
                      TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW,
                      0, 1, 1, TSDB_CFG_UTYPE_NONE);
@@ -721,6 +771,9 @@ static void doInitGlobalConfig() {
   tsInitConfigOption(cfg++, "httpEnableCompress", &tsHttpEnableCompress, TSDB_CFG_VTYPE_INT,
                      TSDB_CFG_CTYPE_B_CONFIG,
                      0, 1, 1, TSDB_CFG_UTYPE_NONE);
+  tsInitConfigOption(cfg++, "httpMaxBodySize", &tsHttpMaxBodySize, TSDB_CFG_VTYPE_INT,
+                     TSDB_CFG_CTYPE_B_CONFIG,
+                     1, 256, 0, TSDB_CFG_UTYPE_MB);
 
   // debug flag
   tsInitConfigOption(cfg++, "numOfLogLines", &tsNumOfLogLines, TSDB_CFG_VTYPE_INT,
@@ -1130,6 +1183,7 @@ void tsSetTimeZone() {
   setenv("TZ", tsTimezone, 1);
 #endif
   tzset();
+  taosResetLocalTimeCache();
 
   /*
   * get CURRENT time zone.
@@ -13,26 +13,79 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#define _GNU_SOURCE  // pthread_setaffinity_np
+
 #include "os.h"
+#include "tglobalcfg.h"
 #include "tlog.h"
 #include "tsched.h"
 
+#define SCHED_CACHE_LINE_SIZE 64
+#define SCHED_SPIN_COUNT 128
+
+/*
+ * The queue is a bounded MPMC ring without lock. Each slot carries a sequence number: a slot at position pos can be
+ * filled when its seq is pos, and can be consumed when its seq is pos + 1. Producers and consumers claim positions by
+ * atomic increment of tail and head, so they only contend on a cache line instead of a mutex.
+ * The two semaphores only count free and filled slots, so that workers sleep when there is nothing to do and
+ * producers block when the queue is full, as before.
+ */
 typedef struct {
-  char            label[16];
-  tsem_t          emptySem;
-  tsem_t          fullSem;
-  pthread_mutex_t queueMutex;
-  int             fullSlot;
-  int             emptySlot;
-  int             queueSize;
-  int             numOfThreads;
-  pthread_t *     qthread;
-  SSchedMsg *     queue;
+  int64_t   seq;
+  SSchedMsg msg;
+} SSchedSlot;
+
+typedef struct {
+  char        label[16];
+  tsem_t      emptySem;
+  tsem_t      fullSem;
+  int         queueSize;
+  int         numOfThreads;
+  int64_t     mask;
+  pthread_t * qthread;
+  SSchedSlot *queue;
+
+  char    pad1[SCHED_CACHE_LINE_SIZE];
+  int64_t head;  // next position to consume
+  char    pad2[SCHED_CACHE_LINE_SIZE];
+  int64_t tail;  // next position to fill
+  char    pad3[SCHED_CACHE_LINE_SIZE];
 } SSchedQueue;
 
+// cores are handed out round robin across all schedulers, so the first workers of each do not share a core
+static int32_t tsSchedNextCore = 0;
+
 void *taosProcessSchedQueue(void *param);
 void taosCleanUpScheduler(void *param);
 
+/*
+ * A position is claimed only after the semaphore guarantees a free or filled slot, but the thread owning the same
+ * slot of the previous round, or the producer of the claimed message, may not have finished copying yet.
+ */
+static void taosWaitSchedSlot(SSchedSlot *pSlot, int64_t seq) {
+  int32_t spin = 0;
+  while (atomic_load_64(&pSlot->seq) != seq) {
+    if (++spin >= SCHED_SPIN_COUNT) {
+      sched_yield();
+      spin = 0;
+    }
+  }
+}
+
+static void taosSetSchedThreadAffinity(SSchedQueue *pSched, int index) {
+#ifdef LINUX
+  int core = atomic_fetch_add_32(&tsSchedNextCore, 1) % tsNumOfCores;
+
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  CPU_SET(core, &cpuset);
+
+  if (pthread_setaffinity_np(pSched->qthread[index], sizeof(cpu_set_t), &cpuset) != 0) {
+    pError("%s: failed to bind thread:%d to core:%d", pSched->label, index, core);
+  }
+#endif
+}
+
 void *taosInitScheduler(int queueSize, int numOfThreads, const char *label) {
   pthread_attr_t attr;
   SSchedQueue *  pSched = (SSchedQueue *)malloc(sizeof(SSchedQueue));
@@ -46,11 +99,6 @@ void *taosInitScheduler(int queueSize, int numOfThreads, const char *label) {
   strncpy(pSched->label, label, sizeof(pSched->label)); // fix buffer overflow
   pSched->label[sizeof(pSched->label)-1] = '\0';
 
-  if (pthread_mutex_init(&pSched->queueMutex, NULL) < 0) {
-    pError("init %s:queueMutex failed, reason:%s", pSched->label, strerror(errno));
-    goto _error;
-  }
-
   if (tsem_init(&pSched->emptySem, 0, (unsigned int)pSched->queueSize) != 0) {
     pError("init %s:empty semaphore failed, reason:%s", pSched->label, strerror(errno));
     goto _error;
@@ -61,14 +109,20 @@ void *taosInitScheduler(int queueSize, int numOfThreads, const char *label) {
     goto _error;
   }
 
-  if ((pSched->queue = (SSchedMsg *)malloc((size_t)pSched->queueSize * sizeof(SSchedMsg))) == NULL) {
+  // the ring is rounded up to power of 2, the semaphore still limits the queue to queueSize messages
+  int64_t numOfSlots = 1;
+  while (numOfSlots < pSched->queueSize) numOfSlots <<= 1;
+  pSched->mask = numOfSlots - 1;
+
+  if ((pSched->queue = (SSchedSlot *)malloc((size_t)numOfSlots * sizeof(SSchedSlot))) == NULL) {
     pError("%s: no enough memory for queue, reason:%s", pSched->label, strerror(errno));
     goto _error;
   }
 
-  memset(pSched->queue, 0, (size_t)pSched->queueSize * sizeof(SSchedMsg));
-  pSched->fullSlot = 0;
-  pSched->emptySlot = 0;
+  memset(pSched->queue, 0, (size_t)numOfSlots * sizeof(SSchedSlot));
+  for (int64_t i = 0; i < numOfSlots; ++i) {
+    pSched->queue[i].seq = i;
+  }
 
   pSched->qthread = malloc(sizeof(pthread_t) * (size_t)numOfThreads);
   if (pSched->qthread == NULL) {
@@ -85,6 +139,10 @@ void *taosInitScheduler(int queueSize, int numOfThreads, const char *label) {
       goto _error;
     }
     ++pSched->numOfThreads;
+
+    if (tsSchedAffinity) {
+      taosSetSchedThreadAffinity(pSched, i);
+    }
   }
 
   pTrace("%s scheduler is initialized, numOfThreads:%d", pSched->label, pSched->numOfThreads);
@@ -110,15 +168,12 @@ void *taosProcessSchedQueue(void *param) {
       pError("wait %s fullSem failed, errno:%d, reason:%s", pSched->label, errno, strerror(errno));
     }
 
-    if (pthread_mutex_lock(&pSched->queueMutex) != 0)
-      pError("lock %s queueMutex failed, reason:%s", pSched->label, strerror(errno));
-
-    msg = pSched->queue[pSched->fullSlot];
-    memset(pSched->queue + pSched->fullSlot, 0, sizeof(SSchedMsg));
-    pSched->fullSlot = (pSched->fullSlot + 1) % pSched->queueSize;
+    int64_t     pos = atomic_fetch_add_64(&pSched->head, 1);
+    SSchedSlot *pSlot = pSched->queue + (pos & pSched->mask);
 
-    if (pthread_mutex_unlock(&pSched->queueMutex) != 0)
-      pError("unlock %s queueMutex failed, reason:%s\n", pSched->label, strerror(errno));
+    taosWaitSchedSlot(pSlot, pos + 1);
+    msg = pSlot->msg;
+    atomic_store_64(&pSlot->seq, pos + pSched->mask + 1);
 
     if (tsem_post(&pSched->emptySem) != 0)
       pError("post %s emptySem failed, reason:%s\n", pSched->label, strerror(errno));
@@ -145,14 +200,12 @@ int taosScheduleTask(void *qhandle, SSchedMsg *pMsg) {
     pTrace("wait %s emptySem was interrupted", pSched->label);
   }
 
-  if (pthread_mutex_lock(&pSched->queueMutex) != 0)
-    pError("lock %s queueMutex failed, reason:%s", pSched->label, strerror(errno));
-
-  pSched->queue[pSched->emptySlot] = *pMsg;
-  pSched->emptySlot = (pSched->emptySlot + 1) % pSched->queueSize;
+  int64_t     pos = atomic_fetch_add_64(&pSched->tail, 1);
+  SSchedSlot *pSlot = pSched->queue + (pos & pSched->mask);
 
-  if (pthread_mutex_unlock(&pSched->queueMutex) != 0)
-    pError("unlock %s queueMutex failed, reason:%s", pSched->label, strerror(errno));
+  taosWaitSchedSlot(pSlot, pos);
+  pSlot->msg = *pMsg;
+  atomic_store_64(&pSlot->seq, pos + 1);
 
   if (tsem_post(&pSched->fullSem) != 0) pError("post %s fullSem failed, reason:%s", pSched->label, strerror(errno));
 
@@ -172,7 +225,6 @@ void taosCleanUpScheduler(void *param) {
 
   tsem_destroy(&pSched->emptySem);
   tsem_destroy(&pSched->fullSem);
-  pthread_mutex_destroy(&pSched->queueMutex);
 
   free(pSched->queue);
   free(pSched->qthread);
@@ -27,6 +27,13 @@
 static int64_t parseFraction(char* str, char** end, int32_t timePrec);
 static int32_t parseTimeWithTz(char* timestr, int64_t* time, int32_t timePrec);
 static int32_t parseLocaltime(char* timestr, int64_t* time, int32_t timePrec);
+static int32_t parseLocaltimeFast(char* timestr, int64_t* time, int32_t len, int32_t timePrec);
+
+/*
+ * offset to UTC of the hour parsed by parseLocaltimeFast most recently. The hour is kept in the high 32 bits and
+ * the offset in seconds in the low 32 bits, so that it is updated by a single store. 0 means empty.
+ */
+static int64_t localHourOffset = 0;
 
 int32_t taosGetTimestampSec() { return (int32_t)time(NULL); }
 
@@ -58,11 +65,15 @@ int32_t taosParseTime(char* timestr, int64_t* time, int32_t len, int32_t timePre
   /* parse datatime string in with tz */
   if (strnchr(timestr, 'T', len, false) != NULL) {
     return parseTimeWithTz(timestr, time, timePrec);
+  } else if (parseLocaltimeFast(timestr, time, len, timePrec) == 0) {
+    return 0;
   } else {
     return parseLocaltime(timestr, time, timePrec);
   }
 }
 
+void taosResetLocalTimeCache() { atomic_store_64(&localHourOffset, 0); }
+
 char* forwardToTimeStringEnd(char* str) {
   int32_t i = 0;
   int32_t numOfSep = 0;
@@ -253,6 +264,107 @@ int32_t parseLocaltime(char* timestr, int64_t* time, int32_t timePrec) {
   return 0;
 }
 
+static FORCE_INLINE int32_t parseDigits(const char* str, int32_t len) {
+  int32_t val = 0;
+  for (int32_t i = 0; i < len; ++i) {
+    if (str[i] < '0' || str[i] > '9') {
+      return -1;
+    }
+    val = val * 10 + (str[i] - '0');
+  }
+
+  return val;
+}
+
+// days since 1970-01-01 of the date in proleptic gregorian calendar
+static int64_t daysFromCivil(int64_t year, int32_t mon, int32_t mday) {
+  year -= (mon <= 2);
+
+  int64_t era = (year >= 0 ? year : year - 399) / 400;
+  int64_t yoe = year - era * 400;
+  int64_t doy = (153 * (mon + (mon > 2 ? -3 : 9)) + 2) / 5 + mday - 1;
+  int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+  return era * 146097 + doe - 719468;
+}
+
+/*
+ * the same as parseLocaltime, but only for the strict format "%Y-%m-%d %H:%M:%S[.fraction]" without any other
+ * characters. The date is converted arithmetically, and mktime is only called once for each hour to get the
+ * offset to UTC, which is the same as the one mktime applies to every second of the hour.
+ *
+ * @return -1 if the string is not in the strict format, parseLocaltime should be used instead
+ */
+static int32_t parseLocaltimeFast(char* timestr, int64_t* time, int32_t len, int32_t timePrec) {
+  const int32_t TIME_STR_LEN = 19;  // "2020-01-01 00:00:00"
+
+  if (len < TIME_STR_LEN || timestr[4] != '-' || timestr[7] != '-' || timestr[10] != ' ' || timestr[13] != ':' ||
+      timestr[16] != ':') {
+    return -1;
+  }
+
+  int32_t year = parseDigits(timestr, 4);
+  int32_t mon = parseDigits(timestr + 5, 2);
+  int32_t mday = parseDigits(timestr + 8, 2);
+  int32_t hour = parseDigits(timestr + 11, 2);
+  int32_t min = parseDigits(timestr + 14, 2);
+  int32_t sec = parseDigits(timestr + 17, 2);
+
+  if (year < 0 || mon < 1 || mon > 12 || mday < 1 || mday > 31 || hour < 0 || hour > 23 || min < 0 || min > 59 ||
+      sec < 0 || sec > 59) {
+    return -1;
+  }
+
+  int64_t fraction = 0;
+  if (len > TIME_STR_LEN) {
+    int32_t digits = len - TIME_STR_LEN - 1;
+    if (timestr[TIME_STR_LEN] != '.' || digits <= 0) {
+      return -1;
+    }
+
+    // only the initial 3 or 6 digits are used, see parseFraction
+    int32_t maxDigits = (timePrec == TSDB_TIME_PRECISION_MILLI) ? 3 : 6;
+    int32_t used = MIN(digits, maxDigits);
+
+    if (parseDigits(timestr + TIME_STR_LEN + 1 + used, digits - used) < 0) {
+      return -1;
+    }
+
+    fraction = parseDigits(timestr + TIME_STR_LEN + 1, used);
+    for (int32_t i = used; i < maxDigits; ++i) {
+      fraction *= 10;
+    }
+  }
+
+  int64_t hourKey = ((year * 13L + mon) * 32 + mday) * 24 + hour;
+  int64_t civilHour = daysFromCivil(year, mon, mday) * 86400 + hour * 3600;
+  int64_t offset = 0;
+
+  int64_t cached = atomic_load_64(&localHourOffset);
+  if (cached != 0 && (cached >> 32) == hourKey) {
+    offset = (int32_t)(cached & 0xFFFFFFFF);
+  } else {
+    struct tm tm = {0};
+    tm.tm_year = year - 1900;
+    tm.tm_mon = mon - 1;
+    tm.tm_mday = mday;
+    tm.tm_hour = hour;
+
+    time_t seconds = mktime(&tm);
+    if (seconds == -1) {
+      return -1;
+    }
+
+    offset = seconds - civilHour;
+    atomic_store_64(&localHourOffset, (hourKey << 32) | (uint32_t)offset);
+  }
+
+  int64_t factor = (timePrec == TSDB_TIME_PRECISION_MILLI) ? 1000 : 1000000;
+  *time = factor * (civilHour + offset + min * 60 + sec) + fraction;
+
+  return 0;
+}
+
 static int32_t getTimestampInUsFromStrImpl(int64_t val, char unit, int64_t* result) {
   *result = val;
 
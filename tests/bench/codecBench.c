@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// decode throughput of the data file codecs, per codec and data distribution
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "tscompression.h"
+
+#define BENCH_POINTS 4096  // default rows of a file block
+
+typedef int (*__compress_fn_t)(const char *const, int, const int, char *const, int, char, char *const, int);
+
+typedef struct {
+  char *          name;
+  int             type;
+  int             bytes;
+  __compress_fn_t compFp;
+  __compress_fn_t decompFp;
+} SCodec;
+
+static SCodec codecs[] = {
+    {"timestamp", TSDB_DATA_TYPE_TIMESTAMP, 8, tsCompressTimestamp, tsDecompressTimestamp},
+    {"bigint", TSDB_DATA_TYPE_BIGINT, 8, tsCompressBigint, tsDecompressBigint},
+    {"int", TSDB_DATA_TYPE_INT, 4, tsCompressInt, tsDecompressInt},
+    {"smallint", TSDB_DATA_TYPE_SMALLINT, 2, tsCompressSmallint, tsDecompressSmallint},
+    {"tinyint", TSDB_DATA_TYPE_TINYINT, 1, tsCompressTinyint, tsDecompressTinyint},
+    {"float", TSDB_DATA_TYPE_FLOAT, 4, tsCompressFloat, tsDecompressFloat},
+    {"double", TSDB_DATA_TYPE_DOUBLE, 8, tsCompressDouble, tsDecompressDouble},
+};
+
+static char *dists[] = {"constant", "small", "random", "jittered"};
+
+static double getCurrentTime() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1E6;
+}
+
+static int64_t genValue(int dist, int i, int64_t prev) {
+  switch (dist) {
+    case 0:
+      return 1000;
+    case 1:
+      return prev + rand() % 16;
+    case 2:
+      return ((int64_t)rand() << 31) ^ rand();
+    default:  // a regular interval with a few milliseconds of jitter, like the timestamps of a sensor
+      return 1500000000000L + (int64_t)i * 1000 + rand() % 8;
+  }
+}
+
+static void genColumn(SCodec *pCodec, int dist, char *data, int points) {
+  int64_t v = 0;
+  for (int i = 0; i < points; ++i) {
+    v = genValue(dist, i, v);
+    switch (pCodec->type) {
+      case TSDB_DATA_TYPE_TIMESTAMP:
+      case TSDB_DATA_TYPE_BIGINT:
+        ((int64_t *)data)[i] = v;
+        break;
+      case TSDB_DATA_TYPE_INT:
+        ((int32_t *)data)[i] = (int32_t)v;
+        break;
+      case TSDB_DATA_TYPE_SMALLINT:
+        ((int16_t *)data)[i] = (int16_t)v;
+        break;
+      case TSDB_DATA_TYPE_TINYINT:
+        ((int8_t *)data)[i] = (int8_t)v;
+        break;
+      case TSDB_DATA_TYPE_FLOAT:
+        ((float *)data)[i] = (float)(v % 100000) / 100;
+        break;
+      default:
+        ((double *)data)[i] = (double)(v % 100000) / 100;
+        break;
+    }
+  }
+}
+
+int main(int argc, char *argv[]) {
+  int    points = BENCH_POINTS;
+  double seconds = 1;
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-n") == 0 && i < argc - 1) {
+      points = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-t") == 0 && i < argc - 1) {
+      seconds = atof(argv[++i]);
+    } else {
+      printf("usage: %s [-n points per block] [-t seconds per case]\n", argv[0]);
+      exit(1);
+    }
+  }
+
+  int   size = points * sizeof(int64_t);
+  char *data = malloc(size);
+  char *comp = malloc(size + EXTRA_BYTES + 1);
+  char *decomp = malloc(size);
+  char *buffer = malloc(size + EXTRA_BYTES + 1);
+
+  printf("%-10s %-9s %6s %10s %11s\n", "codec", "data", "ratio", "comp GB/s", "decomp GB/s");
+
+  for (int c = 0; c < sizeof(codecs) / sizeof(codecs[0]); ++c) {
+    SCodec *pCodec = codecs + c;
+    int     bytes = pCodec->bytes * points;
+
+    for (int d = 0; d < sizeof(dists) / sizeof(dists[0]); ++d) {
+      srand(d + 1);
+      genColumn(pCodec, d, data, points);
+
+      int64_t rounds = 0;
+      int     compLen = 0;
+      double  st = getCurrentTime(), et = st;
+      while (et - st < seconds) {
+        compLen = (*pCodec->compFp)(data, bytes, points, comp, bytes + EXTRA_BYTES, ONE_STAGE_COMP, buffer,
+                                    bytes + EXTRA_BYTES);
+        if (++rounds % 64 == 0) et = getCurrentTime();
+      }
+      double compRate = (double)bytes * rounds / (et - st) / 1E9;
+
+      rounds = 0;
+      st = getCurrentTime(), et = st;
+      while (et - st < seconds) {
+        (*pCodec->decompFp)(comp, compLen, points, decomp, bytes, ONE_STAGE_COMP, buffer, bytes + EXTRA_BYTES);
+        if (++rounds % 64 == 0) et = getCurrentTime();
+      }
+      double decompRate = (double)bytes * rounds / (et - st) / 1E9;
+
+      if (memcmp(data, decomp, bytes) != 0) {
+        printf("%s %s: decoded data differs from the input\n", pCodec->name, dists[d]);
+        exit(1);
+      }
+
+      printf("%-10s %-9s %6.2f %10.2f %11.2f\n", pCodec->name, dists[d], (double)bytes / compLen, compRate,
+             decompRate);
+    }
+  }
+
+  free(data);
+  free(comp);
+  free(decomp);
+  free(buffer);
+  return 0;
+}
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * rows/sec of 1000-row submit blocks on 20-column tables. Rows are bound by column through a prepared statement, so
+ * the client spends little time per row and the append of the vnode dominates.
+ * A block whose keys are all increasing and newer than the table is appended to the cache column-wise in one pass.
+ * With -r, each block starts with the last key of the previous one, so the vnode skips that row and appends the
+ * others row by row as before, which gives the rate of the row path on the same data.
+ */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <taos.h>
+
+#define BENCH_DB      "insertbench"
+#define BENCH_COLUMNS 20
+
+typedef struct {
+  pthread_t pid;
+  int       tableId;
+  int64_t   rows;
+} SInsertThread;
+
+static char *host = NULL;
+static int   numOfBatches = 1000;
+static int   rowsPerBatch = 1000;
+static int   rowPath = 0;
+
+static int columnTypes[] = {TSDB_DATA_TYPE_INT, TSDB_DATA_TYPE_BIGINT, TSDB_DATA_TYPE_FLOAT, TSDB_DATA_TYPE_DOUBLE};
+
+static double getCurrentTime() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1E6;
+}
+
+static TAOS *connectServer() {
+  TAOS *taos = taos_connect(host, "root", "taosdata", NULL, 0);
+  if (taos == NULL) {
+    printf("failed to connect to server, reason:%s\n", taos_errstr(taos));
+    exit(1);
+  }
+  return taos;
+}
+
+static void execute(TAOS *taos, char *sql) {
+  if (taos_query(taos, sql) != 0) {
+    printf("failed to run: %s, reason:%s\n", sql, taos_errstr(taos));
+    exit(1);
+  }
+}
+
+static void *insertRows(void *param) {
+  SInsertThread *pThread = (SInsertThread *)param;
+  TAOS *         taos = connectServer();
+  char           sql[256];
+
+  execute(taos, "use " BENCH_DB);
+
+  int len = sprintf(sql, "insert into t%d values (?", pThread->tableId);
+  for (int i = 1; i < BENCH_COLUMNS; ++i) len += sprintf(sql + len, ", ?");
+  sprintf(sql + len, ")");
+
+  TAOS_MULTI_BIND binds[BENCH_COLUMNS];
+  memset(binds, 0, sizeof(binds));
+
+  int64_t *keys = malloc(sizeof(int64_t) * rowsPerBatch);
+  binds[0].buffer_type = TSDB_DATA_TYPE_TIMESTAMP;
+  binds[0].buffer = keys;
+
+  for (int i = 1; i < BENCH_COLUMNS; ++i) {
+    int   type = columnTypes[i % 4];
+    int   bytes = (type == TSDB_DATA_TYPE_INT || type == TSDB_DATA_TYPE_FLOAT) ? 4 : 8;
+    char *values = malloc((size_t)bytes * rowsPerBatch);
+
+    for (int r = 0; r < rowsPerBatch; ++r) {
+      switch (type) {
+        case TSDB_DATA_TYPE_INT:
+          ((int32_t *)values)[r] = r * i;
+          break;
+        case TSDB_DATA_TYPE_BIGINT:
+          ((int64_t *)values)[r] = (int64_t)r * i;
+          break;
+        case TSDB_DATA_TYPE_FLOAT:
+          ((float *)values)[r] = r * 0.5f;
+          break;
+        default:
+          ((double *)values)[r] = r * 0.25;
+          break;
+      }
+    }
+
+    binds[i].buffer_type = type;
+    binds[i].buffer = values;
+  }
+
+  int64_t key = (int64_t)(getCurrentTime() * 1000) - (int64_t)numOfBatches * rowsPerBatch;
+  for (int b = 0; b < numOfBatches; ++b) {
+    if (rowPath && b > 0) key--;  // repeat the last key of the previous block
+    for (int r = 0; r < rowsPerBatch; ++r) keys[r] = key++;
+
+    TAOS_STMT *stmt = taos_stmt_init(taos);
+    if (taos_stmt_prepare(stmt, sql, 0) != 0 || taos_stmt_bind_param_batch(stmt, binds, rowsPerBatch) != 0 ||
+        taos_stmt_add_batch(stmt) != 0 || taos_stmt_execute(stmt) != 0) {
+      printf("failed to insert into t%d, reason:%s\n", pThread->tableId, taos_errstr(taos));
+      exit(1);
+    }
+    taos_stmt_close(stmt);
+
+    pThread->rows += (rowPath && b > 0) ? rowsPerBatch - 1 : rowsPerBatch;
+  }
+
+  for (int i = 0; i < BENCH_COLUMNS; ++i) free(binds[i].buffer);
+  taos_close(taos);
+  return NULL;
+}
+
+int main(int argc, char *argv[]) {
+  int numOfThreads = 1;
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-h") == 0 && i < argc - 1) {
+      host = argv[++i];
+    } else if (strcmp(argv[i], "-t") == 0 && i < argc - 1) {
+      numOfThreads = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-n") == 0 && i < argc - 1) {
+      numOfBatches = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-b") == 0 && i < argc - 1) {
+      rowsPerBatch = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-r") == 0) {
+      rowPath = 1;
+    } else {
+      printf("usage: %s [-h host] [-t threads] [-n batches per thread] [-b rows per batch] [-r]\n", argv[0]);
+      exit(1);
+    }
+  }
+
+  taos_init();
+  TAOS *taos = connectServer();
+  char  sql[1024];
+
+  execute(taos, "drop database if exists " BENCH_DB);
+  execute(taos, "create database " BENCH_DB);
+  execute(taos, "use " BENCH_DB);
+
+  int len = sprintf(sql, "create table st (ts timestamp");
+  for (int i = 1; i < BENCH_COLUMNS; ++i) {
+    switch (columnTypes[i % 4]) {
+      case TSDB_DATA_TYPE_INT:
+        len += sprintf(sql + len, ", c%d int", i);
+        break;
+      case TSDB_DATA_TYPE_BIGINT:
+        len += sprintf(sql + len, ", c%d bigint", i);
+        break;
+      case TSDB_DATA_TYPE_FLOAT:
+        len += sprintf(sql + len, ", c%d float", i);
+        break;
+      default:
+        len += sprintf(sql + len, ", c%d double", i);
+        break;
+    }
+  }
+  sprintf(sql + len, ") tags (t int)");
+  execute(taos, sql);
+
+  SInsertThread *threads = calloc(numOfThreads, sizeof(SInsertThread));
+  for (int i = 0; i < numOfThreads; ++i) {
+    sprintf(sql, "create table t%d using st tags (%d)", i, i);
+    execute(taos, sql);
+    threads[i].tableId = i;
+  }
+
+  double st = getCurrentTime();
+  for (int i = 0; i < numOfThreads; ++i) {
+    pthread_create(&threads[i].pid, NULL, insertRows, threads + i);
+  }
+
+  int64_t total = 0;
+  for (int i = 0; i < numOfThreads; ++i) {
+    pthread_join(threads[i].pid, NULL);
+    total += threads[i].rows;
+  }
+  double et = getCurrentTime();
+
+  printf("%s path, threads:%d rows:%ld columns:%d rows per batch:%d\n", rowPath ? "row" : "batch", numOfThreads, total,
+         BENCH_COLUMNS, rowsPerBatch);
+  printf("throughput: %.0f rows/s\n", total / (et - st));
+
+  execute(taos, "drop database " BENCH_DB);
+  taos_close(taos);
+  free(threads);
+
+  return 0;
+}
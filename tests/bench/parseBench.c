@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * parse rate of the values of INSERT statements. A buffer of generated "(ts, int, bigint, float, double, smallint,
+ * bool)" rows is parsed repeatedly into a row buffer by the same function as tsParseValues, until the requested
+ * amount of text is consumed. No server is needed, the tokenizer and the conversion of values are measured.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+
+#include "taos.h"
+#include "tscUtil.h"
+#include "tsclient.h"
+#include "tsqldef.h"
+#include "tstoken.h"
+
+#define BENCH_COLUMNS 7
+
+extern int tsParseOneRowData(char **str, STableDataBlocks *pDataBlocks, SSchema schema[], SParsedDataColInfo *spd,
+                             char *error, int16_t timePrec);
+
+static SSchema schema[BENCH_COLUMNS] = {
+    {TSDB_DATA_TYPE_TIMESTAMP, "ts", 0, 8}, {TSDB_DATA_TYPE_INT, "i", 1, 4},   {TSDB_DATA_TYPE_BIGINT, "b", 2, 8},
+    {TSDB_DATA_TYPE_FLOAT, "f", 3, 4},      {TSDB_DATA_TYPE_DOUBLE, "d", 4, 8}, {TSDB_DATA_TYPE_SMALLINT, "s", 5, 2},
+    {TSDB_DATA_TYPE_BOOL, "o", 6, 1}};
+
+static double getCurrentTime() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1E6;
+}
+
+static char *generateValues(int64_t size, int timeStr, int64_t *numOfRows) {
+  char *   buf = malloc(size + 256);
+  int64_t  len = 0;
+  int64_t  rows = 0;
+  int64_t  ts = 1500000000000L;
+  uint32_t seed = 1;
+
+  while (len < size) {
+    int32_t r = rand_r(&seed);
+
+    if (timeStr) {
+      time_t     t = (time_t)(ts / 1000);
+      struct tm *tm = localtime(&t);
+      len += strftime(buf + len, 32, "('%Y-%m-%d %H:%M:%S", tm);
+      len += sprintf(buf + len, ".%03d'", (int)(ts % 1000));
+    } else {
+      len += sprintf(buf + len, "(%ld", ts);
+    }
+
+    len += sprintf(buf + len, ", %d, %ld, %d.%03d, %d.%06d, %d, %s) ", r - RAND_MAX / 2, (int64_t)r * 7919,
+                   r % 1000, r % 1000, r % 100000, r % 1000000, r % 30000, (r & 1) ? "true" : "false");
+    ts += 10;
+    rows++;
+  }
+
+  buf[len] = 0;
+  *numOfRows = rows;
+  return buf;
+}
+
+int main(int argc, char *argv[]) {
+  int64_t bufSize = 64L * 1024 * 1024;
+  double  totalGB = 2;
+  int     timeStr = 0;
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-m") == 0 && i < argc - 1) {
+      bufSize = atol(argv[++i]) * 1024 * 1024;
+    } else if (strcmp(argv[i], "-g") == 0 && i < argc - 1) {
+      totalGB = atof(argv[++i]);
+    } else if (strcmp(argv[i], "-s") == 0) {
+      timeStr = 1;
+    } else {
+      printf("usage: %s [-m MB of generated text] [-g GB to parse] [-s]\n", argv[0]);
+      exit(1);
+    }
+  }
+
+  taos_init();
+
+  int64_t numOfRows = 0;
+  char *  values = generateValues(bufSize, timeStr, &numOfRows);
+  int64_t textLen = strlen(values);
+
+  SParsedDataColInfo spd = {.numOfCols = BENCH_COLUMNS, .numOfAssignedCols = BENCH_COLUMNS};
+  int32_t            rowSize = 0;
+  for (int i = 0; i < BENCH_COLUMNS; ++i) {
+    spd.elems[i].colIndex = i;
+    spd.elems[i].offset = rowSize;
+    spd.hasVal[i] = true;
+    rowSize += schema[i].bytes;
+  }
+
+  STableDataBlocks block;
+  memset(&block, 0, sizeof(block));
+  block.pData = malloc(rowSize);
+  block.nAllocSize = rowSize;
+  block.rowSize = rowSize;
+
+  char    error[256] = {0};
+  int64_t parsed = 0;
+  int64_t rows = 0;
+  double  st = getCurrentTime();
+
+  while (parsed < totalGB * 1024 * 1024 * 1024) {
+    char *str = values;
+
+    block.tsSource = -1;
+    block.prevTS = INT64_MIN;
+    while (1) {
+      int32_t   index = 0;
+      SSQLToken sToken = tStrGetToken(str, &index, false, 0, NULL);
+      if (sToken.n == 0 || sToken.type != TK_LP) break;
+      str += index;
+
+      // each row is written over the previous one, only the parsing is measured
+      block.size = 0;
+      if (tsParseOneRowData(&str, &block, schema, &spd, error, TSDB_TIME_PRECISION_MILLI) <= 0) {
+        printf("failed to parse row %ld, reason:%s\n", rows, error);
+        exit(1);
+      }
+
+      index = 0;
+      sToken = tStrGetToken(str, &index, false, 0, NULL);
+      str += index;
+      if (sToken.type != TK_RP) {
+        printf("failed to parse row %ld, ) is expected\n", rows);
+        exit(1);
+      }
+
+      rows++;
+    }
+
+    parsed += textLen;
+  }
+
+  double et = getCurrentTime();
+
+  printf("%s timestamps, rows:%ld values:%ld text:%.2f GB\n", timeStr ? "string" : "integer", rows,
+         rows * BENCH_COLUMNS, parsed / 1024.0 / 1024 / 1024);
+  printf("throughput: %.1f MB/s, %.0f values/s\n", parsed / 1024.0 / 1024 / (et - st), rows * BENCH_COLUMNS / (et - st));
+
+  free(block.pData);
+  free(values);
+  return 0;
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// throughput and queueing latency of taosScheduleTask, with several producers feeding one scheduler
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "tglobalcfg.h"
+#include "tsched.h"
+
+#define LATENCY_BUCKETS 40  // bucket i counts latencies in [2^i, 2^(i+1)) nanoseconds
+
+typedef struct {
+  pthread_t pid;
+  int64_t   numOfMsgs;
+} SProducer;
+
+static void *   qhandle;
+static int64_t  processed = 0;
+static int64_t  latency[LATENCY_BUCKETS];
+
+static int64_t getNanoSeconds() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000000L + ts.tv_nsec;
+}
+
+static void processMsg(SSchedMsg *pMsg) {
+  int64_t delta = getNanoSeconds() - (int64_t)pMsg->ahandle;
+  int     bucket = 0;
+  while (bucket < LATENCY_BUCKETS - 1 && (delta >> (bucket + 1)) > 0) bucket++;
+
+  __atomic_fetch_add(&latency[bucket], 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&processed, 1, __ATOMIC_RELEASE);
+}
+
+static void *produceMsgs(void *param) {
+  SProducer *pProducer = (SProducer *)param;
+  SSchedMsg  msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.fp = processMsg;
+
+  for (int64_t i = 0; i < pProducer->numOfMsgs; ++i) {
+    msg.ahandle = (void *)getNanoSeconds();
+    taosScheduleTask(qhandle, &msg);
+  }
+
+  return NULL;
+}
+
+static int64_t getPercentile(int64_t total, double percent) {
+  int64_t count = 0;
+  for (int i = 0; i < LATENCY_BUCKETS; ++i) {
+    count += latency[i];
+    if (count >= total * percent) return 1L << (i + 1);
+  }
+  return 1L << LATENCY_BUCKETS;
+}
+
+int main(int argc, char *argv[]) {
+  int     numOfProducers = 4;
+  int     numOfWorkers = 4;
+  int     queueSize = 10000;
+  int64_t numOfMsgs = 1000000;
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-p") == 0 && i < argc - 1) {
+      numOfProducers = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-w") == 0 && i < argc - 1) {
+      numOfWorkers = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-q") == 0 && i < argc - 1) {
+      queueSize = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-n") == 0 && i < argc - 1) {
+      numOfMsgs = atol(argv[++i]);
+    } else if (strcmp(argv[i], "-a") == 0) {
+      tsSchedAffinity = 1;
+    } else {
+      printf("usage: %s [-p producers] [-w workers] [-q queue size] [-n msgs per producer] [-a]\n", argv[0]);
+      exit(1);
+    }
+  }
+
+  tsNumOfCores = (int32_t)sysconf(_SC_NPROCESSORS_ONLN);
+
+  qhandle = taosInitScheduler(queueSize, numOfWorkers, "bench");
+  if (qhandle == NULL) {
+    printf("failed to init scheduler\n");
+    exit(1);
+  }
+
+  SProducer *producers = calloc(numOfProducers, sizeof(SProducer));
+  int64_t    st = getNanoSeconds();
+
+  for (int i = 0; i < numOfProducers; ++i) {
+    producers[i].numOfMsgs = numOfMsgs;
+    pthread_create(&producers[i].pid, NULL, produceMsgs, producers + i);
+  }
+
+  for (int i = 0; i < numOfProducers; ++i) {
+    pthread_join(producers[i].pid, NULL);
+  }
+
+  int64_t total = numOfMsgs * numOfProducers;
+  while (__atomic_load_n(&processed, __ATOMIC_ACQUIRE) < total) sched_yield();
+  int64_t et = getNanoSeconds();
+
+  printf("producers:%d workers:%d queue:%d msgs:%ld\n", numOfProducers, numOfWorkers, queueSize, total);
+  printf("throughput: %.0f msgs/s\n", total * 1E9 / (et - st));
+  printf("latency p50 < %ld ns, p99 < %ld ns, p99.9 < %ld ns\n", getPercentile(total, 0.5),
+         getPercentile(total, 0.99), getPercentile(total, 0.999));
+
+  taosCleanUpScheduler(qhandle);
+  free(producers);
+
+  return 0;
+}
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * receive rate of the TCP server over loopback. Clients stream messages of mixed sizes back to back, and the
+ * allocations done by the server while receiving are counted by wrapping the glibc allocator.
+ */
+
+#include <arpa/inet.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "taosmsg.h"
+#include "tsocket.h"
+#include "ttcpserver.h"
+
+#define BENCH_PORT      7150
+#define BENCH_SEND_SIZE (256 * 1024)
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t n, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void *__libc_memalign(size_t alignment, size_t size);
+
+static int64_t allocs = 0;
+static int64_t received = 0;
+static int64_t total = 0;
+static int     smallPercent = 80;
+
+void *malloc(size_t size) {
+  __atomic_fetch_add(&allocs, 1, __ATOMIC_RELAXED);
+  return __libc_malloc(size);
+}
+
+void *calloc(size_t n, size_t size) {
+  __atomic_fetch_add(&allocs, 1, __ATOMIC_RELAXED);
+  return __libc_calloc(n, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+  __atomic_fetch_add(&allocs, 1, __ATOMIC_RELAXED);
+  return __libc_realloc(ptr, size);
+}
+
+int posix_memalign(void **ptr, size_t alignment, size_t size) {
+  __atomic_fetch_add(&allocs, 1, __ATOMIC_RELAXED);
+  *ptr = __libc_memalign(alignment, size);
+  return (*ptr == NULL) ? -1 : 0;
+}
+
+typedef struct {
+  pthread_t pid;
+  int       numOfMsgs;
+  int       seed;
+} SClient;
+
+static double getCurrentTime() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1E6;
+}
+
+static void *processData(char *data, int dataLen, unsigned int ip, uint16_t port, void *shandle, void *thandle,
+                         void *chandle) {
+  if (data == NULL) return NULL;  // connection is closed
+
+  taosFreeTcpServerMsg(data);
+  __atomic_fetch_add(&received, 1, __ATOMIC_RELEASE);
+
+  return shandle;
+}
+
+static int getMsgLen(unsigned int *seed) {
+  if (rand_r(seed) % 100 < smallPercent) return sizeof(STaosHeader) + 64 + rand_r(seed) % 512;
+  return sizeof(STaosHeader) + 8 * 1024 + rand_r(seed) % (32 * 1024);
+}
+
+static void *sendMsgs(void *param) {
+  SClient *    pClient = (SClient *)param;
+  unsigned int seed = pClient->seed;
+  char *       buffer = calloc(1, BENCH_SEND_SIZE + 64 * 1024);
+
+  int fd = taosOpenTcpClientSocket("127.0.0.1", BENCH_PORT, "127.0.0.1");
+  if (fd < 0) {
+    printf("failed to connect to the server\n");
+    exit(1);
+  }
+
+  int sent = 0;
+  while (sent < pClient->numOfMsgs) {
+    // messages are packed into large writes, so they are split at random places on the server side
+    int len = 0;
+    while (len < BENCH_SEND_SIZE && sent < pClient->numOfMsgs) {
+      int msgLen = getMsgLen(&seed);
+      ((STaosHeader *)(buffer + len))->msgLen = (int32_t)htonl((uint32_t)msgLen);
+      len += msgLen;
+      sent++;
+    }
+
+    if (taosWriteMsg(fd, buffer, len) != len) {
+      printf("failed to send msgs\n");
+      exit(1);
+    }
+  }
+
+  // keep the connection until all messages are received, closing it would drop the pending bytes
+  while (__atomic_load_n(&received, __ATOMIC_ACQUIRE) < total) usleep(1000);
+
+  close(fd);
+  free(buffer);
+  return NULL;
+}
+
+int main(int argc, char *argv[]) {
+  int numOfClients = 4;
+  int numOfThreads = 2;
+  int numOfMsgs = 200000;
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-c") == 0 && i < argc - 1) {
+      numOfClients = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-t") == 0 && i < argc - 1) {
+      numOfThreads = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-n") == 0 && i < argc - 1) {
+      numOfMsgs = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-s") == 0 && i < argc - 1) {
+      smallPercent = atoi(argv[++i]);
+    } else {
+      printf("usage: %s [-c clients] [-t server threads] [-n msgs per client] [-s percent of small msgs]\n", argv[0]);
+      exit(1);
+    }
+  }
+
+  void *server = taosInitTcpServer("127.0.0.1", BENCH_PORT, "bench", numOfThreads, processData, (void *)1);
+  if (server == NULL) {
+    printf("failed to init TCP server\n");
+    exit(1);
+  }
+
+  SClient *clients = calloc(numOfClients, sizeof(SClient));
+  total = (int64_t)numOfClients * numOfMsgs;
+
+  int64_t startAllocs = __atomic_load_n(&allocs, __ATOMIC_RELAXED);
+  double  st = getCurrentTime();
+
+  for (int i = 0; i < numOfClients; ++i) {
+    clients[i].numOfMsgs = numOfMsgs;
+    clients[i].seed = i + 1;
+    pthread_create(&clients[i].pid, NULL, sendMsgs, clients + i);
+  }
+
+  while (__atomic_load_n(&received, __ATOMIC_ACQUIRE) < total) usleep(100);
+  double  et = getCurrentTime();
+  int64_t numOfAllocs = __atomic_load_n(&allocs, __ATOMIC_RELAXED) - startAllocs;
+
+  for (int i = 0; i < numOfClients; ++i) {
+    pthread_join(clients[i].pid, NULL);
+  }
+
+  printf("clients:%d server threads:%d msgs:%ld small msgs:%d%%\n", numOfClients, numOfThreads, total, smallPercent);
+  printf("throughput: %.0f msgs/s\n", total / (et - st));
+  printf("allocations per msg: %.3f\n", (double)numOfAllocs / total);
+
+  taosCleanUpTcpServer(server);
+  free(clients);
+
+  return 0;
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * check taos_fetch_columns against the inserted data, in ascending and descending order, and the aggregates of a
+ * super table query. Set compressMsgSize of taosd to 1 to have every retrieve response compressed by column.
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <taos.h>
+
+#define TEST_DB       "fetchtest"
+#define TEST_TABLES   4
+#define TEST_ROWS     20000
+#define TEST_BATCH    500
+#define TEST_START_TS 1500000000000L
+
+static int failed = 0;
+
+static void execute(TAOS *taos, char *sql) {
+  if (taos_query(taos, sql) != 0) {
+    printf("failed to run: %s, reason:%s\n", sql, taos_errstr(taos));
+    exit(1);
+  }
+}
+
+static void insertData(TAOS *taos) {
+  char *sql = malloc(TEST_BATCH * 64 + 128);
+
+  execute(taos, "drop database if exists " TEST_DB);
+  execute(taos, "create database " TEST_DB);
+  execute(taos, "use " TEST_DB);
+  execute(taos, "create table st (ts timestamp, v int, d double, b binary(8)) tags (t int)");
+
+  for (int t = 0; t < TEST_TABLES; ++t) {
+    sprintf(sql, "create table t%d using st tags (%d)", t, t);
+    execute(taos, sql);
+
+    for (int i = 0; i < TEST_ROWS; i += TEST_BATCH) {
+      int len = sprintf(sql, "insert into t%d values", t);
+      for (int j = i; j < i + TEST_BATCH; ++j) {
+        len += sprintf(sql + len, " (%ld, %d, %d.5, 'b%d')", TEST_START_TS + j, j + t, j, j % 1000);
+      }
+      execute(taos, sql);
+    }
+  }
+
+  free(sql);
+}
+
+static void checkColumns(TAOS *taos, int desc) {
+  execute(taos, desc ? "select * from t0 order by ts desc" : "select * from t0");
+
+  TAOS_RES *result = taos_use_result(taos);
+  void *    columns[4];
+  int       total = 0;
+  int       rows = 0;
+
+  while ((rows = taos_fetch_columns(result, columns)) > 0) {
+    for (int r = 0; r < rows; ++r, ++total) {
+      int   expect = desc ? TEST_ROWS - 1 - total : total;
+      char  b[16];
+      char *pb = (char *)columns[3] + r * 8;
+
+      sprintf(b, "b%d", expect % 1000);
+      if (((int64_t *)columns[0])[r] != TEST_START_TS + expect || ((int32_t *)columns[1])[r] != expect ||
+          ((double *)columns[2])[r] != expect + 0.5 || strncmp(pb, b, 8) != 0) {
+        printf("%s: row %d is wrong, ts:%ld v:%d\n", desc ? "desc" : "asc", total, ((int64_t *)columns[0])[r],
+               ((int32_t *)columns[1])[r]);
+        failed = 1;
+        break;
+      }
+    }
+  }
+
+  if (total != TEST_ROWS) {
+    printf("%s: %d rows are fetched, %d expected\n", desc ? "desc" : "asc", total, TEST_ROWS);
+    failed = 1;
+  }
+
+  taos_free_result(result);
+}
+
+static void checkAggregates(TAOS *taos) {
+  execute(taos, "select count(*), avg(v), spread(v), sum(v) from st");
+
+  TAOS_RES *result = taos_use_result(taos);
+  TAOS_ROW  row = taos_fetch_row(result);
+  if (row == NULL) {
+    printf("super table: no result\n");
+    failed = 1;
+    taos_free_result(result);
+    return;
+  }
+
+  // v of table t is j + t for j in [0, TEST_ROWS)
+  int64_t count = (int64_t)TEST_ROWS * TEST_TABLES;
+  int64_t sum = 0;
+  for (int t = 0; t < TEST_TABLES; ++t) sum += (int64_t)TEST_ROWS * (TEST_ROWS - 1) / 2 + (int64_t)t * TEST_ROWS;
+
+  if (*(int64_t *)row[0] != count || fabs(*(double *)row[1] - (double)sum / count) > 1e-6 ||
+      *(double *)row[2] != TEST_ROWS - 1 + TEST_TABLES - 1 || *(int64_t *)row[3] != sum) {
+    printf("super table: wrong aggregates, count:%ld avg:%f spread:%f sum:%ld\n", *(int64_t *)row[0],
+           *(double *)row[1], *(double *)row[2], *(int64_t *)row[3]);
+    failed = 1;
+  }
+
+  taos_free_result(result);
+}
+
+int main(int argc, char *argv[]) {
+  char *host = (argc > 1) ? argv[1] : NULL;
+
+  taos_init();
+  TAOS *taos = taos_connect(host, "root", "taosdata", NULL, 0);
+  if (taos == NULL) {
+    printf("failed to connect to server, reason:%s\n", taos_errstr(taos));
+    exit(1);
+  }
+
+  insertData(taos);
+  checkColumns(taos, 0);
+  checkColumns(taos, 1);
+  checkAggregates(taos);
+
+  execute(taos, "drop database " TEST_DB);
+  taos_close(taos);
+
+  printf("%s\n", failed ? "failed" : "passed");
+  return failed;
+}
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * compare the results of super table queries scanned by one thread and by several workers in each vnode, and check
+ * them against the inserted data. Set queryParallelism of taosd to 4 or more, otherwise both runs take one thread.
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <taos.h>
+
+#define TEST_DB          "paralleltest"
+#define TEST_TABLES      64
+#define TEST_ROWS        2000
+#define TEST_BATCH       500
+#define TEST_START_TS    1500000000000L
+#define TEST_PARALLELISM 4
+#define TEST_MAX_ROWS    (TEST_TABLES + 1)
+#define TEST_MAX_COLS    8
+
+typedef struct {
+  int    rows;
+  int    cols;
+  double values[TEST_MAX_ROWS][TEST_MAX_COLS];
+} SQueryResult;
+
+static char *queries[] = {
+    "select count(*), sum(v), avg(v), min(v), max(v), spread(v) from st",
+    "select count(*), sum(v), min(d), max(d), first(v), last(v) from st",
+    "select count(*), sum(v), avg(d), max(v) from st group by t",
+    "select count(*), sum(v), min(v) from st where ts >= 1500000000500 and v > 100 group by g",
+};
+
+static int failed = 0;
+
+static double getCurrentTime() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1E6;
+}
+
+static void execute(TAOS *taos, char *sql) {
+  if (taos_query(taos, sql) != 0) {
+    printf("failed to run: %s, reason:%s\n", sql, taos_errstr(taos));
+    exit(1);
+  }
+}
+
+static void insertData(TAOS *taos) {
+  char *sql = malloc(TEST_BATCH * 48 + 128);
+
+  execute(taos, "drop database if exists " TEST_DB);
+  execute(taos, "create database " TEST_DB);
+  execute(taos, "use " TEST_DB);
+  execute(taos, "create table st (ts timestamp, v int, d double) tags (t int, g int)");
+
+  for (int t = 0; t < TEST_TABLES; ++t) {
+    sprintf(sql, "create table t%d using st tags (%d, %d)", t, t, t % 4);
+    execute(taos, sql);
+
+    for (int i = 0; i < TEST_ROWS; i += TEST_BATCH) {
+      int len = sprintf(sql, "insert into t%d values", t);
+      for (int j = i; j < i + TEST_BATCH; ++j) {
+        len += sprintf(sql + len, " (%ld, %d, %d.25)", TEST_START_TS + j, j + t, j - t);
+      }
+      execute(taos, sql);
+    }
+  }
+
+  free(sql);
+}
+
+static double getValue(TAOS_FIELD *field, void *value) {
+  switch (field->type) {
+    case TSDB_DATA_TYPE_INT:
+      return *(int32_t *)value;
+    case TSDB_DATA_TYPE_BIGINT:
+      return (double)*(int64_t *)value;
+    case TSDB_DATA_TYPE_FLOAT:
+      return *(float *)value;
+    case TSDB_DATA_TYPE_DOUBLE:
+      return *(double *)value;
+    default:
+      return 0;
+  }
+}
+
+static double runQuery(TAOS *taos, char *sql, int parallelism, SQueryResult *pResult) {
+  if (taos_set_query_parallelism(taos, parallelism) != 0) {
+    printf("failed to set query parallelism:%d\n", parallelism);
+    exit(1);
+  }
+
+  double st = getCurrentTime();
+  execute(taos, sql);
+
+  TAOS_RES *  result = taos_use_result(taos);
+  TAOS_FIELD *fields = taos_fetch_fields(result);
+  TAOS_ROW    row;
+
+  memset(pResult, 0, sizeof(SQueryResult));
+  pResult->cols = taos_num_fields(result);
+
+  while ((row = taos_fetch_row(result)) != NULL && pResult->rows < TEST_MAX_ROWS) {
+    for (int c = 0; c < pResult->cols && c < TEST_MAX_COLS; ++c) {
+      pResult->values[pResult->rows][c] = (row[c] == NULL) ? NAN : getValue(&fields[c], row[c]);
+    }
+    pResult->rows++;
+  }
+
+  taos_free_result(result);
+  return getCurrentTime() - st;
+}
+
+static int isSameResult(SQueryResult *pLeft, SQueryResult *pRight) {
+  if (pLeft->rows != pRight->rows || pLeft->cols != pRight->cols) return 0;
+
+  for (int r = 0; r < pLeft->rows; ++r) {
+    for (int c = 0; c < pLeft->cols && c < TEST_MAX_COLS; ++c) {
+      double l = pLeft->values[r][c];
+      double v = pRight->values[r][c];
+      if (isnan(l) != isnan(v) || (!isnan(l) && fabs(l - v) > 1e-6 * (fabs(l) + 1))) return 0;
+    }
+  }
+
+  return 1;
+}
+
+// v of table t is j + t and d is j - t + 0.25 for j in [0, TEST_ROWS)
+static void checkExpected(SQueryResult *pResult) {
+  int64_t count = (int64_t)TEST_ROWS * TEST_TABLES;
+  int64_t sum = 0;
+  for (int t = 0; t < TEST_TABLES; ++t) sum += (int64_t)TEST_ROWS * (TEST_ROWS - 1) / 2 + (int64_t)t * TEST_ROWS;
+
+  double *v = pResult->values[0];
+  if (pResult->rows != 1 || v[0] != count || v[1] != sum || fabs(v[2] - (double)sum / count) > 1e-6 || v[3] != 0 ||
+      v[4] != TEST_ROWS - 1 + TEST_TABLES - 1 || v[5] != TEST_ROWS - 1 + TEST_TABLES - 1) {
+    printf("%s: wrong aggregates, count:%.0f sum:%.0f avg:%f min:%.0f max:%.0f spread:%.0f\n", queries[0], v[0], v[1],
+           v[2], v[3], v[4], v[5]);
+    failed = 1;
+  }
+}
+
+int main(int argc, char *argv[]) {
+  char *host = (argc > 1) ? argv[1] : NULL;
+
+  taos_init();
+  TAOS *taos = taos_connect(host, "root", "taosdata", NULL, 0);
+  if (taos == NULL) {
+    printf("failed to connect to server, reason:%s\n", taos_errstr(taos));
+    exit(1);
+  }
+
+  insertData(taos);
+
+  SQueryResult serial, parallel;
+  for (int i = 0; i < sizeof(queries) / sizeof(queries[0]); ++i) {
+    double serialTime = runQuery(taos, queries[i], 1, &serial);
+    double parallelTime = runQuery(taos, queries[i], TEST_PARALLELISM, &parallel);
+
+    if (i == 0) checkExpected(&serial);
+
+    if (!isSameResult(&serial, &parallel)) {
+      printf("%s: results of parallelism 1 and %d differ, rows:%d and %d\n", queries[i], TEST_PARALLELISM, serial.rows,
+             parallel.rows);
+      failed = 1;
+    }
+
+    printf("%s: %.3f ms with parallelism 1, %.3f ms with parallelism %d\n", queries[i], serialTime * 1000,
+           parallelTime * 1000, TEST_PARALLELISM);
+  }
+
+  execute(taos, "drop database " TEST_DB);
+  taos_close(taos);
+
+  printf("%s\n", failed ? "failed" : "passed");
+  return failed;
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * check the windows of a stream with interval(2d) sliding(1d), which are merged from the results of panes of a day,
+ * against the inserted data. The stream starts in the past, so the windows of the last days are computed at once.
+ * Run taosd in a time zone other than UTC, where the vnode aligns intervals of days to local midnight.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <taos.h>
+#include <unistd.h>
+
+#define TEST_DB      "streampanetest"
+#define TEST_DAYS    10
+#define TEST_HOUR    3600000L
+#define TEST_DAY     (24 * TEST_HOUR)
+#define TEST_WINDOWS 6
+#define TEST_CFG_DIR "/tmp/streamPaneTest"
+
+static int64_t startTs = 0;
+static int64_t numOfRows = 0;
+static int     numOfWindows = 0;
+static int     failed = 0;
+
+static void execute(TAOS *taos, char *sql) {
+  if (taos_query(taos, sql) != 0) {
+    printf("failed to run: %s, reason:%s\n", sql, taos_errstr(taos));
+    exit(1);
+  }
+}
+
+// one row an hour, v of the row at startTs + h hours is h
+static void insertData(TAOS *taos) {
+  char *sql = malloc(64 * 48 + 128);
+
+  execute(taos, "drop database if exists " TEST_DB);
+  execute(taos, "create database " TEST_DB " keep 36500");
+  execute(taos, "use " TEST_DB);
+  execute(taos, "create table t (ts timestamp, v int)");
+
+  for (int64_t h = 0; h < numOfRows; h += 48) {
+    int len = sprintf(sql, "insert into t values");
+    for (int64_t i = h; i < h + 48 && i < numOfRows; ++i) {
+      len += sprintf(sql + len, " (%ld, %ld)", startTs + i * TEST_HOUR, i);
+    }
+    execute(taos, sql);
+  }
+
+  free(sql);
+}
+
+static void checkWindow(void *param, TAOS_RES *res, TAOS_ROW row) {
+  if (row == NULL) return;
+
+  int64_t skey = *(int64_t *)row[0];
+  int64_t count = 0, sum = 0, min = INT64_MAX, max = INT64_MIN;
+
+  for (int64_t h = 0; h < numOfRows; ++h) {
+    int64_t ts = startTs + h * TEST_HOUR;
+    if (ts < skey || ts >= skey + 2 * TEST_DAY) continue;
+
+    count++;
+    sum += h;
+    if (h < min) min = h;
+    if (h > max) max = h;
+  }
+
+  if (skey % TEST_DAY != 0 || count == 0 || *(int64_t *)row[1] != count || *(int64_t *)row[2] != sum ||
+      *(int32_t *)row[3] != min || *(int32_t *)row[4] != max) {
+    printf("window %ld: wrong result, count:%ld sum:%ld min:%d max:%d, expected count:%ld sum:%ld min:%ld max:%ld\n",
+           skey, *(int64_t *)row[1], *(int64_t *)row[2], *(int32_t *)row[3], *(int32_t *)row[4], count, sum, min,
+           max);
+    failed = 1;
+  }
+
+  numOfWindows++;
+}
+
+int main(int argc, char *argv[]) {
+  char *host = (argc > 1) ? argv[1] : NULL;
+
+  // compute the windows in the past without the random delay of stream computing
+  mkdir(TEST_CFG_DIR, 0755);
+  FILE *fp = fopen(TEST_CFG_DIR "/taos.cfg", "w");
+  if (fp == NULL) {
+    printf("failed to create config in %s\n", TEST_CFG_DIR);
+    exit(1);
+  }
+  fprintf(fp, "maxStreamCompDelay 10\nmaxFirstStreamCompDelay 1000\n");
+  fclose(fp);
+
+  taos_options(TSDB_OPTION_CONFIGDIR, TEST_CFG_DIR);
+  taos_init();
+
+  TAOS *taos = taos_connect(host, "root", "taosdata", NULL, 0);
+  if (taos == NULL) {
+    printf("failed to connect to server, reason:%s\n", taos_errstr(taos));
+    exit(1);
+  }
+
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  int64_t now = (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+
+  startTs = (now / TEST_DAY - TEST_DAYS) * TEST_DAY + TEST_HOUR / 2;
+  numOfRows = (now - startTs) / TEST_HOUR;
+  insertData(taos);
+
+  TAOS_STREAM *stream = taos_open_stream(
+      taos, "select count(*), sum(v), min(v), max(v) from t interval(2d) sliding(1d)", checkWindow,
+      startTs + (TEST_DAYS - TEST_WINDOWS) * TEST_DAY, NULL, NULL);
+  if (stream == NULL) {
+    printf("failed to open stream, reason:%s\n", taos_errstr(taos));
+    exit(1);
+  }
+
+  for (int i = 0; i < 120 && numOfWindows < TEST_WINDOWS - 1; ++i) sleep(1);
+  taos_close_stream(stream);
+
+  if (numOfWindows < TEST_WINDOWS - 1) {
+    printf("%d windows are computed, at least %d expected\n", numOfWindows, TEST_WINDOWS - 1);
+    failed = 1;
+  }
+
+  execute(taos, "drop database " TEST_DB);
+  taos_close(taos);
+
+  printf("%s\n", failed ? "failed" : "passed");
+  return failed;
+}